@@ -556,7 +556,11 @@ public:
 		: QtZipPrivate(device, ownDev),
 		status(QtZipWriter::NoError),
 		permissions(QFile::ReadOwner | QFile::WriteOwner),
-		compressionPolicy(QtZipWriter::AlwaysCompress)
+		compressionPolicy(QtZipWriter::AlwaysCompress),
+		isStreaming(false),
+		streamCompressed(false),
+		streamCrc(0),
+		streamSize(0)
 	{
 	}
 
@@ -566,7 +570,22 @@ public:
 
 	enum EntryType { Directory, File, Symlink };
 
+	void initHeader(FileHeader &header, EntryType type, const QString &fileName) const;
 	void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+
+	// file which contents are written by parts, see QtZipWriter::beginFile()
+	bool isStreaming;
+	bool streamCompressed;
+	FileHeader streamHeader;
+	z_stream stream;
+	QByteArray streamBuffer;
+	uint streamCrc;
+	uint streamSize;
+
+	void beginStream(const QString &fileName);
+	void writeStream(const char *data, int length);
+	void deflateStream(int flush);
+	void endStream();
 };
 
 LocalFileHeader CentralFileHeader::toLocalHeader() const
@@ -674,6 +693,44 @@ void QtZipReaderPrivate::scanFiles()
 	}
 }
 
+void QtZipWriterPrivate::initHeader(FileHeader &header, EntryType type, const QString &fileName) const
+{
+	memset(&header.h, 0, sizeof(CentralFileHeader));
+	writeUInt(header.h.signature, 0x02014b50);
+
+	writeUShort(header.h.version_needed, ZIP_VERSION);
+	writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
+
+	// if bit 11 is set, the filename and comment fields must be encoded using UTF-8
+	ushort general_purpose_bits = Utf8Names; // always use utf-8
+	writeUShort(header.h.general_purpose_bits, general_purpose_bits);
+
+	const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
+	header.file_name = inUtf8 ? fileName.toUtf8() : fileName.toLocal8Bit();
+	if (header.file_name.size() > 0xffff) {
+		qWarning("QtZip: Filename is too long, chopping it to 65535 bytes");
+		header.file_name = header.file_name.left(0xffff); // ### don't break the utf-8 sequence, if any
+	}
+	if (header.file_comment.size() + header.file_name.size() > 0xffff) {
+		qWarning("QtZip: File comment is too long, chopping it to 65535 bytes");
+		header.file_comment.truncate(0xffff - header.file_name.size()); // ### don't break the utf-8 sequence, if any
+	}
+	writeUShort(header.h.file_name_length, header.file_name.length());
+	//h.extra_field_length[2];
+
+	writeUShort(header.h.version_made, HostUnix << 8);
+	//uchar internal_file_attributes[2];
+	//uchar external_file_attributes[4];
+	quint32 mode = permissionsToMode(permissions);
+	switch (type) {
+		case File: mode |= S_IFREG; break;
+		case Directory: mode |= S_IFDIR; break;
+		case Symlink: mode |= S_IFLNK; break;
+	}
+	writeUInt(header.h.external_file_attributes, mode << 16);
+	writeUInt(header.h.offset_local_header, start_of_directory);
+}
+
 void QtZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, QtZip::Method m*/)
 {
 #ifndef NDEBUG
@@ -684,6 +741,9 @@ void QtZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
 	ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
 #endif
 
+	// the file written by parts must be finished before the next entry
+	endStream();
+
 	if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
 		status = QtZipWriter::FileOpenError;
 		return;
@@ -700,12 +760,8 @@ void QtZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
 	}
 
 	FileHeader header;
-	memset(&header.h, 0, sizeof(CentralFileHeader));
-	writeUInt(header.h.signature, 0x02014b50);
-
-	writeUShort(header.h.version_needed, ZIP_VERSION);
+	initHeader(header, type, fileName);
 	writeUInt(header.h.uncompressed_size, contents.length());
-	writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
 	QByteArray data = contents;
 	if (compression == QtZipWriter::AlwaysCompress) {
 		writeUShort(header.h.compression_method, CompressionMethodDeflated);
@@ -738,43 +794,106 @@ void QtZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
 	crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.length());
 	writeUInt(header.h.crc_32, crc_32);
 
-	// if bit 11 is set, the filename and comment fields must be encoded using UTF-8
-	ushort general_purpose_bits = Utf8Names; // always use utf-8
-	writeUShort(header.h.general_purpose_bits, general_purpose_bits);
+	fileHeaders.append(header);
 
-	const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
-	header.file_name = inUtf8 ? fileName.toUtf8() : fileName.toLocal8Bit();
-	if (header.file_name.size() > 0xffff) {
-		qWarning("QtZip: Filename is too long, chopping it to 65535 bytes");
-		header.file_name = header.file_name.left(0xffff); // ### don't break the utf-8 sequence, if any
+	LocalFileHeader h = header.h.toLocalHeader();
+	device->write((const char *)&h, sizeof(LocalFileHeader));
+	device->write(header.file_name);
+	device->write(data);
+	start_of_directory = device->pos();
+	dirtyFileTree = true;
+}
+
+void QtZipWriterPrivate::beginStream(const QString &fileName)
+{
+	ZDEBUG() << "streaming file:" << fileName.toUtf8().data();
+
+	if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+		status = QtZipWriter::FileOpenError;
+		return;
 	}
-	if (header.file_comment.size() + header.file_name.size() > 0xffff) {
-		qWarning("QtZip: File comment is too long, chopping it to 65535 bytes");
-		header.file_comment.truncate(0xffff - header.file_name.size()); // ### don't break the utf-8 sequence, if any
+	device->seek(start_of_directory);
+
+	// the size of the contents is unknown beforehand, so compress them unless it's forbidden
+	streamCompressed = compressionPolicy != QtZipWriter::NeverCompress;
+	if (streamCompressed) {
+		memset(&stream, 0, sizeof(stream));
+		// same parameters as in deflate() to get the same data as QtZipWriter::addFile() does
+		if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			qWarning("QtZip: Failed to initialize the compression of a file, skipping");
+			return;
+		}
+		streamBuffer.resize(64 * 1024);
 	}
-	writeUShort(header.h.file_name_length, header.file_name.length());
-	//h.extra_field_length[2];
 
-	writeUShort(header.h.version_made, HostUnix << 8);
-	//uchar internal_file_attributes[2];
-	//uchar external_file_attributes[4];
-	quint32 mode = permissionsToMode(permissions);
-	switch (type) {
-		case File: mode |= S_IFREG; break;
-		case Directory: mode |= S_IFDIR; break;
-		case Symlink: mode |= S_IFLNK; break;
+	initHeader(streamHeader, File, fileName);
+	if (streamCompressed)
+		writeUShort(streamHeader.h.compression_method, CompressionMethodDeflated);
+	streamCrc = ::crc32(0, 0, 0);
+	streamSize = 0;
+	isStreaming = true;
+
+	// crc and sizes are written to the local header when the file is finished
+	LocalFileHeader h = streamHeader.h.toLocalHeader();
+	device->write((const char *)&h, sizeof(LocalFileHeader));
+	device->write(streamHeader.file_name);
+}
+
+void QtZipWriterPrivate::writeStream(const char *data, int length)
+{
+	if (!isStreaming || length <= 0)
+		return;
+
+	streamCrc = ::crc32(streamCrc, (const uchar *)data, length);
+	streamSize += length;
+	if (!streamCompressed) {
+		device->write(data, length);
+		return;
 	}
-	writeUInt(header.h.external_file_attributes, mode << 16);
-	writeUInt(header.h.offset_local_header, start_of_directory);
 
+	stream.next_in = (Bytef *)data;
+	stream.avail_in = length;
+	deflateStream(Z_NO_FLUSH);
+}
 
-	fileHeaders.append(header);
+void QtZipWriterPrivate::deflateStream(int flush)
+{
+	int res = Z_OK;
+	do {
+		stream.next_out = (Bytef *)streamBuffer.data();
+		stream.avail_out = streamBuffer.size();
+		res = ::deflate(&stream, flush);
+		device->write(streamBuffer.constData(), streamBuffer.size() - stream.avail_out);
+	} while (res == Z_OK && (stream.avail_in > 0 || stream.avail_out == 0 || flush == Z_FINISH));
+}
 
-	LocalFileHeader h = header.h.toLocalHeader();
+void QtZipWriterPrivate::endStream()
+{
+	if (!isStreaming)
+		return;
+
+	isStreaming = false;
+	if (streamCompressed) {
+		deflateStream(Z_FINISH);
+		deflateEnd(&stream);
+		streamBuffer.clear();
+	}
+
+	const qint64 headerStart = readUInt(streamHeader.h.offset_local_header);
+	const qint64 end = device->pos();
+	const qint64 dataSize = end - headerStart - sizeof(LocalFileHeader) - streamHeader.file_name.size();
+	writeUInt(streamHeader.h.crc_32, streamCrc);
+	writeUInt(streamHeader.h.compressed_size, dataSize);
+	writeUInt(streamHeader.h.uncompressed_size, streamSize);
+
+	// rewrite the local header with the known crc and sizes
+	LocalFileHeader h = streamHeader.h.toLocalHeader();
+	device->seek(headerStart);
 	device->write((const char *)&h, sizeof(LocalFileHeader));
-	device->write(header.file_name);
-	device->write(data);
-	start_of_directory = device->pos();
+	device->seek(end);
+
+	fileHeaders.append(streamHeader);
+	start_of_directory = end;
 	dirtyFileTree = true;
 }
 
@@ -1353,6 +1472,36 @@ void QtZipWriter::addFile(const QString &fileName, QIODevice *device)
 		device->close();
 }
 
+/*!
+	Start a new file in the archive with the specified \a fileName, which
+	contents are written by parts with writeToFile() and compressed on the fly,
+	so the whole contents don't have to be kept in memory. The file is added
+	to the archive when endFile() is called or when the next entry is added.
+	The archive device must be seekable, as the local file header is updated
+	with the checksum and sizes when the file is finished.
+*/
+void QtZipWriter::beginFile(const QString &fileName)
+{
+	endFile();
+	d->beginStream(QDir::fromNativeSeparators(fileName));
+}
+
+/*!
+	Append \a data to the file started with beginFile().
+*/
+void QtZipWriter::writeToFile(const QByteArray &data)
+{
+	d->writeStream(data.constData(), data.size());
+}
+
+/*!
+	Finish the file started with beginFile().
+*/
+void QtZipWriter::endFile()
+{
+	d->endStream();
+}
+
 /*!
 	Create a new directory in the archive with the specified \a dirName and
 	the \a permissions;
@@ -1381,6 +1530,8 @@ void QtZipWriter::addSymLink(const QString &fileName, const QString &destination
 */
 void QtZipWriter::close()
 {
+	endFile();
+
 	if (!(d->device->openMode() & QIODevice::WriteOnly)) {
 		d->device->close();
 		return;
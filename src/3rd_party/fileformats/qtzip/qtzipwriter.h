@@ -85,6 +85,10 @@ public:
 
 	void addFile(const QString &fileName, QIODevice *device);
 
+	void beginFile(const QString &fileName);
+	void writeToFile(const QByteArray &data);
+	void endFile();
+
 	void addDirectory(const QString &dirName);
 
 	void addSymLink(const QString &fileName, const QString &destination);
@@ -20,6 +20,13 @@ exists("../cloud/cloud.pri") {
 DEFINES += CORE_PLUGIN
 DEFINES += QT_DEPRECATED_WARNINGS
 
+#
+# Трассировка выполнения включается через qmake CONFIG+=tracing
+#
+tracing {
+    DEFINES += STARC_TRACING
+}
+
 mac {
     DESTDIR = ../_build/starcapp.app/Contents/PlugIns
     CORELIBDIR = ../_build/starcapp.app/Contents/Frameworks
@@ -61,7 +68,6 @@ SOURCES += \
     management_layer/content/settings/settings_manager.cpp \
     management_layer/content/settings/template_options_manager.cpp \
     management_layer/content/writing_session/writing_session_manager.cpp \
-    management_layer/content/writing_session/writing_session_storage.cpp \
     management_layer/plugins_builder.cpp \
     ui/about_application_dialog.cpp \
     ui/account/account_navigator.cpp \
@@ -136,7 +142,6 @@ HEADERS += \
     management_layer/content/settings/settings_manager.h \
     management_layer/content/settings/template_options_manager.h \
     management_layer/content/writing_session/writing_session_manager.h \
-    management_layer/content/writing_session/writing_session_storage.h \
     management_layer/plugins_builder.h \
     ui/about_application_dialog.h \
     ui/account/account_navigator.h \
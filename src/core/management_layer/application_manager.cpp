@@ -18,6 +18,7 @@
 
 #include <business_layer/model/abstract_model.h>
 #include <data_layer/database.h>
+#include <data_layer/persistence_worker.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <domain/document_change_object.h>
@@ -40,17 +41,20 @@
 #include <utils/3rd_party/WAF/Animation/Animation.h>
 #include <utils/helpers/dialog_helper.h>
 #include <utils/helpers/extension_helper.h>
+#include <utils/helpers/font_helper.h>
 #include <utils/helpers/image_helper.h>
 #include <utils/helpers/platform_helper.h>
 #include <utils/logging.h>
 #include <utils/tools/backup_builder.h>
 #include <utils/tools/once.h>
 #include <utils/tools/run_once.h>
+#include <utils/tracing.h>
 #include <utils/validators/email_validator.h>
 
 #include <QApplication>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFileSystemWatcher>
 #include <QFontDatabase>
@@ -209,6 +213,11 @@ public:
      */
     void saveChanges();
 
+    /**
+     * @brief Сообщить пользователю об ошибке сохранения изменений
+     */
+    void showSavingError(const QString& _error);
+
     /**
      * @brief Если проект был изменён, но не сохранён предложить пользователю сохранить его
      * @param _callback - метод, который будет вызван, если пользователь хочет (Да),
@@ -291,6 +300,11 @@ public:
 
     ApplicationManager* q = nullptr;
 
+    /**
+     * @brief Таймер для замера времени запуска приложения
+     */
+    QElapsedTimer startupTimer;
+
     /**
      * @brief Используем для блокировки файла во время работы
      */
@@ -1206,6 +1220,8 @@ void ApplicationManager::Implementation::saveChanges()
         return;
     }
 
+    TRACE_SCOPE("autosave", "ApplicationManager::saveChanges");
+
     //
     // Сохраняем только, если приложение находится в рабочем состоянии
     //
@@ -1221,50 +1237,19 @@ void ApplicationManager::Implementation::saveChanges()
     }
 
     //
-    // Управляющие должны сохранить все изменения
+    // Управляющие должны сохранить все изменения, при этом сами изменения записываются в базу
+    // данных в фоновом потоке, чтобы не блокировать интерфейс
     //
-    DatabaseLayer::Database::transaction();
+    DatabaseLayer::Database::beginDeferredWrites();
     projectsManager->saveChanges();
     projectManager->saveChanges();
-    DatabaseLayer::Database::commit();
+    DatabaseLayer::Database::endDeferredWrites();
 
     //
-    // Если произошла ошибка сохранения, то делаем дополнительные проверки и работаем с
-    // пользователем
+    // Если произошла ошибка сохранения, то работаем с пользователем
     //
     if (DatabaseLayer::Database::hasError()) {
-        //
-        // Если файл, в который мы пробуем сохранять изменения существует
-        //
-        if (QFile::exists(DatabaseLayer::Database::currentFile())) {
-            //
-            // ... то у нас случилась какая-то внутренняя ошибка базы данных
-            //
-            StandardDialog::information(
-                applicationView, tr("Saving error"),
-                tr("Changes can't be written. There is an internal database error: \"%1\" "
-                   "Please check, if your file exists and if you have permission to write.")
-                    .arg(DatabaseLayer::Database::lastError()));
-
-            //
-            // TODO: пока хер знает, как реагировать на данную проблему...
-            //       нужны реальные кейсы и пробовать что-то предпринимать
-            //
-        }
-        //
-        // Файла с базой данных не найдено
-        //
-        else {
-            //
-            // ... возможно файл был на флешке, а она отошла, или файл был переименован во время
-            // работы программы
-            //
-            StandardDialog::information(
-                applicationView, tr("Saving error"),
-                tr("Changes can't be written because the story located at \"%1\" doesn't exist. "
-                   "Please move the file back and retry saving.")
-                    .arg(DatabaseLayer::Database::currentFile()));
-        }
+        showSavingError(DatabaseLayer::Database::lastError());
         return;
     }
 
@@ -1295,10 +1280,54 @@ void ApplicationManager::Implementation::saveChanges()
             //
             baseBackupName = QString("%1 [%2]").arg(currentProject.name()).arg(currentProject.id());
         }
+        //
+        // ... при этом бэкап делаем после того, как все изменения будут записаны в файл
+        //
         QFuture<void> future = QtConcurrent::run(
-            BackupBuilder::save, projectsManager->currentProject().path(),
-            settingsValue(DataStorageLayer::kApplicationBackupsFolderKey).toString(),
-            baseBackupName, settingsValue(DataStorageLayer::kApplicationBackupsQtyKey).toInt());
+            [projectPath = currentProject.path(),
+             backupsFolder
+             = settingsValue(DataStorageLayer::kApplicationBackupsFolderKey).toString(),
+             baseBackupName,
+             backupsQty = settingsValue(DataStorageLayer::kApplicationBackupsQtyKey).toInt()] {
+                DatabaseLayer::Database::waitForPendingWrites();
+                BackupBuilder::save(projectPath, backupsFolder, baseBackupName, backupsQty);
+            });
+    }
+}
+
+void ApplicationManager::Implementation::showSavingError(const QString& _error)
+{
+    //
+    // Если файл, в который мы пробуем сохранять изменения существует
+    //
+    if (QFile::exists(DatabaseLayer::Database::currentFile())) {
+        //
+        // ... то у нас случилась какая-то внутренняя ошибка базы данных
+        //
+        StandardDialog::information(
+            applicationView, tr("Saving error"),
+            tr("Changes can't be written. There is an internal database error: \"%1\" "
+               "Please check, if your file exists and if you have permission to write.")
+                .arg(_error));
+
+        //
+        // TODO: пока хер знает, как реагировать на данную проблему...
+        //       нужны реальные кейсы и пробовать что-то предпринимать
+        //
+    }
+    //
+    // Файла с базой данных не найдено
+    //
+    else {
+        //
+        // ... возможно файл был на флешке, а она отошла, или файл был переименован во время
+        // работы программы
+        //
+        StandardDialog::information(
+            applicationView, tr("Saving error"),
+            tr("Changes can't be written because the story located at \"%1\" doesn't exist. "
+               "Please move the file back and retry saving.")
+                .arg(DatabaseLayer::Database::currentFile()));
     }
 }
 
@@ -1443,8 +1472,11 @@ void ApplicationManager::Implementation::saveAs()
         QFile::remove(saveAsProjectFilePath);
     }
     //
-    // ... скопируем текущую базу в указанный файл
+    // ... скопируем текущую базу в указанный файл, предварительно перенеся в неё журнал, и
+    //     дождёмся этого, т.к. копия должна содержать все изменения
     //
+    DatabaseLayer::Database::checkpoint();
+    DatabaseLayer::Database::waitForPendingWrites();
     const auto isCopied = QFile::copy(currentProject.realPath(), saveAsProjectFilePath);
     if (!isCopied) {
         StandardDialog::information(
@@ -1635,6 +1667,22 @@ bool ApplicationManager::Implementation::openProject(const QString& _path)
         return false;
     }
 
+    //
+    // Если открывается снимок из бэкапов, то восстанавливаем из него полную копию проекта и
+    // открываем уже её
+    //
+    if (BackupBuilder::isSnapshot(_path)) {
+        const auto fullCopyPath = BackupBuilder::restoreFullCopy(_path);
+        if (fullCopyPath.isEmpty()) {
+            StandardDialog::information(applicationView, {},
+                                        tr("This backup can't be restored, because some of its "
+                                           "data is missing or damaged."));
+            return false;
+        }
+
+        return openProject(fullCopyPath);
+    }
+
     if (projectsManager->project(_path).isLocal() && !QFileInfo::exists(_path)) {
         projectsManager->hideProject(_path);
         return false;
@@ -2115,6 +2163,12 @@ ApplicationManager::ApplicationManager(QObject* _parent)
     //
     PlatformHelper::initConsoleOutput();
 
+    //
+    // Засекаем время запуска
+    //
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     //
     // Первым делом настраиваем сбор логов
     //
@@ -2131,6 +2185,17 @@ ApplicationManager::ApplicationManager(QObject* _parent)
 #endif
     Log::init(loggingLevel, logFilePath);
 
+#ifdef STARC_TRACING
+    //
+    // ... и трассировку выполнения, если она включена при сборке
+    //
+    Trace::init(QString("%1/traces/%2.json")
+                    .arg(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation),
+                         PlatformHelper::systemSavebleFileName(
+                             QDateTime::currentDateTime().toString(Qt::ISODateWithMs))));
+    Log::info("Tracing to \"%1\"", Trace::traceFilePath());
+#endif
+
 
     QString applicationVersion = "0.5.0";
 #if defined(DEV_BUILD) && DEV_BUILD > 0
@@ -2149,45 +2214,17 @@ ApplicationManager::ApplicationManager(QObject* _parent)
     // Загрузим шрифты в базу шрифтов программы, если их там ещё нет
     //
     Log::info("Loading fonts");
+    QElapsedTimer fontsLoadingTimer;
+    fontsLoadingTimer.start();
     //
-    // ... встроенные в бинарник
-    //
-    QFontDatabase fontDatabase;
-    fontDatabase.addApplicationFont(":/fonts/materialdesignicons");
-    fontDatabase.addApplicationFont(":/fonts/font-awesome-brands");
-    fontDatabase.addApplicationFont(":/fonts/roboto-bold");
-    fontDatabase.addApplicationFont(":/fonts/roboto-light");
-    fontDatabase.addApplicationFont(":/fonts/roboto-medium");
-    fontDatabase.addApplicationFont(":/fonts/roboto-regular");
-    fontDatabase.addApplicationFont(":/fonts/noto-sans");
-    fontDatabase.addApplicationFont(":/fonts/noto-sans-light");
-    fontDatabase.addApplicationFont(":/fonts/noto-sans-medium");
-    //
-    fontDatabase.addApplicationFont(":/fonts/arial");
-    fontDatabase.addApplicationFont(":/fonts/arial-bold");
-    fontDatabase.addApplicationFont(":/fonts/arial-italic");
-    fontDatabase.addApplicationFont(":/fonts/arial-bold-italic");
-    fontDatabase.addApplicationFont(":/fonts/courier-new");
-    fontDatabase.addApplicationFont(":/fonts/courier-new-bold");
-    fontDatabase.addApplicationFont(":/fonts/courier-new-italic");
-    fontDatabase.addApplicationFont(":/fonts/courier-new-bold-italic");
-    fontDatabase.addApplicationFont(":/fonts/courier-prime");
-    fontDatabase.addApplicationFont(":/fonts/courier-prime-bold");
-    fontDatabase.addApplicationFont(":/fonts/courier-prime-italic");
-    fontDatabase.addApplicationFont(":/fonts/courier-prime-bold-italic");
-    fontDatabase.addApplicationFont(":/fonts/mallanna-regular");
-    fontDatabase.addApplicationFont(":/fonts/muktamalar-bold");
-    fontDatabase.addApplicationFont(":/fonts/muktamalar-regular");
-    fontDatabase.addApplicationFont(":/fonts/times-new-roman");
-    fontDatabase.addApplicationFont(":/fonts/times-new-roman-bold");
-    fontDatabase.addApplicationFont(":/fonts/times-new-roman-italic");
-    fontDatabase.addApplicationFont(":/fonts/times-new-roman-bold-italic");
-    //
-    fontDatabase.addApplicationFont(":/fonts/montserrat-regular");
-    fontDatabase.addApplicationFont(":/fonts/montserrat-bold");
-    fontDatabase.addApplicationFont(":/fonts/montserrat-italic");
-    fontDatabase.addApplicationFont(":/fonts/montserrat-bold-italic");
-    fontDatabase.addApplicationFont(":/fonts/sf-movie-poster");
+    // ... встроенные в бинарник шрифты интерфейса и шрифты, по которым настраиваются метрики
+    //     текста, а шрифты шаблонов будут загружены при загрузке использующего их шаблона, либо
+    //     в свободное время после отображения приложения
+    //
+    {
+        TRACE_SCOPE("startup", "FontHelper::loadInterfaceFonts");
+        FontHelper::loadInterfaceFonts();
+    }
     //
     // ... скаченные
     //
@@ -2196,13 +2233,15 @@ ApplicationManager::ApplicationManager(QObject* _parent)
               .arg(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
     const auto fonts = QDir(fontsFolderPath).entryInfoList(QDir::Files);
     for (const auto& font : fonts) {
-        fontDatabase.addApplicationFont(font.absoluteFilePath());
+        QFontDatabase::addApplicationFont(font.absoluteFilePath());
     }
+    Log::info("Fonts loaded in %1 ms", fontsLoadingTimer.elapsed());
 
     //
     // Инициилизируем данные после подгрузки шрифтов, чтобы они сразу подхватились системой
     //
     d.reset(new Implementation(this));
+    d->startupTimer = startupTimer;
 
     initConnections();
 }
@@ -2279,6 +2318,8 @@ void ApplicationManager::exec(const QString& _fileToOpenPath)
     //
     Log::info("Show application window");
     d->applicationView->show();
+    TRACE_INSTANT("startup", "Application window shown");
+    Log::info("Application window shown in %1 ms after start", d->startupTimer.elapsed());
 
     //
     // Осуществляем остальную настройку и показываем содержимое, после того, как на экране
@@ -2287,6 +2328,8 @@ void ApplicationManager::exec(const QString& _fileToOpenPath)
     QMetaObject::invokeMethod(
         this,
         [this, _fileToOpenPath] {
+            TRACE_SCOPE("startup", "ApplicationManager::finishStartup");
+
 #ifdef CLOUD_SERVICE_MANAGER
             //
             // Запуск облачного сервиса
@@ -2324,10 +2367,16 @@ void ApplicationManager::exec(const QString& _fileToOpenPath)
             //
             d->loadMissedFonts();
 
+            //
+            // Загружаем в свободное время встроенные шрифты, которые ещё не были загружены
+            //
+            FontHelper::loadRemainingFonts();
+
             //
             // Переводим состояние приложение в рабочий режим
             //
             d->state = ApplicationState::Working;
+            Log::info("Application started in %1 ms", d->startupTimer.elapsed());
         },
         Qt::QueuedConnection);
 }
@@ -2459,6 +2508,15 @@ void ApplicationManager::initConnections()
     fullScreenShortcut->setContext(Qt::ApplicationShortcut);
     connect(fullScreenShortcut, &QShortcut::activated, this, [this] { d->toggleFullScreen(); });
 
+    //
+    // Ошибки фоновой записи изменений
+    //
+    connect(DatabaseLayer::Database::persistenceWorker(),
+            &DatabaseLayer::PersistenceWorker::writeFailed, this, [this](const QString& _error) {
+                d->markChangesSaved(false);
+                d->showSavingError(_error);
+            });
+
     //
     // Представление приложения
     //
@@ -46,6 +46,7 @@
 #include <utils/helpers/dialog_helper.h>
 #include <utils/helpers/extension_helper.h>
 #include <utils/logging.h>
+#include <utils/tracing.h>
 
 #include <QDesktopServices>
 #include <QFileDialog>
@@ -278,6 +279,7 @@ void ExportManager::Implementation::exportScreenplay(
     if (exporter.isNull()) {
         return;
     }
+    TRACE_SCOPE("export", "ExportManager::exportScreenplay");
     exporter->exportTo(screenplayTextModel, exportOptions);
 }
 
@@ -397,6 +399,7 @@ void ExportManager::Implementation::exportComicBook(BusinessLayer::AbstractModel
                 if (exporter.isNull()) {
                     return;
                 }
+                TRACE_SCOPE("export", "ExportManager::exportComicBook");
                 exporter->exportTo(comicBookTextModel, exportOptions);
 
                 //
@@ -543,6 +546,7 @@ void ExportManager::Implementation::exportAudioplay(BusinessLayer::AbstractModel
                 if (exporter.isNull()) {
                     return;
                 }
+                TRACE_SCOPE("export", "ExportManager::exportAudioplay");
                 exporter->exportTo(audioplayTextModel, exportOptions);
 
                 //
@@ -688,6 +692,7 @@ void ExportManager::Implementation::exportStageplay(BusinessLayer::AbstractModel
                 if (exporter.isNull()) {
                     return;
                 }
+                TRACE_SCOPE("export", "ExportManager::exportStageplay");
                 exporter->exportTo(stageplayTextModel, exportOptions);
 
                 //
@@ -827,6 +832,7 @@ void ExportManager::Implementation::exportSimpleText(BusinessLayer::AbstractMode
                 if (exporter.isNull()) {
                     return;
                 }
+                TRACE_SCOPE("export", "ExportManager::exportSimpleText");
                 exporter->exportTo(simpleTextModel, exportOptions);
 
                 //
@@ -969,6 +975,7 @@ void ExportManager::Implementation::exportNovel(BusinessLayer::AbstractModel* _m
                 if (exporter.isNull()) {
                     return;
                 }
+                TRACE_SCOPE("export", "ExportManager::exportNovel");
                 exporter->exportTo(novelTextModel, exportOptions);
 
                 //
@@ -11,6 +11,7 @@
 #include <business_layer/model/comic_book/text/comic_book_text_model.h>
 #include <business_layer/model/locations/location_model.h>
 #include <business_layer/model/locations/locations_model.h>
+#include <business_layer/model/novel/text/novel_text_model.h>
 #include <business_layer/model/project/project_information_model.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
@@ -19,6 +20,7 @@
 #include <business_layer/model/structure/structure_model.h>
 #include <business_layer/model/structure/structure_model_item.h>
 #include <business_layer/model/structure/structure_proxy_model.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/model/worlds/world_model.h>
 #include <business_layer/model/worlds/worlds_model.h>
@@ -48,7 +50,9 @@
 #include <ui/widgets/context_menu/context_menu.h>
 #include <ui/widgets/dialog/dialog.h>
 #include <ui/widgets/splitter/splitter.h>
+#include <utils/diff_match_patch/diff_match_patch_controller.h>
 #include <utils/logging.h>
+#include <utils/tracing.h>
 
 #include <QAction>
 #include <QApplication>
@@ -1924,34 +1928,42 @@ ProjectManager::ProjectManager(QObject* _parent, QWidget* _parentWidget,
 
                 //
                 // Найти все модели где может встречаться персонаж и заменить в них его имя со
-                // старого на новое
+                // старого на новое, подготовив замену один раз для всех документов
                 //
+                const BusinessLayer::TextModelNameReplacement replacement(_oldName, _newName);
                 const auto screenplayModels
                     = d->modelsFacade.modelsFor(Domain::DocumentObjectType::ScreenplayText);
                 for (auto model : screenplayModels) {
                     auto screenplay = qobject_cast<BusinessLayer::ScreenplayTextModel*>(model);
-                    screenplay->updateCharacterName(_oldName, _newName);
+                    screenplay->updateCharacterName(replacement);
                 }
                 //
                 const auto comicBookModels
                     = d->modelsFacade.modelsFor(Domain::DocumentObjectType::ComicBookText);
                 for (auto model : comicBookModels) {
                     auto comicBook = qobject_cast<BusinessLayer::ComicBookTextModel*>(model);
-                    comicBook->updateCharacterName(_oldName, _newName);
+                    comicBook->updateCharacterName(replacement);
                 }
                 //
                 const auto audioplayModels
                     = d->modelsFacade.modelsFor(Domain::DocumentObjectType::AudioplayText);
                 for (auto model : audioplayModels) {
                     auto audioplay = qobject_cast<BusinessLayer::AudioplayTextModel*>(model);
-                    audioplay->updateCharacterName(_oldName, _newName);
+                    audioplay->updateCharacterName(replacement);
                 }
                 //
                 const auto stageplayModels
                     = d->modelsFacade.modelsFor(Domain::DocumentObjectType::StageplayText);
                 for (auto model : stageplayModels) {
                     auto stageplay = qobject_cast<BusinessLayer::StageplayTextModel*>(model);
-                    stageplay->updateCharacterName(_oldName, _newName);
+                    stageplay->updateCharacterName(replacement);
+                }
+                //
+                const auto novelModels
+                    = d->modelsFacade.modelsFor(Domain::DocumentObjectType::NovelText);
+                for (auto model : novelModels) {
+                    auto novel = qobject_cast<BusinessLayer::NovelTextModel*>(model);
+                    novel->updateCharacterName(replacement);
                 }
 
                 //
@@ -2098,13 +2110,21 @@ ProjectManager::ProjectManager(QObject* _parent, QWidget* _parentWidget,
 
                 //
                 // Найти все модели где может встречаться локация и заменить в них её имя со
-                // старого на новое
+                // старого на новое, подготовив замену один раз для всех документов
                 //
-                const auto models
+                const BusinessLayer::TextModelNameReplacement replacement(_oldName, _newName);
+                const auto screenplayModels
                     = d->modelsFacade.modelsFor(Domain::DocumentObjectType::ScreenplayText);
-                for (auto model : models) {
+                for (auto model : screenplayModels) {
                     auto screenplay = qobject_cast<BusinessLayer::ScreenplayTextModel*>(model);
-                    screenplay->updateLocationName(_oldName, _newName);
+                    screenplay->updateLocationName(replacement);
+                }
+                //
+                const auto novelModels
+                    = d->modelsFacade.modelsFor(Domain::DocumentObjectType::NovelText);
+                for (auto model : novelModels) {
+                    auto novel = qobject_cast<BusinessLayer::NovelTextModel*>(model);
+                    novel->updateLocationName(replacement);
                 }
 
                 //
@@ -2435,6 +2455,8 @@ void ProjectManager::checkAvailabilityToEdit()
 
 void ProjectManager::loadCurrentProject(const Project& _project)
 {
+    TRACE_SCOPE("project", "ProjectManager::loadCurrentProject");
+
     //
     // Загружаем структуру
     //
@@ -2912,17 +2934,28 @@ void ProjectManager::mergeDocumentInfo(const Domain::DocumentInfo& _documentInfo
     for (const auto& change : _documentInfo.changes) {
         changes.append(change.redoPatch);
     }
-    documentModel->mergeDocumentChanges(_documentInfo.content, changes);
+    const auto isDocumentMerged
+        = documentModel->mergeDocumentChanges(_documentInfo.content, changes);
+    //
+    // ... если изменения не накладываются на полученный контент без расхождений, то вместо
+    //     документа, который не совпадает с облачным, синхронизируемся по полному контенту
+    //
+    if (!isDocumentMerged && !changes.isEmpty() && !_documentInfo.content.isEmpty()) {
+        documentModel->mergeDocumentChanges(_documentInfo.content, {});
+    }
 
     //
     // Пробуем накатить несинхронизированные изменения
     //
     if (!unsyncedChanges.isEmpty()) {
         changes.clear();
+        QVector<QByteArray> resultHashes;
         for (const auto& change : unsyncedChanges) {
             changes.append(change->redoPatch());
+            resultHashes.append(change->resultHash());
         }
-        const auto isChangesMerged = documentModel->mergeDocumentChanges({}, changes);
+        const auto isChangesMerged
+            = documentModel->mergeDocumentChanges({}, changes, resultHashes);
         //
         // ... если успех - пушим несинхронизированные изменения
         //
@@ -3081,7 +3114,15 @@ void ProjectManager::applyDocumentChanges(const Domain::DocumentInfo& _documentI
     for (const auto& change : _documentInfo.changes) {
         changes.append(change.redoPatch);
     }
-    documentModel->applyDocumentChanges(changes);
+    const auto isChangesApplied = documentModel->applyDocumentChanges(changes);
+
+    //
+    // Если изменения не накладываются на текущий документ, то он разошёлся с облачным,
+    // поэтому запрашиваем его полный контент для синхронизации
+    //
+    if (!isChangesApplied) {
+        emit downloadDocumentRequested(document->uuid());
+    }
 }
 
 void ProjectManager::planDocumentSyncing(const QUuid& _documentUuid)
@@ -3419,7 +3460,8 @@ void ProjectManager::handleModelChange(BusinessLayer::AbstractModel* _model,
     StorageFacade::documentChangeStorage()->appendDocumentChange(
         _model->document()->uuid(), QUuid::createUuid(), _undo, _redo,
         StorageFacade::settingsStorage()->accountName(),
-        StorageFacade::settingsStorage()->accountEmail());
+        StorageFacade::settingsStorage()->accountEmail(),
+        DiffMatchPatchController::contentHash(_model->document()->content()));
 
     emit contentsChanged(_model);
 }
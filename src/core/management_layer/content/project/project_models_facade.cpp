@@ -43,6 +43,7 @@
 #include <data_layer/storage/document_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <domain/document_object.h>
+#include <utils/tracing.h>
 
 #include <QSet>
 
@@ -136,6 +137,8 @@ BusinessLayer::AbstractModel* ProjectModelsFacade::modelFor(Domain::DocumentObje
     bool isDocumentAlias = false;
 
     if (!d->documentsToModels.contains(_document)) {
+        TRACE_SCOPE("project", "ProjectModelsFacade::modelFor");
+
         BusinessLayer::AbstractModel* model = nullptr;
         switch (_document->type()) {
         case Domain::DocumentObjectType::Project: {
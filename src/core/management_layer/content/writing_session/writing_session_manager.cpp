@@ -1,10 +1,9 @@
 #include "writing_session_manager.h"
 
-#include "writing_session_storage.h"
-
 #include <business_layer/plots/abstract_plot.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
+#include <data_layer/storage/writing_session_storage.h>
 #include <domain/starcloud_api.h>
 #include <ui/design_system/design_system.h>
 #include <ui/session_statistics/session_statistics_navigator.h>
@@ -124,8 +123,11 @@ void WritingSessionManager::Implementation::saveCurrentSession(const QDateTime&
 
 void WritingSessionManager::Implementation::processStatistics()
 {
-    QVector<Domain::SessionStatistics> sessionStatistics = sessionStorage.sessionStatistics();
-    if (sessionStatistics.isEmpty()) {
+    //
+    // Для графика используем агрегаты по дням, а не все сессии
+    //
+    const auto rollups = sessionStorage.rollups();
+    if (rollups.isEmpty()) {
         return;
     }
 
@@ -134,74 +136,49 @@ void WritingSessionManager::Implementation::processStatistics()
     //
     // ... х - общий для всех
     QVector<uint> x;
+    QVector<QDate> days;
     // ... y
     QVector<int> summaryY;
     QHash<QString, QVector<int>> deviceY;
     QHash<QString, QString> deviceNames;
-    QPair<std::chrono::seconds, std::chrono::seconds> durationOverview
-        = { std::chrono::hours{ 24 }, {} };
-    QPair<int, int> wordsOverview = { std::numeric_limits<int>::max(), 0 };
     //
-    // ... сначала собираем полный х, список девайсов и сводку
+    // ... сначала собираем полный х и список девайсов
     //
-    uint lastX = 0;
-    const auto overviewStart = QDateTime::currentDateTime().addDays(-30);
-    for (const auto& session : std::as_const(sessionStatistics)) {
-        const auto newX = session.startDateTime.date().startOfDay().toTime_t();
-        if (newX != lastX) {
-            x.append(newX);
-            lastX = newX;
+    for (const auto& rollup : std::as_const(rollups)) {
+        if (days.isEmpty() || days.constLast() != rollup.date) {
+            days.append(rollup.date);
+            x.append(rollup.date.startOfDay().toTime_t());
         }
 
-        if (!deviceY.contains(session.deviceUuid)) {
-            deviceY.insert(session.deviceUuid, {});
+        if (!deviceY.contains(rollup.deviceUuid)) {
+            deviceY.insert(rollup.deviceUuid, {});
         }
 
-        deviceNames[session.deviceUuid] = session.deviceName;
-
-        if (overviewStart < session.startDateTime) {
-            //
-            // ... не учитываем сессии короче 3х минут
-            //
-            const auto sessionDuration
-                = std::chrono::seconds{ session.startDateTime.secsTo(session.endDateTime) };
-            if (sessionDuration > std::chrono::minutes{ 3 }) {
-                durationOverview.first = std::min(durationOverview.first, sessionDuration);
-                durationOverview.second = std::max(durationOverview.second, sessionDuration);
-            }
-
-            //
-            // ... не учитываем сессии без словк
-            //
-            if (session.words > 0) {
-                wordsOverview.first = std::min(wordsOverview.first, session.words);
-                wordsOverview.second = std::max(wordsOverview.second, session.words);
-            }
-        }
+        deviceNames[rollup.deviceUuid] = rollup.deviceName;
     }
     //
     // ... затем собираем детальную стату по девайсам
     //
-    int sessionsStatisticsIndex = 0;
+    int rollupsIndex = 0;
     QMap<qreal, QStringList> info;
-    for (const auto nextX : x) {
+    for (int dayIndex = 0; dayIndex < days.size(); ++dayIndex) {
+        const auto& day = days.at(dayIndex);
         summaryY.append(0);
         for (auto& y : deviceY) {
             y.append(0);
         }
 
-        for (; sessionsStatisticsIndex < sessionStatistics.size(); ++sessionsStatisticsIndex) {
-            const auto& session = sessionStatistics[sessionsStatisticsIndex];
-            const auto newX = session.startDateTime.date().startOfDay().toTime_t();
-            if (newX != nextX) {
+        for (; rollupsIndex < rollups.size(); ++rollupsIndex) {
+            const auto& rollup = rollups[rollupsIndex];
+            if (rollup.date != day) {
                 break;
             }
 
-            deviceY[session.deviceUuid].last() += session.words;
-            summaryY.last() += session.words;
+            deviceY[rollup.deviceUuid].last() += rollup.words;
+            summaryY.last() += rollup.words;
         }
 
-        const auto infoTitle = QDateTime::fromTime_t(nextX).toString("dd.MM.yyyy");
+        const auto infoTitle = day.toString("dd.MM.yyyy");
         QString infoText;
         for (auto iter = deviceNames.begin(); iter != deviceNames.end(); ++iter) {
             const auto words = deviceY[iter.key()].constLast();
@@ -210,7 +187,40 @@ void WritingSessionManager::Implementation::processStatistics()
             }
         }
         infoText.append(QString("%1: %2").arg(tr("Total words")).arg(summaryY.constLast()));
-        info.insert(nextX, { infoTitle, infoText });
+        info.insert(x.at(dayIndex), { infoTitle, infoText });
+    }
+
+    //
+    // Сводка за последние 30 дней - это самые короткие и длинные сессии, которые нельзя получить
+    // из суммарных агрегатов, поэтому считаем её только по сессиям этого периода
+    //
+    QPair<std::chrono::seconds, std::chrono::seconds> durationOverview
+        = { std::chrono::hours{ 24 }, {} };
+    QPair<int, int> wordsOverview = { std::numeric_limits<int>::max(), 0 };
+    const auto overviewStart = QDateTime::currentDateTime().addDays(-30);
+    const auto lastSessions = sessionStorage.sessionStatistics(overviewStart);
+    for (const auto& session : lastSessions) {
+        if (session.startDateTime <= overviewStart) {
+            continue;
+        }
+
+        //
+        // ... не учитываем сессии короче 3х минут
+        //
+        const auto sessionDuration
+            = std::chrono::seconds{ session.startDateTime.secsTo(session.endDateTime) };
+        if (sessionDuration > std::chrono::minutes{ 3 }) {
+            durationOverview.first = std::min(durationOverview.first, sessionDuration);
+            durationOverview.second = std::max(durationOverview.second, sessionDuration);
+        }
+
+        //
+        // ... не учитываем сессии без словк
+        //
+        if (session.words > 0) {
+            wordsOverview.first = std::min(wordsOverview.first, session.words);
+            wordsOverview.second = std::max(wordsOverview.second, session.words);
+        }
     }
     //
     // ... формируем графики
@@ -13,6 +13,7 @@
 #include <business_layer/model/audioplay/text/audioplay_text_model_text_item.h>
 #include <business_layer/model/characters/character_model.h>
 #include <business_layer/model/characters/characters_model.h>
+#include <business_layer/model/text/text_model_mime_data.h>
 #include <business_layer/templates/audioplay_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <domain/starcloud_api.h>
@@ -651,49 +652,12 @@ void AudioplayTextEdit::paintEvent(QPaintEvent* _event)
 
 
     //
-    // Определим начальный блок на экране
+    // Определим диапазон блоков на экране
     //
-    QTextBlock topBlock = document()->lastBlock();
-    {
-        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
-        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
-            topBlock = topCursor.block();
-        }
-    }
-    //
-    // ... идём до начала сцены
-    //
-    while (TextBlockStyle::forBlock(topBlock) != TextParagraphType::SceneHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::SequenceHeading
-           && topBlock != document()->firstBlock()) {
-        topBlock = topBlock.previous();
-    }
-
-    //
-    // Определим последний блок на экране
-    //
-    QTextBlock bottomBlock = document()->firstBlock();
-    {
-        const auto bottomCursor
-            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
-        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
-    if (bottomBlock == document()->firstBlock()) {
-        bottomBlock = document()->lastBlock();
-    }
-    bottomBlock = bottomBlock.next();
-    //
-    // ... в случае, если блок попал в таблицу, нужно дойти до конца таблицы
-    //
-    {
-        BusinessLayer::TextCursor bottomCursor(document());
-        bottomCursor.setPosition(bottomBlock.position());
-        while (bottomCursor.inTable() && bottomCursor.movePosition(QTextCursor::NextBlock)) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
+    const auto visibleBlocks = visibleBlocksRange({ TextParagraphType::SceneHeading,
+                                                    TextParagraphType::SequenceHeading });
+    const QTextBlock topBlock = visibleBlocks.first;
+    const QTextBlock bottomBlock = visibleBlocks.second;
 
     //
     // Прорисовка дополнительных элементов редактора
@@ -1257,7 +1221,7 @@ QMimeData* AudioplayTextEdit::createMimeDataFromSelection() const
         return {};
     }
 
-    QMimeData* mimeData = new QMimeData;
+    auto mimeData = new BusinessLayer::TextModelMimeData;
     BusinessLayer::TextCursor cursor = textCursor();
     const auto selection = cursor.selectionInterval();
 
@@ -1290,8 +1254,7 @@ QMimeData* AudioplayTextEdit::createMimeDataFromSelection() const
     // Поместим в буфер данные о тексте в специальном формате
     //
     {
-        mimeData->setData(d->model->mimeTypes().first(),
-                          d->document.mimeFromSelection(selection.from, selection.to).toUtf8());
+        d->document.setMimeFromSelection(mimeData, selection.from, selection.to);
     }
 
     return mimeData;
@@ -1325,6 +1288,7 @@ void AudioplayTextEdit::insertFromMimeData(const QMimeData* _source)
     // Вставляем сценарий из майм-данных
     //
     QString textToInsert;
+    const QMimeData* mimeToInsert = nullptr;
 
     //
     // Если вставляются данные в сценарном формате, то вставляем как положено
@@ -1332,7 +1296,7 @@ void AudioplayTextEdit::insertFromMimeData(const QMimeData* _source)
     const int invalidPosition = -1;
     int removeCharacterAtPosition = invalidPosition;
     if (_source->formats().contains(d->model->mimeTypes().constFirst())) {
-        textToInsert = _source->data(d->model->mimeTypes().constFirst());
+        mimeToInsert = _source;
     }
     //
     // Если простой текст
@@ -1362,7 +1326,9 @@ void AudioplayTextEdit::insertFromMimeData(const QMimeData* _source)
     //
     // Собственно вставка данных
     //
-    auto cursorPosition = d->document.insertFromMime(textCursor().position(), textToInsert);
+    auto cursorPosition = mimeToInsert != nullptr
+        ? d->document.insertFromMime(textCursor().position(), mimeToInsert)
+        : d->document.insertFromMime(textCursor().position(), textToInsert);
 
     //
     // Удалим лишний пробел, который вставляли
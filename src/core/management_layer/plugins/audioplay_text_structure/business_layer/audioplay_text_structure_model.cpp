@@ -1,51 +1,23 @@
 #include "audioplay_text_structure_model.h"
 
-#include <business_layer/model/audioplay/text/audioplay_text_model.h>
 #include <business_layer/model/text/text_model_item.h>
 
-#include <QApplication>
-
 
 namespace BusinessLayer {
 
-class AudioplayTextStructureModel::Implementation
-{
-public:
-    AudioplayTextModel* audioplayModel = nullptr;
-};
-
-
-// ****
-
-
 AudioplayTextStructureModel::AudioplayTextStructureModel(QObject* _parent)
-    : QSortFilterProxyModel(_parent)
-    , d(new Implementation)
+    : TextModelStructureProxyModel(_parent)
 {
 }
 
 AudioplayTextStructureModel::~AudioplayTextStructureModel() = default;
 
-void AudioplayTextStructureModel::setSourceModel(QAbstractItemModel* _sourceModel)
+bool AudioplayTextStructureModel::filterAcceptsItem(TextModelItem* _item) const
 {
-    d->audioplayModel = qobject_cast<AudioplayTextModel*>(_sourceModel);
-    QSortFilterProxyModel::setSourceModel(_sourceModel);
-}
-
-bool AudioplayTextStructureModel::filterAcceptsRow(int _sourceRow,
-                                                   const QModelIndex& _sourceParent) const
-{
-    if (d->audioplayModel == nullptr) {
-        return false;
-    }
-
-    const auto itemIndex = d->audioplayModel->index(_sourceRow, 0, _sourceParent);
-    const auto item = d->audioplayModel->itemForIndex(itemIndex);
-
     //
     // Показываем папки и сцены
     //
-    if (item->type() == TextModelItemType::Folder || item->type() == TextModelItemType::Group) {
+    if (_item->type() == TextModelItemType::Folder || _item->type() == TextModelItemType::Group) {
         return true;
     }
     //
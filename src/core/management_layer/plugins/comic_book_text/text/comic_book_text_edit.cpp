@@ -12,6 +12,7 @@
 #include <business_layer/model/comic_book/text/comic_book_text_block_parser.h>
 #include <business_layer/model/comic_book/text/comic_book_text_model.h>
 #include <business_layer/model/comic_book/text/comic_book_text_model_page_item.h>
+#include <business_layer/model/text/text_model_mime_data.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/templates/comic_book_template.h>
 #include <business_layer/templates/templates_facade.h>
@@ -658,50 +659,13 @@ void ComicBookTextEdit::paintEvent(QPaintEvent* _event)
 
 
     //
-    // Определим начальный блок на экране
+    // Определим диапазон блоков на экране
     //
-    QTextBlock topBlock = document()->lastBlock();
-    {
-        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
-        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
-            topBlock = topCursor.block();
-        }
-    }
-    //
-    // ... идём до начала сцены
-    //
-    while (TextBlockStyle::forBlock(topBlock) != TextParagraphType::PageHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::PanelHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::SequenceHeading
-           && topBlock != document()->firstBlock()) {
-        topBlock = topBlock.previous();
-    }
-
-    //
-    // Определим последний блок на экране
-    //
-    QTextBlock bottomBlock = document()->firstBlock();
-    {
-        const auto bottomCursor
-            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
-        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
-    if (bottomBlock == document()->firstBlock()) {
-        bottomBlock = document()->lastBlock();
-    }
-    bottomBlock = bottomBlock.next();
-    //
-    // ... в случае, если блок попал в таблицу, нужно дойти до конца таблицы
-    //
-    {
-        BusinessLayer::TextCursor bottomCursor(document());
-        bottomCursor.setPosition(bottomBlock.position());
-        while (bottomCursor.inTable() && bottomCursor.movePosition(QTextCursor::NextBlock)) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
+    const auto visibleBlocks = visibleBlocksRange({ TextParagraphType::PageHeading,
+                                                    TextParagraphType::PanelHeading,
+                                                    TextParagraphType::SequenceHeading });
+    const QTextBlock topBlock = visibleBlocks.first;
+    const QTextBlock bottomBlock = visibleBlocks.second;
 
     //
     // Прорисовка дополнительных элементов редактора
@@ -1226,7 +1190,7 @@ QMimeData* ComicBookTextEdit::createMimeDataFromSelection() const
         return {};
     }
 
-    QMimeData* mimeData = new QMimeData;
+    auto mimeData = new BusinessLayer::TextModelMimeData;
     BusinessLayer::TextCursor cursor = textCursor();
     const auto selection = cursor.selectionInterval();
 
@@ -1259,8 +1223,7 @@ QMimeData* ComicBookTextEdit::createMimeDataFromSelection() const
     // Поместим в буфер данные о тексте в специальном формате
     //
     {
-        mimeData->setData(d->model->mimeTypes().first(),
-                          d->document.mimeFromSelection(selection.from, selection.to).toUtf8());
+        d->document.setMimeFromSelection(mimeData, selection.from, selection.to);
     }
 
     return mimeData;
@@ -1294,6 +1257,7 @@ void ComicBookTextEdit::insertFromMimeData(const QMimeData* _source)
     // Вставляем сценарий из майм-данных
     //
     QString textToInsert;
+    const QMimeData* mimeToInsert = nullptr;
 
     //
     // Если вставляются данные в сценарном формате, то вставляем как положено
@@ -1301,7 +1265,7 @@ void ComicBookTextEdit::insertFromMimeData(const QMimeData* _source)
     const int invalidPosition = -1;
     int removeCharacterAtPosition = invalidPosition;
     if (_source->formats().contains(d->model->mimeTypes().constFirst())) {
-        textToInsert = _source->data(d->model->mimeTypes().constFirst());
+        mimeToInsert = _source;
     }
     //
     // Если простой текст
@@ -1335,7 +1299,9 @@ void ComicBookTextEdit::insertFromMimeData(const QMimeData* _source)
     //
     // Собственно вставка данных
     //
-    auto cursorPosition = d->document.insertFromMime(textCursor().position(), textToInsert);
+    auto cursorPosition = mimeToInsert != nullptr
+        ? d->document.insertFromMime(textCursor().position(), mimeToInsert)
+        : d->document.insertFromMime(textCursor().position(), textToInsert);
 
     //
     // Удалим лишний пробел, который вставляли
@@ -15,6 +15,7 @@
 #include <business_layer/model/novel/text/novel_text_mime_handler.h>
 #include <business_layer/model/novel/text/novel_text_model.h>
 #include <business_layer/model/novel/text/novel_text_model_text_item.h>
+#include <business_layer/model/text/text_model_mime_data.h>
 #include <business_layer/templates/novel_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <domain/starcloud_api.h>
@@ -618,50 +619,13 @@ void NovelOutlineEdit::paintEvent(QPaintEvent* _event)
 
 
     //
-    // Определим начальный блок на экране
+    // Определим диапазон блоков на экране
     //
-    QTextBlock topBlock = document()->lastBlock();
-    {
-        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
-        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
-            topBlock = topCursor.block();
-        }
-    }
-    //
-    // ... идём до начала сцены
-    //
-    while (TextBlockStyle::forBlock(topBlock) != TextParagraphType::SceneHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::PartHeading
-           && topBlock != document()->firstBlock()) {
-        topBlock = topBlock.previous();
-    }
-
-    //
-    // Определим последний блок на экране
-    //
-    QTextBlock bottomBlock = document()->firstBlock();
-    {
-        const auto bottomCursor
-            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
-        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
-    if (bottomBlock == document()->firstBlock()) {
-        bottomBlock = document()->lastBlock();
-    }
-    bottomBlock = bottomBlock.next();
-    //
-    // ... в случае, если блок попал в таблицу, нужно дойти до конца таблицы
-    //
-    {
-        BusinessLayer::TextCursor bottomCursor(document());
-        bottomCursor.setPosition(bottomBlock.position());
-        while (bottomCursor.inTable() && bottomCursor.movePosition(QTextCursor::NextBlock)) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
+    const auto visibleBlocks = visibleBlocksRange({ TextParagraphType::SceneHeading,
+                                                    TextParagraphType::ChapterHeading,
+                                                    TextParagraphType::PartHeading });
+    const QTextBlock topBlock = visibleBlocks.first;
+    const QTextBlock bottomBlock = visibleBlocks.second;
 
     //
     // Прорисовка дополнительных элементов редактора
@@ -1140,7 +1104,7 @@ QMimeData* NovelOutlineEdit::createMimeDataFromSelection() const
         return {};
     }
 
-    QMimeData* mimeData = new QMimeData;
+    auto mimeData = new BusinessLayer::TextModelMimeData;
     BusinessLayer::TextCursor cursor = textCursor();
     auto selection = cursor.selectionInterval();
     //
@@ -1205,8 +1169,7 @@ QMimeData* NovelOutlineEdit::createMimeDataFromSelection() const
         // При работе со внутренним форматом, копируем все блоки, включая текст сценария,
         // т.к. пользователь может захотеть перенести блоки вырезав и вставив их в другое место
         //
-        const auto mime = d->document.mimeFromSelection(selection.from, selection.to);
-        mimeData->setData(d->model->mimeTypes().first(), mime.toUtf8());
+        d->document.setMimeFromSelection(mimeData, selection.from, selection.to);
     }
 
     return mimeData;
@@ -1279,12 +1242,13 @@ void NovelOutlineEdit::insertFromMimeData(const QMimeData* _source)
     // Вставляем сценарий из майм-данных
     //
     QString textToInsert;
+    const QMimeData* mimeToInsert = nullptr;
 
     //
     // Если вставляются данные в сценарном формате, то вставляем как положено
     //
     if (_source->formats().contains(d->model->mimeTypes().constFirst())) {
-        textToInsert = _source->data(d->model->mimeTypes().constFirst());
+        mimeToInsert = _source;
     }
     //
     // Если простой текст
@@ -1307,7 +1271,9 @@ void NovelOutlineEdit::insertFromMimeData(const QMimeData* _source)
     //
     // Собственно вставка данных
     //
-    auto cursorPosition = d->document.insertFromMime(cursor.position(), textToInsert);
+    auto cursorPosition = mimeToInsert != nullptr
+        ? d->document.insertFromMime(cursor.position(), mimeToInsert)
+        : d->document.insertFromMime(cursor.position(), textToInsert);
 
     //
     // Удалим лишний пробел, который вставляли
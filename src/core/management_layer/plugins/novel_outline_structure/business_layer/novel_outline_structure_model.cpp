@@ -1,11 +1,6 @@
 #include "novel_outline_structure_model.h"
 
-#include <business_layer/model/novel/text/novel_text_model.h>
-#include <business_layer/model/novel/text/novel_text_model_text_item.h>
 #include <business_layer/model/text/text_model_group_item.h>
-#include <business_layer/templates/novel_template.h>
-
-#include <QApplication>
 
 
 namespace BusinessLayer {
@@ -13,7 +8,6 @@ namespace BusinessLayer {
 class NovelOutlineStructureModel::Implementation
 {
 public:
-    NovelTextModel* novelModel = nullptr;
     bool showBeats = true;
 };
 
@@ -22,7 +16,7 @@ public:
 
 
 NovelOutlineStructureModel::NovelOutlineStructureModel(QObject* _parent)
-    : QSortFilterProxyModel(_parent)
+    : TextModelStructureProxyModel(_parent)
     , d(new Implementation)
 {
 }
@@ -36,36 +30,22 @@ void NovelOutlineStructureModel::showBeats(bool _show)
     }
 
     d->showBeats = _show;
-    invalidate();
-}
-
-void NovelOutlineStructureModel::setSourceModel(QAbstractItemModel* _sourceModel)
-{
-    d->novelModel = qobject_cast<NovelTextModel*>(_sourceModel);
-    QSortFilterProxyModel::setSourceModel(_sourceModel);
+    invalidateFilter();
 }
 
-bool NovelOutlineStructureModel::filterAcceptsRow(int _sourceRow,
-                                                  const QModelIndex& _sourceParent) const
+bool NovelOutlineStructureModel::filterAcceptsItem(TextModelItem* _item) const
 {
-    if (d->novelModel == nullptr) {
-        return false;
-    }
-
-    const auto itemIndex = d->novelModel->index(_sourceRow, 0, _sourceParent);
-    const auto item = d->novelModel->itemForIndex(itemIndex);
-
     //
     // Показываем папки
     //
-    if (item->type() == TextModelItemType::Folder) {
+    if (_item->type() == TextModelItemType::Folder) {
         return true;
     }
     //
     // Показываем сцены и биты (если разрешены)
     //
-    else if (item->type() == TextModelItemType::Group) {
-        auto groupItem = static_cast<TextModelGroupItem*>(item);
+    else if (_item->type() == TextModelItemType::Group) {
+        auto groupItem = static_cast<TextModelGroupItem*>(_item);
         if (groupItem->groupType() == TextGroupType::Beat) {
             return d->showBeats;
         } else {
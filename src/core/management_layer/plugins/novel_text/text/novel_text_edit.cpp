@@ -17,6 +17,7 @@
 #include <business_layer/model/novel/text/novel_text_model.h>
 #include <business_layer/model/novel/text/novel_text_model_text_item.h>
 #include <business_layer/model/text/text_model_group_item.h>
+#include <business_layer/model/text/text_model_mime_data.h>
 #include <business_layer/templates/novel_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <domain/starcloud_api.h>
@@ -712,50 +713,13 @@ void NovelTextEdit::paintEvent(QPaintEvent* _event)
 
 
     //
-    // Определим начальный блок на экране
+    // Определим диапазон блоков на экране
     //
-    QTextBlock topBlock = document()->lastBlock();
-    {
-        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
-        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
-            topBlock = topCursor.block();
-        }
-    }
-    //
-    // ... идём до начала сцены
-    //
-    while (TextBlockStyle::forBlock(topBlock) != TextParagraphType::SceneHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::PartHeading
-           && topBlock != document()->firstBlock()) {
-        topBlock = topBlock.previous();
-    }
-
-    //
-    // Определим последний блок на экране
-    //
-    QTextBlock bottomBlock = document()->firstBlock();
-    {
-        const auto bottomCursor
-            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
-        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
-    if (bottomBlock == document()->firstBlock()) {
-        bottomBlock = document()->lastBlock();
-    }
-    bottomBlock = bottomBlock.next();
-    //
-    // ... в случае, если блок попал в таблицу, нужно дойти до конца таблицы
-    //
-    {
-        BusinessLayer::TextCursor bottomCursor(document());
-        bottomCursor.setPosition(bottomBlock.position());
-        while (bottomCursor.inTable() && bottomCursor.movePosition(QTextCursor::NextBlock)) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
+    const auto visibleBlocks = visibleBlocksRange({ TextParagraphType::SceneHeading,
+                                                    TextParagraphType::ChapterHeading,
+                                                    TextParagraphType::PartHeading });
+    const QTextBlock topBlock = visibleBlocks.first;
+    const QTextBlock bottomBlock = visibleBlocks.second;
 
     //
     // Прорисовка дополнительных элементов редактора
@@ -1493,7 +1457,7 @@ QMimeData* NovelTextEdit::createMimeDataFromSelection() const
         return {};
     }
 
-    QMimeData* mimeData = new QMimeData;
+    auto mimeData = new BusinessLayer::TextModelMimeData;
     BusinessLayer::TextCursor cursor = textCursor();
     const auto selection = cursor.selectionInterval();
 
@@ -1542,8 +1506,7 @@ QMimeData* NovelTextEdit::createMimeDataFromSelection() const
         // При работе со внутренним форматом, копируем все блоки, включая текст сценария,
         // т.к. пользователь может захотеть перенести блоки вырезав и вставив их в другое место
         //
-        const auto mime = d->document.mimeFromSelection(selection.from, selection.to);
-        mimeData->setData(d->model->mimeTypes().constFirst(), mime.toUtf8());
+        d->document.setMimeFromSelection(mimeData, selection.from, selection.to);
     }
 
     return mimeData;
@@ -1577,6 +1540,7 @@ void NovelTextEdit::insertFromMimeData(const QMimeData* _source)
     // Вставляем сценарий из майм-данных
     //
     QString textToInsert;
+    const QMimeData* mimeToInsert = nullptr;
 
     //
     // Если вставляются данные в сценарном формате, то вставляем как положено
@@ -1584,7 +1548,7 @@ void NovelTextEdit::insertFromMimeData(const QMimeData* _source)
     const int invalidPosition = -1;
     int removeCharacterAtPosition = invalidPosition;
     if (_source->formats().contains(d->model->mimeTypes().constFirst())) {
-        textToInsert = _source->data(d->model->mimeTypes().constFirst());
+        mimeToInsert = _source;
 
         //
         // Акта и папки не меняем ни на что
@@ -1628,7 +1592,9 @@ void NovelTextEdit::insertFromMimeData(const QMimeData* _source)
     //
     // Собственно вставка данных
     //
-    auto cursorPosition = d->document.insertFromMime(textCursor().position(), textToInsert);
+    auto cursorPosition = mimeToInsert != nullptr
+        ? d->document.insertFromMime(textCursor().position(), mimeToInsert)
+        : d->document.insertFromMime(textCursor().position(), textToInsert);
 
     //
     // Удалим лишний пробел, который вставляли
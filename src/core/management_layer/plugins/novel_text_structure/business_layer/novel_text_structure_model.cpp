@@ -1,11 +1,7 @@
 #include "novel_text_structure_model.h"
 
-#include <business_layer/model/novel/text/novel_text_model.h>
 #include <business_layer/model/novel/text/novel_text_model_text_item.h>
 #include <business_layer/model/text/text_model_group_item.h>
-#include <business_layer/templates/novel_template.h>
-
-#include <QApplication>
 
 
 namespace BusinessLayer {
@@ -13,7 +9,6 @@ namespace BusinessLayer {
 class NovelTextStructureModel::Implementation
 {
 public:
-    NovelTextModel* novelModel = nullptr;
     bool showBeats = true;
 };
 
@@ -22,7 +17,7 @@ public:
 
 
 NovelTextStructureModel::NovelTextStructureModel(QObject* _parent)
-    : QSortFilterProxyModel(_parent)
+    : TextModelStructureProxyModel(_parent)
     , d(new Implementation)
 {
 }
@@ -36,36 +31,22 @@ void NovelTextStructureModel::showBeats(bool _show)
     }
 
     d->showBeats = _show;
-    invalidate();
-}
-
-void NovelTextStructureModel::setSourceModel(QAbstractItemModel* _sourceModel)
-{
-    d->novelModel = qobject_cast<NovelTextModel*>(_sourceModel);
-    QSortFilterProxyModel::setSourceModel(_sourceModel);
+    invalidateFilter();
 }
 
-bool NovelTextStructureModel::filterAcceptsRow(int _sourceRow,
-                                               const QModelIndex& _sourceParent) const
+bool NovelTextStructureModel::filterAcceptsItem(TextModelItem* _item) const
 {
-    if (d->novelModel == nullptr) {
-        return false;
-    }
-
-    const auto itemIndex = d->novelModel->index(_sourceRow, 0, _sourceParent);
-    const auto item = d->novelModel->itemForIndex(itemIndex);
-
     //
     // Показываем папки
     //
-    if (item->type() == TextModelItemType::Folder) {
+    if (_item->type() == TextModelItemType::Folder) {
         return true;
     }
     //
     // Показываем сцены и биты (если разрешены)
     //
-    else if (item->type() == TextModelItemType::Group) {
-        auto groupItem = static_cast<TextModelGroupItem*>(item);
+    else if (_item->type() == TextModelItemType::Group) {
+        auto groupItem = static_cast<TextModelGroupItem*>(_item);
         if (groupItem->groupType() == TextGroupType::Beat) {
             return d->showBeats;
         } else {
@@ -75,8 +56,8 @@ bool NovelTextStructureModel::filterAcceptsRow(int _sourceRow,
     //
     // Из текста показываем только кадры, которые не являются корректировочными блоками
     //
-    else if (item->type() == TextModelItemType::Text) {
-        const auto textItem = static_cast<NovelTextModelTextItem*>(item);
+    else if (_item->type() == TextModelItemType::Text) {
+        const auto textItem = static_cast<NovelTextModelTextItem*>(_item);
         return !textItem->isCorrection() && textItem->paragraphType() == TextParagraphType::Shot;
     }
     //
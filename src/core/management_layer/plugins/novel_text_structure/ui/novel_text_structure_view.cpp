@@ -19,8 +19,8 @@
 #include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <ui/widgets/tree/tree.h>
 
+#include <QAbstractProxyModel>
 #include <QAction>
-#include <QSortFilterProxyModel>
 #include <QStringListModel>
 #include <QVBoxLayout>
 
@@ -38,7 +38,7 @@ public:
     void updateCounters();
 
 
-    QSortFilterProxyModel* model = nullptr;
+    QAbstractProxyModel* model = nullptr;
 
     IconsMidLabel* backIcon = nullptr;
     Subtitle2Label* backText = nullptr;
@@ -205,7 +205,7 @@ void NovelTextStructureView::setModel(QAbstractItemModel* _model)
 
     d->content->setModel(_model);
 
-    d->model = qobject_cast<QSortFilterProxyModel*>(_model);
+    d->model = qobject_cast<QAbstractProxyModel*>(_model);
     if (d->model != nullptr) {
         connect(d->model, &BusinessLayer::NovelTextModel::modelReset, this,
                 [this] { d->updateCounters(); });
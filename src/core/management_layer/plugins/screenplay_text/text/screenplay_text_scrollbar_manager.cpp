@@ -1,6 +1,7 @@
 #include "screenplay_text_scrollbar_manager.h"
 
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
+#include <business_layer/model/screenplay/text/screenplay_text_timeline_index.h>
 #include <ui/design_system/design_system.h>
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/time_helper.h>
@@ -13,6 +14,8 @@
 #include <QTimer>
 #include <QVariantAnimation>
 
+#include <algorithm>
+
 
 namespace Ui {
 
@@ -46,14 +49,16 @@ public:
     QTimer timelineHideTimer;
     QVariantAnimation timelineOpacityAnimation;
 
-    Debouncer itemsColorsUpdateDebouncer;
+    BusinessLayer::ScreenplayTextTimelineIndex timelineIndex;
+    Debouncer timelineIndexUpdateDebouncer;
 };
 
 ScreenplayTextScrollBarManager::Implementation::Implementation(QWidget* _parent)
     : scrollbar(new QScrollBar(_parent))
     , timeline(new ScreenplayTextTimeline(_parent))
-    , itemsColorsUpdateDebouncer(180)
+    , timelineIndexUpdateDebouncer(180)
 {
+    timeline->setIndex(&timelineIndex);
     timelineHideTimer.setSingleShot(true);
     timelineHideTimer.setInterval(2000);
     timelineOpacityAnimation.setEasingCurve(QEasingCurve::OutQuad);
@@ -129,16 +134,29 @@ ScreenplayTextScrollBarManager::ScreenplayTextScrollBarManager(QAbstractScrollAr
     });
     connect(&d->timelineOpacityAnimation, &QVariantAnimation::valueChanged, this,
             [this](const QVariant& _value) { d->timeline->setOpacity(_value.toReal()); });
-    connect(&d->itemsColorsUpdateDebouncer, &Debouncer::gotWork, this, [this] {
+    connect(&d->timelineIndex, &BusinessLayer::ScreenplayTextTimelineIndex::updateRequested,
+            &d->timelineIndexUpdateDebouncer, &Debouncer::orderWork);
+    connect(&d->timelineIndexUpdateDebouncer, &Debouncer::gotWork, this, [this] {
         if (d->model == nullptr) {
             return;
         }
 
-        d->timeline->setMaximum(d->model->duration());
-        d->timeline->setColors(d->model->itemsColors());
-        d->timeline->setBookmarks(d->model->itemsBookmarks());
-        d->updateTimelineDisplayRange();
+        d->timelineIndex.update();
     });
+    connect(&d->timelineIndex, &BusinessLayer::ScreenplayTextTimelineIndex::segmentsChanged, this,
+            [this](std::chrono::milliseconds _from, std::chrono::milliseconds _to) {
+                if (d->model == nullptr) {
+                    return;
+                }
+
+                //
+                // Если длительность сценария изменилась, то таймлайн будет перерисован целиком,
+                // а иначе перерисовываем лишь изменившийся участок
+                //
+                d->timeline->setMaximum(d->model->duration());
+                d->timeline->updateRange(_from, _to);
+                d->updateTimelineDisplayRange();
+            });
 }
 
 ScreenplayTextScrollBarManager::~ScreenplayTextScrollBarManager() = default;
@@ -180,21 +198,9 @@ void ScreenplayTextScrollBarManager::setModel(BusinessLayer::ScreenplayTextModel
         return;
     }
 
-    if (d->model) {
-        d->model->disconnect(&d->itemsColorsUpdateDebouncer);
-    }
-
     d->model = _model;
-
-    if (d->model) {
-        connect(d->model, &QAbstractItemModel::rowsInserted, &d->itemsColorsUpdateDebouncer,
-                &Debouncer::orderWork);
-        connect(d->model, &QAbstractItemModel::rowsRemoved, &d->itemsColorsUpdateDebouncer,
-                &Debouncer::orderWork);
-        connect(d->model, &QAbstractItemModel::dataChanged, &d->itemsColorsUpdateDebouncer,
-                &Debouncer::orderWork);
-        d->itemsColorsUpdateDebouncer.orderWork();
-    } else {
+    d->timelineIndex.setModel(d->model);
+    if (d->model == nullptr) {
         d->timeline->update();
     }
 }
@@ -252,8 +258,7 @@ public:
     std::chrono::milliseconds maximum = std::chrono::seconds{ 10 };
     std::chrono::milliseconds current = std::chrono::seconds{ 0 };
     std::chrono::milliseconds displayRange = std::chrono::seconds{ 5 };
-    std::map<std::chrono::milliseconds, QColor> colors;
-    std::map<std::chrono::milliseconds, QColor> bookmarks;
+    const BusinessLayer::ScreenplayTextTimelineIndex* index = nullptr;
 };
 
 
@@ -314,25 +319,33 @@ void ScreenplayTextTimeline::setDisplayRange(std::chrono::milliseconds _value)
     update();
 }
 
-void ScreenplayTextTimeline::setColors(const std::map<std::chrono::milliseconds, QColor>& _colors)
+void ScreenplayTextTimeline::setIndex(const BusinessLayer::ScreenplayTextTimelineIndex* _index)
 {
-    if (d->colors == _colors) {
+    if (d->index == _index) {
         return;
     }
 
-    d->colors = _colors;
+    d->index = _index;
     update();
 }
 
-void ScreenplayTextTimeline::setBookmarks(
-    const std::map<std::chrono::milliseconds, QColor>& _bookmarks)
+void ScreenplayTextTimeline::updateRange(std::chrono::milliseconds _from,
+                                         std::chrono::milliseconds _to)
 {
-    if (d->bookmarks == _bookmarks) {
+    if (d->maximum.count() == 0) {
+        update();
         return;
     }
 
-    d->bookmarks = _bookmarks;
-    update();
+    //
+    // Захватываем с запасом, чтобы перерисовать и наконечники закладок
+    //
+    const auto lineSpacing = QFontMetricsF(Ui::DesignSystem::font().caption()).lineSpacing();
+    const qreal top = (height() - lineSpacing) * _from / d->maximum + lineSpacing / 2
+        - Ui::DesignSystem::layout().px8();
+    const qreal bottom = (height() - lineSpacing) * _to / d->maximum + lineSpacing / 2
+        + Ui::DesignSystem::layout().px8();
+    update(QRectF(0, top, width(), bottom - top).toAlignedRect());
 }
 
 QSize ScreenplayTextTimeline::sizeHint() const
@@ -370,77 +383,90 @@ void ScreenplayTextTimeline::paintEvent(QPaintEvent* _event)
     const auto scrollbarColor = ColorHelper::nearby(Ui::DesignSystem::color().surface());
     painter.fillRect(scrollbarRect, scrollbarColor);
     //
-    // Рисуем дополнительные цвета скролбара
+    // Определяем отрезки таймлайна, попадающие в перерисовываемую область
     //
-    if (d->colors.size() > 0) {
-        painter.setOpacity(opacity() * DesignSystem::inactiveTextOpacity());
-
-        auto startDuration = d->colors.begin()->first;
-        auto endDuration = startDuration;
-        QColor color = d->colors.begin()->second;
-        auto paintColor = [this, &painter, scrollbarRect, &startDuration, &endDuration, &color] {
-            if (!color.isValid() || d->maximum.count() == 0) {
-                return;
-            }
-
-            const QRectF colorRect(
-                QPointF(scrollbarRect.left(),
-                        (height() - painter.fontMetrics().lineSpacing()) * startDuration
-                                / d->maximum
-                            + painter.fontMetrics().lineSpacing() / 2),
-                QPointF(scrollbarRect.right(),
-                        (height() - painter.fontMetrics().lineSpacing()) * endDuration / d->maximum
-                            + painter.fontMetrics().lineSpacing() / 2));
-            painter.fillRect(colorRect, color);
+    const auto lineSpacing = painter.fontMetrics().lineSpacing();
+    auto timeToY = [this, lineSpacing](std::chrono::milliseconds _time) {
+        return (height() - lineSpacing) * _time / d->maximum + lineSpacing / 2;
+    };
+    int firstSegment = 0;
+    int lastSegment = -1;
+    if (d->index != nullptr && d->maximum.count() > 0) {
+        const auto yToTime = [this, lineSpacing](qreal _y) {
+            const auto ratio = std::clamp((_y - lineSpacing / 2) / (height() - lineSpacing), 0.0,
+                                          1.0);
+            return std::chrono::duration_cast<std::chrono::milliseconds>(d->maximum * ratio);
         };
-        for (auto iter = std::next(d->colors.begin()); iter != d->colors.end(); ++iter) {
-            endDuration = iter->first;
-            paintColor();
+        const auto margin = Ui::DesignSystem::layout().px8();
+        firstSegment = d->index->segmentAt(yToTime(_event->rect().top() - margin));
+        lastSegment = std::min(d->index->segmentAt(yToTime(_event->rect().bottom() + margin)),
+                               static_cast<int>(d->index->segments().size()) - 1);
+    }
 
-            startDuration = endDuration;
-            color = iter->second;
+    //
+    // Рисуем дополнительные цвета скролбара
+    //
+    painter.setOpacity(opacity() * DesignSystem::inactiveTextOpacity());
+    for (int index = firstSegment; index <= lastSegment; ++index) {
+        const auto& segment = d->index->segments().at(index);
+        if (!segment.color.isValid()) {
+            continue;
         }
 
-        endDuration = d->maximum;
-        paintColor();
+        const QRectF colorRect(QPointF(scrollbarRect.left(), timeToY(segment.start)),
+                               QPointF(scrollbarRect.right(), timeToY(segment.end())));
+        painter.fillRect(colorRect, segment.color);
+    }
+    painter.setOpacity(opacity());
 
-        painter.setOpacity(opacity());
+    //
+    // Рисуем редакторские заметки
+    //
+    for (int index = firstSegment; index <= lastSegment; ++index) {
+        const auto& segment = d->index->segments().at(index);
+        for (const auto& comment : segment.comments) {
+            const auto y = timeToY(segment.start + comment.offset);
+            painter.fillRect(QRectF(scrollbarRect.left(), y - Ui::DesignSystem::layout().px(),
+                                    scrollbarRect.width(), Ui::DesignSystem::layout().px2()),
+                             comment.color);
+        }
     }
 
     //
     // Рисуем закладки
     //
-    for (auto iter = d->bookmarks.begin(); iter != d->bookmarks.end(); ++iter) {
-        const auto color = iter->second;
-        painter.setPen(QPen(color, Ui::DesignSystem::layout().px2(), Qt::SolidLine, Qt::RoundCap,
-                            Qt::RoundJoin));
-        painter.setBrush(color);
-
-        //
-        // Рисуем линию
-        //
-        const auto duration = iter->first;
-        QPointF left(isLeftToRight() ? 0 : scrollbarRect.left(),
-                     (height() - painter.fontMetrics().lineSpacing()) * duration / d->maximum
-                         + painter.fontMetrics().lineSpacing() / 2);
-        const QPointF right(isLeftToRight() ? scrollbarRect.right() : width(), left.y());
-        const QLineF colorRect(left, right);
-
-        painter.drawLine(colorRect);
-        //
-        // и наконечник
-        //
-        QPolygonF treangle;
-        if (isLeftToRight()) {
-            treangle << QPointF(left.x(), left.y() - Ui::DesignSystem::layout().px4())
-                     << QPointF(left.x() + Ui::DesignSystem::layout().px8(), left.y())
-                     << QPointF(left.x(), left.y() + Ui::DesignSystem::layout().px4());
-        } else {
-            treangle << QPointF(right.x(), right.y() - Ui::DesignSystem::layout().px4())
-                     << QPointF(right.x() - Ui::DesignSystem::layout().px8(), right.y())
-                     << QPointF(right.x(), right.y() + Ui::DesignSystem::layout().px4());
+    for (int index = firstSegment; index <= lastSegment; ++index) {
+        const auto& segment = d->index->segments().at(index);
+        for (const auto& bookmark : segment.bookmarks) {
+            const auto color = bookmark.color;
+            painter.setPen(QPen(color, Ui::DesignSystem::layout().px2(), Qt::SolidLine,
+                                Qt::RoundCap, Qt::RoundJoin));
+            painter.setBrush(color);
+
+            //
+            // Рисуем линию
+            //
+            QPointF left(isLeftToRight() ? 0 : scrollbarRect.left(),
+                         timeToY(segment.start + bookmark.offset));
+            const QPointF right(isLeftToRight() ? scrollbarRect.right() : width(), left.y());
+            const QLineF colorRect(left, right);
+
+            painter.drawLine(colorRect);
+            //
+            // и наконечник
+            //
+            QPolygonF treangle;
+            if (isLeftToRight()) {
+                treangle << QPointF(left.x(), left.y() - Ui::DesignSystem::layout().px4())
+                         << QPointF(left.x() + Ui::DesignSystem::layout().px8(), left.y())
+                         << QPointF(left.x(), left.y() + Ui::DesignSystem::layout().px4());
+            } else {
+                treangle << QPointF(right.x(), right.y() - Ui::DesignSystem::layout().px4())
+                         << QPointF(right.x() - Ui::DesignSystem::layout().px8(), right.y())
+                         << QPointF(right.x(), right.y() + Ui::DesignSystem::layout().px4());
+            }
+            painter.drawPolygon(treangle);
         }
-        painter.drawPolygon(treangle);
     }
     painter.setBrush(Qt::NoBrush);
 
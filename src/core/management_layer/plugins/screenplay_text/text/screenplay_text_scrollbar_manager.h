@@ -8,6 +8,7 @@
 
 namespace BusinessLayer {
 class ScreenplayTextModel;
+class ScreenplayTextTimelineIndex;
 }
 
 namespace Ui {
@@ -86,14 +87,14 @@ public:
     void setDisplayRange(std::chrono::milliseconds _value);
 
     /**
-     * @brief Задать цвета слайдера
+     * @brief Задать индекс, из которого берутся цвета сцен, закладки и редакторские заметки
      */
-    void setColors(const std::map<std::chrono::milliseconds, QColor>& _colors);
+    void setIndex(const BusinessLayer::ScreenplayTextTimelineIndex* _index);
 
     /**
-     * @brief Задать цвета закладок
+     * @brief Перерисовать участок таймлайна, соответствующий заданному промежутку времени
      */
-    void setBookmarks(const std::map<std::chrono::milliseconds, QColor>& _bookmarks);
+    void updateRange(std::chrono::milliseconds _from, std::chrono::milliseconds _to);
 
     /**
      * @brief Переопределяем для корректного подсчёта размера в компоновщиках
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QSortFilterProxyModel>
+#include <business_layer/model/text/text_model_structure_proxy_model.h>
 
 
 namespace BusinessLayer {
@@ -8,7 +8,7 @@ namespace BusinessLayer {
 /**
  * @brief Прокси модель для отображения структуры сценария в навигаторе
  */
-class ScreenplayTextStructureModel : public QSortFilterProxyModel
+class ScreenplayTextStructureModel : public TextModelStructureProxyModel
 {
     Q_OBJECT
 
@@ -21,15 +21,11 @@ public:
      */
     void showBeats(bool _show);
 
-    /**
-     * @brief Переопределяем, чтобы отлавливать модель сценария и сохранять её для дальнейшей работы
-     */
-    void setSourceModel(QAbstractItemModel* _sourceModel) override;
-
+protected:
     /**
      * @brief Определяем собственную фильтрацию, которая будет пропускать текстовые элементы модели
      */
-    bool filterAcceptsRow(int _sourceRow, const QModelIndex& _sourceParent) const override;
+    bool filterAcceptsItem(TextModelItem* _item) const override;
 
 private:
     class Implementation;
@@ -1,11 +1,6 @@
 #include "screenplay_treatment_structure_model.h"
 
-#include <business_layer/model/screenplay/text/screenplay_text_model.h>
-#include <business_layer/model/screenplay/text/screenplay_text_model_text_item.h>
 #include <business_layer/model/text/text_model_group_item.h>
-#include <business_layer/templates/screenplay_template.h>
-
-#include <QApplication>
 
 
 namespace BusinessLayer {
@@ -13,7 +8,6 @@ namespace BusinessLayer {
 class ScreenplayTreatmentStructureModel::Implementation
 {
 public:
-    ScreenplayTextModel* screenplayModel = nullptr;
     bool showBeats = true;
 };
 
@@ -22,7 +16,7 @@ public:
 
 
 ScreenplayTreatmentStructureModel::ScreenplayTreatmentStructureModel(QObject* _parent)
-    : QSortFilterProxyModel(_parent)
+    : TextModelStructureProxyModel(_parent)
     , d(new Implementation)
 {
 }
@@ -36,36 +30,22 @@ void ScreenplayTreatmentStructureModel::showBeats(bool _show)
     }
 
     d->showBeats = _show;
-    invalidate();
-}
-
-void ScreenplayTreatmentStructureModel::setSourceModel(QAbstractItemModel* _sourceModel)
-{
-    d->screenplayModel = qobject_cast<ScreenplayTextModel*>(_sourceModel);
-    QSortFilterProxyModel::setSourceModel(_sourceModel);
+    invalidateFilter();
 }
 
-bool ScreenplayTreatmentStructureModel::filterAcceptsRow(int _sourceRow,
-                                                         const QModelIndex& _sourceParent) const
+bool ScreenplayTreatmentStructureModel::filterAcceptsItem(TextModelItem* _item) const
 {
-    if (d->screenplayModel == nullptr) {
-        return false;
-    }
-
-    const auto itemIndex = d->screenplayModel->index(_sourceRow, 0, _sourceParent);
-    const auto item = d->screenplayModel->itemForIndex(itemIndex);
-
     //
     // Показываем папки
     //
-    if (item->type() == TextModelItemType::Folder) {
+    if (_item->type() == TextModelItemType::Folder) {
         return true;
     }
     //
     // Показываем сцены и биты (если разрешены)
     //
-    else if (item->type() == TextModelItemType::Group) {
-        auto groupItem = static_cast<TextModelGroupItem*>(item);
+    else if (_item->type() == TextModelItemType::Group) {
+        auto groupItem = static_cast<TextModelGroupItem*>(_item);
         if (groupItem->groupType() == TextGroupType::Beat) {
             return d->showBeats;
         } else {
@@ -7,6 +7,7 @@
 #include <business_layer/document/text/text_cursor.h>
 #include <business_layer/import/text/simple_text_markdown_importer.h>
 #include <business_layer/model/simple_text/simple_text_model.h>
+#include <business_layer/model/text/text_model_mime_data.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/templates/simple_text_template.h>
 #include <business_layer/templates/templates_facade.h>
@@ -397,43 +398,16 @@ void SimpleTextEdit::paintEvent(QPaintEvent* _event)
 
 
     //
-    // Определим начальный блок на экране
+    // Определим диапазон блоков на экране
     //
-    QTextBlock topBlock = document()->lastBlock();
-    {
-        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
-        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
-            topBlock = topCursor.block();
-        }
-    }
-    //
-    // ... идём до начала сцены
-    //
-    while (TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading1
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading2
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading3
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading4
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading5
-           && TextBlockStyle::forBlock(topBlock) != TextParagraphType::ChapterHeading6
-           && topBlock != document()->firstBlock()) {
-        topBlock = topBlock.previous();
-    }
-
-    //
-    // Определим последний блок на экране
-    //
-    QTextBlock bottomBlock = document()->firstBlock();
-    {
-        const auto bottomCursor
-            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
-        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
-            bottomBlock = bottomCursor.block();
-        }
-    }
-    if (bottomBlock == document()->firstBlock()) {
-        bottomBlock = document()->lastBlock();
-    }
-    bottomBlock = bottomBlock.next();
+    const auto visibleBlocks = visibleBlocksRange({ TextParagraphType::ChapterHeading1,
+                                                    TextParagraphType::ChapterHeading2,
+                                                    TextParagraphType::ChapterHeading3,
+                                                    TextParagraphType::ChapterHeading4,
+                                                    TextParagraphType::ChapterHeading5,
+                                                    TextParagraphType::ChapterHeading6 });
+    const QTextBlock topBlock = visibleBlocks.first;
+    const QTextBlock bottomBlock = visibleBlocks.second;
 
     //
     // Прорисовка дополнительных элементов редактора
@@ -721,7 +695,7 @@ QMimeData* SimpleTextEdit::createMimeDataFromSelection() const
         return {};
     }
 
-    QMimeData* mimeData = new QMimeData;
+    auto mimeData = new BusinessLayer::TextModelMimeData;
     TextCursor cursor = textCursor();
     const auto selection = cursor.selectionInterval();
 
@@ -755,8 +729,7 @@ QMimeData* SimpleTextEdit::createMimeDataFromSelection() const
     // Поместим в буфер данные о тексте в специальном формате
     //
     {
-        mimeData->setData(d->model->mimeTypes().first(),
-                          d->document.mimeFromSelection(selection.from, selection.to).toUtf8());
+        d->document.setMimeFromSelection(mimeData, selection.from, selection.to);
     }
 
     return mimeData;
@@ -790,6 +763,7 @@ void SimpleTextEdit::insertFromMimeData(const QMimeData* _source)
     // Вставляем сценарий из майм-данных
     //
     QString textToInsert;
+    const QMimeData* mimeToInsert = nullptr;
 
     //
     // Если вставляются данные в сценарном формате, то вставляем как положено
@@ -797,7 +771,7 @@ void SimpleTextEdit::insertFromMimeData(const QMimeData* _source)
     const int invalidPosition = -1;
     int removeCharacterAtPosition = invalidPosition;
     if (_source->formats().contains(d->model->mimeTypes().constFirst())) {
-        textToInsert = _source->data(d->model->mimeTypes().constFirst());
+        mimeToInsert = _source;
     }
     //
     // Если простой текст
@@ -827,7 +801,9 @@ void SimpleTextEdit::insertFromMimeData(const QMimeData* _source)
     //
     // Собственно вставка данных
     //
-    auto cursorPosition = d->document.insertFromMime(textCursor().position(), textToInsert);
+    auto cursorPosition = mimeToInsert != nullptr
+        ? d->document.insertFromMime(textCursor().position(), mimeToInsert)
+        : d->document.insertFromMime(textCursor().position(), textToInsert);
 
     //
     // Удалим лишний пробел, который вставляли
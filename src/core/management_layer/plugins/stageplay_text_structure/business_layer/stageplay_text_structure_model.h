@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QSortFilterProxyModel>
+#include <business_layer/model/text/text_model_structure_proxy_model.h>
 
 
 namespace BusinessLayer {
@@ -8,7 +8,7 @@ namespace BusinessLayer {
 /**
  * @brief Прокси модель для отображения структуры аудиопостановки в навигаторе
  */
-class StageplayTextStructureModel : public QSortFilterProxyModel
+class StageplayTextStructureModel : public TextModelStructureProxyModel
 {
     Q_OBJECT
 
@@ -16,19 +16,11 @@ public:
     explicit StageplayTextStructureModel(QObject* _parent = nullptr);
     ~StageplayTextStructureModel() override;
 
-    /**
-     * @brief Переопределяем, чтобы отлавливать модель сценария и сохранять её для дальнейшей работы
-     */
-    void setSourceModel(QAbstractItemModel* _sourceModel) override;
-
+protected:
     /**
      * @brief Определяем собственную фильтрацию, которая будет пропускать текстовые элементы модели
      */
-    bool filterAcceptsRow(int _sourceRow, const QModelIndex& _sourceParent) const override;
-
-private:
-    class Implementation;
-    QScopedPointer<Implementation> d;
+    bool filterAcceptsItem(TextModelItem* _item) const override;
 };
 
 } // namespace BusinessLayer
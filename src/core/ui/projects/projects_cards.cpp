@@ -195,10 +195,14 @@ void ProjectCard::paint(QPainter* _painter, const QStyleOptionGraphicsItem* _opt
     const qreal shadowHeight
         = std::max(Ui::DesignSystem::floatingToolBar().minimumShadowBlurRadius(),
                    m_shadowHeightAnimation.currentValue().toReal());
-    const QPixmap shadow = ImageHelper::dropShadow(
-        backgroundPixmapCache, Ui::DesignSystem::floatingToolBar().shadowMargins(), shadowHeight,
+    //
+    // ... тень отсчитывается от левого верхнего угла карточки
+    //
+    const auto shadowMargins = Ui::DesignSystem::floatingToolBar().shadowMargins();
+    ImageHelper::drawRoundedRectShadow(
+        *_painter, QRectF({ shadowMargins.left(), shadowMargins.top() }, backgroundRect.size()),
+        Ui::DesignSystem::card().borderRadius(), shadowMargins, shadowHeight,
         Ui::DesignSystem::color().shadow());
-    _painter->drawPixmap(0, 0, shadow);
     //
     // ... рисуем сам фон
     //
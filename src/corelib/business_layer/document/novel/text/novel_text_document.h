@@ -31,7 +31,7 @@ public:
     /**
      * @brief Список видимых блоков в зависимости от режима отображения документа
      */
-    QSet<TextParagraphType> visibleBlocksTypes() const;
+    QSet<TextParagraphType> visibleBlocksTypes() const override;
 
     /**
      * @brief Настроить необходимость корректировок
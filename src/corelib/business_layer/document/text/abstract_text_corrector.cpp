@@ -2,6 +2,7 @@
 
 #include <business_layer/model/text/text_model_item.h>
 #include <utils/logging.h>
+#include <utils/tracing.h>
 
 #include <QTextDocument>
 
@@ -81,6 +82,8 @@ void AbstractTextCorrector::setTemplateId(const QString& _templateId)
     }
 
     d->templateId = _templateId;
+
+    TRACE_SCOPE("corrector", "AbstractTextCorrector::makeCorrections");
     makeCorrections();
 }
 
@@ -114,6 +117,7 @@ void AbstractTextCorrector::setVisibleTopLevelItem(TextModelItem* _item)
         d->visibleTopLevelItem->setCustomIcon(u8"\U000F0EFF");
     }
 
+    TRACE_SCOPE("corrector", "AbstractTextCorrector::makeCorrections");
     makeCorrections(-1, -1);
 }
 
@@ -166,11 +170,15 @@ void AbstractTextCorrector::makePlannedCorrection(const QByteArray& _contentHash
 
     if (d->lastContent.hash == _contentHash
         && d->lastContent.characterCount == d->document->characterCount()) {
+        TRACE_SCOPE("corrector", "AbstractTextCorrector::makeSoftCorrections");
         makeSoftCorrections();
         return;
     }
 
-    makeCorrections(d->plannedCorrection.position, d->plannedCorrection.lenght);
+    {
+        TRACE_SCOPE("corrector", "AbstractTextCorrector::makeCorrections");
+        makeCorrections(d->plannedCorrection.position, d->plannedCorrection.lenght);
+    }
 
     d->lastContent.hash = _contentHash;
     d->lastContent.characterCount = d->document->characterCount();
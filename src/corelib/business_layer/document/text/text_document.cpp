@@ -17,6 +17,7 @@
 #include <utils/helpers/text_helper.h>
 #include <utils/shugar.h>
 #include <utils/tools/debouncer.h>
+#include <utils/tracing.h>
 
 #include <QDateTime>
 #include <QPointer>
@@ -49,6 +50,16 @@ public:
     TextModelItem* itemFor(const QTextBlock& _block) const;
     TextModelItem* itemFor(const TextCursor& _cursor) const;
 
+    /**
+     * @brief Получить индекс элемента модели для заданной позиции в документе и позицию в нём
+     */
+    QModelIndex itemIndexFor(int _position, int& _positionInBlock) const;
+
+    /**
+     * @brief Отображается ли в документе блок заданного типа
+     */
+    bool isBlockTypeVisible(TextParagraphType _type) const;
+
     /**
      * @brief Скорректировать позиции элементов на заданную дистанцию
      */
@@ -94,6 +105,13 @@ public:
     std::map<int, TextModelItem*> positionsToItems;
     QScopedPointer<AbstractTextCorrector> corrector;
 
+    /**
+     * @brief Типы видимых блоков
+     * @note Запоминаем их перед считыванием элементов модели, чтобы не формировать список
+     *       для каждого считываемого блока
+     */
+    QSet<TextParagraphType> visibleBlocksTypes;
+
     /**
      * @brief Дебаунсер для корректировки текста после изменений в модели
      * @note Тут нужен именно дебаунсинг, т.к. некоторые изменения в модели могут быть
@@ -133,6 +151,23 @@ TextModelItem* TextDocument::Implementation::itemFor(const TextCursor& _cursor)
     return itemFor(_cursor.block());
 }
 
+QModelIndex TextDocument::Implementation::itemIndexFor(int _position, int& _positionInBlock) const
+{
+    const auto block = q->findBlock(_position);
+    const auto item = itemFor(block);
+    if (item == nullptr) {
+        return {};
+    }
+
+    _positionInBlock = _position - block.position();
+    return model->indexForItem(item);
+}
+
+bool TextDocument::Implementation::isBlockTypeVisible(TextParagraphType _type) const
+{
+    return visibleBlocksTypes.isEmpty() || visibleBlocksTypes.contains(_type);
+}
+
 void TextDocument::Implementation::correctPositionsToItems(
     std::map<int, TextModelItem*>::iterator _from, int _distance)
 {
@@ -367,7 +402,19 @@ void TextDocument::Implementation::readModelItemContent(int _itemRow, const QMod
         if (textItem->isBreakCorrectionEnd()) {
             decorationFormat.setProperty(TextBlockStyle::PropertyIsBreakCorrectionEnd, true);
         }
+        //
+        // ... а невидимый в документе блок сразу настраиваем так, как его скрыл бы корректор,
+        //     чтобы он не участвовал в компоновке документа. Сам блок всё равно нужен, т.к.
+        //     удаление и слияние блоков переносятся в модель по позициям соседних блоков
+        //
+        const bool isBlockVisible = isBlockTypeVisible(textItem->paragraphType());
+        if (!isBlockVisible) {
+            decorationFormat.setTopMargin(0);
+            decorationFormat.setBottomMargin(0);
+            decorationFormat.setPageBreakPolicy(QTextFormat::PageBreak_Auto);
+        }
         _cursor.setBlockFormat(decorationFormat);
+        _cursor.block().setVisible(isBlockVisible);
 
         //
         // ... выравнивание
@@ -470,6 +517,8 @@ bool TextDocument::isEditTransactionActive()
 
 void TextDocument::setModel(BusinessLayer::TextModel* _model, bool _canChangeModel)
 {
+    TRACE_SCOPE("document", "TextDocument::setModel");
+
     d->state = DocumentState::Loading;
 
     if (d->model) {
@@ -505,6 +554,7 @@ void TextDocument::setModel(BusinessLayer::TextModel* _model, bool _canChangeMod
     if (d->corrector != nullptr) {
         d->corrector->setTemplateId(d->documentTemplate().id());
     }
+    d->visibleBlocksTypes = visibleBlocksTypes();
 
     //
     // Обновим шрифт документа, в моменте когда текста нет
@@ -750,6 +800,7 @@ void TextDocument::setModel(BusinessLayer::TextModel* _model, bool _canChangeMod
 
                 QScopedValueRollback temporatryState(d->state, DocumentState::Changing);
                 d->modelChangeCorrectionDebouncer.orderWork();
+                d->visibleBlocksTypes = visibleBlocksTypes();
 
                 //
                 // Игнорируем добавление пустых сцен и папок
@@ -1160,6 +1211,11 @@ TextModel* TextDocument::model() const
     return d->model;
 }
 
+QSet<TextParagraphType> TextDocument::visibleBlocksTypes() const
+{
+    return {};
+}
+
 void TextDocument::setCorrectionOptions(const QStringList& _options)
 {
     if (d->corrector == nullptr) {
@@ -1357,48 +1413,61 @@ QString TextDocument::groupTitle(const QTextBlock& _forBlock) const
 
 QString TextDocument::mimeFromSelection(int _fromPosition, int _toPosition) const
 {
-    const auto fromBlock = findBlock(_fromPosition);
-    if (fromBlock.userData() == nullptr) {
-        return {};
-    }
-    auto fromBlockData = static_cast<TextBlockData*>(fromBlock.userData());
-    if (fromBlockData == nullptr) {
+    int fromPositionInBlock = 0;
+    const auto fromItemIndex = d->itemIndexFor(_fromPosition, fromPositionInBlock);
+    int toPositionInBlock = 0;
+    const auto toItemIndex = d->itemIndexFor(_toPosition, toPositionInBlock);
+    if (!fromItemIndex.isValid() || !toItemIndex.isValid()) {
         return {};
     }
-    const auto fromItemIndex = d->model->indexForItem(fromBlockData->item());
-    const auto fromPositionInBlock = _fromPosition - fromBlock.position();
-
-    const auto toBlock = findBlock(_toPosition);
-    if (toBlock.userData() == nullptr) {
-        return {};
-    }
-    auto toBlockData = static_cast<TextBlockData*>(toBlock.userData());
-    if (toBlockData == nullptr) {
-        return {};
-    }
-    const auto toItemIndex = d->model->indexForItem(toBlockData->item());
-    const auto toPositionInBlock = _toPosition - toBlock.position();
 
     const bool clearUuid = true;
     return d->model->mimeFromSelection(fromItemIndex, fromPositionInBlock, toItemIndex,
                                        toPositionInBlock, clearUuid);
 }
 
+void TextDocument::setMimeFromSelection(TextModelMimeData* _mimeData, int _fromPosition,
+                                        int _toPosition) const
+{
+    int fromPositionInBlock = 0;
+    const auto fromItemIndex = d->itemIndexFor(_fromPosition, fromPositionInBlock);
+    int toPositionInBlock = 0;
+    const auto toItemIndex = d->itemIndexFor(_toPosition, toPositionInBlock);
+    if (!fromItemIndex.isValid() || !toItemIndex.isValid()) {
+        return;
+    }
+
+    const bool clearUuid = true;
+    d->model->setMimeFromSelection(_mimeData, fromItemIndex, fromPositionInBlock, toItemIndex,
+                                   toPositionInBlock, clearUuid);
+}
+
 int TextDocument::insertFromMime(int _position, const QString& _mimeData)
 {
     constexpr auto invalidPosition = -1;
-    const auto block = findBlock(_position);
-    if (block.userData() == nullptr) {
+    int positionInBlock = 0;
+    const auto itemIndex = d->itemIndexFor(_position, positionInBlock);
+    if (!itemIndex.isValid()) {
         return invalidPosition;
     }
 
-    auto blockData = static_cast<TextBlockData*>(block.userData());
-    if (blockData == nullptr) {
+    const auto insertedMimeLength = d->model->insertFromMime(itemIndex, positionInBlock, _mimeData);
+    if (insertedMimeLength <= 0) {
+        return invalidPosition;
+    }
+
+    return _position + insertedMimeLength;
+}
+
+int TextDocument::insertFromMime(int _position, const QMimeData* _mimeData)
+{
+    constexpr auto invalidPosition = -1;
+    int positionInBlock = 0;
+    const auto itemIndex = d->itemIndexFor(_position, positionInBlock);
+    if (!itemIndex.isValid()) {
         return invalidPosition;
     }
 
-    const auto itemIndex = d->model->indexForItem(blockData->item());
-    const auto positionInBlock = _position - block.position();
     const auto insertedMimeLength = d->model->insertFromMime(itemIndex, positionInBlock, _mimeData);
     if (insertedMimeLength <= 0) {
         return invalidPosition;
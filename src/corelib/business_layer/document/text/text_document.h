@@ -6,9 +6,12 @@
 
 #include <corelib_global.h>
 
+class QMimeData;
+
 
 namespace BusinessLayer {
 class TextModel;
+class TextModelMimeData;
 enum class TextParagraphType;
 } // namespace BusinessLayer
 
@@ -51,6 +54,16 @@ public:
     QModelIndex visibleTopLeveLItem() const;
     void setVisibleTopLevelItem(const QModelIndex& _index);
 
+    /**
+     * @brief Список видимых блоков в зависимости от режима отображения документа
+     * @note Пустой список означает, что видны блоки всех типов. Блоки остальных типов вставляются
+     *       в документ сразу скрытыми и не участвуют в компоновке, но создаются и оформляются,
+     *       т.к. изменения документа сопоставляются с моделью по блоку на каждый элемент. Поэтому
+     *       загрузка документа, отображающего лишь структуру текста, всё так же пропорциональна
+     *       количеству абзацев, а не элементов структуры
+     */
+    virtual QSet<TextParagraphType> visibleBlocksTypes() const;
+
     /**
      * @brief Получить позицию элемента в заданном индексе
      * @param _fromStart - true начальная позиция, false конечная позиция
@@ -91,6 +104,19 @@ public:
      */
     int insertFromMime(int _position, const QString& _mimeData);
 
+    /**
+     * @brief Поместить в майм-данные копии элементов модели в заданном диапазоне
+     */
+    void setMimeFromSelection(BusinessLayer::TextModelMimeData* _mimeData, int _fromPosition,
+                              int _toPosition) const;
+
+    /**
+     * @brief Вставить контент из майм-данных в заданной позиции
+     * @note Фрагменты, скопированные внутри приложения, вставляются без разбора xml
+     * @return Позиция завершения вставки, либо -1 если вставки не было
+     */
+    int insertFromMime(int _position, const QMimeData* _mimeData);
+
     /**
      * @brief Вставить новый блок заданного типа
      */
@@ -15,6 +15,7 @@
 
 #include <QFile>
 #include <QFontMetrics>
+#include <QHash>
 #include <QLocale>
 #include <QTextBlock>
 #include <QTextLayout>
@@ -24,6 +25,11 @@ namespace BusinessLayer {
 
 namespace {
 
+/**
+ * @brief Размер порции текста документа, после накопления которой она сжимается в архив
+ */
+constexpr int kDocumentPartLength = 64 * 1024;
+
 /**
  * @brief Перевести миллиметры в твипсы (мера длины в формате RTF)
  */
@@ -86,10 +92,10 @@ public:
     bool isCommentsRangeEnd(const QTextBlock& _block, const QTextLayout::FormatRange& _range) const;
 
     /**
-     * @brief Сформировать текст блока документа в зависимости от его стиля и оформления
+     * @brief Дописать текст блока документа в зависимости от его стиля и оформления
      */
-    QString docxText(QMap<int, QStringList>& _comments, const TextCursor& _cursor,
-                     const ExportOptions& _exportOptions) const;
+    void docxText(QMap<int, QStringList>& _comments, const TextCursor& _cursor,
+                  const ExportOptions& _exportOptions, QString& _documentXml) const;
     void writeStaticData(QtZipWriter* _zip, const ExportOptions& _exportOptions) const;
     void writeStyles(QtZipWriter* _zip, const ExportOptions& _exportOptions) const;
     void writeHeader(QtZipWriter* _zip, const ExportOptions& _exportOptions) const;
@@ -101,6 +107,17 @@ public:
 
 
     AbstractDocxExporter* q = nullptr;
+
+    /**
+     * @brief Начала абзацев со ссылкой на стиль, подготовленные вместе со стилями
+     */
+    mutable QHash<TextParagraphType, QString> paragraphsStarts;
+    mutable QHash<TextParagraphType, QString> splittedParagraphsStarts;
+
+    /**
+     * @brief Сжимать ли текст документа в архив порциями
+     */
+    bool isDocumentStreamed = true;
 };
 
 AbstractDocxExporter::Implementation::Implementation(AbstractDocxExporter* _q)
@@ -355,9 +372,10 @@ bool AbstractDocxExporter::Implementation::isCommentsRangeEnd(
     return isEnd;
 }
 
-QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _comments,
-                                                       const TextCursor& _cursor,
-                                                       const ExportOptions& _exportOptions) const
+void AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _comments,
+                                                    const TextCursor& _cursor,
+                                                    const ExportOptions& _exportOptions,
+                                                    QString& _documentXml) const
 {
     //
     // Блокируем сигналы от документа - по ходу экспорта мы будем изменять документ,
@@ -373,8 +391,6 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
                          - documentTemplate.pageMargins().right());
     };
 
-    QString documentXml;
-
     //
     // Получим стиль параграфа
     //
@@ -407,31 +423,31 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
         //
         // ... настройки абзаца
         //
-        documentXml = "<w:p><w:pPr><w:pStyle w:val=\"Normal\"/>";
+        _documentXml.append("<w:p><w:pPr><w:pStyle w:val=\"Normal\"/>");
         if (block.textDirection() == Qt::RightToLeft) {
-            documentXml.append("<w:bidi/>");
+            _documentXml.append("<w:bidi/>");
         }
-        documentXml.append(
+        _documentXml.append(
             QString("<w:rPr><w:rFonts w:ascii=\"%1\" w:hAnsi=\"%1\"/><w:sz w:val=\"%2\"/><w:szCs "
                     "w:val=\"%2\"/></w:rPr>")
                 .arg(_cursor.charFormat().font().family())
                 .arg(MeasurementHelper::pxToPt(_cursor.charFormat().font().pixelSize()) * 2));
-        documentXml.append(docxAlignment(_cursor.blockFormat().alignment()));
+        _documentXml.append(docxAlignment(_cursor.blockFormat().alignment()));
         if (_cursor.blockFormat().rightMargin() != 0 || _cursor.blockFormat().leftMargin() != 0) {
-            documentXml.append(QString("<w:ind w:left=\"%1\" w:right=\"%2\" w:hanging=\"0\" />")
-                                   .arg(pxToTwips(_cursor.blockFormat().leftMargin()))
-                                   .arg(pxToTwips(_cursor.blockFormat().rightMargin())));
+            _documentXml.append(QString("<w:ind w:left=\"%1\" w:right=\"%2\" w:hanging=\"0\" />")
+                                    .arg(pxToTwips(_cursor.blockFormat().leftMargin()))
+                                    .arg(pxToTwips(_cursor.blockFormat().rightMargin())));
         }
         //
         // ... интервалы
         //
         if (_cursor.blockFormat().topMargin() != 0 || _cursor.blockFormat().bottomMargin() != 0) {
-            documentXml.append(
+            _documentXml.append(
                 QString("<w:spacing w:before=\"%1\" w:after=\"%2\" w:lineRule=\"auto\"/>")
                     .arg(pxToTwips(_cursor.blockFormat().topMargin(), false))
                     .arg(pxToTwips(_cursor.blockFormat().bottomMargin(), false)));
         }
-        documentXml.append("<w:rPr/></w:pPr>");
+        _documentXml.append("<w:rPr/></w:pPr>");
         //
         // ... текст блока
         //
@@ -443,28 +459,28 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
             if (range.format.fontCapitalization() == QFont::AllUppercase) {
                 formatRangeText = TextHelper::smartToUpper(formatRangeText);
             }
-            documentXml.append(
+            _documentXml.append(
                 QString("<w:r><w:rPr><w:rFonts w:ascii=\"%1\" w:hAnsi=\"%1\"/>"
                         "<w:sz w:val=\"%2\"/><w:szCs w:val=\"%2\"/>")
                     .arg(range.format.font().family())
                     .arg(MeasurementHelper::pxToPt(range.format.font().pixelSize()) * 2));
             if (range.format.font().bold()) {
-                documentXml.append("<w:b/><w:bCs/>");
+                _documentXml.append("<w:b/><w:bCs/>");
             }
             if (range.format.font().italic()) {
-                documentXml.append("<w:i/><w:iCs/>");
+                _documentXml.append("<w:i/><w:iCs/>");
             }
             if (range.format.font().underline()) {
-                documentXml.append("<w:u w:val=\"single\"/>");
+                _documentXml.append("<w:u w:val=\"single\"/>");
             }
             if (formatRangeSourceText.isRightToLeft()) {
-                documentXml.append("<w:rtl/>");
+                _documentXml.append("<w:rtl/>");
             }
 
-            documentXml.append(QString("</w:rPr><w:t>%1</w:t></w:r>")
-                                   .arg(TextHelper::toHtmlEscaped(formatRangeText)));
+            _documentXml.append(QString("</w:rPr><w:t>%1</w:t></w:r>")
+                                    .arg(TextHelper::toHtmlEscaped(formatRangeText)));
         }
-        documentXml.append("</w:p>");
+        _documentXml.append("</w:p>");
     }
     //
     // ... начало и конец таблицы
@@ -474,11 +490,11 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
         if (blockData != nullptr) {
             const auto splitterItem = static_cast<TextModelSplitterItem*>(blockData->item());
             if (splitterItem->splitterType() == TextModelSplitterItemType::Start) {
-                documentXml.append("<w:tbl><w:tblPr>");
+                _documentXml.append("<w:tbl><w:tblPr>");
                 const auto fullTableWidth = tableWidth();
-                documentXml.append(
+                _documentXml.append(
                     QString("<w:tblW w:w=\"%1\" w:type=\"dxa\"/>").arg(tableWidth()));
-                documentXml.append(
+                _documentXml.append(
                     "<w:jc w:val=\"left\"/><w:tblInd w:w=\"0\" "
                     "w:type=\"dxa\"/><w:tblCellMar><w:top w:w=\"0\" w:type=\"dxa\"/><w:left "
                     "w:w=\"0\" w:type=\"dxa\"/><w:bottom w:w=\"0\" w:type=\"dxa\"/><w:right "
@@ -486,16 +502,16 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
                 const int middleColumnWidth = pxToTwips(documentTemplate.pageSplitterWidth());
                 const int leftColumnWidth = (fullTableWidth - middleColumnWidth)
                     * documentTemplate.leftHalfOfPageWidthPercents() / 100.;
-                documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(leftColumnWidth));
-                documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(middleColumnWidth));
+                _documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(leftColumnWidth));
+                _documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(middleColumnWidth));
                 const int rightColumnWidth = fullTableWidth - leftColumnWidth - middleColumnWidth;
-                documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(rightColumnWidth));
-                documentXml.append("</w:tblGrid><w:tr><w:trPr/><w:tc><w:tcPr>");
-                documentXml.append(
+                _documentXml.append(QString("<w:gridCol w:w=\"%1\"/>").arg(rightColumnWidth));
+                _documentXml.append("</w:tblGrid><w:tr><w:trPr/><w:tc><w:tcPr>");
+                _documentXml.append(
                     QString("<w:tcW w:w=\"%1\" w:type=\"dxa\"/>").arg(leftColumnWidth));
-                documentXml.append("<w:tcBorders/></w:tcPr>");
+                _documentXml.append("<w:tcBorders/></w:tcPr>");
             } else {
-                documentXml.append("</w:tc></w:tr></w:tbl>");
+                _documentXml.append("</w:tc></w:tr></w:tbl>");
             }
         }
     }
@@ -510,47 +526,54 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
             TextCursor cursor(_cursor);
             cursor.movePosition(TextCursor::PreviousBlock);
             if (cursor.inFirstColumn()) {
-                documentXml.append("</w:tc><w:tc><w:tcPr>");
+                _documentXml.append("</w:tc><w:tc><w:tcPr>");
                 const auto fullTableWidth = tableWidth();
                 const int middleColumnWidth = pxToTwips(documentTemplate.pageSplitterWidth());
-                documentXml.append(
+                _documentXml.append(
                     QString("<w:tcW w:w=\"%1\" w:type=\"dxa\"/>").arg(middleColumnWidth));
-                documentXml.append(
+                _documentXml.append(
                     "<w:tcBorders/></w:tcPr>"
                     "<w:p><w:pPr><w:pStyle w:val=\"Normal\"/><w:rPr/></w:pPr>"
                     "<w:r><w:t xml:space=\"preserve\"></w:t></w:r></w:p></w:tc><w:tc><w:tcPr>");
                 const int leftColumnWidth = (fullTableWidth - middleColumnWidth)
                     * documentTemplate.leftHalfOfPageWidthPercents() / 100.;
                 const int rightColumnWidth = fullTableWidth - leftColumnWidth - middleColumnWidth;
-                documentXml.append(
+                _documentXml.append(
                     QString("<w:tcW w:w=\"%1\" w:type=\"dxa\"/>").arg(rightColumnWidth));
-                documentXml.append("<w:tcBorders/></w:tcPr>");
+                _documentXml.append("<w:tcBorders/></w:tcPr>");
             }
         }
 
         //
         // ... пишем стиль блока
         //
-        const QString suffix = _cursor.inTable() ? "_splitted" : "";
-        documentXml.append(QString("<w:p><w:pPr><w:pStyle w:val=\"%1\"/>")
-                               .arg(paragraphTypeName(correctedBlockType, suffix)));
+        const auto& blockParagraphsStarts
+            = _cursor.inTable() ? splittedParagraphsStarts : paragraphsStarts;
+        const auto paragraphStart = blockParagraphsStarts.constFind(correctedBlockType);
+        if (isDocumentStreamed && paragraphStart != blockParagraphsStarts.constEnd()) {
+            _documentXml.append(paragraphStart.value());
+        } else {
+            const QString suffix = _cursor.inTable() ? "_splitted" : "";
+            _documentXml.append(QString("<w:p><w:pPr><w:pStyle w:val=\"%1\"/>")
+                                    .arg(paragraphTypeName(correctedBlockType, suffix)));
+        }
         //
         // ... признак RTL и разворачиваем отступы
         //
         if (block.textDirection() == Qt::RightToLeft) {
             const auto blockStyle = documentTemplate.paragraphStyle(correctedBlockType);
-            documentXml.append(
+            _documentXml.append(
                 QString("<w:ind w:left=\"%1\" w:right=\"%2\"/>")
                     .arg(pxToTwips(blockStyle.blockFormat(_cursor.inTable()).rightMargin()))
                     .arg(pxToTwips(blockStyle.blockFormat(_cursor.inTable()).leftMargin())));
-            documentXml.append("<w:bidi/>");
+            _documentXml.append("<w:bidi/>");
         }
         //
         // ... начинать с новой страницы
         //
         if (_cursor.blockFormat().pageBreakPolicy() == QTextFormat::PageBreak_AlwaysBefore) {
-            documentXml.append("<w:spacing w:before=\"0\"/>");
-            documentXml.append("<w:pageBreakBefore/>");
+            _documentXml.append("<w:spacing w:before=\"0\"/>");
+            _documentXml.append("<w:pageBreakBefore/>");
         }
         //
         // ... если это самый первый блок в документе,
@@ -560,7 +583,7 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
         else if (_cursor.atStart()
                  || _cursor.blockFormat().hasProperty(
                      TextBlockStyle::PropertyIsCorrectionContinued)) {
-            documentXml.append("<w:spacing w:before=\"0\"/>");
+            _documentXml.append("<w:spacing w:before=\"0\"/>");
         }
 
         //
@@ -568,19 +591,19 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
         //
         if (block.blockFormat().alignment()
             != q->documentTemplate(_exportOptions).paragraphStyle(currentBlockType).align()) {
-            documentXml.append(docxAlignment(block.blockFormat().alignment()));
+            _documentXml.append(docxAlignment(block.blockFormat().alignment()));
         }
 
         //
         // ... обработаем блок в наследнике
         //
-        q->processBlock(_cursor, _exportOptions, documentXml);
+        q->processBlock(_cursor, _exportOptions, _documentXml);
 
         //
         //  ... текст абзаца
         //
         const QString blockText = block.text();
-        documentXml.append("<w:rPr/></w:pPr>");
+        _documentXml.append("<w:rPr/></w:pPr>");
         const auto textFormats = block.textFormats();
         for (const auto& range : textFormats) {
             const auto formatRangeSourceText = blockText.mid(range.start, range.length);
@@ -601,38 +624,38 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
                 // ... стандартный для абзаца
                 //
                 if (range.format == block.charFormat()) {
-                    documentXml.append("<w:r>");
+                    _documentXml.append("<w:r>");
                     if (formatRangeSourceText.isRightToLeft()) {
-                        documentXml.append("<w:rPr><w:rtl/></w:rPr>");
+                        _documentXml.append("<w:rPr><w:rtl/></w:rPr>");
                     }
-                    documentXml.append(formatRangeText);
-                    documentXml.append("</w:r>");
+                    _documentXml.append(formatRangeText);
+                    _documentXml.append("</w:r>");
 
                 }
                 //
                 // ... не стандартный
                 //
                 else {
-                    documentXml.append("<w:r>");
-                    documentXml.append("<w:rPr>");
+                    _documentXml.append("<w:r>");
+                    _documentXml.append("<w:rPr>");
                     if (range.format.font().bold()) {
-                        documentXml.append("<w:b/><w:bCs/>");
+                        _documentXml.append("<w:b/><w:bCs/>");
                     }
                     if (range.format.font().italic()) {
-                        documentXml.append("<w:i/><w:iCs/>");
+                        _documentXml.append("<w:i/><w:iCs/>");
                     }
                     if (range.format.font().underline()) {
-                        documentXml.append("<w:u w:val=\"single\"/>");
+                        _documentXml.append("<w:u w:val=\"single\"/>");
                     }
                     if (formatRangeSourceText.isRightToLeft()) {
-                        documentXml.append("<w:rtl/>");
+                        _documentXml.append("<w:rtl/>");
                     }
-                    documentXml.append("</w:rPr>");
+                    _documentXml.append("</w:rPr>");
                     //
                     // Сам текст
                     //
-                    documentXml.append(formatRangeText);
-                    documentXml.append("</w:r>");
+                    _documentXml.append(formatRangeText);
+                    _documentXml.append("</w:r>");
                 }
             }
             //
@@ -663,53 +686,53 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
                                              << comments.at(commentIndex)
                                              << authors.at(commentIndex) << dates.at(commentIndex));
 
-                        documentXml.append(
+                        _documentXml.append(
                             QString("<w:commentRangeStart w:id=\"%1\"/>").arg(lastCommentIndex));
                     }
                 }
-                documentXml.append("<w:r>");
-                documentXml.append("<w:rPr>");
+                _documentXml.append("<w:r>");
+                _documentXml.append("<w:rPr>");
                 //
                 // Заливка
                 //
                 if (!hasComments && range.format.hasProperty(QTextFormat::BackgroundBrush)) {
-                    documentXml.append(QString("<w:shd w:fill=\"%1\" w:val=\"clear\"/>")
-                                           // код цвета без решётки
-                                           .arg(range.format.background().color().name().mid(1)));
+                    _documentXml.append(QString("<w:shd w:fill=\"%1\" w:val=\"clear\"/>")
+                                            // код цвета без решётки
+                                            .arg(range.format.background().color().name().mid(1)));
                 }
                 //
                 // Цвет текста
                 //
                 if (!hasComments && range.format.hasProperty(QTextFormat::ForegroundBrush)) {
-                    documentXml.append(QString("<w:color w:val=\"%1\"/>")
-                                           // код цвета без решётки
-                                           .arg(range.format.foreground().color().name().mid(1)));
+                    _documentXml.append(QString("<w:color w:val=\"%1\"/>")
+                                            // код цвета без решётки
+                                            .arg(range.format.foreground().color().name().mid(1)));
                 }
                 if (range.format.font().bold()) {
-                    documentXml.append("<w:b/><w:bCs/>");
+                    _documentXml.append("<w:b/><w:bCs/>");
                 }
                 if (range.format.font().italic()) {
-                    documentXml.append("<w:i/><w:iCs/>");
+                    _documentXml.append("<w:i/><w:iCs/>");
                 }
                 if (range.format.font().underline()) {
-                    documentXml.append("<w:u w:val=\"single\"/>");
+                    _documentXml.append("<w:u w:val=\"single\"/>");
                 }
                 if (formatRangeSourceText.isRightToLeft()) {
-                    documentXml.append("<w:rtl/>");
+                    _documentXml.append("<w:rtl/>");
                 }
-                documentXml.append("</w:rPr>");
+                _documentXml.append("</w:rPr>");
                 //
                 // Сам текст
                 //
-                documentXml.append(formatRangeText);
-                documentXml.append("</w:r>");
+                _documentXml.append(formatRangeText);
+                _documentXml.append("</w:r>");
                 //
                 // Текст комментария
                 //
                 if (hasComments && isCommentsRangeEnd(block, range)) {
                     for (int commentIndex = lastCommentIndex - comments.size() + 1;
                          commentIndex <= lastCommentIndex; ++commentIndex) {
-                        documentXml.append(
+                        _documentXml.append(
                             QString("<w:commentRangeEnd w:id=\"%1\"/>"
                                     "<w:r><w:rPr/><w:commentReference w:id=\"%1\"/></w:r>")
                                 .arg(commentIndex));
@@ -720,10 +743,8 @@ QString AbstractDocxExporter::Implementation::docxText(QMap<int, QStringList>& _
         //
         // ... закрываем абзац
         //
-        documentXml.append("</w:p>");
+        _documentXml.append("</w:p>");
     }
-
-    return documentXml;
 }
 
 void AbstractDocxExporter::Implementation::writeStaticData(
@@ -866,11 +887,23 @@ void AbstractDocxExporter::Implementation::writeStyles(QtZipWriter* _zip,
     const auto& audioplayTemplate = q->documentTemplate(_exportOptions);
     const QString defaultFontFamily
         = audioplayTemplate.paragraphStyle(TextParagraphType::Description).font().family();
+    paragraphsStarts.clear();
+    splittedParagraphsStarts.clear();
     for (const auto& paragraphType : q->paragraphTypes()) {
         const auto blockStyle = audioplayTemplate.paragraphStyle(paragraphType);
         styleXml.append(docxBlockStyle(blockStyle, defaultFontFamily));
         const auto onHalfPage = true;
         styleXml.append(docxBlockStyle(blockStyle, defaultFontFamily, onHalfPage));
+
+        //
+        // ... заодно готовим начала абзацев, чтобы не формировать их для каждого блока документа
+        //
+        paragraphsStarts.insert(paragraphType,
+                                QString("<w:p><w:pPr><w:pStyle w:val=\"%1\"/>")
+                                    .arg(paragraphTypeName(paragraphType)));
+        splittedParagraphsStarts.insert(paragraphType,
+                                        QString("<w:p><w:pPr><w:pStyle w:val=\"%1\"/>")
+                                            .arg(paragraphTypeName(paragraphType, "_splitted")));
     }
 
     styleXml.append("</w:styles>");
@@ -1020,13 +1053,23 @@ void AbstractDocxExporter::Implementation::writeDocument(QtZipWriter* _zip,
     // Данные считываются из исходного документа, определяется тип блока
     // и записываются прямо в файл
     //
+    // ... документ сжимается в архив порциями по мере формирования, поэтому в памяти никогда
+    //     не находится целиком, сколь бы большим он ни был, если это не отключено для сверки
+    //
+    if (isDocumentStreamed) {
+        _zip->beginFile(QString::fromLatin1("word/document.xml"));
+    }
     TextCursor documentCursor(_audioplayText);
     do {
         if (!documentCursor.block().isVisible()) {
             continue;
         }
 
-        documentXml.append(docxText(_comments, documentCursor, _exportOptions));
+        docxText(_comments, documentCursor, _exportOptions, documentXml);
+        if (isDocumentStreamed && documentXml.length() >= kDocumentPartLength) {
+            _zip->writeToFile(documentXml.toUtf8());
+            documentXml.resize(0);
+        }
     } while (documentCursor.movePosition(QTextCursor::NextBlock));
 
     //
@@ -1082,9 +1125,14 @@ void AbstractDocxExporter::Implementation::writeDocument(QtZipWriter* _zip,
     documentXml.append("</w:body></w:document>");
 
     //
-    // Запишем документ в архив
+    // Запишем остаток документа в архив, либо документ целиком, если он не сжимался порциями
     //
-    _zip->addFile(QString::fromLatin1("word/document.xml"), documentXml.toUtf8());
+    if (!isDocumentStreamed) {
+        _zip->addFile(QString::fromLatin1("word/document.xml"), documentXml.toUtf8());
+        return;
+    }
+    _zip->writeToFile(documentXml.toUtf8());
+    _zip->endFile();
 }
 
 void AbstractDocxExporter::Implementation::writeComments(
@@ -1177,6 +1225,11 @@ void AbstractDocxExporter::exportTo(TextModel* _model, ExportOptions& _exportOpt
     docxFile.close();
 }
 
+void AbstractDocxExporter::setDocumentStreamed(bool _streamed)
+{
+    d->isDocumentStreamed = _streamed;
+}
+
 void AbstractDocxExporter::processBlock(const TextCursor& _cursor,
                                         const ExportOptions& _exportOptions,
                                         QString& _documentXml) const
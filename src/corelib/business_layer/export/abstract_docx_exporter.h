@@ -20,6 +20,13 @@ public:
      */
     void exportTo(TextModel* _model, ExportOptions& _exportOptions) const override;
 
+    /**
+     * @brief Сжимать ли текст документа в архив порциями по мере его формирования
+     * @note Включено по умолчанию. Без этого документ формируется целиком, как раньше, и
+     *       добавляется в архив одним файлом, что позволяет сверить результаты обоих способов
+     */
+    void setDocumentStreamed(bool _streamed);
+
 protected:
     /**
      * @brief Определить список стилей для экспорта
@@ -5,7 +5,9 @@
 
 #include <domain/document_object.h>
 #include <utils/diff_match_patch/diff_match_patch_controller.h>
+#include <utils/logging.h>
 #include <utils/tools/debouncer.h>
+#include <utils/tracing.h>
 
 #include <QScopedValueRollback>
 
@@ -167,6 +169,8 @@ void AbstractModel::reassignContent()
 
 void AbstractModel::saveChanges()
 {
+    TRACE_SCOPE("model", "AbstractModel::saveChanges");
+
     if (d->document == nullptr) {
         return;
     }
@@ -237,24 +241,49 @@ ChangeCursor AbstractModel::redo()
 }
 
 bool AbstractModel::mergeDocumentChanges(const QByteArray _content,
-                                         const QVector<QByteArray>& _patches)
+                                         const QVector<QByteArray>& _patches,
+                                         const QVector<QByteArray>& _resultHashes)
 {
     if (_content.isEmpty() && _patches.isEmpty()) {
         return false;
     }
 
     auto newContent = _content.isEmpty() ? toXml() : _content;
-    for (const auto& patch : _patches) {
-        auto patchedContent = d->dmpController.applyPatch(newContent, patch);
+    for (int index = 0; index < _patches.size(); ++index) {
+        //
+        // Результат сверяем с ожидаемым только, если патч накладывается ровно на то содержимое,
+        // для которого он был сформирован, т.е. на результат предыдущего изменения
+        //
+        QByteArray expectedHash;
+        if (index > 0 && !_resultHashes.value(index).isEmpty()
+            && DiffMatchPatchController::contentHash(newContent)
+                == _resultHashes.value(index - 1)) {
+            expectedHash = _resultHashes.at(index);
+        }
+        auto result
+            = d->dmpController.applyPatchVerified(newContent, _patches.at(index), expectedHash);
+
+        //
+        // Если какой-то из кусков патча не наложился, или результат разошёлся с ожидаемым,
+        // то не сохраняем документ, т.к. он не совпадает ни с одной из версий авторов изменений
+        //
+        if (!result.isValid()) {
+            Log::warning(
+                "Document changes merge failed: %1 of %2 hunks are not applied, result hash %3",
+                QString::number(result.hunks.count(DiffMatchPatchController::HunkStatus::Failed)),
+                QString::number(result.hunks.size()),
+                result.isHashMatched ? QString("matched") : QString("mismatched"));
+            return false;
+        }
 
         //
         // Если патч не принёс успеха, значит ошибка в наложении изменений
         //
-        if (patchedContent.size() == newContent.size() && patchedContent == newContent) {
+        if (result.content.size() == newContent.size() && result.content == newContent) {
             return false;
         }
 
-        newContent.swap(patchedContent);
+        newContent.swap(result.content);
     }
 
 
@@ -266,10 +295,24 @@ bool AbstractModel::mergeDocumentChanges(const QByteArray _content,
     return true;
 }
 
-void AbstractModel::applyDocumentChanges(const QVector<QByteArray>& _patches)
+bool AbstractModel::applyDocumentChanges(const QVector<QByteArray>& _patches)
 {
     QScopedValueRollback isChangesApplyingInProgressRollback(d->isChangesApplyingInProgress, true);
 
+    //
+    // Предварительно проверяем, что все изменения накладываются на текущее содержимое документа,
+    // чтобы не получить документ, который разошёлся с документами соавторов
+    //
+    auto verifiedContent = toXml();
+    for (const auto& patch : _patches) {
+        auto result = d->dmpController.applyPatchVerified(verifiedContent, patch);
+        if (!result.isApplied()) {
+            Log::warning("Document changes can't be applied, full document resync is needed");
+            return false;
+        }
+        verifiedContent.swap(result.content);
+    }
+
     //
     // Накладываем изменения
     //
@@ -281,6 +324,7 @@ void AbstractModel::applyDocumentChanges(const QVector<QByteArray>& _patches)
     // Чтобы изменения не продуцировали патч, применим новый контент с изменениями к документу
     //
     reassignContent();
+    return true;
 }
 
 bool AbstractModel::isChangesApplyingInProcess() const
@@ -350,10 +394,19 @@ void AbstractModel::initImageWrapper()
 
 ChangeCursor AbstractModel::applyPatch(const QByteArray& _patch)
 {
-    const auto newContent = d->dmpController.applyPatch(toXml(), _patch);
+    const auto result = d->dmpController.applyPatchVerified(toXml(), _patch);
+
+    //
+    // Не накладываем патч частично, чтобы не сохранить документ, который не совпадает ни с одной
+    // из его версий
+    //
+    if (!result.isApplied()) {
+        Log::warning("Patch can't be applied to the document");
+        return {};
+    }
 
     clearDocument();
-    document()->setContent(newContent);
+    document()->setContent(result.content);
     initDocument();
 
     return {};
@@ -101,13 +101,19 @@ public:
 
     /**
      * @brief Смержить документ с заданным
+     * @param _resultHashes Хэши содержимого документа после каждого из изменений (если известны)
+     * @return false, если изменения не удалось наложить без расхождений, в таком случае
+     *         документ остаётся без изменений
      */
-    bool mergeDocumentChanges(const QByteArray _content, const QVector<QByteArray>& _patches);
+    bool mergeDocumentChanges(const QByteArray _content, const QVector<QByteArray>& _patches,
+                              const QVector<QByteArray>& _resultHashes = {});
 
     /**
      * @brief Наложить заданные изменения на документ
+     * @return false, если изменения не накладываются на текущее содержимое документа, в таком
+     *         случае документ остаётся без изменений и его нужно синхронизировать целиком
      */
-    void applyDocumentChanges(const QVector<QByteArray>& _patches);
+    bool applyDocumentChanges(const QVector<QByteArray>& _patches);
 
     /**
      * @brief Применяются ли в данный момент изменения
@@ -8,13 +8,14 @@
 #include <business_layer/model/audioplay/text/audioplay_text_block_parser.h>
 #include <business_layer/model/characters/character_model.h>
 #include <business_layer/model/characters/characters_model.h>
+#include <business_layer/model/text/text_model_dialogues_index.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_numbering.h>
 #include <business_layer/templates/audioplay_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
-#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 
-#include <QRegularExpression>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -35,6 +36,29 @@ public:
      */
     TextModelItem* rootItem() const;
 
+    /**
+     * @brief Состояние счётчиков номеров сцен и реплик
+     */
+    struct NumberingState {
+        int sceneNumber = 1;
+        int dialogueNumber = 0;
+
+        bool operator==(const NumberingState& _other) const
+        {
+            return sceneNumber == _other.sceneNumber && dialogueNumber == _other.dialogueNumber;
+        }
+    };
+
+    /**
+     * @brief Пронумеровать реплику
+     */
+    void updateTextNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Пронумеровать сцену
+     */
+    void updateSceneNumber(TextModelItem* _item, NumberingState& _state);
+
     /**
      * @brief Обновить номера сцен и реплик
      */
@@ -51,6 +75,11 @@ public:
      */
     AudioplayTextModel* q = nullptr;
 
+    /**
+     * @brief Индекс реплик персонажей
+     */
+    TextModelDialoguesIndex* dialoguesIndex = nullptr;
+
     /**
      * @brief Модель информации о проекте
      */
@@ -70,10 +99,20 @@ public:
      * @brief Справочники, которые строятся в рантайме
      */
     QStringListModel* charactersModelFromText = nullptr;
+
+    /**
+     * @brief Нумерация сцен и реплик
+     */
+    TextModelNumbering<NumberingState> numbering;
 };
 
 AudioplayTextModel::Implementation::Implementation(AudioplayTextModel* _q)
     : q(_q)
+    , dialoguesIndex(new TextModelDialoguesIndex(_q, &AudioplayCharacterParser::name))
+    , numbering([this](TextModelItem* _item,
+                       NumberingState& _state) { updateTextNumber(_item, _state); },
+                [this](TextModelItem* _item,
+                       NumberingState& _state) { updateSceneNumber(_item, _state); })
 {
 }
 
@@ -82,63 +121,59 @@ TextModelItem* AudioplayTextModel::Implementation::rootItem() const
     return q->itemForIndex({});
 }
 
-void AudioplayTextModel::Implementation::updateNumbering()
+void AudioplayTextModel::Implementation::updateTextNumber(TextModelItem* _item,
+                                                          NumberingState& _state)
 {
-    int sceneNumber = 1;
-    int dialogueNumber = 0;
-    std::function<void(const TextModelItem*)> updateChildNumbering;
-    updateChildNumbering = [this, &sceneNumber, &dialogueNumber,
-                            &updateChildNumbering](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                updateChildNumbering(childItem);
-                break;
-            }
+    if (_item->type() != TextModelItemType::Text) {
+        return;
+    }
 
-            case TextModelItemType::Group: {
-                updateChildNumbering(childItem);
-                auto groupItem = static_cast<TextModelGroupItem*>(childItem);
-                if (groupItem->setNumber(sceneNumber, {})) {
-                    ++sceneNumber;
-                }
-                break;
-            }
+    auto textItem = static_cast<AudioplayTextModelTextItem*>(_item);
+    if (textItem->isCorrection()) {
+        return;
+    }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<AudioplayTextModelTextItem*>(childItem);
-                if (!textItem->isCorrection()) {
-                    switch (textItem->paragraphType()) {
-                    case TextParagraphType::Character:
-                    case TextParagraphType::Sound:
-                    case TextParagraphType::Music:
-                    case TextParagraphType::Cue: {
-                        ++dialogueNumber;
-                        Q_FALLTHROUGH();
-                    }
-
-                    case TextParagraphType::Dialogue:
-                    case TextParagraphType::Lyrics: {
-                        textItem->setNumber(dialogueNumber);
-                        q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
-                        break;
-                    }
-
-                    default: {
-                        break;
-                    }
-                    }
-                }
-                break;
-            }
+    switch (textItem->paragraphType()) {
+    case TextParagraphType::Character:
+    case TextParagraphType::Sound:
+    case TextParagraphType::Music:
+    case TextParagraphType::Cue: {
+        ++_state.dialogueNumber;
+        Q_FALLTHROUGH();
+    }
 
-            default:
-                break;
-            }
+    case TextParagraphType::Dialogue:
+    case TextParagraphType::Lyrics: {
+        if (!textItem->number().has_value()
+            || textItem->number()->value != _state.dialogueNumber) {
+            textItem->setNumber(_state.dialogueNumber);
+            q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
         }
-    };
-    updateChildNumbering(rootItem());
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+}
+
+void AudioplayTextModel::Implementation::updateSceneNumber(TextModelItem* _item,
+                                                           NumberingState& _state)
+{
+    if (_item->type() != TextModelItemType::Group) {
+        return;
+    }
+
+    auto groupItem = static_cast<TextModelGroupItem*>(_item);
+    if (groupItem->setNumber(_state.sceneNumber, {})) {
+        ++_state.sceneNumber;
+    }
+}
+
+void AudioplayTextModel::Implementation::updateNumbering()
+{
+    numbering.update(rootItem(), {});
 }
 
 void AudioplayTextModel::Implementation::updateChildrenDuration(const TextModelItem* _item)
@@ -172,18 +207,45 @@ AudioplayTextModel::AudioplayTextModel(QObject* _parent)
     : TextModel(_parent, createFolderItem(TextFolderType::Root))
     , d(new Implementation(this))
 {
-    auto updateCounters = [this](const QModelIndex& _index) {
-        d->updateNumbering();
-        d->updateChildrenDuration(itemForIndex(_index));
-    };
-
     //
     // Обновляем счётчики после того, как операции вставки и удаления будут обработаны клиентами
     // модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели может
     // приводить к падению внутри них
     //
-    connect(this, &AudioplayTextModel::afterRowsInserted, this, updateCounters);
-    connect(this, &AudioplayTextModel::afterRowsRemoved, this, updateCounters);
+    // ... номера пересчитываем начиная с первого затронутого элемента
+    //
+    connect(this, &AudioplayTextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _last);
+                d->updateChildrenDuration(parentItem);
+            });
+    connect(this, &AudioplayTextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _first - 1);
+                d->updateChildrenDuration(parentItem);
+            });
+    //
+    // ... удаляемые элементы забываем, пока они ещё существуют
+    //
+    connect(this, &AudioplayTextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->numbering.forget(parentItem->childAt(row));
+                }
+            });
+    //
+    // ... а изменённые без вставки и удаления строк элементы пересчитаем при следующем обновлении
+    //
+    connect(this, &AudioplayTextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    d->numbering.markChanged(itemForIndex(_topLeft.siblingAtRow(row)));
+                }
+            });
+    connect(this, &AudioplayTextModel::modelReset, this, [this] { d->numbering.clear(); });
 
     connect(this, &AudioplayTextModel::contentsChanged, this,
             [this] { d->needUpdateRuntimeDictionaries = true; });
@@ -267,111 +329,28 @@ void AudioplayTextModel::createCharacter(const QString& _name)
     d->charactersModel->createCharacter(_name);
 }
 
-void AudioplayTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
+void AudioplayTextModel::updateCharacterName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<AudioplayTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::Character
-                    && AudioplayCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(QString("\\b(%1)\\b").arg(oldName),
-                                                         QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
+    const auto& oldName = _replacement.oldName();
+    _replacement.apply(this, [&_replacement, &oldName](const TextModelTextItem* _item,
+                                                       QString& _text) {
+        if (_item->paragraphType() == TextParagraphType::Character
+            && AudioplayCharacterParser::name(_text) == oldName) {
+            return _replacement.replaceFirst(_text);
         }
-    };
 
-    emit rowsAboutToBeChanged();
-    updateCharacterBlock(d->rootItem());
-    emit rowsChanged();
+        return _replacement.replaceMentions(_text);
+    });
 }
 
 QVector<QModelIndex> AudioplayTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QString lastCharacter;
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = AudioplayCharacterParser::name(textItem->text());
-                break;
-            }
-
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
-
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                lastCharacter.clear();
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
-        }
-    }
+    return d->dialoguesIndex->dialogues(_name);
+}
 
-    return dialoguesIndexes;
+int AudioplayTextModel::characterDialoguesCount(const QString& _name) const
+{
+    return d->dialoguesIndex->dialoguesCount(_name);
 }
 
 QSet<QString> AudioplayTextModel::findCharactersFromText() const
@@ -8,6 +8,7 @@ namespace BusinessLayer {
 class CharacterModel;
 class CharactersModel;
 class AudioplayInformationModel;
+class TextModelNameReplacement;
 
 /**
  * @brief Модель текста аудиопостановки
@@ -52,13 +53,18 @@ public:
     /**
      * @brief Обновить имя персонажа
      */
-    void updateCharacterName(const QString& _oldName, const QString& _newName);
+    void updateCharacterName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Получить список реплик персонажа
      */
     QVector<QModelIndex> characterDialogues(const QString& _name) const;
 
+    /**
+     * @brief Получить количество реплик персонажа
+     */
+    int characterDialoguesCount(const QString& _name) const;
+
     /**
      * @brief Найти всех персонажей сценария
      */
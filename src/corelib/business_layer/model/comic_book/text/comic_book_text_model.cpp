@@ -9,16 +9,17 @@
 #include <business_layer/model/characters/characters_model.h>
 #include <business_layer/model/comic_book/comic_book_dictionaries_model.h>
 #include <business_layer/model/comic_book/comic_book_information_model.h>
+#include <business_layer/model/text/text_model_dialogues_index.h>
 #include <business_layer/model/text/text_model_folder_item.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_numbering.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/templates/comic_book_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
-#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 #include <utils/shugar.h>
 
-#include <QRegularExpression>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -39,6 +40,31 @@ public:
      */
     TextModelItem* rootItem() const;
 
+    /**
+     * @brief Состояние счётчиков номеров страниц, панелей и реплик
+     */
+    struct NumberingState {
+        int pageNumber = 1;
+        int panelNumber = 1;
+        int dialogueNumber = 0;
+
+        bool operator==(const NumberingState& _other) const
+        {
+            return pageNumber == _other.pageNumber && panelNumber == _other.panelNumber
+                && dialogueNumber == _other.dialogueNumber;
+        }
+    };
+
+    /**
+     * @brief Начать нумерацию панелей и реплик страницы, либо пронумеровать реплику
+     */
+    void updateTextNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Пронумеровать страницу или панель
+     */
+    void updateGroupNumber(TextModelItem* _item, NumberingState& _state);
+
     /**
      * @brief Обновить номера страниц, панелей и реплик
      */
@@ -50,6 +76,11 @@ public:
      */
     ComicBookTextModel* q = nullptr;
 
+    /**
+     * @brief Индекс реплик персонажей
+     */
+    TextModelDialoguesIndex* dialoguesIndex = nullptr;
+
     /**
      * @brief Модель информации о проекте
      */
@@ -74,10 +105,20 @@ public:
      * @brief Справочники, которые строятся в рантайме
      */
     QStringListModel* charactersModelFromText = nullptr;
+
+    /**
+     * @brief Нумерация страниц, панелей и реплик
+     */
+    TextModelNumbering<NumberingState> numbering;
 };
 
 ComicBookTextModel::Implementation::Implementation(ComicBookTextModel* _q)
     : q(_q)
+    , dialoguesIndex(new TextModelDialoguesIndex(_q, &ComicBookCharacterParser::name))
+    , numbering([this](TextModelItem* _item,
+                       NumberingState& _state) { updateTextNumber(_item, _state); },
+                [this](TextModelItem* _item,
+                       NumberingState& _state) { updateGroupNumber(_item, _state); })
 {
 }
 
@@ -86,74 +127,92 @@ TextModelItem* ComicBookTextModel::Implementation::rootItem() const
     return q->itemForIndex({});
 }
 
-void ComicBookTextModel::Implementation::updateNumbering()
+void ComicBookTextModel::Implementation::updateTextNumber(TextModelItem* _item,
+                                                          NumberingState& _state)
 {
-    int pageNumber = 1;
-    int panelNumber = 1;
-    int dialogueNumber = 0;
-    std::function<void(const TextModelItem*)> updateChildNumbering;
-    updateChildNumbering = [this, &pageNumber, &panelNumber, &dialogueNumber,
-                            &updateChildNumbering](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                updateChildNumbering(childItem);
-                break;
-            }
+    switch (_item->type()) {
+    case TextModelItemType::Group: {
+        const auto groupItem = static_cast<TextModelGroupItem*>(_item);
+        if (groupItem->groupType() == TextGroupType::Page) {
+            _state.panelNumber = 1;
+            _state.dialogueNumber = 0;
+        }
+        break;
+    }
 
-            case TextModelItemType::Group: {
-                const auto groupItem = static_cast<TextModelGroupItem*>(childItem);
-                if (groupItem->groupType() == TextGroupType::Page) {
-                    panelNumber = 1;
-                    dialogueNumber = 0;
-                    updateChildNumbering(childItem);
-
-                    auto pageItem = static_cast<ComicBookTextModelPageItem*>(childItem);
-                    pageItem->setPageNumber(pageNumber, dictionariesModel->singlePageIntros(),
-                                            dictionariesModel->multiplePageIntros());
-                    pageItem->updateCounters();
-                } else {
-                    updateChildNumbering(childItem);
-                    auto panelItem = static_cast<ComicBookTextModelPanelItem*>(childItem);
-                    panelItem->setPanelNumber(panelNumber, dictionariesModel->singlePanelIntros(),
-                                              dictionariesModel->multiplePanelIntros());
-                }
-                break;
-            }
+    case TextModelItemType::Text: {
+        auto textItem = static_cast<TextModelTextItem*>(_item);
+        if (textItem->isCorrection()) {
+            break;
+        }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<TextModelTextItem*>(childItem);
-                if (!textItem->isCorrection()) {
-                    switch (textItem->paragraphType()) {
-                    case TextParagraphType::Character: {
-                        ++dialogueNumber;
-                        Q_FALLTHROUGH();
-                    }
-
-                    case TextParagraphType::Dialogue:
-                    case TextParagraphType::Lyrics: {
-                        textItem->setNumber(dialogueNumber);
-                        q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
-                        break;
-                    }
-
-                    default: {
-                        break;
-                    }
-                    }
-                }
-                break;
-            }
+        switch (textItem->paragraphType()) {
+        case TextParagraphType::Character: {
+            ++_state.dialogueNumber;
+            Q_FALLTHROUGH();
+        }
 
-            default:
-                break;
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (!textItem->number().has_value()
+                || textItem->number()->value != _state.dialogueNumber) {
+                textItem->setNumber(_state.dialogueNumber);
+                q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
             }
+            break;
         }
-    };
-    updateChildNumbering(rootItem());
+
+        default: {
+            break;
+        }
+        }
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
 }
 
+void ComicBookTextModel::Implementation::updateGroupNumber(TextModelItem* _item,
+                                                           NumberingState& _state)
+{
+    if (_item->type() != TextModelItemType::Group) {
+        return;
+    }
+
+    //
+    // Уведомляем об изменении только тех страниц и панелей, у которых изменился номер или
+    // счётчики, т.к. вместе с номером страницы меняется и признак ошибки в чётности разворота
+    //
+    const auto groupItem = static_cast<TextModelGroupItem*>(_item);
+    if (groupItem->groupType() == TextGroupType::Page) {
+        auto pageItem = static_cast<ComicBookTextModelPageItem*>(groupItem);
+        const auto panelsCount = pageItem->panelsCount();
+        const auto dialoguesWordsCount = pageItem->dialoguesWordsCount();
+        const bool isNumberChanged
+            = pageItem->setPageNumber(_state.pageNumber, dictionariesModel->singlePageIntros(),
+                                      dictionariesModel->multiplePageIntros());
+        pageItem->updateCounters();
+        if (isNumberChanged || pageItem->panelsCount() != panelsCount
+            || pageItem->dialoguesWordsCount() != dialoguesWordsCount) {
+            pageItem->setChanged(true);
+            q->updateItem(pageItem);
+        }
+    } else {
+        auto panelItem = static_cast<ComicBookTextModelPanelItem*>(groupItem);
+        if (panelItem->setPanelNumber(_state.panelNumber, dictionariesModel->singlePanelIntros(),
+                                      dictionariesModel->multiplePanelIntros())) {
+            q->updateItem(panelItem);
+        }
+    }
+}
+
+void ComicBookTextModel::Implementation::updateNumbering()
+{
+    numbering.update(rootItem(), {});
+}
 
 // ****
 
@@ -162,15 +221,44 @@ ComicBookTextModel::ComicBookTextModel(QObject* _parent)
     : TextModel(_parent, ComicBookTextModel::createFolderItem(TextFolderType::Root))
     , d(new Implementation(this))
 {
-    auto updateNumbering = [this] { d->updateNumbering(); };
-
     //
     // Обновляем счётчики после того, как операции вставки и удаления будут обработаны клиентами
     // модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели может
     // приводить к падению внутри них
     //
-    connect(this, &ComicBookTextModel::afterRowsInserted, this, updateNumbering);
-    connect(this, &ComicBookTextModel::afterRowsRemoved, this, updateNumbering);
+    // ... номера пересчитываем начиная с первого затронутого элемента
+    //
+    connect(this, &ComicBookTextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _last);
+            });
+    connect(this, &ComicBookTextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _first - 1);
+            });
+    //
+    // ... удаляемые элементы забываем, пока они ещё существуют
+    //
+    connect(this, &ComicBookTextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->numbering.forget(parentItem->childAt(row));
+                }
+            });
+    //
+    // ... а изменённые без вставки и удаления строк элементы (например, заголовок страницы,
+    //     определяющий её разворот) пересчитаем при следующем обновлении
+    //
+    connect(this, &ComicBookTextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    d->numbering.markChanged(itemForIndex(_topLeft.siblingAtRow(row)));
+                }
+            });
+    connect(this, &ComicBookTextModel::modelReset, this, [this] { d->numbering.clear(); });
 
     connect(this, &ComicBookTextModel::contentsChanged, this,
             [this] { d->needUpdateRuntimeDictionaries = true; });
@@ -261,111 +349,28 @@ void ComicBookTextModel::createCharacter(const QString& _name)
     d->charactersModel->createCharacter(_name);
 }
 
-void ComicBookTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
+void ComicBookTextModel::updateCharacterName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<TextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::Character
-                    && ComicBookCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(QString("\\b(%1)\\b").arg(oldName),
-                                                         QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
+    const auto& oldName = _replacement.oldName();
+    _replacement.apply(this, [&_replacement, &oldName](const TextModelTextItem* _item,
+                                                       QString& _text) {
+        if (_item->paragraphType() == TextParagraphType::Character
+            && ComicBookCharacterParser::name(_text) == oldName) {
+            return _replacement.replaceFirst(_text);
         }
-    };
 
-    emit rowsAboutToBeChanged();
-    updateCharacterBlock(d->rootItem());
-    emit rowsChanged();
+        return _replacement.replaceMentions(_text);
+    });
 }
 
 QVector<QModelIndex> ComicBookTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QString lastCharacter;
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = ComicBookCharacterParser::name(textItem->text());
-                break;
-            }
-
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
-
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                lastCharacter.clear();
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
-        }
-    }
+    return d->dialoguesIndex->dialogues(_name);
+}
 
-    return dialoguesIndexes;
+int ComicBookTextModel::characterDialoguesCount(const QString& _name) const
+{
+    return d->dialoguesIndex->dialoguesCount(_name);
 }
 
 QSet<QString> ComicBookTextModel::findCharactersFromText() const
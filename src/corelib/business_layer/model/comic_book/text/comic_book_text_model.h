@@ -9,6 +9,7 @@ class CharacterModel;
 class CharactersModel;
 class ComicBookDictionariesModel;
 class ComicBookInformationModel;
+class TextModelNameReplacement;
 
 /**
  * @brief Модель текста комикса
@@ -59,13 +60,18 @@ public:
     /**
      * @brief Обновить имя персонажа
      */
-    void updateCharacterName(const QString& _oldName, const QString& _newName);
+    void updateCharacterName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Получить список реплик персонажа
      */
     QVector<QModelIndex> characterDialogues(const QString& _name) const;
 
+    /**
+     * @brief Получить количество реплик персонажа
+     */
+    int characterDialoguesCount(const QString& _name) const;
+
     /**
      * @brief Найти всех персонажей сценария
      */
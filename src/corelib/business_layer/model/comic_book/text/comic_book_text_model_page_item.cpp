@@ -55,7 +55,7 @@ std::optional<ComicBookTextModelPageItem::PageNumber> ComicBookTextModelPageItem
     return d->number;
 }
 
-void ComicBookTextModelPageItem::setPageNumber(int& _fromNumber,
+bool ComicBookTextModelPageItem::setPageNumber(int& _fromNumber,
                                                const QStringList& _singlePageIntros,
                                                const QStringList& _multiplePageIntros)
 {
@@ -76,14 +76,13 @@ void ComicBookTextModelPageItem::setPageNumber(int& _fromNumber,
     }
     _fromNumber += newNumber.pageCount;
     if (d->number.has_value() && d->number->text == newNumber.text) {
-        return;
+        return false;
     }
 
     d->number = { newNumber };
-    //
-    // Т.к. пока мы не сохраняем номера, в указании, что произошли изменения нет смысла
-    //
-    //    setChanged(true);
+    setChanged(true);
+
+    return true;
 }
 
 int ComicBookTextModelPageItem::panelsCount() const
@@ -149,8 +148,13 @@ void ComicBookTextModelPageItem::handleChange()
         auto child = childAt(childIndex);
         switch (child->type()) {
         case TextModelItemType::Group: {
+            //
+            // Только что вставленная панель ещё не пронумерована, поэтому до нумерации считаем её
+            // одинарной, а точное количество посчитаем при выходе из страницы во время нумерации
+            //
             auto childItem = static_cast<ComicBookTextModelPanelItem*>(child);
-            d->panelsCount += childItem->panelNumber()->panelCount;
+            const auto panelNumber = childItem->panelNumber();
+            d->panelsCount += panelNumber.has_value() ? panelNumber->panelCount : 1;
             d->dialoguesWordsCount += childItem->dialoguesWordsCount();
             break;
         }
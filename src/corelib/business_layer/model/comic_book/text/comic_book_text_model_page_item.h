@@ -39,7 +39,7 @@ public:
      * @brief Номер страницы
      */
     std::optional<PageNumber> pageNumber() const;
-    void setPageNumber(int& _fromNumber, const QStringList& _singlePageIntros,
+    bool setPageNumber(int& _fromNumber, const QStringList& _singlePageIntros,
                        const QStringList& _multiplePageIntros);
 
     /**
@@ -51,7 +51,7 @@ std::optional<ComicBookTextModelPanelItem::PanelNumber> ComicBookTextModelPanelI
     return d->number;
 }
 
-void ComicBookTextModelPanelItem::setPanelNumber(int& _fromNumber,
+bool ComicBookTextModelPanelItem::setPanelNumber(int& _fromNumber,
                                                  const QStringList& _singlePanelIntros,
                                                  const QStringList& _multiplePanelIntros)
 {
@@ -93,14 +93,13 @@ void ComicBookTextModelPanelItem::setPanelNumber(int& _fromNumber,
     }
     _fromNumber += newNumber.panelCount;
     if (d->number.has_value() && d->number->text == newNumber.text) {
-        return;
+        return false;
     }
 
     d->number = { newNumber };
-    //
-    // Т.к. пока мы не сохраняем номера, в указании, что произошли изменения нет смысла
-    //
-    //    setChanged(true);
+    setChanged(true);
+
+    return true;
 }
 
 int ComicBookTextModelPanelItem::dialoguesWordsCount() const
@@ -37,7 +37,7 @@ public:
      * @brief Номер панели
      */
     std::optional<PanelNumber> panelNumber() const;
-    void setPanelNumber(int& _fromNumber, const QStringList& _singlePanelIntros,
+    bool setPanelNumber(int& _fromNumber, const QStringList& _singlePanelIntros,
                         const QStringList& _multiplePanelIntros);
 
     /**
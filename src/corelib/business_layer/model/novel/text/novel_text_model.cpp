@@ -10,13 +10,13 @@
 #include <business_layer/model/characters/characters_model.h>
 #include <business_layer/model/locations/locations_model.h>
 #include <business_layer/model/novel/novel_information_model.h>
+#include <business_layer/model/text/text_model_dialogues_index.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
 #include <business_layer/templates/novel_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
-#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 
-#include <QRegularExpression>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -48,6 +48,11 @@ public:
      */
     NovelTextModel* q = nullptr;
 
+    /**
+     * @brief Индекс реплик персонажей
+     */
+    TextModelDialoguesIndex* dialoguesIndex = nullptr;
+
     /**
      * @brief Модель информации о проекте
      */
@@ -82,6 +87,7 @@ public:
 
 NovelTextModel::Implementation::Implementation(NovelTextModel* _q)
     : q(_q)
+    , dialoguesIndex(new TextModelDialoguesIndex(_q, &NovelCharacterParser::name))
 {
 }
 
@@ -228,137 +234,31 @@ void NovelTextModel::createCharacter(const QString& _name)
     d->charactersModel->createCharacter(_name);
 }
 
-void NovelTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
+void NovelTextModel::updateCharacterName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<NovelTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::SceneCharacters
-                    && NovelSceneCharactersParser::characters(textItem->text()).contains(oldName)) {
-                    auto text = textItem->text();
-                    auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                    while (nameIndex != -1) {
-                        //
-                        // Убедимся, что выделено именно имя, а не часть другого имени
-                        //
-                        const auto nameEndIndex = nameIndex + oldName.length();
-                        const bool atLeftAllOk = nameIndex == 0 || text.at(nameIndex - 1) == ','
-                            || (nameIndex > 2 && text.mid(nameIndex - 2, 2) == ", ");
-                        const bool atRightAllOk = nameEndIndex == text.length()
-                            || text.at(nameEndIndex) == ','
-                            || (text.length() > nameEndIndex + 1
-                                && text.mid(nameEndIndex, 2) == " ,");
-                        if (!atLeftAllOk || !atRightAllOk) {
-                            nameIndex = TextHelper::smartToUpper(text).indexOf(oldName, nameIndex);
-                            continue;
-                        }
-
-                        text.remove(nameIndex, oldName.length());
-                        text.insert(nameIndex, _newName);
-                        textItem->setText(text);
-                        updateItem(textItem);
-                        break;
-                    }
-                } else if (textItem->paragraphType() == TextParagraphType::Character
-                           && NovelCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(QString("\\b(%1)\\b").arg(oldName),
-                                                         QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
+    const auto& oldName = _replacement.oldName();
+    _replacement.apply(this, [&_replacement, &oldName](const TextModelTextItem* _item,
+                                                       QString& _text) {
+        if (_item->paragraphType() == TextParagraphType::SceneCharacters
+            && NovelSceneCharactersParser::characters(_text).contains(oldName)) {
+            return _replacement.replaceInList(_text);
+        } else if (_item->paragraphType() == TextParagraphType::Character
+                   && NovelCharacterParser::name(_text) == oldName) {
+            return _replacement.replaceFirst(_text);
         }
-    };
 
-    emit rowsAboutToBeChanged();
-    updateCharacterBlock(d->rootItem());
-    emit rowsChanged();
+        return _replacement.replaceMentions(_text);
+    });
 }
 
 QVector<QModelIndex> NovelTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QString lastCharacter;
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = NovelCharacterParser::name(textItem->text());
-                break;
-            }
-
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
-
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                lastCharacter.clear();
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
-        }
-    }
+    return d->dialoguesIndex->dialogues(_name);
+}
 
-    return dialoguesIndexes;
+int NovelTextModel::characterDialoguesCount(const QString& _name) const
+{
+    return d->dialoguesIndex->dialoguesCount(_name);
 }
 
 QSet<QString> NovelTextModel::findCharactersFromText() const
@@ -451,44 +351,13 @@ QSet<QString> NovelTextModel::findLocationsFromText() const
     return locations;
 }
 
-void NovelTextModel::updateLocationName(const QString& _oldName, const QString& _newName)
-{
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateLocationBlock;
-    updateLocationBlock
-        = [this, oldName, _newName, &updateLocationBlock](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      updateLocationBlock(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<NovelTextModelTextItem*>(childItem);
-                      if (textItem->paragraphType() == TextParagraphType::SceneHeading
-                          && NovelSceneHeadingParser::location(textItem->text()) == oldName) {
-                          auto text = textItem->text();
-                          const auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                          text.remove(nameIndex, oldName.length());
-                          text.insert(nameIndex, _newName);
-                          textItem->setText(text);
-                          updateItem(textItem);
-                      }
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
-
-    emit rowsAboutToBeChanged();
-    updateLocationBlock(d->rootItem());
-    emit rowsChanged();
+void NovelTextModel::updateLocationName(const TextModelNameReplacement& _replacement)
+{
+    _replacement.apply(this, [&_replacement](const TextModelTextItem* _item, QString& _text) {
+        return _item->paragraphType() == TextParagraphType::SceneHeading
+            && NovelSceneHeadingParser::location(_text) == _replacement.oldName()
+            && _replacement.replaceFirst(_text);
+    });
 }
 
 int NovelTextModel::outlinePageCount() const
@@ -11,6 +11,7 @@ class LocationModel;
 class LocationsModel;
 class NovelDictionariesModel;
 class NovelInformationModel;
+class TextModelNameReplacement;
 
 /**
  * @brief Модель текста сценария
@@ -66,13 +67,18 @@ public:
     /**
      * @brief Обновить имя персонажа
      */
-    void updateCharacterName(const QString& _oldName, const QString& _newName);
+    void updateCharacterName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Получить список реплик персонажа
      */
     QVector<QModelIndex> characterDialogues(const QString& _name) const;
 
+    /**
+     * @brief Получить количество реплик персонажа
+     */
+    int characterDialoguesCount(const QString& _name) const;
+
     /**
      * @brief Найти всех персонажей сценария
      */
@@ -102,7 +108,7 @@ public:
     /**
      * @brief Обновить название локации
      */
-    void updateLocationName(const QString& _oldName, const QString& _newName);
+    void updateLocationName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Количество страниц текста поэпизодника
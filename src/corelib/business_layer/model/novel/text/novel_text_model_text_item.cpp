@@ -78,11 +78,12 @@ void NovelTextModelTextItem::updateCounters()
     //
     // Считаем
     //
-    const auto wordsCount = TextHelper::wordsCount(text());
+    const auto textCounters = TextHelper::counters(text());
+    const auto wordsCount = textCounters.words;
     //
-    const auto charactersCountFirst = text().length() - text().count(' ');
+    const auto charactersCountFirst = textCounters.charactersWithoutSpaces;
     const auto charactersCountSecond
-        = text().length() + 1; // всегда добавляем единичку за перенос строки
+        = textCounters.characters + 1; // всегда добавляем единичку за перенос строки
 
     //
     // Если не было изменений, то и ладно, выходим тогда
@@ -0,0 +1,383 @@
+#include "screenplay_breakdown_index.h"
+
+#include "screenplay_text_model.h"
+#include "screenplay_text_model_scene_item.h"
+
+#include <business_layer/model/screenplay/screenplay_dictionaries_model.h>
+#include <utils/tools/model_index_path.h>
+
+#include <QHash>
+#include <QPointer>
+
+#include <algorithm>
+
+
+namespace BusinessLayer {
+
+class ScreenplayBreakdownIndex::Implementation
+{
+public:
+    explicit Implementation(ScreenplayTextModel* _model);
+
+    /**
+     * @brief Построить индекс, если он ещё не построен
+     */
+    void build();
+
+    /**
+     * @brief Очистить индекс
+     */
+    void clear();
+
+    /**
+     * @brief Обновить ресурсы всех сцен элемента и его детей
+     */
+    void processItem(TextModelItem* _item);
+
+    /**
+     * @brief Обновить ресурсы сцены, если они изменились
+     */
+    void updateScene(ScreenplayTextModelSceneItem* _scene);
+
+    /**
+     * @brief Убрать из индекса ресурсы всех сцен элемента и его детей перед удалением из модели
+     */
+    void forget(TextModelItem* _item);
+
+    /**
+     * @brief Добавить в индекс и убрать из него ресурс сцены
+     */
+    void addSceneResource(ScreenplayTextModelSceneItem* _scene,
+                          const BreakdownSceneResource& _resource);
+    void removeSceneResource(ScreenplayTextModelSceneItem* _scene,
+                             const BreakdownSceneResource& _resource);
+
+    /**
+     * @brief Обновить категории ресурсов из справочников и пересчитать сводки по категориям
+     */
+    void updateCategories();
+
+
+    ScreenplayTextModel* model = nullptr;
+    QPointer<ScreenplayDictionariesModel> dictionariesModel;
+
+    /**
+     * @brief Построен ли индекс
+     */
+    bool isBuilt = false;
+
+    /**
+     * @brief Ресурсы сцен на момент последнего обновления индекса
+     */
+    QHash<ScreenplayTextModelSceneItem*, QVector<BreakdownSceneResource>> scenesResources;
+
+    /**
+     * @brief Сцены ресурсов с количеством единиц ресурса в каждой из них
+     */
+    QHash<QUuid, QHash<ScreenplayTextModelSceneItem*, int>> resourcesScenes;
+
+    /**
+     * @brief Категории ресурсов
+     */
+    QHash<QUuid, QUuid> resourcesCategories;
+
+    /**
+     * @brief Данные для сводки по категории
+     */
+    struct CategoryData {
+        int resourcesCount = 0;
+        QHash<ScreenplayTextModelSceneItem*, int> scenesResourcesCount;
+        int qty = 0;
+    };
+    QHash<QUuid, CategoryData> categories;
+};
+
+ScreenplayBreakdownIndex::Implementation::Implementation(ScreenplayTextModel* _model)
+    : model(_model)
+{
+}
+
+void ScreenplayBreakdownIndex::Implementation::build()
+{
+    if (isBuilt) {
+        return;
+    }
+
+    clear();
+    updateCategories();
+    processItem(model->itemForIndex({}));
+    isBuilt = true;
+}
+
+void ScreenplayBreakdownIndex::Implementation::clear()
+{
+    isBuilt = false;
+    scenesResources.clear();
+    resourcesScenes.clear();
+    categories.clear();
+}
+
+void ScreenplayBreakdownIndex::Implementation::processItem(TextModelItem* _item)
+{
+    if (_item->type() == TextModelItemType::Group
+        && static_cast<TextModelGroupItem*>(_item)->groupType() == TextGroupType::Scene) {
+        updateScene(static_cast<ScreenplayTextModelSceneItem*>(_item));
+        //
+        // ... ресурсы задаются только для сцен, поэтому в детей сцены не заглядываем
+        //
+        return;
+    }
+
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        processItem(_item->childAt(childIndex));
+    }
+}
+
+void ScreenplayBreakdownIndex::Implementation::updateScene(ScreenplayTextModelSceneItem* _scene)
+{
+    const auto resources = _scene->resources();
+    auto iter = scenesResources.find(_scene);
+    if (iter == scenesResources.end()) {
+        if (resources.isEmpty()) {
+            return;
+        }
+
+        iter = scenesResources.insert(_scene, {});
+    } else if (iter.value() == resources) {
+        return;
+    }
+
+    for (const auto& resource : std::as_const(iter.value())) {
+        removeSceneResource(_scene, resource);
+    }
+    for (const auto& resource : resources) {
+        addSceneResource(_scene, resource);
+    }
+
+    if (resources.isEmpty()) {
+        scenesResources.erase(iter);
+    } else {
+        iter.value() = resources;
+    }
+}
+
+void ScreenplayBreakdownIndex::Implementation::forget(TextModelItem* _item)
+{
+    if (_item->type() == TextModelItemType::Group
+        && static_cast<TextModelGroupItem*>(_item)->groupType() == TextGroupType::Scene) {
+        const auto scene = static_cast<ScreenplayTextModelSceneItem*>(_item);
+        const auto resources = scenesResources.take(scene);
+        for (const auto& resource : resources) {
+            removeSceneResource(scene, resource);
+        }
+        return;
+    }
+
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        forget(_item->childAt(childIndex));
+    }
+}
+
+void ScreenplayBreakdownIndex::Implementation::addSceneResource(
+    ScreenplayTextModelSceneItem* _scene, const BreakdownSceneResource& _resource)
+{
+    auto& resourceScenes = resourcesScenes[_resource.uuid];
+    auto& category = categories[resourcesCategories.value(_resource.uuid)];
+    if (resourceScenes.isEmpty()) {
+        ++category.resourcesCount;
+    }
+    resourceScenes.insert(_scene, _resource.qty);
+    ++category.scenesResourcesCount[_scene];
+    category.qty += _resource.qty;
+}
+
+void ScreenplayBreakdownIndex::Implementation::removeSceneResource(
+    ScreenplayTextModelSceneItem* _scene, const BreakdownSceneResource& _resource)
+{
+    const auto resourceScenes = resourcesScenes.find(_resource.uuid);
+    if (resourceScenes == resourcesScenes.end() || !resourceScenes->contains(_scene)) {
+        return;
+    }
+
+    resourceScenes->remove(_scene);
+    const auto categoryUuid = resourcesCategories.value(_resource.uuid);
+    auto& category = categories[categoryUuid];
+    if (resourceScenes->isEmpty()) {
+        resourcesScenes.erase(resourceScenes);
+        --category.resourcesCount;
+    }
+    auto sceneResourcesCount = category.scenesResourcesCount.find(_scene);
+    if (--sceneResourcesCount.value() == 0) {
+        category.scenesResourcesCount.erase(sceneResourcesCount);
+    }
+    category.qty -= _resource.qty;
+    if (category.resourcesCount == 0) {
+        categories.remove(categoryUuid);
+    }
+}
+
+void ScreenplayBreakdownIndex::Implementation::updateCategories()
+{
+    QHash<QUuid, QUuid> newResourcesCategories;
+    if (!dictionariesModel.isNull()) {
+        const auto resources = dictionariesModel->resources();
+        for (const auto& resource : resources) {
+            newResourcesCategories.insert(resource.uuid, resource.categoryUuid);
+        }
+    }
+    if (newResourcesCategories == resourcesCategories) {
+        return;
+    }
+
+    resourcesCategories = newResourcesCategories;
+
+    //
+    // Справочник меняется редко, поэтому при смене категорий просто пересчитываем все сводки
+    //
+    categories.clear();
+    for (auto scene = scenesResources.cbegin(); scene != scenesResources.cend(); ++scene) {
+        for (const auto& resource : scene.value()) {
+            auto& category = categories[resourcesCategories.value(resource.uuid)];
+            ++category.scenesResourcesCount[scene.key()];
+            category.qty += resource.qty;
+        }
+    }
+    for (auto resource = resourcesScenes.cbegin(); resource != resourcesScenes.cend();
+         ++resource) {
+        ++categories[resourcesCategories.value(resource.key())].resourcesCount;
+    }
+}
+
+
+// ****
+
+
+ScreenplayBreakdownIndex::ScreenplayBreakdownIndex(ScreenplayTextModel* _model)
+    : QObject(_model)
+    , d(new Implementation(_model))
+{
+    //
+    // Пока к индексу не обращались, не тратим время на его обновление
+    //
+    connect(_model, &TextModel::modelAboutToBeReset, this, [this] { d->clear(); });
+    connect(_model, &TextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                if (!d->isBuilt) {
+                    return;
+                }
+
+                const auto parentItem = d->model->itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->processItem(parentItem->childAt(row));
+                }
+            });
+    connect(_model, &TextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                if (!d->isBuilt) {
+                    return;
+                }
+
+                const auto parentItem = d->model->itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->forget(parentItem->childAt(row));
+                }
+            });
+    //
+    // ... изменение ресурсов сцены приходит как изменение самой сцены, а изменения текста внутри
+    //     сцены сравниваются с запомненными ресурсами и отсеиваются без обновления индекса
+    //
+    connect(_model, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                if (!d->isBuilt || !_topLeft.isValid()) {
+                    return;
+                }
+
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    auto item = d->model->itemForIndex(_topLeft.siblingAtRow(row));
+                    if (item->type() == TextModelItemType::Group
+                        && static_cast<TextModelGroupItem*>(item)->groupType()
+                            == TextGroupType::Scene) {
+                        d->updateScene(static_cast<ScreenplayTextModelSceneItem*>(item));
+                    }
+                }
+            });
+}
+
+ScreenplayBreakdownIndex::~ScreenplayBreakdownIndex() = default;
+
+void ScreenplayBreakdownIndex::setDictionariesModel(ScreenplayDictionariesModel* _model)
+{
+    if (!d->dictionariesModel.isNull()) {
+        d->dictionariesModel->disconnect(this);
+    }
+
+    d->dictionariesModel = _model;
+
+    if (d->dictionariesModel.isNull()) {
+        return;
+    }
+
+    connect(d->dictionariesModel, &ScreenplayDictionariesModel::resourcesChanged, this, [this] {
+        if (d->isBuilt) {
+            d->updateCategories();
+        }
+    });
+    if (d->isBuilt) {
+        d->updateCategories();
+    }
+}
+
+QVector<QModelIndex> ScreenplayBreakdownIndex::resourceScenes(const QUuid& _resourceUuid) const
+{
+    d->build();
+
+    const auto scenes = d->resourcesScenes.constFind(_resourceUuid);
+    if (scenes == d->resourcesScenes.constEnd()) {
+        return {};
+    }
+
+    QVector<QModelIndex> indexes;
+    indexes.reserve(scenes->size());
+    for (auto scene = scenes->cbegin(); scene != scenes->cend(); ++scene) {
+        indexes.append(d->model->indexForItem(scene.key()));
+    }
+    std::sort(indexes.begin(), indexes.end(),
+              [](const QModelIndex& _lhs, const QModelIndex& _rhs) {
+                  return ModelIndexPath(_lhs) < ModelIndexPath(_rhs);
+              });
+    return indexes;
+}
+
+ScreenplayBreakdownIndex::Totals ScreenplayBreakdownIndex::resourceTotals(
+    const QUuid& _resourceUuid) const
+{
+    d->build();
+
+    const auto scenes = d->resourcesScenes.constFind(_resourceUuid);
+    if (scenes == d->resourcesScenes.constEnd()) {
+        return {};
+    }
+
+    Totals totals;
+    totals.resourcesCount = 1;
+    totals.scenesCount = scenes->size();
+    for (const auto qty : *scenes) {
+        totals.qty += qty;
+    }
+    return totals;
+}
+
+ScreenplayBreakdownIndex::Totals ScreenplayBreakdownIndex::categoryTotals(
+    const QUuid& _categoryUuid) const
+{
+    d->build();
+
+    const auto category = d->categories.constFind(_categoryUuid);
+    if (category == d->categories.constEnd()) {
+        return {};
+    }
+
+    return { category->resourcesCount, category->scenesResourcesCount.size(), category->qty };
+}
+
+} // namespace BusinessLayer
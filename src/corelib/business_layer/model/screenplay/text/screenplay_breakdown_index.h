@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QObject>
+
+#include <corelib_global.h>
+
+class QModelIndex;
+class QUuid;
+
+
+namespace BusinessLayer {
+
+class ScreenplayDictionariesModel;
+class ScreenplayTextModel;
+
+/**
+ * @brief Индекс ресурсов разработки сценария
+ *
+ * Для каждого ресурса хранятся сцены, в которых он задействован, а для каждой категории ресурсов -
+ * сводка по всем её ресурсам. Индекс строится при первом обращении, а затем обновляется по
+ * сигналам модели только для вставленных, удалённых и изменившихся сцен, поэтому получение сцен
+ * ресурса и сводок по ресурсам и категориям не требует обхода модели.
+ */
+class CORE_LIBRARY_EXPORT ScreenplayBreakdownIndex : public QObject
+{
+public:
+    /**
+     * @brief Сводка по использованию ресурсов
+     */
+    struct Totals {
+        /**
+         * @brief Количество задействованных ресурсов
+         */
+        int resourcesCount = 0;
+
+        /**
+         * @brief Количество сцен, в которых задействованы ресурсы
+         */
+        int scenesCount = 0;
+
+        /**
+         * @brief Суммарное количество единиц ресурсов во всех сценах
+         */
+        int qty = 0;
+    };
+
+public:
+    explicit ScreenplayBreakdownIndex(ScreenplayTextModel* _model);
+    ~ScreenplayBreakdownIndex() override;
+
+    /**
+     * @brief Задать модель справочников, из которой берутся категории ресурсов
+     */
+    void setDictionariesModel(ScreenplayDictionariesModel* _model);
+
+    /**
+     * @brief Сцены, в которых задействован ресурс, в порядке следования в документе
+     */
+    QVector<QModelIndex> resourceScenes(const QUuid& _resourceUuid) const;
+
+    /**
+     * @brief Сводка по ресурсу
+     */
+    Totals resourceTotals(const QUuid& _resourceUuid) const;
+
+    /**
+     * @brief Сводка по категории ресурсов
+     * @note Сцена, в которой задействовано несколько ресурсов категории, учитывается один раз
+     */
+    Totals categoryTotals(const QUuid& _categoryUuid) const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
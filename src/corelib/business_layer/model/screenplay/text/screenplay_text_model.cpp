@@ -1,5 +1,6 @@
 #include "screenplay_text_model.h"
 
+#include "screenplay_breakdown_index.h"
 #include "screenplay_text_block_parser.h"
 #include "screenplay_text_model_beat_item.h"
 #include "screenplay_text_model_folder_item.h"
@@ -11,13 +12,14 @@
 #include <business_layer/model/locations/location_model.h>
 #include <business_layer/model/locations/locations_model.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
+#include <business_layer/model/text/text_model_dialogues_index.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_numbering.h>
 #include <business_layer/templates/screenplay_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
-#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 
-#include <QRegularExpression>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -43,12 +45,57 @@ public:
      */
     void updateChildrenDuration(const TextModelItem* _item, bool _force = false);
 
+    /**
+     * @brief Состояние счётчиков номеров сцен и реплик
+     */
+    struct NumberingState {
+        int sceneNumber = 0;
+        int dialogueNumber = 0;
+        QString lastLockedSceneFullNumber;
+
+        bool operator==(const NumberingState& _other) const
+        {
+            return sceneNumber == _other.sceneNumber && dialogueNumber == _other.dialogueNumber
+                && lastLockedSceneFullNumber == _other.lastLockedSceneFullNumber;
+        }
+    };
+
+    /**
+     * @brief Состояние счётчиков в начале документа
+     */
+    NumberingState initialNumberingState() const;
+
+    /**
+     * @brief Пронумеровать реплику
+     */
+    void updateTextNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Пронумеровать сцену
+     */
+    void updateSceneNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Посчитать количество сцен в элементе и всех его детях
+     */
+    int countScenes(const TextModelItem* _item) const;
+
 
     /**
      * @brief Родительский элемент
      */
     ScreenplayTextModel* q = nullptr;
 
+    /**
+     * @brief Индекс реплик персонажей
+     */
+    TextModelDialoguesIndex* dialoguesIndex = nullptr;
+
+    /**
+     * @brief Индекс ресурсов разработки
+     */
+    ScreenplayBreakdownIndex* breakdownIndex = nullptr;
+
     /**
      * @brief Модель информации о проекте
      */
@@ -90,10 +137,21 @@ public:
      * @brief Количество сцен
      */
     int scenesCount = 0;
+
+    /**
+     * @brief Нумерация сцен и реплик
+     */
+    TextModelNumbering<NumberingState> numbering;
 };
 
 ScreenplayTextModel::Implementation::Implementation(ScreenplayTextModel* _q)
     : q(_q)
+    , dialoguesIndex(new TextModelDialoguesIndex(_q, &ScreenplayCharacterParser::name))
+    , breakdownIndex(new ScreenplayBreakdownIndex(_q))
+    , numbering([this](TextModelItem* _item,
+                       NumberingState& _state) { updateTextNumber(_item, _state); },
+                [this](TextModelItem* _item,
+                       NumberingState& _state) { updateSceneNumber(_item, _state); })
 {
 }
 
@@ -130,6 +188,120 @@ void ScreenplayTextModel::Implementation::updateChildrenDuration(const TextModel
     }
 }
 
+ScreenplayTextModel::Implementation::NumberingState ScreenplayTextModel::Implementation::
+    initialNumberingState() const
+{
+    return { informationModel->scenesNumberingStartAt(), 0, {} };
+}
+
+void ScreenplayTextModel::Implementation::updateTextNumber(TextModelItem* _item,
+                                                           NumberingState& _state)
+{
+    if (_item->type() != TextModelItemType::Text) {
+        return;
+    }
+
+    auto textItem = static_cast<ScreenplayTextModelTextItem*>(_item);
+    if (textItem->isCorrection()) {
+        return;
+    }
+
+    switch (textItem->paragraphType()) {
+    case TextParagraphType::Character: {
+        ++_state.dialogueNumber;
+        Q_FALLTHROUGH();
+    }
+
+    case TextParagraphType::Dialogue:
+    case TextParagraphType::Lyrics: {
+        if (!textItem->number().has_value()
+            || textItem->number()->value != _state.dialogueNumber) {
+            textItem->setNumber(_state.dialogueNumber);
+            q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
+        }
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+}
+
+void ScreenplayTextModel::Implementation::updateSceneNumber(TextModelItem* _item,
+                                                            NumberingState& _state)
+{
+    if (_item->type() != TextModelItemType::Group) {
+        return;
+    }
+
+    auto groupItem = static_cast<TextModelGroupItem*>(_item);
+    if (groupItem->groupType() != TextGroupType::Scene) {
+        return;
+    }
+
+    const auto oldNumber = groupItem->number();
+
+    //
+    // Если у сцены номер заблокирован, то запоминаем последний заблокированный для работы с
+    // номерами незаблокированных сцен и сбрасываем счётчик номеров
+    //
+    if (groupItem->number().has_value() && groupItem->number()->isLocked) {
+        _state.lastLockedSceneFullNumber
+            = groupItem->number()->followNumber + groupItem->number()->value;
+        _state.sceneNumber = 0;
+    }
+    //
+    // Если у сцены задан кастомный номер, то не меняем его
+    //
+    else if (groupItem->number().has_value() && groupItem->number()->isCustom) {
+        //
+        // ... но при необходимости переводим счётчик номеров сцен
+        //
+        if (groupItem->number()->isEatNumber) {
+            ++_state.sceneNumber;
+        }
+    }
+    //
+    // А если номера назначаются автоматически, то задаём очередной номер
+    //
+    else {
+        if (groupItem->setNumber(_state.sceneNumber, _state.lastLockedSceneFullNumber)) {
+            ++_state.sceneNumber;
+        }
+    }
+
+    //
+    // После того, как номер сформирован, декорируем его
+    //
+    groupItem->prepareNumberText(informationModel->scenesNumbersTemplate());
+
+    //
+    // Уведомляем клиентов модели, только если номер действительно изменился
+    //
+    const auto newNumber = groupItem->number();
+    if (oldNumber.has_value() != newNumber.has_value()
+        || (newNumber.has_value()
+            && (oldNumber->value != newNumber->value
+                || oldNumber->followNumber != newNumber->followNumber
+                || oldNumber->text != newNumber->text))) {
+        q->updateItem(groupItem);
+    }
+}
+
+int ScreenplayTextModel::Implementation::countScenes(const TextModelItem* _item) const
+{
+    int count = 0;
+    if (_item->type() == TextModelItemType::Group
+        && static_cast<const TextModelGroupItem*>(_item)->groupType() == TextGroupType::Scene) {
+        ++count;
+    }
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        count += countScenes(_item->childAt(childIndex));
+    }
+    return count;
+}
+
 
 // ****
 
@@ -138,17 +310,52 @@ ScreenplayTextModel::ScreenplayTextModel(QObject* _parent)
     : TextModel(_parent, ScreenplayTextModel::createFolderItem(TextFolderType::Root))
     , d(new Implementation(this))
 {
-    auto updateCounters = [this](const QModelIndex& _index) {
-        updateNumbering();
-        d->updateChildrenDuration(itemForIndex(_index));
-    };
     //
     // Обновляем счётчики после того, как операции вставки и удаления будут обработаны клиентами
     // модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели может
     // приводить к падению внутри них
     //
-    connect(this, &ScreenplayTextModel::afterRowsInserted, this, updateCounters);
-    connect(this, &ScreenplayTextModel::afterRowsRemoved, this, updateCounters);
+    // ... номера пересчитываем начиная с первого затронутого элемента
+    //
+    connect(this, &ScreenplayTextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->scenesCount += d->countScenes(parentItem->childAt(row));
+                }
+                d->numbering.update(d->rootItem(), d->initialNumberingState(), parentItem, _first,
+                                    _last);
+                d->updateChildrenDuration(parentItem);
+            });
+    connect(this, &ScreenplayTextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), d->initialNumberingState(), parentItem, _first,
+                                    _first - 1);
+                d->updateChildrenDuration(parentItem);
+            });
+    //
+    // ... удаляемые элементы забываем, пока они ещё существуют
+    //
+    connect(this, &ScreenplayTextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    const auto item = parentItem->childAt(row);
+                    d->scenesCount -= d->countScenes(item);
+                    d->numbering.forget(item);
+                }
+            });
+    //
+    // ... а изменённые без вставки и удаления строк элементы пересчитаем при следующем обновлении
+    //
+    connect(this, &ScreenplayTextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    d->numbering.markChanged(itemForIndex(_topLeft.siblingAtRow(row)));
+                }
+            });
+    connect(this, &ScreenplayTextModel::modelReset, this, [this] { d->numbering.clear(); });
 
     connect(this, &ScreenplayTextModel::contentsChanged, this,
             [this] { d->needUpdateRuntimeDictionaries = true; });
@@ -224,6 +431,7 @@ ScreenplayInformationModel* ScreenplayTextModel::informationModel() const
 void ScreenplayTextModel::setDictionariesModel(ScreenplayDictionariesModel* _model)
 {
     d->dictionariesModel = _model;
+    d->breakdownIndex->setDictionariesModel(_model);
 }
 
 ScreenplayDictionariesModel* ScreenplayTextModel::dictionariesModel() const
@@ -231,6 +439,11 @@ ScreenplayDictionariesModel* ScreenplayTextModel::dictionariesModel() const
     return d->dictionariesModel;
 }
 
+const ScreenplayBreakdownIndex* ScreenplayTextModel::breakdownIndex() const
+{
+    return d->breakdownIndex;
+}
+
 void ScreenplayTextModel::setCharactersModel(CharactersModel* _model)
 {
     if (d->charactersModel) {
@@ -267,138 +480,31 @@ void ScreenplayTextModel::createCharacter(const QString& _name)
     d->charactersModel->createCharacter(_name);
 }
 
-void ScreenplayTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
+void ScreenplayTextModel::updateCharacterName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::SceneCharacters
-                    && ScreenplaySceneCharactersParser::characters(textItem->text())
-                           .contains(oldName)) {
-                    auto text = textItem->text();
-                    auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                    while (nameIndex != -1) {
-                        //
-                        // Убедимся, что выделено именно имя, а не часть другого имени
-                        //
-                        const auto nameEndIndex = nameIndex + oldName.length();
-                        const bool atLeftAllOk = nameIndex == 0 || text.at(nameIndex - 1) == ','
-                            || (nameIndex > 2 && text.mid(nameIndex - 2, 2) == ", ");
-                        const bool atRightAllOk = nameEndIndex == text.length()
-                            || text.at(nameEndIndex) == ','
-                            || (text.length() > nameEndIndex + 1
-                                && text.mid(nameEndIndex, 2) == " ,");
-                        if (!atLeftAllOk || !atRightAllOk) {
-                            nameIndex = TextHelper::smartToUpper(text).indexOf(oldName, nameIndex);
-                            continue;
-                        }
-
-                        text.remove(nameIndex, oldName.length());
-                        text.insert(nameIndex, _newName);
-                        textItem->setText(text);
-                        updateItem(textItem);
-                        break;
-                    }
-                } else if (textItem->paragraphType() == TextParagraphType::Character
-                           && ScreenplayCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(QString("\\b(%1)\\b").arg(oldName),
-                                                         QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
+    const auto& oldName = _replacement.oldName();
+    _replacement.apply(this, [&_replacement, &oldName](const TextModelTextItem* _item,
+                                                       QString& _text) {
+        if (_item->paragraphType() == TextParagraphType::SceneCharacters
+            && ScreenplaySceneCharactersParser::characters(_text).contains(oldName)) {
+            return _replacement.replaceInList(_text);
+        } else if (_item->paragraphType() == TextParagraphType::Character
+                   && ScreenplayCharacterParser::name(_text) == oldName) {
+            return _replacement.replaceFirst(_text);
         }
-    };
 
-    emit rowsAboutToBeChanged();
-    updateCharacterBlock(d->rootItem());
-    emit rowsChanged();
+        return _replacement.replaceMentions(_text);
+    });
 }
 
 QVector<QModelIndex> ScreenplayTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QString lastCharacter;
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = ScreenplayCharacterParser::name(textItem->text());
-                break;
-            }
-
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
-
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                lastCharacter.clear();
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
-        }
-    }
+    return d->dialoguesIndex->dialogues(_name);
+}
 
-    return dialoguesIndexes;
+int ScreenplayTextModel::characterDialoguesCount(const QString& _name) const
+{
+    return d->dialoguesIndex->dialoguesCount(_name);
 }
 
 QSet<QString> ScreenplayTextModel::findCharactersFromText() const
@@ -507,44 +613,13 @@ QSet<QString> ScreenplayTextModel::findLocationsFromText() const
     return locations;
 }
 
-void ScreenplayTextModel::updateLocationName(const QString& _oldName, const QString& _newName)
+void ScreenplayTextModel::updateLocationName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateLocationBlock;
-    updateLocationBlock
-        = [this, oldName, _newName, &updateLocationBlock](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      updateLocationBlock(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                      if (textItem->paragraphType() == TextParagraphType::SceneHeading
-                          && ScreenplaySceneHeadingParser::location(textItem->text()) == oldName) {
-                          auto text = textItem->text();
-                          const auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                          text.remove(nameIndex, oldName.length());
-                          text.insert(nameIndex, _newName);
-                          textItem->setText(text);
-                          updateItem(textItem);
-                      }
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
-
-    emit rowsAboutToBeChanged();
-    updateLocationBlock(d->rootItem());
-    emit rowsChanged();
+    _replacement.apply(this, [&_replacement](const TextModelTextItem* _item, QString& _text) {
+        return _item->paragraphType() == TextParagraphType::SceneHeading
+            && ScreenplaySceneHeadingParser::location(_text) == _replacement.oldName()
+            && _replacement.replaceFirst(_text);
+    });
 }
 
 int ScreenplayTextModel::treatmentPageCount() const
@@ -672,95 +747,8 @@ std::map<std::chrono::milliseconds, QColor> ScreenplayTextModel::itemsBookmarks(
 
 void ScreenplayTextModel::updateNumbering()
 {
-    d->scenesCount = 0;
-    int sceneNumber = d->informationModel->scenesNumberingStartAt();
-    int dialogueNumber = 0;
-    QString lastLockedSceneFullNumber;
-    std::function<void(const TextModelItem*)> updateChildNumbering;
-    updateChildNumbering = [this, &sceneNumber, &dialogueNumber, &lastLockedSceneFullNumber,
-                            &updateChildNumbering](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                updateChildNumbering(childItem);
-                break;
-            }
-
-            case TextModelItemType::Group: {
-                updateChildNumbering(childItem);
-                auto groupItem = static_cast<TextModelGroupItem*>(childItem);
-                if (groupItem->groupType() == TextGroupType::Scene) {
-                    ++d->scenesCount;
-
-                    //
-                    // Если у сцены номер заблокирован, то запоминаем последний заблокированный для
-                    // работы с номерами незаблокированных сцен и сбрасываем счётчик номеров
-                    //
-                    if (groupItem->number().has_value() && groupItem->number()->isLocked) {
-                        lastLockedSceneFullNumber
-                            = groupItem->number()->followNumber + groupItem->number()->value;
-                        sceneNumber = 0;
-                    }
-                    //
-                    // Если у сцены задан кастомный номер, то не меняем его
-                    //
-                    else if (groupItem->number().has_value() && groupItem->number()->isCustom) {
-                        //
-                        // ... но при необходимости переводим счётчик номеров сцен
-                        //
-                        if (groupItem->number()->isEatNumber) {
-                            ++sceneNumber;
-                        }
-                    }
-                    //
-                    // А если номера назначаются автоматически, то задаём очередной номер
-                    //
-                    else {
-                        if (groupItem->setNumber(sceneNumber, lastLockedSceneFullNumber)) {
-                            updateItem(groupItem);
-                            ++sceneNumber;
-                        }
-                    }
-
-                    //
-                    // После того, как номер сформирован, декорируем его
-                    //
-                    groupItem->prepareNumberText(d->informationModel->scenesNumbersTemplate());
-                }
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                if (!textItem->isCorrection()) {
-                    switch (textItem->paragraphType()) {
-                    case TextParagraphType::Character: {
-                        ++dialogueNumber;
-                        Q_FALLTHROUGH();
-                    }
-
-                    case TextParagraphType::Dialogue:
-                    case TextParagraphType::Lyrics: {
-                        textItem->setNumber(dialogueNumber);
-                        updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
-                        break;
-                    }
-
-                    default: {
-                        break;
-                    }
-                    }
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
-        }
-    };
-    updateChildNumbering(d->rootItem());
+    d->scenesCount = d->countScenes(d->rootItem());
+    d->numbering.update(d->rootItem(), d->initialNumberingState());
 }
 
 void ScreenplayTextModel::setScenesNumbersLocked(bool _locked)
@@ -9,8 +9,10 @@ class CharacterModel;
 class CharactersModel;
 class LocationModel;
 class LocationsModel;
+class ScreenplayBreakdownIndex;
 class ScreenplayDictionariesModel;
 class ScreenplayInformationModel;
+class TextModelNameReplacement;
 
 /**
  * @brief Модель текста сценария
@@ -47,6 +49,11 @@ public:
     void setDictionariesModel(ScreenplayDictionariesModel* _model);
     ScreenplayDictionariesModel* dictionariesModel() const;
 
+    /**
+     * @brief Индекс ресурсов разработки сценария
+     */
+    const ScreenplayBreakdownIndex* breakdownIndex() const;
+
     /**
      * @brief Модель персонажей проекта
      */
@@ -71,13 +78,18 @@ public:
     /**
      * @brief Обновить имя персонажа
      */
-    void updateCharacterName(const QString& _oldName, const QString& _newName);
+    void updateCharacterName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Получить список реплик персонажа
      */
     QVector<QModelIndex> characterDialogues(const QString& _name) const;
 
+    /**
+     * @brief Получить количество реплик персонажа
+     */
+    int characterDialoguesCount(const QString& _name) const;
+
     /**
      * @brief Найти всех персонажей сценария
      */
@@ -112,7 +124,7 @@ public:
     /**
      * @brief Обновить название локации
      */
-    void updateLocationName(const QString& _oldName, const QString& _newName);
+    void updateLocationName(const TextModelNameReplacement& _replacement);
 
     /**
      * @brief Количество страниц текста поэпизодника
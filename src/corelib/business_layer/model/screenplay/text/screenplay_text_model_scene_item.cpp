@@ -178,6 +178,7 @@ void ScreenplayTextModelSceneItem::copyFrom(TextModelItem* _item)
 
     auto sceneItem = static_cast<ScreenplayTextModelSceneItem*>(_item);
     d->plannedDuration = sceneItem->d->plannedDuration;
+    d->resources = sceneItem->d->resources;
 
     TextModelGroupItem::copyFrom(_item);
 }
@@ -92,11 +92,12 @@ void ScreenplayTextModelTextItem::updateCounters(bool _force)
     //
     // Считаем
     //
-    const auto wordsCount = TextHelper::wordsCount(text());
+    const auto textCounters = TextHelper::counters(text());
+    const auto wordsCount = textCounters.words;
     //
-    const auto charactersCountFirst = text().length() - text().count(' ');
+    const auto charactersCountFirst = textCounters.charactersWithoutSpaces;
     const auto charactersCountSecond
-        = text().length() + 1; // всегда добавляем единичку за перенос строки
+        = textCounters.characters + 1; // всегда добавляем единичку за перенос строки
     //
     const auto screenplayModel = qobject_cast<const ScreenplayTextModel*>(model());
     Q_ASSERT(screenplayModel);
@@ -0,0 +1,481 @@
+#include "screenplay_text_timeline_index.h"
+
+#include "screenplay_text_model.h"
+#include "screenplay_text_model_scene_item.h"
+#include "screenplay_text_model_text_item.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+#include <algorithm>
+
+
+namespace BusinessLayer {
+
+class ScreenplayTextTimelineIndex::Implementation
+{
+public:
+    explicit Implementation(ScreenplayTextTimelineIndex* _q);
+
+    /**
+     * @brief Является ли элемент самостоятельным отрезком таймлайна
+     */
+    bool isSegmentItem(const TextModelItem* _item) const;
+
+    /**
+     * @brief Получить элемент отрезка, в который входит заданный элемент
+     */
+    const TextModelItem* segmentItem(const TextModelItem* _item) const;
+
+    /**
+     * @brief Собрать элементы отрезков, находящиеся в заданном элементе
+     */
+    void collectSegmentItems(const TextModelItem* _item,
+                             QVector<const TextModelItem*>& _items) const;
+
+    /**
+     * @brief Индекс последнего отрезка внутри заданного элемента, либо -1, если таковых нет
+     */
+    int lastSegmentIndexIn(const TextModelItem* _item) const;
+
+    /**
+     * @brief Индекс последнего отрезка, находящегося перед заданной строкой родителя
+     */
+    int segmentIndexBefore(TextModelItem* _parent, int _row) const;
+
+    /**
+     * @brief Обновить индексы отрезков начиная с заданного
+     */
+    void reindexSegments(int _from);
+
+    /**
+     * @brief Пересчитать длительность, цвет и отметки отрезка
+     */
+    void refreshSegment(Segment& _segment) const;
+
+    /**
+     * @brief Добавить в отрезок отметки текстового элемента
+     */
+    void collectMarks(const TextModelItem* _item, std::chrono::milliseconds& _offset,
+                      Segment& _segment) const;
+
+    /**
+     * @brief Построить индекс заново
+     */
+    void rebuild();
+
+    /**
+     * @brief Запомнить промежуток времени, в котором произошли изменения
+     */
+    void includeChangedRange(std::chrono::milliseconds _from, std::chrono::milliseconds _to);
+
+    /**
+     * @brief Пометить отрезок для пересчёта
+     */
+    void markDirty(const TextModelItem* _segmentItem);
+
+
+    ScreenplayTextTimelineIndex* q = nullptr;
+
+    QPointer<ScreenplayTextModel> model;
+
+    QVector<Segment> segments;
+    QHash<const TextModelItem*, int> segmentIndexes;
+    std::chrono::milliseconds duration{ 0 };
+
+    /**
+     * @brief Отрезки, которые нужно пересчитать
+     */
+    QSet<const TextModelItem*> dirtySegments;
+
+    /**
+     * @brief Индекс первого отрезка, начало которого могло сместиться, либо -1
+     */
+    int firstShiftedSegment = -1;
+
+    /**
+     * @brief Промежуток времени, в котором произошли изменения с момента последнего обновления
+     */
+    bool hasChangedRange = false;
+    std::chrono::milliseconds changedFrom{ 0 };
+    std::chrono::milliseconds changedTo{ 0 };
+};
+
+ScreenplayTextTimelineIndex::Implementation::Implementation(ScreenplayTextTimelineIndex* _q)
+    : q(_q)
+{
+}
+
+bool ScreenplayTextTimelineIndex::Implementation::isSegmentItem(const TextModelItem* _item) const
+{
+    return _item->parent() != nullptr && _item->parent()->type() == TextModelItemType::Folder
+        && (_item->type() == TextModelItemType::Group
+            || _item->type() == TextModelItemType::Text);
+}
+
+const TextModelItem* ScreenplayTextTimelineIndex::Implementation::segmentItem(
+    const TextModelItem* _item) const
+{
+    auto item = _item;
+    while (item != nullptr && !isSegmentItem(item)) {
+        item = item->parent();
+    }
+    return item;
+}
+
+void ScreenplayTextTimelineIndex::Implementation::collectSegmentItems(
+    const TextModelItem* _item, QVector<const TextModelItem*>& _items) const
+{
+    if (isSegmentItem(_item)) {
+        _items.append(_item);
+        return;
+    }
+
+    if (_item->type() != TextModelItemType::Folder) {
+        return;
+    }
+
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        collectSegmentItems(_item->childAt(childIndex), _items);
+    }
+}
+
+int ScreenplayTextTimelineIndex::Implementation::lastSegmentIndexIn(
+    const TextModelItem* _item) const
+{
+    const auto iter = segmentIndexes.find(_item);
+    if (iter != segmentIndexes.end()) {
+        return iter.value();
+    }
+
+    if (_item->type() != TextModelItemType::Folder) {
+        return -1;
+    }
+
+    for (int childIndex = _item->childCount() - 1; childIndex >= 0; --childIndex) {
+        const auto index = lastSegmentIndexIn(_item->childAt(childIndex));
+        if (index != -1) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+int ScreenplayTextTimelineIndex::Implementation::segmentIndexBefore(TextModelItem* _parent,
+                                                                    int _row) const
+{
+    auto parent = _parent;
+    int row = _row;
+    while (parent != nullptr) {
+        for (int childIndex = row - 1; childIndex >= 0; --childIndex) {
+            const auto index = lastSegmentIndexIn(parent->childAt(childIndex));
+            if (index != -1) {
+                return index;
+            }
+        }
+
+        if (parent->parent() == nullptr) {
+            break;
+        }
+        row = parent->parent()->rowOfChild(parent);
+        parent = parent->parent();
+    }
+    return -1;
+}
+
+void ScreenplayTextTimelineIndex::Implementation::reindexSegments(int _from)
+{
+    for (int index = _from; index < segments.size(); ++index) {
+        segmentIndexes[segments[index].item] = index;
+    }
+
+    if (firstShiftedSegment == -1 || firstShiftedSegment > _from) {
+        firstShiftedSegment = _from;
+    }
+}
+
+void ScreenplayTextTimelineIndex::Implementation::refreshSegment(Segment& _segment) const
+{
+    _segment.bookmarks.clear();
+    _segment.comments.clear();
+
+    std::chrono::milliseconds offset{ 0 };
+    if (_segment.item->type() == TextModelItemType::Group) {
+        const auto sceneItem = static_cast<const ScreenplayTextModelSceneItem*>(_segment.item);
+        _segment.duration = sceneItem->duration();
+        _segment.color = sceneItem->color();
+        for (int childIndex = 0; childIndex < sceneItem->childCount(); ++childIndex) {
+            collectMarks(sceneItem->childAt(childIndex), offset, _segment);
+        }
+    } else {
+        const auto textItem = static_cast<const ScreenplayTextModelTextItem*>(_segment.item);
+        _segment.duration = textItem->duration();
+        _segment.color = {};
+        collectMarks(textItem, offset, _segment);
+    }
+}
+
+void ScreenplayTextTimelineIndex::Implementation::collectMarks(const TextModelItem* _item,
+                                                               std::chrono::milliseconds& _offset,
+                                                               Segment& _segment) const
+{
+    switch (_item->type()) {
+    case TextModelItemType::Folder:
+    case TextModelItemType::Group: {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            collectMarks(_item->childAt(childIndex), _offset, _segment);
+        }
+        break;
+    }
+
+    case TextModelItemType::Text: {
+        const auto textItem = static_cast<const ScreenplayTextModelTextItem*>(_item);
+        if (textItem->bookmark().has_value() && textItem->bookmark()->isValid()) {
+            _segment.bookmarks.append({ _offset, textItem->bookmark()->color });
+        }
+        //
+        // Для редакторских заметок достаточно одной отметки на блок текста
+        //
+        for (const auto& reviewMark : textItem->reviewMarks()) {
+            if (!reviewMark.isDone && !reviewMark.comments.isEmpty()) {
+                _segment.comments.append({ _offset, reviewMark.backgroundColor });
+                break;
+            }
+        }
+        _offset += textItem->duration();
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+}
+
+void ScreenplayTextTimelineIndex::Implementation::rebuild()
+{
+    const auto oldDuration = duration;
+
+    segments.clear();
+    segmentIndexes.clear();
+    dirtySegments.clear();
+    duration = std::chrono::milliseconds{ 0 };
+    firstShiftedSegment = -1;
+    hasChangedRange = false;
+
+    if (!model.isNull()) {
+        QVector<const TextModelItem*> items;
+        collectSegmentItems(model->itemForIndex({}), items);
+        segments.reserve(items.size());
+        for (const auto item : items) {
+            Segment segment;
+            segment.item = item;
+            segment.start = duration;
+            refreshSegment(segment);
+            duration += segment.duration;
+            segmentIndexes.insert(item, segments.size());
+            segments.append(segment);
+        }
+    }
+
+    emit q->segmentsChanged(std::chrono::milliseconds{ 0 }, std::max(oldDuration, duration));
+}
+
+void ScreenplayTextTimelineIndex::Implementation::includeChangedRange(
+    std::chrono::milliseconds _from, std::chrono::milliseconds _to)
+{
+    if (!hasChangedRange) {
+        changedFrom = _from;
+        changedTo = _to;
+        hasChangedRange = true;
+        return;
+    }
+
+    changedFrom = std::min(changedFrom, _from);
+    changedTo = std::max(changedTo, _to);
+}
+
+void ScreenplayTextTimelineIndex::Implementation::markDirty(const TextModelItem* _segmentItem)
+{
+    if (_segmentItem == nullptr || !segmentIndexes.contains(_segmentItem)) {
+        return;
+    }
+
+    dirtySegments.insert(_segmentItem);
+    emit q->updateRequested();
+}
+
+
+// ****
+
+
+ScreenplayTextTimelineIndex::ScreenplayTextTimelineIndex(QObject* _parent)
+    : QObject(_parent)
+    , d(new Implementation(this))
+{
+}
+
+ScreenplayTextTimelineIndex::~ScreenplayTextTimelineIndex() = default;
+
+void ScreenplayTextTimelineIndex::setModel(ScreenplayTextModel* _model)
+{
+    if (d->model == _model) {
+        return;
+    }
+
+    if (!d->model.isNull()) {
+        d->model->disconnect(this);
+    }
+
+    d->model = _model;
+
+    if (!d->model.isNull()) {
+        connect(d->model, &ScreenplayTextModel::modelReset, this, [this] { d->rebuild(); });
+        connect(d->model, &ScreenplayTextModel::dataChanged, this,
+                [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                    for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                        d->markDirty(
+                            d->segmentItem(d->model->itemForIndex(_topLeft.siblingAtRow(row))));
+                    }
+                });
+        connect(d->model, &ScreenplayTextModel::rowsInserted, this,
+                [this](const QModelIndex& _parent, int _first, int _last) {
+                    auto parentItem = d->model->itemForIndex(_parent);
+                    if (parentItem->type() != TextModelItemType::Folder) {
+                        d->markDirty(d->segmentItem(parentItem));
+                        return;
+                    }
+
+                    //
+                    // Вставляем новые отрезки после последнего отрезка, предшествующего
+                    // вставленным строкам
+                    //
+                    QVector<const TextModelItem*> items;
+                    for (int row = _first; row <= _last; ++row) {
+                        d->collectSegmentItems(parentItem->childAt(row), items);
+                    }
+                    if (items.isEmpty()) {
+                        return;
+                    }
+
+                    const auto insertIndex = d->segmentIndexBefore(parentItem, _first) + 1;
+                    d->segments.insert(insertIndex, items.size(), Segment());
+                    for (int index = 0; index < items.size(); ++index) {
+                        d->segments[insertIndex + index].item = items.at(index);
+                    }
+                    d->reindexSegments(insertIndex);
+                    for (const auto item : items) {
+                        d->markDirty(item);
+                    }
+                });
+        connect(d->model, &ScreenplayTextModel::rowsAboutToBeRemoved, this,
+                [this](const QModelIndex& _parent, int _first, int _last) {
+                    auto parentItem = d->model->itemForIndex(_parent);
+                    if (parentItem->type() != TextModelItemType::Folder) {
+                        d->markDirty(d->segmentItem(parentItem));
+                        return;
+                    }
+
+                    //
+                    // Удаляемые отрезки всегда идут подряд
+                    //
+                    QVector<const TextModelItem*> items;
+                    for (int row = _first; row <= _last; ++row) {
+                        d->collectSegmentItems(parentItem->childAt(row), items);
+                    }
+                    if (items.isEmpty()) {
+                        return;
+                    }
+
+                    const auto removeIndex = d->segmentIndexes.value(items.constFirst());
+                    const auto& firstSegment = d->segments.at(removeIndex);
+                    const auto& lastSegment = d->segments.at(removeIndex + items.size() - 1);
+                    d->includeChangedRange(firstSegment.start, lastSegment.end());
+                    for (const auto item : items) {
+                        d->segmentIndexes.remove(item);
+                        d->dirtySegments.remove(item);
+                    }
+                    d->segments.remove(removeIndex, items.size());
+                    d->reindexSegments(removeIndex);
+                    emit updateRequested();
+                });
+    }
+
+    d->rebuild();
+}
+
+void ScreenplayTextTimelineIndex::update()
+{
+    if (d->dirtySegments.isEmpty() && d->firstShiftedSegment == -1) {
+        return;
+    }
+
+    //
+    // Пересчитываем изменившиеся отрезки
+    //
+    int firstChangedSegment = d->firstShiftedSegment == -1 ? d->segments.size()
+                                                           : d->firstShiftedSegment;
+    bool isDurationChanged = d->firstShiftedSegment != -1;
+    for (const auto item : std::as_const(d->dirtySegments)) {
+        const auto index = d->segmentIndexes.value(item);
+        auto& segment = d->segments[index];
+        const auto oldDuration = segment.duration;
+        d->includeChangedRange(segment.start, segment.end());
+        d->refreshSegment(segment);
+        d->includeChangedRange(segment.start, segment.end());
+        isDurationChanged = isDurationChanged || segment.duration != oldDuration;
+        firstChangedSegment = std::min(firstChangedSegment, index);
+    }
+    d->dirtySegments.clear();
+    d->firstShiftedSegment = -1;
+
+    //
+    // Сдвигаем начала отрезков, следующих за изменившимися
+    //
+    const auto oldDuration = d->duration;
+    if (isDurationChanged) {
+        auto start = firstChangedSegment > 0 ? d->segments.at(firstChangedSegment - 1).end()
+                                             : std::chrono::milliseconds{ 0 };
+        for (int index = firstChangedSegment; index < d->segments.size(); ++index) {
+            d->segments[index].start = start;
+            start += d->segments.at(index).duration;
+        }
+        d->duration = start;
+        if (firstChangedSegment < d->segments.size()) {
+            d->includeChangedRange(d->segments.at(firstChangedSegment).start,
+                                   std::max(oldDuration, d->duration));
+        } else {
+            d->includeChangedRange(d->duration, std::max(oldDuration, d->duration));
+        }
+    }
+
+    if (!d->hasChangedRange) {
+        return;
+    }
+
+    d->hasChangedRange = false;
+    emit segmentsChanged(d->changedFrom, d->changedTo);
+}
+
+std::chrono::milliseconds ScreenplayTextTimelineIndex::duration() const
+{
+    return d->duration;
+}
+
+const QVector<ScreenplayTextTimelineIndex::Segment>& ScreenplayTextTimelineIndex::segments() const
+{
+    return d->segments;
+}
+
+int ScreenplayTextTimelineIndex::segmentAt(std::chrono::milliseconds _time) const
+{
+    const auto iter = std::upper_bound(
+        d->segments.constBegin(), d->segments.constEnd(), _time,
+        [](std::chrono::milliseconds _value, const Segment& _segment) {
+            return _value < _segment.end();
+        });
+    return static_cast<int>(std::distance(d->segments.constBegin(), iter));
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QColor>
+#include <QObject>
+#include <QVector>
+
+#include <chrono>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+
+class ScreenplayTextModel;
+class TextModelItem;
+
+/**
+ * @brief Индекс хронометража сценария для таймлайна редактора
+ *
+ * Документ разбивается на отрезки - сцены верхнего уровня и блоки текста вне сцен. Для каждого
+ * отрезка хранятся его начало, длительность, цвет, закладки и редакторские заметки. Изменения
+ * модели лишь помечают затронутые отрезки, а при обновлении пересчитываются только они.
+ */
+class CORE_LIBRARY_EXPORT ScreenplayTextTimelineIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Отметка внутри отрезка
+     */
+    struct Mark {
+        /**
+         * @brief Смещение от начала отрезка
+         */
+        std::chrono::milliseconds offset{ 0 };
+
+        /**
+         * @brief Цвет отметки
+         */
+        QColor color;
+    };
+
+    /**
+     * @brief Отрезок таймлайна
+     */
+    struct Segment {
+        const TextModelItem* item = nullptr;
+        std::chrono::milliseconds start{ 0 };
+        std::chrono::milliseconds duration{ 0 };
+        QColor color;
+        QVector<Mark> bookmarks;
+        QVector<Mark> comments;
+
+        std::chrono::milliseconds end() const
+        {
+            return start + duration;
+        }
+    };
+
+public:
+    explicit ScreenplayTextTimelineIndex(QObject* _parent = nullptr);
+    ~ScreenplayTextTimelineIndex() override;
+
+    /**
+     * @brief Задать модель сценария
+     */
+    void setModel(ScreenplayTextModel* _model);
+
+    /**
+     * @brief Пересчитать помеченные отрезки
+     * @note Если что-то изменилось, то будет испущен сигнал segmentsChanged
+     */
+    void update();
+
+    /**
+     * @brief Суммарная длительность всех отрезков
+     */
+    std::chrono::milliseconds duration() const;
+
+    /**
+     * @brief Отрезки в порядке следования в документе
+     */
+    const QVector<Segment>& segments() const;
+
+    /**
+     * @brief Индекс первого отрезка, который заканчивается после заданного момента
+     */
+    int segmentAt(std::chrono::milliseconds _time) const;
+
+signals:
+    /**
+     * @brief Есть отрезки, которые нужно пересчитать
+     */
+    void updateRequested();
+
+    /**
+     * @brief Изменились отрезки в заданном промежутке времени
+     */
+    void segmentsChanged(std::chrono::milliseconds _from, std::chrono::milliseconds _to);
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
@@ -7,14 +7,15 @@
 #include <business_layer/model/characters/characters_model.h>
 #include <business_layer/model/stageplay/stageplay_information_model.h>
 #include <business_layer/model/stageplay/text/stageplay_text_block_parser.h>
+#include <business_layer/model/text/text_model_dialogues_index.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_numbering.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/templates/stageplay_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
-#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 
-#include <QRegularExpression>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -35,6 +36,29 @@ public:
      */
     TextModelItem* rootItem() const;
 
+    /**
+     * @brief Состояние счётчиков номеров сцен и реплик
+     */
+    struct NumberingState {
+        int sceneNumber = 1;
+        int dialogueNumber = 0;
+
+        bool operator==(const NumberingState& _other) const
+        {
+            return sceneNumber == _other.sceneNumber && dialogueNumber == _other.dialogueNumber;
+        }
+    };
+
+    /**
+     * @brief Пронумеровать реплику
+     */
+    void updateTextNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Пронумеровать сцену
+     */
+    void updateSceneNumber(TextModelItem* _item, NumberingState& _state);
+
     /**
      * @brief Обновить номера сцен и реплик
      */
@@ -46,6 +70,11 @@ public:
      */
     StageplayTextModel* q = nullptr;
 
+    /**
+     * @brief Индекс реплик персонажей
+     */
+    TextModelDialoguesIndex* dialoguesIndex = nullptr;
+
     /**
      * @brief Модель информации о проекте
      */
@@ -65,10 +94,20 @@ public:
      * @brief Справочники, которые строятся в рантайме
      */
     QStringListModel* charactersModelFromText = nullptr;
+
+    /**
+     * @brief Нумерация сцен и реплик
+     */
+    TextModelNumbering<NumberingState> numbering;
 };
 
 StageplayTextModel::Implementation::Implementation(StageplayTextModel* _q)
     : q(_q)
+    , dialoguesIndex(new TextModelDialoguesIndex(_q, &StageplayCharacterParser::name))
+    , numbering([this](TextModelItem* _item,
+                       NumberingState& _state) { updateTextNumber(_item, _state); },
+                [this](TextModelItem* _item,
+                       NumberingState& _state) { updateSceneNumber(_item, _state); })
 {
 }
 
@@ -77,60 +116,56 @@ TextModelItem* StageplayTextModel::Implementation::rootItem() const
     return q->itemForIndex({});
 }
 
-void StageplayTextModel::Implementation::updateNumbering()
+void StageplayTextModel::Implementation::updateTextNumber(TextModelItem* _item,
+                                                          NumberingState& _state)
 {
-    int sceneNumber = 1;
-    int dialogueNumber = 0;
-    std::function<void(const TextModelItem*)> updateChildNumbering;
-    updateChildNumbering = [this, &sceneNumber, &dialogueNumber,
-                            &updateChildNumbering](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                updateChildNumbering(childItem);
-                break;
-            }
+    if (_item->type() != TextModelItemType::Text) {
+        return;
+    }
 
-            case TextModelItemType::Group: {
-                updateChildNumbering(childItem);
-                auto groupItem = static_cast<TextModelGroupItem*>(childItem);
-                if (groupItem->setNumber(sceneNumber, {})) {
-                    ++sceneNumber;
-                }
-                break;
-            }
+    auto textItem = static_cast<TextModelTextItem*>(_item);
+    if (textItem->isCorrection()) {
+        return;
+    }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<TextModelTextItem*>(childItem);
-                if (!textItem->isCorrection()) {
-                    switch (textItem->paragraphType()) {
-                    case TextParagraphType::Character: {
-                        ++dialogueNumber;
-                        Q_FALLTHROUGH();
-                    }
-
-                    case TextParagraphType::Dialogue:
-                    case TextParagraphType::Lyrics: {
-                        textItem->setNumber(dialogueNumber);
-                        q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
-                        break;
-                    }
-
-                    default: {
-                        break;
-                    }
-                    }
-                }
-                break;
-            }
+    switch (textItem->paragraphType()) {
+    case TextParagraphType::Character: {
+        ++_state.dialogueNumber;
+        Q_FALLTHROUGH();
+    }
 
-            default:
-                break;
-            }
+    case TextParagraphType::Dialogue:
+    case TextParagraphType::Lyrics: {
+        if (!textItem->number().has_value()
+            || textItem->number()->value != _state.dialogueNumber) {
+            textItem->setNumber(_state.dialogueNumber);
+            q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
         }
-    };
-    updateChildNumbering(rootItem());
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+}
+
+void StageplayTextModel::Implementation::updateSceneNumber(TextModelItem* _item,
+                                                           NumberingState& _state)
+{
+    if (_item->type() != TextModelItemType::Group) {
+        return;
+    }
+
+    auto groupItem = static_cast<TextModelGroupItem*>(_item);
+    if (groupItem->setNumber(_state.sceneNumber, {})) {
+        ++_state.sceneNumber;
+    }
+}
+
+void StageplayTextModel::Implementation::updateNumbering()
+{
+    numbering.update(rootItem(), {});
 }
 
 
@@ -141,14 +176,43 @@ StageplayTextModel::StageplayTextModel(QObject* _parent)
     : TextModel(_parent, createFolderItem(TextFolderType::Root))
     , d(new Implementation(this))
 {
-    auto updateNumbering = [this] { d->updateNumbering(); };
     //
     // Обновляем счётчики после того, как операции вставки и удаления будут обработаны клиентами
     // модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели может
     // приводить к падению внутри них
     //
-    connect(this, &StageplayTextModel::afterRowsInserted, this, updateNumbering);
-    connect(this, &StageplayTextModel::afterRowsRemoved, this, updateNumbering);
+    // ... номера пересчитываем начиная с первого затронутого элемента
+    //
+    connect(this, &StageplayTextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _last);
+            });
+    connect(this, &StageplayTextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                auto parentItem = itemForIndex(_parent);
+                d->numbering.update(d->rootItem(), {}, parentItem, _first, _first - 1);
+            });
+    //
+    // ... удаляемые элементы забываем, пока они ещё существуют
+    //
+    connect(this, &StageplayTextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->numbering.forget(parentItem->childAt(row));
+                }
+            });
+    //
+    // ... а изменённые без вставки и удаления строк элементы пересчитаем при следующем обновлении
+    //
+    connect(this, &StageplayTextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    d->numbering.markChanged(itemForIndex(_topLeft.siblingAtRow(row)));
+                }
+            });
+    connect(this, &StageplayTextModel::modelReset, this, [this] { d->numbering.clear(); });
 
     connect(this, &StageplayTextModel::contentsChanged, this,
             [this] { d->needUpdateRuntimeDictionaries = true; });
@@ -232,111 +296,28 @@ void StageplayTextModel::createCharacter(const QString& _name)
     d->charactersModel->createCharacter(_name);
 }
 
-void StageplayTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
+void StageplayTextModel::updateCharacterName(const TextModelNameReplacement& _replacement)
 {
-    const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<TextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::Character
-                    && StageplayCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(QString("\\b(%1)\\b").arg(oldName),
-                                                         QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
-
-            default:
-                break;
-            }
+    const auto& oldName = _replacement.oldName();
+    _replacement.apply(this, [&_replacement, &oldName](const TextModelTextItem* _item,
+                                                       QString& _text) {
+        if (_item->paragraphType() == TextParagraphType::Character
+            && StageplayCharacterParser::name(_text) == oldName) {
+            return _replacement.replaceFirst(_text);
         }
-    };
 
-    emit rowsAboutToBeChanged();
-    updateCharacterBlock(d->rootItem());
-    emit rowsChanged();
+        return _replacement.replaceMentions(_text);
+    });
 }
 
 QVector<QModelIndex> StageplayTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QString lastCharacter;
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = StageplayCharacterParser::name(textItem->text());
-                break;
-            }
-
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
-
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                lastCharacter.clear();
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
-        }
-    }
+    return d->dialoguesIndex->dialogues(_name);
+}
 
-    return dialoguesIndexes;
+int StageplayTextModel::characterDialoguesCount(const QString& _name) const
+{
+    return d->dialoguesIndex->dialoguesCount(_name);
 }
 
 QSet<QString> StageplayTextModel::findCharactersFromText() const
@@ -2,6 +2,8 @@
 
 #include "text_model_folder_item.h"
 #include "text_model_group_item.h"
+#include "text_model_items_writer.h"
+#include "text_model_mime_data.h"
 #include "text_model_splitter_item.h"
 #include "text_model_text_item.h"
 #include "text_model_xml.h"
@@ -23,8 +25,8 @@
 
 #include <QCryptographicHash>
 #include <QDateTime>
-#include <QDomDocument>
 #include <QMimeData>
+#include <QPointer>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -35,6 +37,158 @@
 
 namespace BusinessLayer {
 
+namespace {
+
+/**
+ * @brief Количество преобразований фрагментов документа в xml и обратно
+ */
+int s_mimeXmlConversionsCount = 0;
+
+/**
+ * @brief Добавить в xml, либо в копии элементов, фрагмент документа в заданном диапазоне
+ * @return Удалось ли сформировать фрагмент
+ */
+template<typename Writer>
+bool writeSelection(Writer& _writer, const TextModel* _model, const QModelIndex& _from,
+                    int _fromPosition, const QModelIndex& _to, int _toPosition, bool _clearUuid)
+{
+    if (ModelIndexPath(_to) < ModelIndexPath(_from)
+        || (_from == _to && _fromPosition >= _toPosition)) {
+        return false;
+    }
+
+    const auto fromItem = _model->itemForIndex(_from);
+    if (fromItem == nullptr) {
+        return false;
+    }
+
+    const auto toItem = _model->itemForIndex(_to);
+    if (toItem == nullptr) {
+        return false;
+    }
+
+    auto buildFor = [&_writer, fromItem, _fromPosition, toItem, _toPosition,
+                     _clearUuid](TextModelItem* _fromItemParent, int _fromItemRow) {
+        bool needAddSplitter = false;
+        if (fromItem != toItem && fromItem->type() == TextModelItemType::Text
+            && toItem->type() == TextModelItemType::Text) {
+            const auto fromTextItem = static_cast<TextModelTextItem*>(fromItem);
+            const auto toTextItem = static_cast<TextModelTextItem*>(toItem);
+            needAddSplitter = fromTextItem->isInFirstColumn().has_value()
+                && fromTextItem->isInFirstColumn().value() == true
+                && toTextItem->isInFirstColumn().has_value()
+                && toTextItem->isInFirstColumn().value() == false;
+        }
+
+        auto addSplitterIfNeeded
+            = [&_writer, fromItem, needAddSplitter](TextModelSplitterItemType _type) {
+                  if (needAddSplitter) {
+                      TextModelSplitterItem splitterItem(fromItem->model());
+                      splitterItem.setSplitterType(_type);
+                      _writer += &splitterItem;
+                  }
+              };
+
+        addSplitterIfNeeded(TextModelSplitterItemType::Start);
+
+        for (int childIndex = _fromItemRow; childIndex < _fromItemParent->childCount();
+             ++childIndex) {
+            const auto childItem = _fromItemParent->childAt(childIndex);
+
+            switch (childItem->type()) {
+            case TextModelItemType::Folder:
+            case TextModelItemType::Group: {
+                addItemPart(_writer, childItem, fromItem, _fromPosition, toItem, _toPosition,
+                            _clearUuid);
+                break;
+            }
+
+            case TextModelItemType::Text: {
+                const auto textItem = static_cast<TextModelTextItem*>(childItem);
+
+                //
+                // Не сохраняем закрывающие блоки неоткрытых папок, всё это делается внутри самих
+                // папок
+                //
+                if (textItem->paragraphType() == TextParagraphType::ActFooter
+                    || textItem->paragraphType() == TextParagraphType::SequenceFooter
+                    || textItem->paragraphType() == TextParagraphType::PartFooter
+                    || textItem->paragraphType() == TextParagraphType::ChapterFooter) {
+                    break;
+                }
+
+                if (textItem == fromItem && textItem == toItem) {
+                    _writer += { textItem, _fromPosition, _toPosition - _fromPosition };
+                } else if (textItem == fromItem) {
+                    _writer += { textItem, _fromPosition,
+                                 textItem->text().length() - _fromPosition };
+                } else if (textItem == toItem) {
+                    _writer += { textItem, 0, _toPosition };
+                } else {
+                    _writer += textItem;
+                }
+                break;
+            }
+
+            default: {
+                _writer += childItem;
+                break;
+            }
+            }
+
+            const bool recursively = true;
+            if (childItem == toItem || childItem->hasChild(toItem, recursively)) {
+                addSplitterIfNeeded(TextModelSplitterItemType::End);
+                return true;
+            }
+        }
+
+        addSplitterIfNeeded(TextModelSplitterItemType::End);
+
+        return false;
+    };
+    auto fromItemParent = fromItem->parent();
+    auto fromItemRow = fromItemParent->rowOfChild(fromItem);
+    //
+    // Если построить нужно начиная с заголовка сцены или папки, и при этом майм нужен не только для
+    // блока заголовка, то нужно захватить и саму сцену/папку
+    //
+    if (fromItem->type() == TextModelItemType::Text) {
+        const auto textItem = static_cast<TextModelTextItem*>(fromItem);
+        if (textItem->paragraphType() == TextParagraphType::ActHeading
+            || textItem->paragraphType() == TextParagraphType::SequenceHeading
+            || textItem->paragraphType() == TextParagraphType::PartHeading
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading
+            || textItem->paragraphType() == TextParagraphType::SceneHeading
+            || textItem->paragraphType() == TextParagraphType::BeatHeading
+            || textItem->paragraphType() == TextParagraphType::PageHeading
+            || textItem->paragraphType() == TextParagraphType::PanelHeading
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading1
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading2
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading3
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading4
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading5
+            || textItem->paragraphType() == TextParagraphType::ChapterHeading6) {
+            auto newFromItem = fromItemParent;
+            fromItemParent = fromItemParent->parent();
+            fromItemRow = fromItemParent->rowOfChild(newFromItem);
+        }
+    }
+    //
+    // Собственно формируем данные выделенного интервала
+    //
+    while (buildFor(fromItemParent, fromItemRow) != true) {
+        auto newFromItem = fromItemParent;
+        fromItemParent = fromItemParent->parent();
+        fromItemRow
+            = fromItemParent->rowOfChild(newFromItem) + 1; // +1, т.к. текущий мы уже обработали
+    }
+
+    return true;
+}
+
+} // namespace
+
 class TextModel::Implementation
 {
 public:
@@ -55,6 +209,25 @@ public:
      */
     void updateContentHash(const QByteArray& _xml = {}) const;
 
+    /**
+     * @brief Сформировать копии элементов фрагмента документа в заданном диапазоне
+     */
+    QVector<TextModelItem*> itemsFromSelection(const QModelIndex& _from, int _fromPosition,
+                                               const QModelIndex& _to, int _toPosition,
+                                               bool _clearUuid) const;
+
+    /**
+     * @brief Создать элементы фрагмента документа из его xml
+     */
+    QVector<TextModelItem*> itemsFromMime(const QString& _mimeData) const;
+
+    /**
+     * @brief Создать элементы фрагмента документа из майм-данных
+     * @note Если фрагмент скопирован внутри приложения, то копируются его элементы, а xml
+     *       разбирается только для данных, полученных из других приложений
+     */
+    QVector<TextModelItem*> itemsFromMime(const QMimeData* _mimeData) const;
+
 
     /**
      * @brief Родительский элемент
@@ -85,10 +258,22 @@ public:
         QMimeData* data = nullptr;
     } lastMime;
 
+    /**
+     * @brief Майм-данные, в которые помещены копии элементов модели
+     * @note Копии элементов нельзя использовать без модели, в которой они созданы, поэтому при
+     *       очистке модели эти майм-данные переводятся в xml
+     */
+    mutable QVector<QPointer<TextModelMimeData>> mimeDataWithItems;
+
     /**
      * @brief MD5-хэш текущего состояния контента
      */
     mutable QByteArray contentHash;
+
+    /**
+     * @brief Номер версии структуры модели
+     */
+    int structureRevision = 0;
 };
 
 TextModel::Implementation::Implementation(TextModel* _q, TextModelFolderItem* _rootItem)
@@ -169,6 +354,70 @@ void TextModel::Implementation::updateContentHash(const QByteArray& _xml) const
     contentHash = hash.result();
 }
 
+QVector<TextModelItem*> TextModel::Implementation::itemsFromSelection(const QModelIndex& _from,
+                                                                      int _fromPosition,
+                                                                      const QModelIndex& _to,
+                                                                      int _toPosition,
+                                                                      bool _clearUuid) const
+{
+    TextModelItemsWriter items(q);
+    if (!writeSelection(items, q, _from, _fromPosition, _to, _toPosition, _clearUuid)) {
+        return {};
+    }
+
+    return items.takeItems();
+}
+
+QVector<TextModelItem*> TextModel::Implementation::itemsFromMime(const QString& _mimeData) const
+{
+    if (_mimeData.isEmpty()) {
+        return {};
+    }
+
+    ++s_mimeXmlConversionsCount;
+
+    QVector<TextModelItem*> items;
+    QXmlStreamReader contentReader(_mimeData);
+    contentReader.readNextStartElement(); // document
+    contentReader.readNextStartElement();
+    while (!contentReader.atEnd()) {
+        const auto currentTag = contentReader.name().toString();
+        if (currentTag == xml::kDocumentTag) {
+            break;
+        }
+
+        if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
+            items.append(q->createFolderItem(contentReader));
+        } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
+            items.append(q->createGroupItem(contentReader));
+        } else if (currentTag == xml::kSplitterTag) {
+            items.append(q->createSplitterItem(contentReader));
+        } else {
+            items.append(q->createTextItem(contentReader));
+        }
+    }
+    return items;
+}
+
+QVector<TextModelItem*> TextModel::Implementation::itemsFromMime(const QMimeData* _mimeData) const
+{
+    const auto mimeType = q->mimeTypes().constFirst();
+    const auto mimeItems = TextModelMimeData::items(_mimeData, mimeType);
+    if (mimeItems.isEmpty()) {
+        return itemsFromMime(TextModelMimeData::content(_mimeData, mimeType));
+    }
+
+    //
+    // Копии в майм-данных могут вставляться несколько раз и в другие модели, поэтому вставляем
+    // их собственные копии, созданные в текущей модели
+    //
+    TextModelItemsWriter items(q);
+    for (auto item : mimeItems) {
+        items += item;
+    }
+    return items.takeItems();
+}
+
 
 // ****
 
@@ -227,6 +476,21 @@ TextModel::TextModel(QObject* _parent, TextModelFolderItem* _rootItem)
         _parent)
     , d(new Implementation(this, _rootItem))
 {
+    //
+    // Версия структуры меняется как перед изменением, так и после него, чтобы пути, запомненные
+    // в обработчиках сигналов о предстоящем изменении, не пережили само изменение
+    //
+    auto updateStructureRevision = [this] { ++d->structureRevision; };
+    connect(this, &TextModel::rowsAboutToBeInserted, this, updateStructureRevision);
+    connect(this, &TextModel::rowsInserted, this, updateStructureRevision);
+    connect(this, &TextModel::rowsAboutToBeRemoved, this, updateStructureRevision);
+    connect(this, &TextModel::rowsRemoved, this, updateStructureRevision);
+    connect(this, &TextModel::rowsAboutToBeMoved, this, updateStructureRevision);
+    connect(this, &TextModel::rowsMoved, this, updateStructureRevision);
+    connect(this, &TextModel::layoutAboutToBeChanged, this, updateStructureRevision);
+    connect(this, &TextModel::layoutChanged, this, updateStructureRevision);
+    connect(this, &TextModel::modelAboutToBeReset, this, updateStructureRevision);
+    connect(this, &TextModel::modelReset, this, updateStructureRevision);
 }
 
 TextModel::~TextModel() = default;
@@ -496,6 +760,33 @@ void TextModel::updateItemForRoles(TextModelItem* _item, const QVector<int>& _ro
     }
 }
 
+void TextModel::setItemsTexts(const QVector<QPair<TextModelTextItem*, QString>>& _itemsTexts)
+{
+    if (_itemsTexts.isEmpty()) {
+        return;
+    }
+
+    //
+    // Сохраняем изменения, сделанные до групповой замены, чтобы они не отменялись вместе с ней
+    //
+    saveChanges();
+
+    emit rowsAboutToBeChanged();
+    for (const auto& itemText : _itemsTexts) {
+        itemText.first->setText(itemText.second);
+    }
+    //
+    // ... уведомляем об изменениях только после замены всех текстов, чтобы общие родители
+    //     изменённых блоков уведомили о своём изменении лишь один раз
+    //
+    for (const auto& itemText : _itemsTexts) {
+        updateItem(itemText.first);
+    }
+    emit rowsChanged();
+
+    saveChanges();
+}
+
 QModelIndex TextModel::index(int _row, int _column, const QModelIndex& _parent) const
 {
     if (_row < 0 || _row > rowCount(_parent) || _column < 0 || _column > columnCount(_parent)
@@ -607,25 +898,45 @@ bool TextModel::canDropMimeData(const QMimeData* _data, Qt::DropAction _action,
     //
     // Получим первый из перемещаемых элементов
     //
-    QXmlStreamReader contentReader(_data->data(mimeTypes().constFirst()));
-    contentReader.readNextStartElement(); // document
-    contentReader.readNextStartElement();
     TextModelItemType firstItemType = TextModelItemType::Text;
-    do {
-        const auto currentTag = contentReader.name().toString();
-        if (currentTag == xml::kDocumentTag) {
-            break;
+    int firstItemLevel = 0;
+    const auto mimeItems = TextModelMimeData::items(_data, mimeTypes().constFirst());
+    //
+    // ... если данные скопированы внутри приложения, то смотрим на сами элементы
+    //
+    if (!mimeItems.isEmpty()) {
+        const auto firstItem = mimeItems.constFirst();
+        firstItemType = firstItem->type();
+        if (firstItemType == TextModelItemType::Group) {
+            firstItemLevel = static_cast<TextModelGroupItem*>(firstItem)->level();
         }
+    }
+    //
+    // ... а данные других приложений разбираем, пока не будет считан первый элемент
+    //
+    else {
+        QXmlStreamReader contentReader(
+            TextModelMimeData::content(_data, mimeTypes().constFirst()));
+        contentReader.readNextStartElement(); // document
+        contentReader.readNextStartElement();
+        do {
+            const auto currentTag = contentReader.name().toString();
+            if (currentTag == xml::kDocumentTag) {
+                break;
+            }
 
-        if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
-            firstItemType = TextModelItemType::Folder;
-        } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
-            firstItemType = TextModelItemType::Group;
-        } else if (currentTag == xml::kSplitterTag) {
-            firstItemType = TextModelItemType::Splitter;
+            if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
+                firstItemType = TextModelItemType::Folder;
+            } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
+                firstItemType = TextModelItemType::Group;
+                QScopedPointer<TextModelGroupItem> firstItem(createGroupItem(contentReader));
+                firstItemLevel = firstItem->level();
+            } else if (currentTag == xml::kSplitterTag) {
+                firstItemType = TextModelItemType::Splitter;
+            }
         }
+        once;
     }
-    once;
 
     //
     // Собственно определяем правила перемещения
@@ -651,8 +962,7 @@ bool TextModel::canDropMimeData(const QMimeData* _data, Qt::DropAction _action,
         //
         else if (parentItemType == TextModelItemType::Group) {
             const auto parentItem = static_cast<TextModelGroupItem*>(itemForIndex(_parent));
-            const auto firstItem = createGroupItem(contentReader);
-            return parentItem->level() < firstItem->level();
+            return parentItem->level() < firstItemLevel;
         }
         //
         // ... а больше никуда нельзя
@@ -749,30 +1059,12 @@ bool TextModel::dropMimeData(const QMimeData* _data, Qt::DropAction _action, int
         //
         // Вставим перемещаемые элементы
         //
-        // ... cчитываем данные и последовательно вставляем в модель
+        // ... получаем их из майм-данных и последовательно вставляем в модель
         //
-        QXmlStreamReader contentReader(_data->data(mimeTypes().constFirst()));
-        contentReader.readNextStartElement(); // document
-        contentReader.readNextStartElement();
+        const auto newItems = d->itemsFromMime(_data);
         bool isFirstItemHandled = false;
         TextModelItem* lastItem = insertAnchorItem;
-        while (!contentReader.atEnd()) {
-            const auto currentTag = contentReader.name().toString();
-            if (currentTag == xml::kDocumentTag) {
-                break;
-            }
-
-            TextModelItem* newItem = nullptr;
-            if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
-                newItem = createFolderItem(contentReader);
-            } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
-                newItem = createGroupItem(contentReader);
-            } else if (currentTag == xml::kSplitterTag) {
-                newItem = createSplitterItem(contentReader);
-            } else {
-                newItem = createTextItem(contentReader);
-            }
-
+        for (auto newItem : newItems) {
             if (!isFirstItemHandled) {
                 isFirstItemHandled = true;
                 //
@@ -897,10 +1189,9 @@ QMimeData* TextModel::mimeData(const QModelIndexList& _indexes) const
     QModelIndex fromIndex = correctedIndexes.first();
     QModelIndex toIndex = correctedIndexes.last();
 
-    auto mimeData = new QMimeData;
+    auto mimeData = new TextModelMimeData;
     const bool clearUuid = false;
-    mimeData->setData(mimeTypes().constFirst(),
-                      mimeFromSelection(fromIndex, 0, toIndex, 1, clearUuid).toUtf8());
+    setMimeFromSelection(mimeData, fromIndex, 0, toIndex, 1, clearUuid);
 
     d->lastMime = { fromIndex, toIndex, mimeData };
 
@@ -924,152 +1215,54 @@ QString TextModel::mimeFromSelection(const QModelIndex& _from, int _fromPosition
         return {};
     }
 
-    if (ModelIndexPath(_to) < ModelIndexPath(_from)
-        || (_from == _to && _fromPosition >= _toPosition)) {
-        return {};
-    }
-
-    const auto fromItem = itemForIndex(_from);
-    if (fromItem == nullptr) {
-        return {};
-    }
-
-    const auto toItem = itemForIndex(_to);
-    if (toItem == nullptr) {
-        return {};
-    }
-
-
     const bool addXmlHeader = true;
     xml::TextModelXmlWriter xml(addXmlHeader);
     xml += "<document mime-type=\"" + Domain::mimeTypeFor(document()->type())
         + "\" version=\"1.0\">\n";
+    if (!writeSelection(xml, this, _from, _fromPosition, _to, _toPosition, _clearUuid)) {
+        return {};
+    }
+    xml += "</document>";
 
-    auto buildXmlFor = [&xml, fromItem, _fromPosition, toItem, _toPosition,
-                        _clearUuid](TextModelItem* _fromItemParent, int _fromItemRow) {
-        bool needAddSplitter = false;
-        if (fromItem != toItem && fromItem->type() == TextModelItemType::Text
-            && toItem->type() == TextModelItemType::Text) {
-            const auto fromTextItem = static_cast<TextModelTextItem*>(fromItem);
-            const auto toTextItem = static_cast<TextModelTextItem*>(toItem);
-            needAddSplitter = fromTextItem->isInFirstColumn().has_value()
-                && fromTextItem->isInFirstColumn().value() == true
-                && toTextItem->isInFirstColumn().has_value()
-                && toTextItem->isInFirstColumn().value() == false;
-        }
-
-        auto addSplitterXmlIfNeeded
-            = [&xml, fromItem, needAddSplitter](TextModelSplitterItemType _type) {
-                  if (needAddSplitter) {
-                      TextModelSplitterItem splitterItem(fromItem->model());
-                      splitterItem.setSplitterType(_type);
-                      xml += splitterItem.toXml();
-                  }
-              };
-
-        addSplitterXmlIfNeeded(TextModelSplitterItemType::Start);
-
-        for (int childIndex = _fromItemRow; childIndex < _fromItemParent->childCount();
-             ++childIndex) {
-            const auto childItem = _fromItemParent->childAt(childIndex);
-
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                const auto folderItem = static_cast<TextModelFolderItem*>(childItem);
-                xml += folderItem->toXml(fromItem, _fromPosition, toItem, _toPosition, _clearUuid);
-                break;
-            }
-
-            case TextModelItemType::Group: {
-                const auto sceneItem = static_cast<TextModelGroupItem*>(childItem);
-                xml += sceneItem->toXml(fromItem, _fromPosition, toItem, _toPosition, _clearUuid);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                const auto textItem = static_cast<TextModelTextItem*>(childItem);
-
-                //
-                // Не сохраняем закрывающие блоки неоткрытых папок, всё это делается внутри самих
-                // папок
-                //
-                if (textItem->paragraphType() == TextParagraphType::ActFooter
-                    || textItem->paragraphType() == TextParagraphType::SequenceFooter
-                    || textItem->paragraphType() == TextParagraphType::PartFooter
-                    || textItem->paragraphType() == TextParagraphType::ChapterFooter) {
-                    break;
-                }
-
-                if (textItem == fromItem && textItem == toItem) {
-                    xml += { textItem, _fromPosition, _toPosition - _fromPosition };
-                } else if (textItem == fromItem) {
-                    xml += { textItem, _fromPosition, textItem->text().length() - _fromPosition };
-                } else if (textItem == toItem) {
-                    xml += { textItem, 0, _toPosition };
-                } else {
-                    xml += textItem;
-                }
-                break;
-            }
+    ++s_mimeXmlConversionsCount;
+    return xml.data();
+}
 
-            default: {
-                xml += childItem;
-                break;
-            }
-            }
+void TextModel::setMimeFromSelection(TextModelMimeData* _mimeData, const QModelIndex& _from,
+                                     int _fromPosition, const QModelIndex& _to, int _toPosition,
+                                     bool _clearUuid) const
+{
+    if (_mimeData == nullptr || document() == nullptr) {
+        return;
+    }
 
-            const bool recursively = true;
-            if (childItem == toItem || childItem->hasChild(toItem, recursively)) {
-                addSplitterXmlIfNeeded(TextModelSplitterItemType::End);
-                return true;
-            }
-        }
+    _mimeData->setItems(mimeTypes().constFirst(), this, Domain::mimeTypeFor(document()->type()),
+                        d->itemsFromSelection(_from, _fromPosition, _to, _toPosition, _clearUuid));
 
-        addSplitterXmlIfNeeded(TextModelSplitterItemType::End);
+    d->mimeDataWithItems.removeAll(nullptr);
+    d->mimeDataWithItems.append(_mimeData);
+}
 
-        return false;
-    };
-    auto fromItemParent = fromItem->parent();
-    auto fromItemRow = fromItemParent->rowOfChild(fromItem);
-    //
-    // Если построить нужно начиная с заголовка сцены или папки, и при этом майм нужен не только для
-    // блока заголовка, то нужно захватить и саму сцену/папку
-    //
-    if (fromItem->type() == TextModelItemType::Text) {
-        const auto textItem = static_cast<TextModelTextItem*>(fromItem);
-        if (textItem->paragraphType() == TextParagraphType::ActHeading
-            || textItem->paragraphType() == TextParagraphType::SequenceHeading
-            || textItem->paragraphType() == TextParagraphType::PartHeading
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading
-            || textItem->paragraphType() == TextParagraphType::SceneHeading
-            || textItem->paragraphType() == TextParagraphType::BeatHeading
-            || textItem->paragraphType() == TextParagraphType::PageHeading
-            || textItem->paragraphType() == TextParagraphType::PanelHeading
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading1
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading2
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading3
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading4
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading5
-            || textItem->paragraphType() == TextParagraphType::ChapterHeading6) {
-            auto newFromItem = fromItemParent;
-            fromItemParent = fromItemParent->parent();
-            fromItemRow = fromItemParent->rowOfChild(newFromItem);
-        }
-    }
-    //
-    // Собственно строим xml с данными выделенного интервала
-    //
-    while (buildXmlFor(fromItemParent, fromItemRow) != true) {
-        auto newFromItem = fromItemParent;
-        fromItemParent = fromItemParent->parent();
-        fromItemRow
-            = fromItemParent->rowOfChild(newFromItem) + 1; // +1, т.к. текущий мы уже обработали
+QString TextModel::mimeFromItems(const QString& _documentMimeType,
+                                 const QVector<TextModelItem*>& _items)
+{
+    const bool addXmlHeader = true;
+    xml::TextModelXmlWriter xml(addXmlHeader);
+    xml += "<document mime-type=\"" + _documentMimeType + "\" version=\"1.0\">\n";
+    for (auto item : _items) {
+        xml += item;
     }
-
     xml += "</document>";
+
+    ++s_mimeXmlConversionsCount;
     return xml.data();
 }
 
+int TextModel::mimeXmlConversionsCount()
+{
+    return s_mimeXmlConversionsCount;
+}
+
 int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
                               const QString& _mimeData)
 {
@@ -1078,7 +1271,25 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
         return invalidLength;
     }
 
-    if (_mimeData.isEmpty()) {
+    return insertItemsFromMime(_index, _positionInBlock, d->itemsFromMime(_mimeData));
+}
+
+int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
+                              const QMimeData* _mimeData)
+{
+    constexpr auto invalidLength = -1;
+    if (!_index.isValid() || _mimeData == nullptr) {
+        return invalidLength;
+    }
+
+    return insertItemsFromMime(_index, _positionInBlock, d->itemsFromMime(_mimeData));
+}
+
+int TextModel::insertItemsFromMime(const QModelIndex& _index, int _positionInBlock,
+                                   QVector<TextModelItem*> _items)
+{
+    constexpr auto invalidLength = -1;
+    if (_items.isEmpty()) {
         return invalidLength;
     }
 
@@ -1101,50 +1312,23 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
         }
         mimeLength += _length;
     };
-    QString sourceBlockEndContent;
+    QVector<TextModelItem*> sourceBlockEndItems;
     QVector<TextModelItem*> lastItemsFromSourceScene;
-    QString correctedMimeData = _mimeData;
     if (item->type() == TextModelItemType::Text) {
         auto textItem = static_cast<TextModelTextItem*>(item);
 
         //
         // Посмотрим на содержимое майм данных и проверим сколько там текстовых блоков
         //
-        auto isMimeContainsFolderOrSequence = false;
-        auto isMimeContainsJustOneBlock = false;
-        {
-            QDomDocument mimeDocument;
-            mimeDocument.setContent(correctedMimeData);
-            const auto document = mimeDocument.firstChildElement(xml::kDocumentTag);
-
-            //
-            // Всего один текстовый блок
-            //
-            if (document.childNodes().size() == 1
-                && textFolderTypeFromString(document.firstChild().nodeName())
-                    == TextFolderType::Undefined
-                && textGroupTypeFromString(document.firstChild().nodeName())
-                    == TextGroupType::Undefined) {
-                isMimeContainsJustOneBlock = true;
-            }
-
-            //
-            // или группа с одним заголовком
-            //
-            else if (document.childNodes().size() == 1
-                     && (textFolderTypeFromString(document.firstChild().nodeName())
-                             != TextFolderType::Undefined
-                         || textGroupTypeFromString(document.firstChild().nodeName())
-                             != TextGroupType::Undefined)
-                     && document.firstChild()
-                             .firstChildElement(xml::kContentTag)
-                             .childNodes()
-                             .size()
-                         == 1) {
-                isMimeContainsFolderOrSequence = true;
-                isMimeContainsJustOneBlock = true;
-            }
-        }
+        // ... всего один текстовый блок, или группа с одним заголовком
+        //
+        const auto mimeFirstItem = _items.constFirst();
+        const auto isMimeFirstItemFolderOrGroup = mimeFirstItem->type() == TextModelItemType::Folder
+            || mimeFirstItem->type() == TextModelItemType::Group;
+        const auto isMimeContainsFolderOrSequence = _items.size() == 1
+            && isMimeFirstItemFolderOrGroup && mimeFirstItem->childCount() == 1;
+        const auto isMimeContainsJustOneBlock = _items.size() == 1
+            && (!isMimeFirstItemFolderOrGroup || mimeFirstItem->childCount() == 1);
         //
         // ... если текст блока, в который идёт вставка не пуст, а в майм данных есть группа и всего
         //     один текстовый элемент в ней
@@ -1154,19 +1338,11 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
             //
             // ... то удалим группирующий элемент, чтобы вставлять только текст
             //
-            QDomDocument mimeDocument;
-            mimeDocument.setContent(correctedMimeData);
-            auto document = mimeDocument.firstChildElement(xml::kDocumentTag);
-            // document -> folder/group -> content tag -> text block
-            const auto itemNode = document.firstChild();
-            auto contentNode = itemNode.firstChild();
-            while (contentNode.nodeName() != xml::kContentTag) {
-                contentNode = contentNode.nextSibling();
-            }
-            const auto textNode = contentNode.firstChild();
-            document.removeChild(itemNode);
-            document.appendChild(textNode);
-            correctedMimeData = mimeDocument.toString();
+            auto groupingItem = _items.constFirst();
+            auto contentItem = groupingItem->childAt(0);
+            groupingItem->takeItem(contentItem);
+            delete groupingItem;
+            _items = { contentItem };
         }
 
         //
@@ -1207,8 +1383,9 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
                 //
                 if (textItem->text().length() > _positionInBlock) {
                     const bool clearUuid = true;
-                    sourceBlockEndContent = mimeFromSelection(_index, _positionInBlock, _index,
-                                                              textItem->text().length(), clearUuid);
+                    sourceBlockEndItems
+                        = d->itemsFromSelection(_index, _positionInBlock, _index,
+                                                textItem->text().length(), clearUuid);
                     textItem->removeText(_positionInBlock);
                     updateItem(textItem);
                 }
@@ -1217,15 +1394,13 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
     } else {
         Log::warning(
             "Trying to insert from mime to position with no text item. Aborting insertion.");
+        qDeleteAll(_items);
         return invalidLength;
     }
 
     //
-    // Считываем данные и последовательно вставляем в модель
+    // Последовательно вставляем элементы в модель
     //
-    QXmlStreamReader contentReader(correctedMimeData);
-    contentReader.readNextStartElement(); // document
-    contentReader.readNextStartElement();
     bool isFirstTextItemHandled = false;
     bool isSplitterStartWasCreated = false;
     TextModelItem* lastItem = item;
@@ -1240,27 +1415,14 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
         lastItem = itemsToInsert.constLast();
         itemsToInsert.clear();
     };
-    while (!contentReader.atEnd()) {
-        const auto currentTag = contentReader.name().toString();
-
-        //
-        // Если дошли до конца
-        //
-        if (currentTag == xml::kDocumentTag) {
-            //
-            // ... поместим в модель, все собранные элементы
-            //
-            insertCollectedItems();
-            break;
-        }
-
+    for (auto mimeItem : std::as_const(_items)) {
         TextModelItem* newItem = nullptr;
         //
         // При входе в папку или группу, если предыдущий текстовый элемент был в группе,
         // то вставлять их будем не после текстового элемента, а после группы
         //
-        if ((textFolderTypeFromString(currentTag) != TextFolderType::Undefined
-             || textGroupTypeFromString(currentTag) != TextGroupType::Undefined)
+        if ((mimeItem->type() == TextModelItemType::Folder
+             || mimeItem->type() == TextModelItemType::Group)
             && (lastItem->type() == TextModelItemType::Text
                 || lastItem->type() == TextModelItemType::Splitter)) {
             //
@@ -1297,10 +1459,14 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
         }
 
 
-        if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
-            newItem = createFolderItem(contentReader);
-        } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
-            auto newGroupItem = createGroupItem(contentReader);
+        switch (mimeItem->type()) {
+        case TextModelItemType::Folder: {
+            newItem = mimeItem;
+            break;
+        }
+
+        case TextModelItemType::Group: {
+            auto newGroupItem = static_cast<TextModelGroupItem*>(mimeItem);
             increaseMimeLength(newGroupItem->length());
 
             //
@@ -1322,13 +1488,15 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
             }
 
             newItem = newGroupItem;
-        } else if (currentTag == xml::kSplitterTag) {
+            break;
+        }
+
+        case TextModelItemType::Splitter: {
             const auto previousItemType
                 = insertAfterItem != nullptr ? insertAfterItem->type() : TextModelItemType::Folder;
             switch (previousItemType) {
             case TextModelItemType::Text: {
-                QScopedPointer<TextModelSplitterItem> newSplitterItem(
-                    createSplitterItem(contentReader));
+                const auto newSplitterItem = static_cast<TextModelSplitterItem*>(mimeItem);
                 const auto textItem = static_cast<TextModelTextItem*>(insertAfterItem);
 
                 //
@@ -1361,8 +1529,7 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
                 // Если всё прошло успешно, добавляем созданный разделитель
                 //
                 increaseMimeLength();
-                newItem = createSplitterItem();
-                newItem->copyFrom(newSplitterItem.data());
+                newItem = newSplitterItem;
                 break;
             }
 
@@ -1371,8 +1538,18 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
                 break;
             }
             }
-        } else {
-            auto newTextItem = createTextItem(contentReader);
+
+            //
+            // ... не вставленный разделитель больше не нужен
+            //
+            if (newItem == nullptr) {
+                delete mimeItem;
+            }
+            break;
+        }
+
+        case TextModelItemType::Text: {
+            auto newTextItem = static_cast<TextModelTextItem*>(mimeItem);
             increaseMimeLength(newTextItem->text().length());
             //
             // Смотрим на положение в таблице предыдущего элемента
@@ -1425,6 +1602,8 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
             else {
                 newItem = newTextItem;
             }
+            break;
+        }
         }
 
         if (newItem != nullptr) {
@@ -1437,22 +1616,24 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
     //
     // Если есть оторванный от первого блока текст
     //
-    if (!sourceBlockEndContent.isEmpty()) {
-        contentReader.clear();
-        contentReader.addData(sourceBlockEndContent);
-        contentReader.readNextStartElement(); // document
-        const auto hasContent = contentReader.readNextStartElement(); // potential text node
-        if (textFolderTypeFromString(contentReader.name().toString()) != TextFolderType::Undefined
-            || textGroupTypeFromString(contentReader.name().toString())
-                != TextGroupType::Undefined) {
-            while (contentReader.name() != xml::kContentTag) {
-                contentReader.readNextStartElement(); // content
-            }
-            contentReader.readNextStartElement(); // text node
+    if (!sourceBlockEndItems.isEmpty()) {
+        //
+        // ... то берём его текстовый блок, в том числе из группы, если блок был её заголовком
+        //
+        TextModelItem* sourceBlockEndItem = sourceBlockEndItems.constFirst();
+        if (sourceBlockEndItem->type() == TextModelItemType::Folder
+            || sourceBlockEndItem->type() == TextModelItemType::Group) {
+            sourceBlockEndItem
+                = sourceBlockEndItem->hasChildren() ? sourceBlockEndItem->childAt(0) : nullptr;
         }
-
-        if (hasContent) {
-            auto item = createTextItem(contentReader);
+        if (sourceBlockEndItem != nullptr
+            && sourceBlockEndItem->type() == TextModelItemType::Text) {
+            auto item = static_cast<TextModelTextItem*>(sourceBlockEndItem);
+            if (item->hasParent()) {
+                item->parent()->takeItem(item);
+            } else {
+                sourceBlockEndItems.removeAll(item);
+            }
             //
             // ... и последний вставленный элемент был текстовым
             //
@@ -1474,8 +1655,10 @@ int TextModel::insertFromMime(const QModelIndex& _index, int _positionInBlock,
                 lastItem = item;
             }
         }
+        qDeleteAll(sourceBlockEndItems);
     }
 
+
     //
     // Если есть оторванные текстовые блоки
     //
@@ -1596,6 +1779,11 @@ QModelIndex TextModel::indexForItem(TextModelItem* _item) const
     return index(row, 0, parent);
 }
 
+int TextModel::structureRevision() const
+{
+    return d->structureRevision;
+}
+
 void TextModel::setTitlePageModel(SimpleTextModel* _model)
 {
     d->titlePageModel = _model;
@@ -1649,6 +1837,17 @@ void TextModel::initDocument()
 
 void TextModel::clearDocument()
 {
+    //
+    // Скопированные фрагменты могут остаться в буфере обмена и после закрытия документа, поэтому
+    // переводим их в xml, пока модель ещё жива
+    //
+    for (auto& mimeData : d->mimeDataWithItems) {
+        if (!mimeData.isNull()) {
+            mimeData->releaseItems();
+        }
+    }
+    d->mimeDataWithItems.clear();
+
     if (!d->rootItem->hasChildren()) {
         return;
     }
@@ -2,6 +2,7 @@
 
 #include <business_layer/model/abstract_model.h>
 
+class QMimeData;
 class QXmlStreamReader;
 
 
@@ -12,6 +13,7 @@ enum class TextGroupType;
 class SimpleTextModel;
 class TextModelItem;
 class TextModelGroupItem;
+class TextModelMimeData;
 class TextModelFolderItem;
 class TextModelSplitterItem;
 class TextModelTextItem;
@@ -81,6 +83,13 @@ public:
     void updateItem(TextModelItem* _item);
     void updateItemForRoles(TextModelItem* _item, const QVector<int>& _roles);
 
+    /**
+     * @brief Задать тексты сразу нескольким блокам одним изменением
+     * @note Несохранённые ранее изменения сохраняются отдельно, а все новые тексты сохраняются
+     *       сразу после применения, поэтому групповое изменение отменяется за один шаг
+     */
+    void setItemsTexts(const QVector<QPair<TextModelTextItem*, QString>>& _itemsTexts);
+
     /**
      * @brief Реализация древовидной модели
      */
@@ -113,6 +122,32 @@ public:
      */
     int insertFromMime(const QModelIndex& _index, int _positionInBlock, const QString& _mimeData);
 
+    /**
+     * @brief Поместить в майм-данные копии элементов выделенного фрагмента
+     * @note Xml фрагмента формируется только если его запросит другое приложение
+     */
+    void setMimeFromSelection(TextModelMimeData* _mimeData, const QModelIndex& _from,
+                              int _fromPosition, const QModelIndex& _to, int _toPosition,
+                              bool _clearUuid) const;
+
+    /**
+     * @brief Вставить контент из майм-данных в заданной позиции
+     * @note Скопированные внутри приложения элементы вставляются без преобразования в xml
+     */
+    int insertFromMime(const QModelIndex& _index, int _positionInBlock,
+                       const QMimeData* _mimeData);
+
+    /**
+     * @brief Сформировать xml фрагмента документа из его элементов
+     */
+    static QString mimeFromItems(const QString& _documentMimeType,
+                                 const QVector<TextModelItem*>& _items);
+
+    /**
+     * @brief Количество преобразований фрагментов в xml и обратно, для проверок
+     */
+    static int mimeXmlConversionsCount();
+
     /**
      * @brief Получить элемент находящийся в заданном индексе
      */
@@ -123,6 +158,13 @@ public:
      */
     QModelIndex indexForItem(TextModelItem* _item) const;
 
+    /**
+     * @brief Номер версии структуры модели
+     * @note Меняется при каждой вставке, удалении и перемещении строк, а также при сбросе модели,
+     *       поэтому позволяет понять, что пути элементов, запомненные ранее, устарели
+     */
+    int structureRevision() const;
+
     /**
      * @brief Задать модель титульной страницы
      */
@@ -162,6 +204,13 @@ protected:
     virtual void finalizeInitialization() = 0;
 
 private:
+    /**
+     * @brief Вставить элементы фрагмента в заданной позиции
+     * @note Модель забирает владение элементами, невставленные элементы удаляются
+     */
+    int insertItemsFromMime(const QModelIndex& _index, int _positionInBlock,
+                            QVector<TextModelItem*> _items);
+
     class Implementation;
     QScopedPointer<Implementation> d;
 };
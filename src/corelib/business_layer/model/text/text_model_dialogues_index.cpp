@@ -0,0 +1,314 @@
+#include "text_model_dialogues_index.h"
+
+#include "text_model.h"
+#include "text_model_numbering.h"
+#include "text_model_text_item.h"
+#include "text_model_text_items_index.h"
+
+#include <business_layer/templates/text_template.h>
+
+#include <QHash>
+
+
+namespace BusinessLayer {
+
+class TextModelDialoguesIndex::Implementation
+{
+public:
+    Implementation(TextModel* _model, const CharacterNameParser& _characterName);
+
+    /**
+     * @brief Получить корневой элемент модели
+     */
+    TextModelItem* rootItem() const;
+
+    /**
+     * @brief Построить индекс, если он ещё не построен
+     */
+    void build();
+
+    /**
+     * @brief Очистить индекс
+     */
+    void clear();
+
+    /**
+     * @brief Обработать элемент при обходе модели
+     * @param _character Персонаж, которому принадлежат реплики в текущем месте документа
+     */
+    void processItem(TextModelItem* _item, QString& _character);
+
+    /**
+     * @brief Отнести реплику к заданному персонажу
+     */
+    void setDialogueCharacter(TextModelTextItem* _item, const QString& _character);
+
+    /**
+     * @brief Убрать реплику из индекса
+     */
+    void removeDialogue(TextModelTextItem* _item);
+
+    /**
+     * @brief Убрать из индекса элемент и всех его детей перед удалением из модели
+     */
+    void forget(TextModelItem* _item);
+
+
+    TextModel* model = nullptr;
+    CharacterNameParser characterName;
+
+    /**
+     * @brief Построен ли индекс
+     */
+    bool isBuilt = false;
+
+    /**
+     * @brief Идёт ли полное построение индекса, при котором реплики обходятся по порядку
+     */
+    bool isBuilding = false;
+
+    /**
+     * @brief Обход модели с запоминанием персонажа вокруг каждого элемента
+     */
+    TextModelNumbering<QString> walker;
+
+    /**
+     * @brief Персонажи реплик
+     */
+    QHash<TextModelTextItem*, QString> dialogueCharacters;
+
+    /**
+     * @brief Реплики персонажей в порядке следования в документе
+     */
+    QHash<QString, TextModelTextItemsIndex> characterDialogues;
+};
+
+TextModelDialoguesIndex::Implementation::Implementation(TextModel* _model,
+                                                        const CharacterNameParser& _characterName)
+    : model(_model)
+    , characterName(_characterName)
+    , walker([this](TextModelItem* _item, QString& _character) { processItem(_item, _character); },
+             [](TextModelItem*, QString&) {})
+{
+}
+
+TextModelItem* TextModelDialoguesIndex::Implementation::rootItem() const
+{
+    return model->itemForIndex({});
+}
+
+void TextModelDialoguesIndex::Implementation::build()
+{
+    if (isBuilt) {
+        return;
+    }
+
+    clear();
+    isBuilding = true;
+    walker.update(rootItem(), {});
+    isBuilding = false;
+    isBuilt = true;
+}
+
+void TextModelDialoguesIndex::Implementation::clear()
+{
+    isBuilt = false;
+    walker.clear();
+    dialogueCharacters.clear();
+    characterDialogues.clear();
+}
+
+void TextModelDialoguesIndex::Implementation::processItem(TextModelItem* _item,
+                                                          QString& _character)
+{
+    if (_item->type() != TextModelItemType::Text) {
+        return;
+    }
+
+    const auto textItem = static_cast<TextModelTextItem*>(_item);
+    switch (textItem->paragraphType()) {
+    case TextParagraphType::Character: {
+        _character = characterName(textItem->text());
+        removeDialogue(textItem);
+        break;
+    }
+
+    case TextParagraphType::Parenthetical: {
+        //
+        // Не очищаем имя персонажа, идём до реплики
+        //
+        removeDialogue(textItem);
+        break;
+    }
+
+    case TextParagraphType::Dialogue:
+    case TextParagraphType::Lyrics: {
+        setDialogueCharacter(textItem, _character);
+        break;
+    }
+
+    default: {
+        _character.clear();
+        removeDialogue(textItem);
+        break;
+    }
+    }
+}
+
+void TextModelDialoguesIndex::Implementation::setDialogueCharacter(TextModelTextItem* _item,
+                                                                   const QString& _character)
+{
+    const auto iter = dialogueCharacters.find(_item);
+    if (iter != dialogueCharacters.end()) {
+        if (iter.value() == _character) {
+            return;
+        }
+
+        removeDialogue(_item);
+    }
+
+    auto dialogues = characterDialogues.find(_character);
+    if (dialogues == characterDialogues.end()) {
+        dialogues = characterDialogues.insert(_character, {});
+        dialogues->setModel(model);
+    }
+
+    //
+    // При полном построении реплики идут в порядке следования в документе, поэтому их можно
+    // просто добавлять в конец, а при обновлении ищем место для вставки
+    //
+    if (isBuilding) {
+        dialogues->append(_item);
+    } else {
+        dialogues->insert(_item);
+    }
+    dialogueCharacters.insert(_item, _character);
+}
+
+void TextModelDialoguesIndex::Implementation::removeDialogue(TextModelTextItem* _item)
+{
+    const auto iter = dialogueCharacters.find(_item);
+    if (iter == dialogueCharacters.end()) {
+        return;
+    }
+
+    const auto dialogues = characterDialogues.find(iter.value());
+    if (dialogues != characterDialogues.end()) {
+        dialogues->remove(_item);
+        if (dialogues->isEmpty()) {
+            characterDialogues.erase(dialogues);
+        }
+    }
+    dialogueCharacters.erase(iter);
+}
+
+void TextModelDialoguesIndex::Implementation::forget(TextModelItem* _item)
+{
+    walker.forget(_item);
+
+    std::function<void(TextModelItem*)> removeDialogues;
+    removeDialogues = [this, &removeDialogues](TextModelItem* _childItem) {
+        if (_childItem->type() == TextModelItemType::Text) {
+            removeDialogue(static_cast<TextModelTextItem*>(_childItem));
+        }
+        for (int childIndex = 0; childIndex < _childItem->childCount(); ++childIndex) {
+            removeDialogues(_childItem->childAt(childIndex));
+        }
+    };
+    removeDialogues(_item);
+}
+
+
+// ****
+
+
+TextModelDialoguesIndex::TextModelDialoguesIndex(TextModel* _model,
+                                                 const CharacterNameParser& _characterName)
+    : QObject(_model)
+    , d(new Implementation(_model, _characterName))
+{
+    //
+    // Пока к индексу не обращались, не тратим время на его обновление
+    //
+    connect(_model, &TextModel::modelAboutToBeReset, this, [this] { d->clear(); });
+    connect(_model, &TextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                if (!d->isBuilt) {
+                    return;
+                }
+
+                d->walker.update(d->rootItem(), {}, d->model->itemForIndex(_parent), _first,
+                                 _last);
+            });
+    //
+    // ... удаляемые элементы забываем, пока они ещё находятся в модели, т.к. для удаления
+    //     реплики из списка персонажа нужно знать её положение в документе
+    //
+    connect(_model, &TextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                if (!d->isBuilt) {
+                    return;
+                }
+
+                const auto parentItem = d->model->itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->forget(parentItem->childAt(row));
+                }
+            });
+    connect(_model, &TextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                if (!d->isBuilt) {
+                    return;
+                }
+
+                d->walker.update(d->rootItem(), {}, d->model->itemForIndex(_parent), _first,
+                                 _first - 1);
+            });
+    //
+    // ... изменение типа или текста блока может поменять персонажа у следующих за ним реплик,
+    //     поэтому обновляем индекс сразу, начиная с изменённого элемента
+    //
+    connect(_model, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                if (!d->isBuilt || d->walker.isUpdating() || !_topLeft.isValid()) {
+                    return;
+                }
+
+                const auto parentItem = d->model->itemForIndex(_topLeft.parent());
+                d->walker.update(d->rootItem(), {}, parentItem, _topLeft.row(),
+                                 _bottomRight.row());
+            });
+}
+
+TextModelDialoguesIndex::~TextModelDialoguesIndex() = default;
+
+QVector<QModelIndex> TextModelDialoguesIndex::dialogues(const QString& _name) const
+{
+    d->build();
+
+    const auto dialogues = d->characterDialogues.constFind(_name);
+    if (dialogues == d->characterDialogues.constEnd()) {
+        return {};
+    }
+
+    QVector<QModelIndex> indexes;
+    indexes.reserve(dialogues->size());
+    for (int index = 0; index < dialogues->size(); ++index) {
+        indexes.append(d->model->indexForItem(dialogues->at(index)));
+    }
+    return indexes;
+}
+
+int TextModelDialoguesIndex::dialoguesCount(const QString& _name) const
+{
+    d->build();
+
+    const auto dialogues = d->characterDialogues.constFind(_name);
+    if (dialogues == d->characterDialogues.constEnd()) {
+        return 0;
+    }
+
+    return dialogues->size();
+}
+
+} // namespace BusinessLayer
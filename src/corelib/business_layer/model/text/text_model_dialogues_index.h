@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QObject>
+
+#include <corelib_global.h>
+
+#include <functional>
+
+class QModelIndex;
+
+
+namespace BusinessLayer {
+
+class TextModel;
+
+/**
+ * @brief Индекс реплик персонажей текстовой модели
+ *
+ * Реплики распределяются по персонажам при обходе модели в порядке следования в документе:
+ * реплика принадлежит персонажу из ближайшего предшествующего блока персонажа, если между ними
+ * нет других блоков, кроме ремарок и реплик. Индекс строится при первом обращении, а затем
+ * обновляется по сигналам модели, начиная с изменившегося элемента и до тех пор, пока
+ * распределение реплик не совпадёт с уже известным, поэтому получение реплик персонажа и их
+ * количества не требует обхода модели.
+ */
+class CORE_LIBRARY_EXPORT TextModelDialoguesIndex : public QObject
+{
+public:
+    /**
+     * @brief Функция извлечения имени персонажа из текста блока персонажа
+     */
+    using CharacterNameParser = std::function<QString(const QString&)>;
+
+    TextModelDialoguesIndex(TextModel* _model, const CharacterNameParser& _characterName);
+    ~TextModelDialoguesIndex() override;
+
+    /**
+     * @brief Реплики персонажа в порядке следования в документе
+     */
+    QVector<QModelIndex> dialogues(const QString& _name) const;
+
+    /**
+     * @brief Количество реплик персонажа
+     */
+    int dialoguesCount(const QString& _name) const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
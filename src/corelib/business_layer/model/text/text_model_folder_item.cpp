@@ -1,7 +1,7 @@
 #include "text_model_folder_item.h"
 
 #include "text_model.h"
-#include "text_model_group_item.h"
+#include "text_model_items_writer.h"
 #include "text_model_splitter_item.h"
 #include "text_model_text_item.h"
 #include "text_model_xml.h"
@@ -17,6 +17,112 @@
 
 namespace BusinessLayer {
 
+namespace {
+
+/**
+ * @brief Добавить блок, закрывающий папку
+ */
+template<typename Writer>
+void addFolderFooter(Writer& _writer, const TextModelFolderItem* _folder)
+{
+    TextModelTextItem item(_folder->model());
+    item.setParagraphType([type = _folder->folderType()] {
+        switch (type) {
+        default:
+        case TextFolderType::Act: {
+            return TextParagraphType::ActFooter;
+        }
+        case TextFolderType::Sequence: {
+            return TextParagraphType::SequenceFooter;
+        }
+        case TextFolderType::Part: {
+            return TextParagraphType::PartFooter;
+        }
+        case TextFolderType::Chapter: {
+            return TextParagraphType::ChapterFooter;
+        }
+        }
+    }());
+    _writer += &item;
+}
+
+/**
+ * @brief Добавить содержимое папки в заданном диапазоне в xml, либо в копии элементов
+ */
+template<typename Writer>
+void writeContent(Writer& _writer, const TextModelFolderItem* _folder, TextModelItem* _from,
+                  int _fromPosition, TextModelItem* _to, int _toPosition, bool _clearUuid)
+{
+    for (int childIndex = 0; childIndex < _folder->childCount(); ++childIndex) {
+        auto child = _folder->childAt(childIndex);
+
+        //
+        // Нетекстовые блоки, просто добавляем к общему xml
+        //
+        if (child->type() == TextModelItemType::Splitter) {
+            _writer += child;
+            continue;
+        }
+        //
+        // Папки и сцены проверяем на наличие в них завершающего элемента
+        //
+        else if (child->type() != TextModelItemType::Text) {
+            //
+            // Если конечный элемент содержится в дите, то сохраняем его и завершаем формирование
+            //
+            const bool recursively = true;
+            if (child->hasChild(_to, recursively)) {
+                addItemPart(_writer, child, _from, _fromPosition, _to, _toPosition, _clearUuid);
+
+                //
+                // Не забываем завершить папку
+                //
+                addFolderFooter(_writer, _folder);
+                break;
+            }
+            //
+            // В противном случае просто дополняем xml
+            //
+            else {
+                _writer += child;
+                continue;
+            }
+        }
+
+        //
+        // Текстовые блоки, в зависимости от необходимости вставить блок целиком, или его часть
+        //
+        auto textItem = static_cast<TextModelTextItem*>(child);
+        if (textItem == _to) {
+            if (textItem == _from) {
+                _writer += { textItem, _fromPosition, _toPosition - _fromPosition };
+            } else {
+                _writer += { textItem, 0, _toPosition };
+            }
+
+            //
+            // Если папка не была закрыта, добавим корректное завершение для неё
+            //
+            if (textItem->paragraphType() != TextParagraphType::ActFooter
+                && textItem->paragraphType() != TextParagraphType::SequenceFooter
+                && textItem->paragraphType() != TextParagraphType::PartFooter
+                && textItem->paragraphType() != TextParagraphType::ChapterFooter) {
+                addFolderFooter(_writer, _folder);
+            }
+            break;
+        }
+        //
+        else if (textItem == _from) {
+            _writer += { textItem, _fromPosition,
+                         static_cast<int>(textItem->text().length()) - _fromPosition };
+        } else {
+            _writer += textItem;
+        }
+    }
+}
+
+} // namespace
+
 class TextModelFolderItem::Implementation
 {
 public:
@@ -248,108 +354,37 @@ QByteArray TextModelFolderItem::toXml() const
 QByteArray TextModelFolderItem::toXml(TextModelItem* _from, int _fromPosition, TextModelItem* _to,
                                       int _toPosition, bool _clearUuid) const
 {
-    auto folderFooterXml = [this] {
-        TextModelTextItem item(model());
-        item.setParagraphType([type = d->folderType] {
-            switch (type) {
-            default:
-            case TextFolderType::Act: {
-                return TextParagraphType::ActFooter;
-            }
-            case TextFolderType::Sequence: {
-                return TextParagraphType::SequenceFooter;
-            }
-            case TextFolderType::Part: {
-                return TextParagraphType::PartFooter;
-            }
-            case TextFolderType::Chapter: {
-                return TextParagraphType::ChapterFooter;
-            }
-            }
-        }());
-        return item.toXml();
-    };
-
     xml::TextModelXmlWriter xml;
     xml += xmlHeader(_clearUuid);
-    for (int childIndex = 0; childIndex < childCount(); ++childIndex) {
-        auto child = childAt(childIndex);
-
-        //
-        // Нетекстовые блоки, просто добавляем к общему xml
-        //
-        if (child->type() == TextModelItemType::Splitter) {
-            xml += child;
-            continue;
-        }
-        //
-        // Папки и сцены проверяем на наличие в них завершающего элемента
-        //
-        else if (child->type() != TextModelItemType::Text) {
-            //
-            // Если конечный элемент содержится в дите, то сохраняем его и завершаем формирование
-            //
-            const bool recursively = true;
-            if (child->hasChild(_to, recursively)) {
-                if (child->type() == TextModelItemType::Folder) {
-                    auto folder = static_cast<TextModelFolderItem*>(child);
-                    xml += folder->toXml(_from, _fromPosition, _to, _toPosition, _clearUuid);
-                } else if (child->type() == TextModelItemType::Group) {
-                    auto group = static_cast<TextModelGroupItem*>(child);
-                    xml += group->toXml(_from, _fromPosition, _to, _toPosition, _clearUuid);
-                } else {
-                    Q_ASSERT(false);
-                }
+    writeContent(xml, this, _from, _fromPosition, _to, _toPosition, _clearUuid);
+    xml += QString("</%1>\n").arg(xml::kContentTag).toUtf8();
+    xml += QString("</%1>\n").arg(toString(d->folderType)).toUtf8();
 
-                //
-                // Не забываем завершить папку
-                //
-                xml += folderFooterXml();
-                break;
-            }
-            //
-            // В противном случае просто дополняем xml
-            //
-            else {
-                xml += child;
-                continue;
-            }
-        }
+    return xml.data();
+}
 
-        //
-        // Текстовые блоки, в зависимости от необходимости вставить блок целиком, или его часть
-        //
-        auto textItem = static_cast<TextModelTextItem*>(child);
-        if (textItem == _to) {
-            if (textItem == _from) {
-                xml += { textItem, _fromPosition, _toPosition - _fromPosition };
-            } else {
-                xml += { textItem, 0, _toPosition };
-            }
+TextModelFolderItem* TextModelFolderItem::copy(const TextModel* _model, TextModelItem* _from,
+                                               int _fromPosition, TextModelItem* _to,
+                                               int _toPosition, bool _clearUuid)
+{
+    auto folderItem = _model->createFolderItem(d->folderType);
+    folderItem->copyFrom(this);
+    if (_clearUuid) {
+        folderItem->d->uuid = QUuid::createUuid();
+    }
 
-            //
-            // Если папка не была закрыта, добавим корректное завершение для неё
-            //
-            if (textItem->paragraphType() != TextParagraphType::ActFooter
-                && textItem->paragraphType() != TextParagraphType::SequenceFooter
-                && textItem->paragraphType() != TextParagraphType::PartFooter
-                && textItem->paragraphType() != TextParagraphType::ChapterFooter) {
-                xml += folderFooterXml();
-            }
-            break;
-        }
-        //
-        else if (textItem == _from) {
-            xml += { textItem, _fromPosition,
-                     static_cast<int>(textItem->text().length()) - _fromPosition };
-        } else {
-            xml += textItem;
-        }
+    TextModelItemsWriter items(_model);
+    writeContent(items, this, _from, _fromPosition, _to, _toPosition, _clearUuid);
+    for (auto item : items.takeItems()) {
+        folderItem->appendItem(item);
     }
-    xml += QString("</%1>\n").arg(xml::kContentTag).toUtf8();
-    xml += QString("</%1>\n").arg(toString(d->folderType)).toUtf8();
 
-    return xml.data();
+    //
+    // Определим название
+    //
+    folderItem->handleChange();
+
+    return folderItem;
 }
 
 QByteArray TextModelFolderItem::xmlHeader(bool _clearUuid) const
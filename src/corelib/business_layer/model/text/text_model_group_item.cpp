@@ -1,6 +1,7 @@
 #include "text_model_group_item.h"
 
 #include "text_model.h"
+#include "text_model_items_writer.h"
 #include "text_model_splitter_item.h"
 #include "text_model_text_item.h"
 #include "text_model_xml.h"
@@ -17,6 +18,49 @@
 
 namespace BusinessLayer {
 
+namespace {
+
+/**
+ * @brief Добавить содержимое группы в заданном диапазоне в xml, либо в копии элементов
+ */
+template<typename Writer>
+void writeContent(Writer& _writer, const TextModelGroupItem* _group, TextModelItem* _from,
+                  int _fromPosition, TextModelItem* _to, int _toPosition)
+{
+    for (int childIndex = 0; childIndex < _group->childCount(); ++childIndex) {
+        auto child = _group->childAt(childIndex);
+
+        //
+        // Нетекстовые блоки, просто добавляем к общему xml
+        //
+        if (child->type() != TextModelItemType::Text) {
+            _writer += child;
+            continue;
+        }
+
+        //
+        // Текстовые блоки, в зависимости от необходимости вставить блок целиком, или его часть
+        //
+        auto textItem = static_cast<TextModelTextItem*>(child);
+        if (textItem == _to) {
+            if (textItem == _from) {
+                _writer += { textItem, _fromPosition, _toPosition - _fromPosition };
+            } else {
+                _writer += { textItem, 0, _toPosition };
+            }
+            break;
+        }
+        //
+        else if (textItem == _from) {
+            _writer += { textItem, _fromPosition, textItem->text().length() - _fromPosition };
+        } else {
+            _writer += textItem;
+        }
+    }
+}
+
+} // namespace
+
 class TextModelGroupItem::Implementation
 {
 public:
@@ -215,6 +259,14 @@ bool TextModelGroupItem::setNumber(int _number, const QString& _followNumber)
         }
     }
 
+    //
+    // Если номер не изменился, то не помечаем группу изменённой
+    //
+    if (d->number.has_value() && d->number->value == numberText
+        && d->number->followNumber == _followNumber) {
+        return true;
+    }
+
     auto newNumber = d->number.value_or(Number());
     newNumber.value = numberText;
     newNumber.followNumber = _followNumber;
@@ -561,42 +613,43 @@ QByteArray TextModelGroupItem::toXml(TextModelItem* _from, int _fromPosition, Te
 {
     xml::TextModelXmlWriter xml;
     xml += xmlHeader(_clearUuid);
-    for (int childIndex = 0; childIndex < childCount(); ++childIndex) {
-        auto child = childAt(childIndex);
-
-        //
-        // Нетекстовые блоки, просто добавляем к общему xml
-        //
-        if (child->type() != TextModelItemType::Text) {
-            xml += child;
-            continue;
-        }
-
-        //
-        // Текстовые блоки, в зависимости от необходимости вставить блок целиком, или его часть
-        //
-        auto textItem = static_cast<TextModelTextItem*>(child);
-        if (textItem == _to) {
-            if (textItem == _from) {
-                xml += { textItem, _fromPosition, _toPosition - _fromPosition };
-            } else {
-                xml += { textItem, 0, _toPosition };
-            }
-            break;
-        }
-        //
-        else if (textItem == _from) {
-            xml += { textItem, _fromPosition, textItem->text().length() - _fromPosition };
-        } else {
-            xml += textItem;
-        }
-    }
+    writeContent(xml, this, _from, _fromPosition, _to, _toPosition);
     xml += QString("</%1>\n").arg(xml::kContentTag).toUtf8();
     xml += QString("</%1>\n").arg(toString(d->groupType)).toUtf8();
 
     return xml.data();
 }
 
+TextModelGroupItem* TextModelGroupItem::copy(const TextModel* _model, TextModelItem* _from,
+                                             int _fromPosition, TextModelItem* _to,
+                                             int _toPosition, bool _clearUuid)
+{
+    auto groupItem = _model->createGroupItem(d->groupType);
+    groupItem->copyFrom(this);
+    if (_clearUuid) {
+        groupItem->d->uuid = QUuid::createUuid();
+    }
+    //
+    // ... в xml номер попадает, только если он задан вручную, или зафиксирован
+    //
+    if (d->number.has_value() && !d->number->isCustom && !d->number->isLocked) {
+        groupItem->resetNumber();
+    }
+
+    TextModelItemsWriter items(_model);
+    writeContent(items, this, _from, _fromPosition, _to, _toPosition);
+    for (auto item : items.takeItems()) {
+        groupItem->appendItem(item);
+    }
+
+    //
+    // Соберём заголовок, текст группы и прочие параметры
+    //
+    groupItem->handleChange();
+
+    return groupItem;
+}
+
 QByteArray TextModelGroupItem::xmlHeader(bool _clearUuid) const
 {
     QByteArray xml;
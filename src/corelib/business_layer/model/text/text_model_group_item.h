@@ -189,6 +189,13 @@ public:
                      bool _clearUuid) const;
     QByteArray xmlHeader(bool _clearUuid = false) const;
 
+    /**
+     * @brief Сформировать в заданной модели копию группы с содержимым в заданном диапазоне, такую
+     *        же, как если бы она была считана из xml этого диапазона
+     */
+    TextModelGroupItem* copy(const TextModel* _model, TextModelItem* _from, int _fromPosition,
+                             TextModelItem* _to, int _toPosition, bool _clearUuid);
+
     /**
      * @brief Скопировать контент с заданного элемента
      */
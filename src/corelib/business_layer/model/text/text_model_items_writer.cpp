@@ -0,0 +1,226 @@
+#include "text_model_items_writer.h"
+
+#include "text_model.h"
+#include "text_model_folder_item.h"
+#include "text_model_group_item.h"
+#include "text_model_splitter_item.h"
+#include "text_model_text_item.h"
+
+
+namespace BusinessLayer {
+
+class TextModelItemsWriter::Implementation
+{
+public:
+    explicit Implementation(const TextModel* _model);
+
+    /**
+     * @brief Добавить копию текстового элемента, объединяя её с последним недобавленным элементом
+     */
+    void writeTextItemData(const xml::TextModelXmlWriter::TextItemData& _data = {});
+
+
+    /**
+     * @brief Модель, в которой создаются копии
+     */
+    const TextModel* model = nullptr;
+
+    /**
+     * @brief Собственно копии элементов
+     */
+    QVector<TextModelItem*> items;
+
+    /**
+     * @brief Последний текстовый блок к добавлению
+     */
+    xml::TextModelXmlWriter::TextItemData lastTextItemData;
+};
+
+TextModelItemsWriter::Implementation::Implementation(const TextModel* _model)
+    : model(_model)
+{
+}
+
+void TextModelItemsWriter::Implementation::writeTextItemData(
+    const xml::TextModelXmlWriter::TextItemData& _data)
+{
+    auto appendTextItemCopy = [this](const xml::TextModelXmlWriter::TextItemData& _itemData) {
+        auto textItem = model->createTextItem();
+        textItem->copyPartFrom(_itemData.item, _itemData.fromPosition, _itemData.toPosition);
+        items.append(textItem);
+    };
+    auto writeLastTextItemDataAndDestroy = [this, appendTextItemCopy] {
+        appendTextItemCopy(lastTextItemData);
+        delete lastTextItemData.item;
+        lastTextItemData = {};
+    };
+
+    if (_data.item == nullptr) {
+        if (lastTextItemData.item == nullptr) {
+            return;
+        }
+
+        writeLastTextItemDataAndDestroy();
+        return;
+    }
+
+    if (lastTextItemData.item == nullptr) {
+        appendTextItemCopy(_data);
+        return;
+    }
+
+    lastTextItemData.item->setText(lastTextItemData.item->text() + " ");
+    lastTextItemData.item->mergeWith(_data.item);
+    Q_ASSERT(_data.fromPosition == 0);
+    lastTextItemData.toPosition += _data.toPosition + 1; // +1 - за пробел
+    writeLastTextItemDataAndDestroy();
+}
+
+
+// ****
+
+
+TextModelItemsWriter::TextModelItemsWriter(const TextModel* _model)
+    : d(new Implementation(_model))
+{
+}
+
+TextModelItemsWriter::~TextModelItemsWriter()
+{
+    delete d->lastTextItemData.item;
+    qDeleteAll(d->items);
+}
+
+const TextModel* TextModelItemsWriter::model() const
+{
+    return d->model;
+}
+
+void TextModelItemsWriter::operator+=(TextModelItem* _item)
+{
+    switch (_item->type()) {
+    //
+    // Текстовые элементы добавляем в специальном методе, т.к. возможно понадобится отложенная
+    // запись
+    //
+    case TextModelItemType::Text: {
+        auto textItem = static_cast<TextModelTextItem*>(_item);
+        operator+=({ textItem, 0, textItem->text().length() });
+        break;
+    }
+
+    case TextModelItemType::Splitter: {
+        auto splitterItem = d->model->createSplitterItem();
+        splitterItem->copyFrom(_item);
+        append(splitterItem);
+        break;
+    }
+
+    //
+    // Папки и группы копируем вместе со всем их содержимым
+    //
+    default: {
+        addItemPart(*this, _item, nullptr, 0, nullptr, 0, false);
+        break;
+    }
+    }
+}
+
+void TextModelItemsWriter::operator+=(const xml::TextModelXmlWriter::TextItemData& _data)
+{
+    if (_data.item->isCorrection()) {
+        return;
+    }
+
+    //
+    // Если элемент разорван, то сохраняем его и пока не добавляем
+    //
+    if (_data.item->isBreakCorrectionStart()) {
+        delete d->lastTextItemData.item;
+        auto textItem = new TextModelTextItem(_data.item->model());
+        textItem->copyFrom(_data.item);
+        d->lastTextItemData = { textItem, _data.fromPosition, _data.toPosition };
+    }
+    //
+    // А если элемент не разорван, добавим его копию, при необходимости соединив с предыдущим
+    //
+    else {
+        d->writeTextItemData(_data);
+    }
+}
+
+void TextModelItemsWriter::append(TextModelItem* _item)
+{
+    //
+    // Если был недобавленный элемент, добавляем его
+    //
+    d->writeTextItemData();
+
+    d->items.append(_item);
+}
+
+QVector<TextModelItem*> TextModelItemsWriter::takeItems()
+{
+    //
+    // Если был недобавленный элемент, добавляем его
+    //
+    d->writeTextItemData();
+
+    QVector<TextModelItem*> items;
+    items.swap(d->items);
+    return items;
+}
+
+
+// ****
+
+
+void addItemPart(xml::TextModelXmlWriter& _writer, TextModelItem* _item, TextModelItem* _from,
+                 int _fromPosition, TextModelItem* _to, int _toPosition, bool _clearUuid)
+{
+    switch (_item->type()) {
+    case TextModelItemType::Folder: {
+        const auto folderItem = static_cast<TextModelFolderItem*>(_item);
+        _writer += folderItem->toXml(_from, _fromPosition, _to, _toPosition, _clearUuid);
+        break;
+    }
+
+    case TextModelItemType::Group: {
+        const auto groupItem = static_cast<TextModelGroupItem*>(_item);
+        _writer += groupItem->toXml(_from, _fromPosition, _to, _toPosition, _clearUuid);
+        break;
+    }
+
+    default: {
+        Q_ASSERT(false);
+        break;
+    }
+    }
+}
+
+void addItemPart(TextModelItemsWriter& _writer, TextModelItem* _item, TextModelItem* _from,
+                 int _fromPosition, TextModelItem* _to, int _toPosition, bool _clearUuid)
+{
+    switch (_item->type()) {
+    case TextModelItemType::Folder: {
+        const auto folderItem = static_cast<TextModelFolderItem*>(_item);
+        _writer.append(folderItem->copy(_writer.model(), _from, _fromPosition, _to, _toPosition,
+                                        _clearUuid));
+        break;
+    }
+
+    case TextModelItemType::Group: {
+        const auto groupItem = static_cast<TextModelGroupItem*>(_item);
+        _writer.append(
+            groupItem->copy(_writer.model(), _from, _fromPosition, _to, _toPosition, _clearUuid));
+        break;
+    }
+
+    default: {
+        Q_ASSERT(false);
+        break;
+    }
+    }
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "text_model_xml_writer.h"
+
+#include <QVector>
+
+
+namespace BusinessLayer {
+
+class TextModel;
+class TextModelItem;
+
+/**
+ * @brief Класс для формирования копий элементов текстового документа
+ * @note Повторяет формирование xml фрагмента документа, в том числе склеивание разорванных
+ *       текстовых блоков, но вместо xml создаёт копии элементов в заданной модели
+ */
+class TextModelItemsWriter
+{
+public:
+    explicit TextModelItemsWriter(const TextModel* _model);
+    ~TextModelItemsWriter();
+
+    /**
+     * @brief Модель, в которой создаются копии элементов
+     */
+    const TextModel* model() const;
+
+    /**
+     * @brief Добавить копию элемента целиком, либо копию части текстового элемента
+     */
+    void operator+=(TextModelItem* _item);
+    void operator+=(const xml::TextModelXmlWriter::TextItemData& _data);
+
+    /**
+     * @brief Добавить созданный в модели элемент, владение которым переходит к писателю
+     */
+    void append(TextModelItem* _item);
+
+    /**
+     * @brief Забрать сформированные элементы, владение ими переходит к вызывающему
+     */
+    QVector<TextModelItem*> takeItems();
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+/**
+ * @brief Добавить часть папки или группы в заданном диапазоне в xml, либо в копии элементов
+ */
+void addItemPart(xml::TextModelXmlWriter& _writer, TextModelItem* _item, TextModelItem* _from,
+                 int _fromPosition, TextModelItem* _to, int _toPosition, bool _clearUuid);
+void addItemPart(TextModelItemsWriter& _writer, TextModelItem* _item, TextModelItem* _from,
+                 int _fromPosition, TextModelItem* _to, int _toPosition, bool _clearUuid);
+
+} // namespace BusinessLayer
@@ -0,0 +1,168 @@
+#include "text_model_mime_data.h"
+
+#include "text_model.h"
+#include "text_model_item.h"
+
+#include <QPointer>
+
+
+namespace BusinessLayer {
+
+class TextModelMimeData::Implementation
+{
+public:
+    ~Implementation();
+
+    /**
+     * @brief Сформировать xml фрагмента из копий элементов, если он ещё не сформирован
+     */
+    void buildContent() const;
+
+    /**
+     * @brief Удалить копии элементов
+     */
+    void clearItems();
+
+
+    QString mimeType;
+
+    /**
+     * @brief Xml фрагмента, для копий элементов формируется при первом запросе
+     */
+    mutable QString content;
+
+    /**
+     * @brief Модель, в которой созданы копии элементов, и формат её документа
+     */
+    QPointer<const TextModel> model;
+    QString documentMimeType;
+
+    /**
+     * @brief Копии элементов фрагмента
+     */
+    QVector<TextModelItem*> items;
+
+    /**
+     * @brief Закодированный фрагмент, формируется при первом запросе
+     */
+    mutable QByteArray encodedContent;
+};
+
+TextModelMimeData::Implementation::~Implementation()
+{
+    clearItems();
+}
+
+void TextModelMimeData::Implementation::buildContent() const
+{
+    if (!content.isEmpty() || items.isEmpty() || model.isNull()) {
+        return;
+    }
+
+    content = TextModel::mimeFromItems(documentMimeType, items);
+}
+
+void TextModelMimeData::Implementation::clearItems()
+{
+    qDeleteAll(items);
+    items.clear();
+    model.clear();
+}
+
+
+// ****
+
+
+TextModelMimeData::TextModelMimeData()
+    : QMimeData()
+    , d(new Implementation)
+{
+}
+
+TextModelMimeData::~TextModelMimeData() = default;
+
+void TextModelMimeData::setContent(const QString& _mimeType, const QString& _content)
+{
+    d->clearItems();
+    d->mimeType = _mimeType;
+    d->content = _content;
+    d->encodedContent.clear();
+}
+
+void TextModelMimeData::setItems(const QString& _mimeType, const TextModel* _model,
+                                 const QString& _documentMimeType,
+                                 const QVector<TextModelItem*>& _items)
+{
+    d->clearItems();
+    d->mimeType = _mimeType;
+    d->content.clear();
+    d->model = _model;
+    d->documentMimeType = _documentMimeType;
+    d->items = _items;
+    d->encodedContent.clear();
+}
+
+void TextModelMimeData::releaseItems()
+{
+    d->buildContent();
+    d->clearItems();
+}
+
+QVector<TextModelItem*> TextModelMimeData::items(const QMimeData* _data, const QString& _mimeType)
+{
+    const auto textModelData = qobject_cast<const TextModelMimeData*>(_data);
+    if (textModelData == nullptr || textModelData->d->mimeType != _mimeType
+        || textModelData->d->model.isNull()) {
+        return {};
+    }
+
+    return textModelData->d->items;
+}
+
+QString TextModelMimeData::content(const QMimeData* _data, const QString& _mimeType)
+{
+    if (_data == nullptr) {
+        return {};
+    }
+
+    if (const auto textModelData = qobject_cast<const TextModelMimeData*>(_data);
+        textModelData != nullptr && textModelData->d->mimeType == _mimeType) {
+        textModelData->d->buildContent();
+        return textModelData->d->content;
+    }
+
+    return QString::fromUtf8(_data->data(_mimeType));
+}
+
+QStringList TextModelMimeData::formats() const
+{
+    auto formats = QMimeData::formats();
+    if (!d->mimeType.isEmpty() && !formats.contains(d->mimeType)) {
+        formats.prepend(d->mimeType);
+    }
+    return formats;
+}
+
+bool TextModelMimeData::hasFormat(const QString& _mimeType) const
+{
+    return (!d->mimeType.isEmpty() && _mimeType == d->mimeType) || QMimeData::hasFormat(_mimeType);
+}
+
+#if (QT_VERSION > QT_VERSION_CHECK(6, 0, 0))
+QVariant TextModelMimeData::retrieveData(const QString& _mimeType, QMetaType _type) const
+#else
+QVariant TextModelMimeData::retrieveData(const QString& _mimeType, QVariant::Type _type) const
+#endif
+{
+    if (d->mimeType.isEmpty() || _mimeType != d->mimeType) {
+        return QMimeData::retrieveData(_mimeType, _type);
+    }
+
+    d->buildContent();
+    if (d->encodedContent.isEmpty() && !d->content.isEmpty()) {
+        d->encodedContent = d->content.toUtf8();
+    }
+    return d->encodedContent;
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QMimeData>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+
+class TextModel;
+class TextModelItem;
+
+/**
+ * @brief Майм-данные фрагмента текстового документа
+ * @note Внутри приложения фрагмент передаётся копиями элементов модели, а xml и байты для других
+ *       приложений формируются только в момент, когда они его запросят
+ */
+class CORE_LIBRARY_EXPORT TextModelMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    TextModelMimeData();
+    ~TextModelMimeData() override;
+
+    /**
+     * @brief Задать фрагмент документа в заданном формате
+     */
+    void setContent(const QString& _mimeType, const QString& _content);
+
+    /**
+     * @brief Задать фрагмент документа копиями элементов модели
+     * @note Майм-данные забирают владение элементами
+     */
+    void setItems(const QString& _mimeType, const TextModel* _model,
+                  const QString& _documentMimeType, const QVector<TextModelItem*>& _items);
+
+    /**
+     * @brief Сформировать xml фрагмента и удалить копии элементов, т.к. модель, в которой они
+     *        созданы, закрывается
+     */
+    void releaseItems();
+
+    /**
+     * @brief Получить копии элементов фрагмента заданного формата из майм-данных
+     * @note Элементы возвращаются только для данных, сформированных внутри приложения, пока жива
+     *       модель, в которой они созданы, владение элементами остаётся за майм-данными
+     */
+    static QVector<TextModelItem*> items(const QMimeData* _data, const QString& _mimeType);
+
+    /**
+     * @brief Получить фрагмент документа заданного формата из майм-данных
+     * @note Если данные сформированы внутри приложения, то они возвращаются без перекодирования
+     */
+    static QString content(const QMimeData* _data, const QString& _mimeType);
+
+    /**
+     * @brief Переопределяем, чтобы сообщать о формате фрагмента документа
+     */
+    /** @{ */
+    QStringList formats() const override;
+    bool hasFormat(const QString& _mimeType) const override;
+    /** @} */
+
+protected:
+    /**
+     * @brief Переопределяем, чтобы кодировать фрагмент документа только по запросу
+     */
+#if (QT_VERSION > QT_VERSION_CHECK(6, 0, 0))
+    QVariant retrieveData(const QString& _mimeType, QMetaType _type) const override;
+#else
+    QVariant retrieveData(const QString& _mimeType, QVariant::Type _type) const override;
+#endif
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
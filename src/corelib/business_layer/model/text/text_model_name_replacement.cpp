@@ -0,0 +1,176 @@
+#include "text_model_name_replacement.h"
+
+#include "text_model.h"
+#include "text_model_text_item.h"
+
+#include <utils/helpers/text_helper.h>
+
+#include <QRegularExpression>
+
+
+namespace BusinessLayer {
+
+class TextModelNameReplacement::Implementation
+{
+public:
+    Implementation(const QString& _oldName, const QString& _newName);
+
+
+    const QString oldName;
+    const QString newName;
+
+    /**
+     * @brief Новое имя для замены упоминаний в верхнем регистре
+     */
+    const QString upperNewName;
+
+    /**
+     * @brief Новое имя для замены остальных упоминаний
+     */
+    const QString sentenceNewName;
+
+    /**
+     * @brief Выражение для поиска упоминаний имени целым словом
+     */
+    QRegularExpression mentionMatcher;
+};
+
+TextModelNameReplacement::Implementation::Implementation(const QString& _oldName,
+                                                         const QString& _newName)
+    : oldName(TextHelper::smartToUpper(_oldName))
+    , newName(_newName)
+    , upperNewName(TextHelper::smartToUpper(_newName))
+    , sentenceNewName(TextHelper::toSentenceCase(_newName, true))
+    , mentionMatcher(QString("\\b(%1)\\b").arg(QRegularExpression::escape(oldName)),
+                     QRegularExpression::CaseInsensitiveOption
+                         | QRegularExpression::UseUnicodePropertiesOption)
+{
+    //
+    // Выражение используется для всех блоков всех документов, поэтому компилируем его сразу
+    //
+    mentionMatcher.optimize();
+}
+
+
+// ****
+
+
+TextModelNameReplacement::TextModelNameReplacement(const QString& _oldName,
+                                                   const QString& _newName)
+    : d(new Implementation(_oldName, _newName))
+{
+}
+
+TextModelNameReplacement::~TextModelNameReplacement() = default;
+
+const QString& TextModelNameReplacement::oldName() const
+{
+    return d->oldName;
+}
+
+const QString& TextModelNameReplacement::newName() const
+{
+    return d->newName;
+}
+
+bool TextModelNameReplacement::replaceFirst(QString& _text) const
+{
+    const auto nameIndex = TextHelper::smartToUpper(_text).indexOf(d->oldName);
+    if (nameIndex == -1) {
+        return false;
+    }
+
+    _text.replace(nameIndex, d->oldName.length(), d->newName);
+    return true;
+}
+
+bool TextModelNameReplacement::replaceInList(QString& _text) const
+{
+    const auto upperText = TextHelper::smartToUpper(_text);
+    auto nameIndex = upperText.indexOf(d->oldName);
+    while (nameIndex != -1) {
+        //
+        // Убедимся, что найдено именно имя, а не часть другого имени
+        //
+        const auto nameEndIndex = nameIndex + d->oldName.length();
+        const bool atLeftAllOk = nameIndex == 0 || _text.at(nameIndex - 1) == ','
+            || (nameIndex >= 2 && _text.mid(nameIndex - 2, 2) == ", ");
+        const bool atRightAllOk = nameEndIndex == _text.length() || _text.at(nameEndIndex) == ','
+            || (_text.length() > nameEndIndex + 1 && _text.mid(nameEndIndex, 2) == " ,");
+        if (!atLeftAllOk || !atRightAllOk) {
+            nameIndex = upperText.indexOf(d->oldName, nameIndex + 1);
+            continue;
+        }
+
+        _text.replace(nameIndex, d->oldName.length(), d->newName);
+        return true;
+    }
+
+    return false;
+}
+
+bool TextModelNameReplacement::replaceMentions(QString& _text) const
+{
+    //
+    // Поиск подстроки гораздо дешевле поиска по выражению, поэтому сперва отсеиваем тексты,
+    // в которых имени нет вовсе
+    //
+    if (!_text.contains(d->oldName, Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    auto matches = d->mentionMatcher.globalMatch(_text);
+    if (!matches.hasNext()) {
+        return false;
+    }
+
+    QString text;
+    text.reserve(_text.length());
+    int position = 0;
+    while (matches.hasNext()) {
+        const auto match = matches.next();
+        text.append(_text.constData() + position, match.capturedStart() - position);
+        text.append(match.captured() == d->oldName ? d->upperNewName : d->sentenceNewName);
+        position = match.capturedEnd();
+    }
+    text.append(_text.constData() + position, _text.length() - position);
+
+    _text = text;
+    return true;
+}
+
+void TextModelNameReplacement::apply(TextModel* _model, const Replacer& _replacer) const
+{
+    QVector<QPair<TextModelTextItem*, QString>> itemsTexts;
+    std::function<void(const TextModelItem*)> collectItemsTexts;
+    collectItemsTexts = [&_replacer, &itemsTexts,
+                         &collectItemsTexts](const TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            auto childItem = _item->childAt(childIndex);
+            switch (childItem->type()) {
+            case TextModelItemType::Folder:
+            case TextModelItemType::Group: {
+                collectItemsTexts(childItem);
+                break;
+            }
+
+            case TextModelItemType::Text: {
+                auto textItem = static_cast<TextModelTextItem*>(childItem);
+                auto text = textItem->text();
+                if (_replacer(textItem, text) && text != textItem->text()) {
+                    itemsTexts.append({ textItem, text });
+                }
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+    };
+    collectItemsTexts(_model->itemForIndex({}));
+
+    _model->setItemsTexts(itemsTexts);
+}
+
+} // namespace BusinessLayer
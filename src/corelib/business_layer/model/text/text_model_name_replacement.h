@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QScopedPointer>
+
+#include <corelib_global.h>
+
+#include <functional>
+
+class QString;
+
+
+namespace BusinessLayer {
+
+class TextModel;
+class TextModelTextItem;
+
+/**
+ * @brief Замена имени персонажа или локации в текстовых моделях
+ *
+ * Выражение для поиска упоминаний имени собирается один раз на всю замену и используется для всех
+ * документов проекта. Изменённые тексты блоков документа собираются за один обход модели и
+ * применяются к ней одним групповым изменением, поэтому модель уведомляет о замене единожды, а
+ * пользователь может отменить её в документе за один шаг.
+ */
+class CORE_LIBRARY_EXPORT TextModelNameReplacement
+{
+public:
+    /**
+     * @brief Функция замены имени в тексте блока
+     * @return Был ли изменён текст
+     */
+    using Replacer = std::function<bool(const TextModelTextItem* _item, QString& _text)>;
+
+    TextModelNameReplacement(const QString& _oldName, const QString& _newName);
+    ~TextModelNameReplacement();
+
+    /**
+     * @brief Заменяемое имя в верхнем регистре
+     */
+    const QString& oldName() const;
+
+    /**
+     * @brief Новое имя
+     */
+    const QString& newName() const;
+
+    /**
+     * @brief Заменить первое вхождение имени в тексте
+     */
+    bool replaceFirst(QString& _text) const;
+
+    /**
+     * @brief Заменить имя в перечислении через запятую
+     * @note Имена, частью которых является заменяемое, не изменяются
+     */
+    bool replaceInList(QString& _text) const;
+
+    /**
+     * @brief Заменить упоминания имени в тексте в любом регистре
+     * @note Упоминание в верхнем регистре заменяется новым именем в верхнем регистре, а остальные
+     *       упоминания - новым именем с заглавными буквами в начале слов
+     */
+    bool replaceMentions(QString& _text) const;
+
+    /**
+     * @brief Заменить имя в блоках модели одним изменением
+     */
+    void apply(TextModel* _model, const Replacer& _replacer) const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "text_model_item.h"
+
+#include <QSet>
+
+#include <functional>
+#include <unordered_map>
+
+
+namespace BusinessLayer {
+
+/**
+ * @brief Инкрементальная нумерация элементов текстовой модели
+ *
+ * Элементы обходятся в порядке следования в документе: при входе в элемент вызывается обработчик
+ * входа, а после обхода всех его детей - обработчик выхода. Состояние счётчиков вокруг каждого
+ * элемента запоминается, поэтому после изменения строк модели обход начинается с первого
+ * затронутого элемента и прекращается, как только состояние перед очередным незатронутым
+ * элементом совпадает с запомненным, т.к. дальше номера уже не изменятся.
+ *
+ * @note Обработчик входа в папку или группу может менять только состояние, но не сам элемент
+ */
+template<typename State>
+class TextModelNumbering
+{
+public:
+    using Handler = std::function<void(TextModelItem*, State&)>;
+
+    TextModelNumbering(const Handler& _enter, const Handler& _leave)
+        : m_enter(_enter)
+        , m_leave(_leave)
+    {
+    }
+
+    /**
+     * @brief Идёт ли сейчас нумерация
+     */
+    bool isUpdating() const
+    {
+        return m_isUpdating;
+    }
+
+    /**
+     * @brief Пронумеровать все элементы
+     */
+    void update(TextModelItem* _root, const State& _initialState)
+    {
+        m_isUpdating = true;
+
+        m_checkpoints.clear();
+        m_changedItems.clear();
+        State state = _initialState;
+        auto& rootCheckpoint = m_checkpoints[_root];
+        rootCheckpoint.before = state;
+        rootCheckpoint.inside = state;
+        for (int childIndex = 0; childIndex < _root->childCount(); ++childIndex) {
+            walk(_root->childAt(childIndex), state);
+        }
+        rootCheckpoint.beforeLeave = state;
+        rootCheckpoint.after = state;
+
+        m_isUpdating = false;
+    }
+
+    /**
+     * @brief Обновить нумерацию после изменения строк [_first, _last] заданного родителя
+     * @note При удалении строк последняя строка должна быть меньше первой
+     */
+    void update(TextModelItem* _root, const State& _initialState, TextModelItem* _parent,
+                int _first, int _last)
+    {
+        const auto rootIter = m_checkpoints.find(_root);
+        if (rootIter == m_checkpoints.end() || !(rootIter->second.before == _initialState)) {
+            update(_root, _initialState);
+            return;
+        }
+
+        m_isUpdating = true;
+
+        bool isUpdated = updateRange(_root, _parent, _first, _last);
+
+        //
+        // Элементы, изменённые без вставки или удаления строк, пересчитываем отдельно, т.к. обход
+        // мог остановиться раньше, чем дошёл до них
+        //
+        const auto changedItems = m_changedItems;
+        m_changedItems.clear();
+        for (auto item : changedItems) {
+            if (!isUpdated) {
+                break;
+            }
+            auto parent = item->parent();
+            if (parent == nullptr) {
+                continue;
+            }
+            const auto row = parent->rowOfChild(item);
+            isUpdated = updateRange(_root, parent, row, row);
+        }
+
+        m_isUpdating = false;
+
+        if (!isUpdated) {
+            update(_root, _initialState);
+        }
+    }
+
+    /**
+     * @brief Запомнить, что элемент изменился без изменения строк модели
+     */
+    void markChanged(TextModelItem* _item)
+    {
+        if (m_isUpdating || m_checkpoints.empty()) {
+            return;
+        }
+
+        m_changedItems.insert(_item);
+    }
+
+    /**
+     * @brief Забыть элемент и всех его детей перед удалением из модели
+     */
+    void forget(TextModelItem* _item)
+    {
+        m_checkpoints.erase(_item);
+        m_changedItems.remove(_item);
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            forget(_item->childAt(childIndex));
+        }
+    }
+
+    /**
+     * @brief Забыть все элементы
+     */
+    void clear()
+    {
+        m_checkpoints.clear();
+        m_changedItems.clear();
+    }
+
+private:
+    /**
+     * @brief Состояние счётчиков вокруг элемента
+     */
+    struct Checkpoint {
+        State before;
+        State inside;
+        State beforeLeave;
+        State after;
+    };
+
+    /**
+     * @brief Полностью пронумеровать элемент со всеми детьми
+     */
+    void walk(TextModelItem* _item, State& _state)
+    {
+        //
+        // NOTE: unordered_map не инвалидирует ссылки на элементы при добавлении новых
+        //
+        auto& checkpoint = m_checkpoints[_item];
+        checkpoint.before = _state;
+        m_enter(_item, _state);
+        checkpoint.inside = _state;
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            walk(_item->childAt(childIndex), _state);
+        }
+        checkpoint.beforeLeave = _state;
+        m_leave(_item, _state);
+        checkpoint.after = _state;
+    }
+
+    /**
+     * @brief Пронумеровать элементы, начиная с заданной строки родителя
+     * @return false, если запомненного состояния недостаточно и нужна полная нумерация
+     */
+    bool updateRange(TextModelItem* _root, TextModelItem* _parent, int _first, int _last)
+    {
+        if (_parent == nullptr || m_checkpoints.count(_parent) == 0) {
+            return false;
+        }
+
+        //
+        // Определим состояние счётчиков перед первой изменившейся строкой
+        //
+        State state;
+        if (_first > 0) {
+            const auto previousIter = m_checkpoints.find(_parent->childAt(_first - 1));
+            if (previousIter == m_checkpoints.end()) {
+                return false;
+            }
+            state = previousIter->second.after;
+        } else {
+            state = m_checkpoints[_parent].inside;
+        }
+
+        auto container = _parent;
+        int row = _first;
+        forever
+        {
+            for (; row < container->childCount(); ++row) {
+                const auto item = container->childAt(row);
+                const bool isChanged = container == _parent && row <= _last;
+                if (!isChanged) {
+                    //
+                    // Если состояние перед неизменённым элементом совпадает с запомненным, то
+                    // и до конца контейнера состояние будет таким же, как было
+                    //
+                    const auto itemIter = m_checkpoints.find(item);
+                    if (itemIter != m_checkpoints.end() && itemIter->second.before == state) {
+                        state = m_checkpoints[container].beforeLeave;
+                        break;
+                    }
+                }
+
+                walk(item, state);
+            }
+
+            auto& checkpoint = m_checkpoints[container];
+            checkpoint.beforeLeave = state;
+            if (container == _root) {
+                checkpoint.after = state;
+                return true;
+            }
+
+            //
+            // Выходим из контейнера, и если состояние после него не изменилось, то дальше все
+            // номера остаются прежними, т.к. выше изменившегося родителя состав детей не менялся
+            //
+            m_leave(container, state);
+            const bool isSameAfter = checkpoint.after == state;
+            checkpoint.after = state;
+            if (isSameAfter) {
+                return true;
+            }
+
+            const auto parent = container->parent();
+            if (parent == nullptr) {
+                return true;
+            }
+            row = parent->rowOfChild(container) + 1;
+            container = parent;
+        }
+    }
+
+    Handler m_enter;
+    Handler m_leave;
+    bool m_isUpdating = false;
+    std::unordered_map<const TextModelItem*, Checkpoint> m_checkpoints;
+    QSet<TextModelItem*> m_changedItems;
+};
+
+} // namespace BusinessLayer
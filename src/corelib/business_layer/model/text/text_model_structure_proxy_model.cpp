@@ -0,0 +1,537 @@
+#include "text_model_structure_proxy_model.h"
+
+#include "text_model.h"
+#include "text_model_item.h"
+
+#include <QHash>
+#include <QPointer>
+
+#include <algorithm>
+
+
+namespace BusinessLayer {
+
+namespace {
+
+/**
+ * @brief Узел структуры, соответствующий видимому элементу текстовой модели
+ */
+struct Node {
+    TextModelItem* item = nullptr;
+    Node* parent = nullptr;
+    int row = 0;
+    /**
+     * @brief Строка элемента в исходной модели, чтобы не искать её перебором детей родителя
+     */
+    int sourceRow = 0;
+    QVector<Node*> children;
+};
+
+} // namespace
+
+class TextModelStructureProxyModel::Implementation
+{
+public:
+    explicit Implementation(TextModelStructureProxyModel* _q);
+    ~Implementation();
+
+    /**
+     * @brief Удалить все узлы
+     */
+    void clear();
+
+    /**
+     * @brief Построить узлы для всей модели
+     */
+    void build();
+
+    /**
+     * @brief Создать узел для элемента и узлы для всех его видимых детей
+     */
+    Node* createNode(TextModelItem* _item, int _sourceRow, Node* _parent);
+
+    /**
+     * @brief Удалить узел вместе с детьми
+     */
+    void deleteNode(Node* _node);
+
+    /**
+     * @brief Обновить номера строк детей узла начиная с заданной
+     */
+    void updateRows(Node* _parent, int _fromRow);
+
+    /**
+     * @brief Сдвинуть строки исходной модели для детей узла, начиная с заданной строки
+     */
+    void shiftSourceRows(Node* _parent, int _fromSourceRow, int _distance);
+
+    /**
+     * @brief Индекс прокси модели для узла
+     */
+    QModelIndex proxyIndex(Node* _node) const;
+
+    /**
+     * @brief Индекс исходной модели для узла
+     */
+    QModelIndex sourceIndex(Node* _node) const;
+
+    /**
+     * @brief Определить строку в родительском узле, в которую нужно вставить элемент, находящийся
+     *        в заданной строке исходной модели
+     */
+    int rowForInsert(Node* _parent, int _sourceRow) const;
+
+    /**
+     * @brief Вставить узлы для элементов, заданных строками исходной модели
+     */
+    void insertNodes(Node* _parent, TextModelItem* _sourceParentItem,
+                     const QVector<int>& _sourceRows);
+
+    /**
+     * @brief Удалить заданный диапазон детей узла
+     */
+    void removeNodes(Node* _parent, int _fromRow, int _toRow);
+
+    /**
+     * @brief Обработать изменения исходной модели
+     */
+    void processSourceRowsInserted(const QModelIndex& _parent, int _first, int _last);
+    void processSourceRowsAboutToBeRemoved(const QModelIndex& _parent, int _first, int _last);
+    void processSourceRowsRemoved(const QModelIndex& _parent, int _first, int _last);
+    void processSourceDataChanged(const QModelIndex& _topLeft, const QModelIndex& _bottomRight,
+                                  const QVector<int>& _roles);
+
+
+    TextModelStructureProxyModel* q = nullptr;
+
+    /**
+     * @brief Текстовая модель, структуру которой отображаем
+     */
+    QPointer<TextModel> model;
+
+    /**
+     * @brief Корневой узел, соответствующий корневому элементу модели
+     */
+    Node root;
+
+    /**
+     * @brief Узлы видимых элементов модели
+     */
+    QHash<TextModelItem*, Node*> nodes;
+};
+
+TextModelStructureProxyModel::Implementation::Implementation(TextModelStructureProxyModel* _q)
+    : q(_q)
+{
+}
+
+TextModelStructureProxyModel::Implementation::~Implementation()
+{
+    clear();
+}
+
+void TextModelStructureProxyModel::Implementation::clear()
+{
+    for (auto node : std::as_const(root.children)) {
+        deleteNode(node);
+    }
+    root.children.clear();
+    root.item = nullptr;
+    nodes.clear();
+}
+
+void TextModelStructureProxyModel::Implementation::build()
+{
+    clear();
+
+    if (model.isNull()) {
+        return;
+    }
+
+    root.item = model->itemForIndex({});
+    if (root.item == nullptr) {
+        return;
+    }
+
+    nodes.insert(root.item, &root);
+    for (int row = 0; row < root.item->childCount(); ++row) {
+        auto childItem = root.item->childAt(row);
+        if (!q->filterAcceptsItem(childItem)) {
+            continue;
+        }
+
+        auto childNode = createNode(childItem, row, &root);
+        childNode->row = root.children.size();
+        root.children.append(childNode);
+    }
+}
+
+Node* TextModelStructureProxyModel::Implementation::createNode(TextModelItem* _item,
+                                                               int _sourceRow, Node* _parent)
+{
+    auto node = new Node;
+    node->item = _item;
+    node->parent = _parent;
+    node->sourceRow = _sourceRow;
+    nodes.insert(_item, node);
+
+    for (int row = 0; row < _item->childCount(); ++row) {
+        auto childItem = _item->childAt(row);
+        if (!q->filterAcceptsItem(childItem)) {
+            continue;
+        }
+
+        auto childNode = createNode(childItem, row, node);
+        childNode->row = node->children.size();
+        node->children.append(childNode);
+    }
+
+    return node;
+}
+
+void TextModelStructureProxyModel::Implementation::deleteNode(Node* _node)
+{
+    for (auto child : std::as_const(_node->children)) {
+        deleteNode(child);
+    }
+    nodes.remove(_node->item);
+    delete _node;
+}
+
+void TextModelStructureProxyModel::Implementation::updateRows(Node* _parent, int _fromRow)
+{
+    for (int row = _fromRow; row < _parent->children.size(); ++row) {
+        _parent->children[row]->row = row;
+    }
+}
+
+void TextModelStructureProxyModel::Implementation::shiftSourceRows(Node* _parent,
+                                                                  int _fromSourceRow,
+                                                                  int _distance)
+{
+    for (int row = rowForInsert(_parent, _fromSourceRow); row < _parent->children.size(); ++row) {
+        _parent->children[row]->sourceRow += _distance;
+    }
+}
+
+QModelIndex TextModelStructureProxyModel::Implementation::proxyIndex(Node* _node) const
+{
+    if (_node == nullptr || _node == &root) {
+        return {};
+    }
+
+    return q->createIndex(_node->row, 0, _node);
+}
+
+QModelIndex TextModelStructureProxyModel::Implementation::sourceIndex(Node* _node) const
+{
+    if (_node == nullptr || _node == &root) {
+        return {};
+    }
+
+    const auto index = model->index(_node->sourceRow, 0, sourceIndex(_node->parent));
+    Q_ASSERT(model->itemForIndex(index) == _node->item);
+    return index;
+}
+
+int TextModelStructureProxyModel::Implementation::rowForInsert(Node* _parent,
+                                                               int _sourceRow) const
+{
+    //
+    // Дети узла упорядочены по строкам исходной модели, поэтому ищем первый из них,
+    // находящийся не выше заданной строки
+    //
+    const auto child = std::lower_bound(
+        _parent->children.constBegin(), _parent->children.constEnd(), _sourceRow,
+        [](const Node* _node, int _row) { return _node->sourceRow < _row; });
+    return std::distance(_parent->children.constBegin(), child);
+}
+
+void TextModelStructureProxyModel::Implementation::insertNodes(Node* _parent,
+                                                               TextModelItem* _sourceParentItem,
+                                                               const QVector<int>& _sourceRows)
+{
+    if (_sourceRows.isEmpty()) {
+        return;
+    }
+
+    //
+    // Все вставляемые элементы разделены в исходной модели только скрытыми элементами,
+    // поэтому в структуре они идут подряд
+    //
+    const auto row = rowForInsert(_parent, _sourceRows.constFirst());
+    q->beginInsertRows(proxyIndex(_parent), row, row + _sourceRows.size() - 1);
+    for (int index = 0; index < _sourceRows.size(); ++index) {
+        const auto sourceRow = _sourceRows.at(index);
+        _parent->children.insert(
+            row + index, createNode(_sourceParentItem->childAt(sourceRow), sourceRow, _parent));
+    }
+    updateRows(_parent, row);
+    q->endInsertRows();
+}
+
+void TextModelStructureProxyModel::Implementation::removeNodes(Node* _parent, int _fromRow,
+                                                               int _toRow)
+{
+    q->beginRemoveRows(proxyIndex(_parent), _fromRow, _toRow);
+    for (int row = _toRow; row >= _fromRow; --row) {
+        deleteNode(_parent->children.takeAt(row));
+    }
+    updateRows(_parent, _fromRow);
+    q->endRemoveRows();
+}
+
+void TextModelStructureProxyModel::Implementation::processSourceRowsInserted(
+    const QModelIndex& _parent, int _first, int _last)
+{
+    const auto parentItem = model->itemForIndex(_parent);
+    const auto parentNode = nodes.value(parentItem);
+    if (parentNode == nullptr) {
+        return;
+    }
+
+    //
+    // Строки исходной модели у видимых элементов после вставленных сдвигаются вниз
+    //
+    shiftSourceRows(parentNode, _first, _last - _first + 1);
+
+    QVector<int> sourceRows;
+    for (int row = _first; row <= _last; ++row) {
+        if (q->filterAcceptsItem(parentItem->childAt(row))) {
+            sourceRows.append(row);
+        }
+    }
+    insertNodes(parentNode, parentItem, sourceRows);
+}
+
+void TextModelStructureProxyModel::Implementation::processSourceRowsAboutToBeRemoved(
+    const QModelIndex& _parent, int _first, int _last)
+{
+    const auto parentItem = model->itemForIndex(_parent);
+    const auto parentNode = nodes.value(parentItem);
+    if (parentNode == nullptr) {
+        return;
+    }
+
+    int fromRow = -1;
+    int toRow = -1;
+    for (int row = _first; row <= _last; ++row) {
+        const auto node = nodes.value(parentItem->childAt(row));
+        if (node == nullptr) {
+            continue;
+        }
+
+        if (fromRow == -1) {
+            fromRow = node->row;
+        }
+        toRow = node->row;
+    }
+    if (fromRow == -1) {
+        return;
+    }
+
+    removeNodes(parentNode, fromRow, toRow);
+}
+
+void TextModelStructureProxyModel::Implementation::processSourceRowsRemoved(
+    const QModelIndex& _parent, int _first, int _last)
+{
+    //
+    // Строки исходной модели у видимых элементов после удалённых сдвигаются вверх только после
+    // собственно удаления, до этого момента индексы исходной модели ещё старые
+    //
+    const auto parentNode = nodes.value(model->itemForIndex(_parent));
+    if (parentNode == nullptr) {
+        return;
+    }
+
+    shiftSourceRows(parentNode, _last + 1, _first - _last - 1);
+}
+
+void TextModelStructureProxyModel::Implementation::processSourceDataChanged(
+    const QModelIndex& _topLeft, const QModelIndex& _bottomRight, const QVector<int>& _roles)
+{
+    if (!_topLeft.isValid() || !_bottomRight.isValid()) {
+        return;
+    }
+
+    const auto parentItem = model->itemForIndex(_topLeft.parent());
+    const auto parentNode = nodes.value(parentItem);
+    if (parentNode == nullptr) {
+        return;
+    }
+
+    for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+        const auto item = parentItem->childAt(row);
+        const auto node = nodes.value(item);
+        const auto isVisible = q->filterAcceptsItem(item);
+
+        //
+        // Видимость не изменилась - уведомляем об изменении отображаемого элемента
+        //
+        if (node != nullptr && isVisible) {
+            const auto index = proxyIndex(node);
+            emit q->dataChanged(index, index, _roles);
+        }
+        //
+        // Элемент перестал быть видимым
+        //
+        else if (node != nullptr) {
+            removeNodes(parentNode, node->row, node->row);
+        }
+        //
+        // Элемент стал видимым
+        //
+        else if (isVisible) {
+            insertNodes(parentNode, parentItem, { row });
+        }
+    }
+}
+
+
+// ****
+
+
+TextModelStructureProxyModel::TextModelStructureProxyModel(QObject* _parent)
+    : QAbstractProxyModel(_parent)
+    , d(new Implementation(this))
+{
+}
+
+TextModelStructureProxyModel::~TextModelStructureProxyModel() = default;
+
+void TextModelStructureProxyModel::setSourceModel(QAbstractItemModel* _sourceModel)
+{
+    if (d->model != nullptr) {
+        d->model->disconnect(this);
+    }
+
+    beginResetModel();
+    d->model = qobject_cast<TextModel*>(_sourceModel);
+    QAbstractProxyModel::setSourceModel(_sourceModel);
+    d->build();
+    endResetModel();
+
+    if (d->model == nullptr) {
+        return;
+    }
+
+    auto beginReset = [this] {
+        beginResetModel();
+        d->clear();
+    };
+    auto endReset = [this] {
+        d->build();
+        endResetModel();
+    };
+    connect(d->model, &TextModel::modelAboutToBeReset, this, beginReset);
+    connect(d->model, &TextModel::modelReset, this, endReset);
+    connect(d->model, &TextModel::layoutAboutToBeChanged, this, beginReset);
+    connect(d->model, &TextModel::layoutChanged, this, endReset);
+    connect(d->model, &TextModel::rowsAboutToBeMoved, this, beginReset);
+    connect(d->model, &TextModel::rowsMoved, this, endReset);
+    connect(d->model, &TextModel::destroyed, this, [this] {
+        beginResetModel();
+        d->clear();
+        endResetModel();
+    });
+    connect(d->model, &TextModel::rowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                d->processSourceRowsInserted(_parent, _first, _last);
+            });
+    connect(d->model, &TextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                d->processSourceRowsAboutToBeRemoved(_parent, _first, _last);
+            });
+    connect(d->model, &TextModel::rowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                d->processSourceRowsRemoved(_parent, _first, _last);
+            });
+    connect(d->model, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight,
+                   const QVector<int>& _roles) {
+                d->processSourceDataChanged(_topLeft, _bottomRight, _roles);
+            });
+}
+
+QModelIndex TextModelStructureProxyModel::mapToSource(const QModelIndex& _proxyIndex) const
+{
+    if (!_proxyIndex.isValid() || d->model.isNull()) {
+        return {};
+    }
+
+    return d->sourceIndex(static_cast<Node*>(_proxyIndex.internalPointer()));
+}
+
+QModelIndex TextModelStructureProxyModel::mapFromSource(const QModelIndex& _sourceIndex) const
+{
+    if (!_sourceIndex.isValid() || d->model.isNull()) {
+        return {};
+    }
+
+    const auto node = d->nodes.value(d->model->itemForIndex(_sourceIndex));
+    return d->proxyIndex(node);
+}
+
+QModelIndex TextModelStructureProxyModel::index(int _row, int _column,
+                                                const QModelIndex& _parent) const
+{
+    if (_column != 0) {
+        return {};
+    }
+
+    const auto parentNode
+        = _parent.isValid() ? static_cast<Node*>(_parent.internalPointer()) : &d->root;
+    if (_row < 0 || _row >= parentNode->children.size()) {
+        return {};
+    }
+
+    return createIndex(_row, _column, parentNode->children.at(_row));
+}
+
+QModelIndex TextModelStructureProxyModel::parent(const QModelIndex& _child) const
+{
+    if (!_child.isValid()) {
+        return {};
+    }
+
+    const auto node = static_cast<Node*>(_child.internalPointer());
+    return d->proxyIndex(node->parent);
+}
+
+QModelIndex TextModelStructureProxyModel::sibling(int _row, int _column,
+                                                  const QModelIndex& _index) const
+{
+    return index(_row, _column, parent(_index));
+}
+
+int TextModelStructureProxyModel::rowCount(const QModelIndex& _parent) const
+{
+    if (_parent.column() > 0) {
+        return 0;
+    }
+
+    const auto parentNode
+        = _parent.isValid() ? static_cast<Node*>(_parent.internalPointer()) : &d->root;
+    return parentNode->children.size();
+}
+
+int TextModelStructureProxyModel::columnCount(const QModelIndex& _parent) const
+{
+    Q_UNUSED(_parent)
+    return 1;
+}
+
+bool TextModelStructureProxyModel::hasChildren(const QModelIndex& _parent) const
+{
+    return rowCount(_parent) > 0;
+}
+
+void TextModelStructureProxyModel::invalidateFilter()
+{
+    beginResetModel();
+    d->build();
+    endResetModel();
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QAbstractProxyModel>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+
+class TextModelItem;
+
+/**
+ * @brief Прокси модель для отображения структуры текстового документа в навигаторе
+ *
+ * В отличие от QSortFilterProxyModel хранит соответствие только для видимых элементов и
+ * обновляет его по сигналам исходной модели, поэтому изменения скрытых элементов (абзацев текста)
+ * обходятся в поиск по хэшу, а стоимость работы навигатора зависит от количества отображаемых
+ * элементов (папок и сцен), а не от количества абзацев.
+ */
+class CORE_LIBRARY_EXPORT TextModelStructureProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit TextModelStructureProxyModel(QObject* _parent = nullptr);
+    ~TextModelStructureProxyModel() override;
+
+    /**
+     * @brief Задать текстовую модель, структуру которой нужно отображать
+     */
+    void setSourceModel(QAbstractItemModel* _sourceModel) override;
+
+    /**
+     * @brief Реализация прокси модели
+     */
+    QModelIndex mapToSource(const QModelIndex& _proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& _sourceIndex) const override;
+    QModelIndex index(int _row, int _column, const QModelIndex& _parent = {}) const override;
+    QModelIndex parent(const QModelIndex& _child) const override;
+    QModelIndex sibling(int _row, int _column, const QModelIndex& _index) const override;
+    int rowCount(const QModelIndex& _parent = {}) const override;
+    int columnCount(const QModelIndex& _parent = {}) const override;
+    bool hasChildren(const QModelIndex& _parent = {}) const override;
+
+protected:
+    /**
+     * @brief Нужно ли отображать элемент текстовой модели
+     * @note Дети скрытого элемента не отображаются вне зависимости от результата для них
+     */
+    virtual bool filterAcceptsItem(TextModelItem* _item) const = 0;
+
+    /**
+     * @brief Перестроить структуру, после изменения условий фильтрации
+     */
+    void invalidateFilter();
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
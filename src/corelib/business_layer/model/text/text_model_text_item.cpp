@@ -39,6 +39,13 @@ public:
      */
     QByteArray buildXml(int _from, int _length);
 
+    /**
+     * @brief Редакторские заметки и форматирование заданного диапазона текста со смещением
+     *        относительно его начала
+     */
+    QVector<ReviewMark> reviewMarksToSave(int _from, int _length) const;
+    QVector<TextFormat> formatsToSave(int _from, int _length) const;
+
 
     TextModelTextItem* q = nullptr;
 
@@ -264,8 +271,6 @@ QByteArray TextModelTextItem::Implementation::buildXml(int _from, int _length)
         return {};
     }
 
-    const auto _end = _from + _length;
-
     QByteArray xml;
     xml += QString("<%1>").arg(toString(paragraphType)).toUtf8();
     if (alignment.has_value() || isInFirstColumn.has_value()) {
@@ -293,28 +298,7 @@ QByteArray TextModelTextItem::Implementation::buildXml(int _from, int _length)
     //
     // Сохранить редакторские заметки
     //
-    QVector<ReviewMark> reviewMarksToSave;
-    for (const auto& reviewMark : std::as_const(reviewMarks)) {
-        if (reviewMark.from >= _end) {
-            continue;
-        }
-
-        //
-        // Корректируем заметки, которые будут сохранены,
-        // т.к. начало и конец сохраняемого блока могут отличаться
-        //
-        auto reviewMarkToSave = reviewMark;
-        if (reviewMark.from >= _from) {
-            reviewMarkToSave.from -= _from;
-        } else {
-            reviewMarkToSave.from = 0;
-            reviewMarkToSave.length -= _from - reviewMark.from;
-        }
-        if (reviewMark.end() > _end) {
-            reviewMarkToSave.length -= reviewMark.end() - _end;
-        }
-        reviewMarksToSave.append(reviewMarkToSave);
-    }
+    const auto reviewMarksToSave = this->reviewMarksToSave(_from, _length);
     //
     // Собственно сохраняем
     //
@@ -362,28 +346,7 @@ QByteArray TextModelTextItem::Implementation::buildXml(int _from, int _length)
     //
     // Сохраняем форматированое блока
     //
-    QVector<TextFormat> formatsToSave;
-    for (const auto& format : std::as_const(formats)) {
-        if (format.from >= _end) {
-            continue;
-        }
-
-        //
-        // Корректируем заметки, которые будут сохранены,
-        // т.к. начало и конец сохраняемого блока могут отличаться
-        //
-        auto formatToSave = format;
-        if (format.from >= _from) {
-            formatToSave.from -= _from;
-        } else {
-            formatToSave.from = 0;
-            formatToSave.length -= _from - format.from;
-        }
-        if (format.end() > _end) {
-            formatToSave.length -= format.end() - _end;
-        }
-        formatsToSave.append(formatToSave);
-    }
+    const auto formatsToSave = this->formatsToSave(_from, _length);
     //
     // Собственно сохраняем
     //
@@ -436,6 +399,64 @@ QByteArray TextModelTextItem::Implementation::buildXml(int _from, int _length)
     return xml;
 }
 
+QVector<TextModelTextItem::ReviewMark> TextModelTextItem::Implementation::reviewMarksToSave(
+    int _from, int _length) const
+{
+    const auto _end = _from + _length;
+    QVector<ReviewMark> reviewMarksToSave;
+    for (const auto& reviewMark : std::as_const(reviewMarks)) {
+        if (reviewMark.from >= _end) {
+            continue;
+        }
+
+        //
+        // Корректируем заметки, которые будут сохранены,
+        // т.к. начало и конец сохраняемого блока могут отличаться
+        //
+        auto reviewMarkToSave = reviewMark;
+        if (reviewMark.from >= _from) {
+            reviewMarkToSave.from -= _from;
+        } else {
+            reviewMarkToSave.from = 0;
+            reviewMarkToSave.length -= _from - reviewMark.from;
+        }
+        if (reviewMark.end() > _end) {
+            reviewMarkToSave.length -= reviewMark.end() - _end;
+        }
+        reviewMarksToSave.append(reviewMarkToSave);
+    }
+    return reviewMarksToSave;
+}
+
+QVector<TextModelTextItem::TextFormat> TextModelTextItem::Implementation::formatsToSave(
+    int _from, int _length) const
+{
+    const auto _end = _from + _length;
+    QVector<TextFormat> formatsToSave;
+    for (const auto& format : std::as_const(formats)) {
+        if (format.from >= _end) {
+            continue;
+        }
+
+        //
+        // Корректируем заметки, которые будут сохранены,
+        // т.к. начало и конец сохраняемого блока могут отличаться
+        //
+        auto formatToSave = format;
+        if (format.from >= _from) {
+            formatToSave.from -= _from;
+        } else {
+            formatToSave.from = 0;
+            formatToSave.length -= _from - format.from;
+        }
+        if (format.end() > _end) {
+            formatToSave.length -= format.end() - _end;
+        }
+        formatsToSave.append(formatToSave);
+    }
+    return formatsToSave;
+}
+
 
 // ****
 
@@ -1026,6 +1047,32 @@ void TextModelTextItem::copyFrom(TextModelItem* _item)
     markChanged();
 }
 
+void TextModelTextItem::copyPartFrom(TextModelTextItem* _item, int _from, int _length)
+{
+    if (_item == nullptr) {
+        Q_ASSERT(false);
+        return;
+    }
+
+    //
+    // Для блока целиком берём весь сохраняемый текст, как это делается и при формировании xml
+    //
+    if (_from == 0 && _length == _item->text().length()) {
+        _length = _item->textToSave().length();
+    }
+
+    d->isInFirstColumn = _item->d->isInFirstColumn;
+    d->paragraphType = _item->d->paragraphType;
+    d->alignment = _item->d->alignment;
+    d->bookmark = _item->d->bookmark;
+    d->text = _item->textToSave().mid(_from, _length);
+    d->reviewMarks = _item->d->reviewMarksToSave(_from, _length);
+    d->formats = _item->d->formatsToSave(_from, _length);
+    d->updateXml();
+
+    markChanged();
+}
+
 bool TextModelTextItem::isEqual(TextModelItem* _item) const
 {
     if (_item == nullptr || type() != _item->type()) {
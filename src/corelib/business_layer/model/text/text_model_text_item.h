@@ -214,6 +214,12 @@ public:
      */
     void copyFrom(TextModelItem* _item) override;
 
+    /**
+     * @brief Скопировать часть заданного элемента в том виде, в котором она попадает в xml
+     * @note Номер блока, признаки декораций и ревизии не копируются, т.к. они не сохраняются
+     */
+    void copyPartFrom(TextModelTextItem* _item, int _from, int _length);
+
     /**
      * @brief Проверить равен ли текущий элемент заданному
      */
@@ -0,0 +1,146 @@
+#include "text_model_text_items_index.h"
+
+#include "text_model.h"
+#include "text_model_text_item.h"
+
+#include <utils/tools/model_index_path.h>
+
+#include <algorithm>
+
+
+namespace BusinessLayer {
+
+TextModelTextItemsIndex::TextModelTextItemsIndex() = default;
+
+void TextModelTextItemsIndex::setModel(TextModel* _model)
+{
+    m_model = _model;
+    clear();
+}
+
+void TextModelTextItemsIndex::clear()
+{
+    m_items.clear();
+    m_itemsSet.clear();
+    m_itemsPaths.clear();
+}
+
+int TextModelTextItemsIndex::size() const
+{
+    return m_items.size();
+}
+
+bool TextModelTextItemsIndex::isEmpty() const
+{
+    return m_items.isEmpty();
+}
+
+TextModelTextItem* TextModelTextItemsIndex::at(int _index) const
+{
+    return m_items.at(_index);
+}
+
+TextModelTextItem* TextModelTextItemsIndex::value(int _index) const
+{
+    return m_items.value(_index);
+}
+
+bool TextModelTextItemsIndex::contains(TextModelTextItem* _item) const
+{
+    return m_itemsSet.contains(_item);
+}
+
+int TextModelTextItemsIndex::indexOf(TextModelTextItem* _item) const
+{
+    if (!contains(_item)) {
+        return -1;
+    }
+
+    const auto index = lowerBound(_item);
+    if (index < m_items.size() && m_items.at(index) == _item) {
+        return index;
+    }
+
+    //
+    // Сюда попадаем, только если порядок элементов в модели изменился без уведомления списка,
+    // поэтому ищем по старинке
+    //
+    return m_items.indexOf(_item);
+}
+
+int TextModelTextItemsIndex::lowerBound(TextModelTextItem* _item) const
+{
+    if (m_model.isNull()) {
+        return m_items.size();
+    }
+
+    const auto path = itemPath(_item);
+    const auto iter = std::lower_bound(m_items.begin(), m_items.end(), path,
+                                       [this](TextModelTextItem* _value, const QList<int>& _path) {
+                                           return itemPath(_value) < _path;
+                                       });
+    return static_cast<int>(std::distance(m_items.begin(), iter));
+}
+
+void TextModelTextItemsIndex::append(TextModelTextItem* _item)
+{
+    m_items.append(_item);
+    m_itemsSet.insert(_item);
+}
+
+int TextModelTextItemsIndex::insert(TextModelTextItem* _item)
+{
+    const auto index = lowerBound(_item);
+    insert(index, _item);
+    return index;
+}
+
+void TextModelTextItemsIndex::insert(int _index, TextModelTextItem* _item)
+{
+    m_items.insert(_index, _item);
+    m_itemsSet.insert(_item);
+}
+
+int TextModelTextItemsIndex::remove(TextModelTextItem* _item)
+{
+    const auto index = indexOf(_item);
+    if (index != -1) {
+        removeAt(index);
+    }
+    return index;
+}
+
+void TextModelTextItemsIndex::removeAt(int _index)
+{
+    m_itemsSet.remove(m_items.at(_index));
+    m_itemsPaths.remove(m_items.at(_index));
+    m_items.removeAt(_index);
+}
+
+bool TextModelTextItemsIndex::isBefore(TextModelTextItem* _lhs, TextModelTextItem* _rhs) const
+{
+    if (m_model.isNull()) {
+        return false;
+    }
+
+    return itemPath(_lhs) < itemPath(_rhs);
+}
+
+QList<int> TextModelTextItemsIndex::itemPath(TextModelTextItem* _item) const
+{
+    //
+    // Если структура модели изменилась, то все запомненные пути устарели
+    //
+    if (m_itemsPathsRevision != m_model->structureRevision()) {
+        m_itemsPaths.clear();
+        m_itemsPathsRevision = m_model->structureRevision();
+    }
+
+    auto iter = m_itemsPaths.find(_item);
+    if (iter == m_itemsPaths.end()) {
+        iter = m_itemsPaths.insert(_item, ModelIndexPath(m_model->indexForItem(_item)).path());
+    }
+    return iter.value();
+}
+
+} // namespace BusinessLayer
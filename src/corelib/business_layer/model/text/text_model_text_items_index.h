@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+
+class TextModel;
+class TextModelTextItem;
+
+/**
+ * @brief Список текстовых элементов модели, упорядоченный по их расположению в документе
+ *
+ * Поиск и определение места для вставки элемента выполняются двоичным поиском по путям элементов
+ * в модели, поэтому все элементы списка должны находиться в модели на момент обращения к нему.
+ * Пути запоминаются и переиспользуются, пока не изменится структура модели.
+ */
+class CORE_LIBRARY_EXPORT TextModelTextItemsIndex
+{
+public:
+    TextModelTextItemsIndex();
+
+    /**
+     * @brief Задать модель, в которой находятся элементы
+     */
+    void setModel(TextModel* _model);
+
+    /**
+     * @brief Очистить список
+     */
+    void clear();
+
+    /**
+     * @brief Количество элементов в списке
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /**
+     * @brief Элемент в заданной позиции
+     */
+    TextModelTextItem* at(int _index) const;
+    TextModelTextItem* value(int _index) const;
+
+    /**
+     * @brief Есть ли элемент в списке
+     */
+    bool contains(TextModelTextItem* _item) const;
+
+    /**
+     * @brief Позиция элемента в списке, либо -1, если его там нет
+     */
+    int indexOf(TextModelTextItem* _item) const;
+
+    /**
+     * @brief Позиция, в которую должен быть вставлен элемент, чтобы не нарушить порядок
+     */
+    int lowerBound(TextModelTextItem* _item) const;
+
+    /**
+     * @brief Добавить элемент, который следует за всеми элементами списка
+     */
+    void append(TextModelTextItem* _item);
+
+    /**
+     * @brief Вставить элемент на своё место
+     * @return позицию вставленного элемента
+     */
+    int insert(TextModelTextItem* _item);
+
+    /**
+     * @brief Вставить элемент в заданную позицию
+     */
+    void insert(int _index, TextModelTextItem* _item);
+
+    /**
+     * @brief Удалить элемент из списка
+     * @return позицию удалённого элемента, либо -1, если его не было в списке
+     */
+    int remove(TextModelTextItem* _item);
+
+    /**
+     * @brief Удалить элемент в заданной позиции
+     */
+    void removeAt(int _index);
+
+    /**
+     * @brief Идёт ли первый элемент в документе раньше второго
+     */
+    bool isBefore(TextModelTextItem* _lhs, TextModelTextItem* _rhs) const;
+
+private:
+    /**
+     * @brief Путь элемента в модели, по которому определяется порядок элементов
+     */
+    QList<int> itemPath(TextModelTextItem* _item) const;
+
+    QPointer<TextModel> m_model;
+    QVector<TextModelTextItem*> m_items;
+    QSet<TextModelTextItem*> m_itemsSet;
+
+    /**
+     * @brief Запомненные пути элементов и версия структуры модели, для которой они построены
+     */
+    mutable QHash<TextModelTextItem*, QList<int>> m_itemsPaths;
+    mutable int m_itemsPathsRevision = -1;
+};
+
+} // namespace BusinessLayer
@@ -13,6 +13,7 @@
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -44,6 +45,8 @@ ScreenplayCharactersActivityPlot::~ScreenplayCharactersActivityPlot() = default;
 
 void ScreenplayCharactersActivityPlot::build(QAbstractItemModel* _model) const
 {
+    TRACE_SCOPE("plot", "ScreenplayCharactersActivityPlot::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -13,6 +13,7 @@
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -46,6 +47,8 @@ ScreenplayStructureAnalysisPlot::~ScreenplayStructureAnalysisPlot() = default;
 
 void ScreenplayStructureAnalysisPlot::build(QAbstractItemModel* _model) const
 {
+    TRACE_SCOPE("plot", "ScreenplayStructureAnalysisPlot::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -7,6 +7,7 @@
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/text_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QStandardItemModel>
@@ -74,6 +75,8 @@ ComicBookSummaryReport::~ComicBookSummaryReport() = default;
 
 void ComicBookSummaryReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ComicBookSummaryReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -122,12 +125,11 @@ void ComicBookSummaryReport::build(QAbstractItemModel* _model)
                 if (paragraphsToCounters.contains(textItem->paragraphType())) {
                     auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
                     ++paragraphCounters.occurrences;
-                    const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                    paragraphCounters.words += paragraphWords;
-                    totalWords += paragraphWords;
-                    totalCharacters.withSpaces += textItem->text().length();
-                    totalCharacters.withoutSpaces
-                        += textItem->text().length() - textItem->text().count(' ');
+                    const auto textCounters = TextHelper::counters(textItem->text());
+                    paragraphCounters.words += textCounters.words;
+                    totalWords += textCounters.words;
+                    totalCharacters.withSpaces += textCounters.characters;
+                    totalCharacters.withoutSpaces += textCounters.charactersWithoutSpaces;
                 }
 
                 //
@@ -9,6 +9,7 @@
 #include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QStandardItemModel>
@@ -41,6 +42,8 @@ NovelSummaryReport::~NovelSummaryReport() = default;
 
 void NovelSummaryReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "NovelSummaryReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -94,12 +97,11 @@ void NovelSummaryReport::build(QAbstractItemModel* _model)
                       if (paragraphsToCounters.contains(textItem->paragraphType())) {
                           auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
                           ++paragraphCounters.occurrences;
-                          const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                          paragraphCounters.words += paragraphWords;
-                          totalWords += paragraphWords;
-                          totalCharacters.withSpaces += textItem->text().length();
-                          totalCharacters.withoutSpaces
-                              += textItem->text().length() - textItem->text().count(' ');
+                          const auto textCounters = TextHelper::counters(textItem->text());
+                          paragraphCounters.words += textCounters.words;
+                          totalWords += textCounters.words;
+                          totalCharacters.withSpaces += textCounters.characters;
+                          totalCharacters.withoutSpaces += textCounters.charactersWithoutSpaces;
                       }
 
                       //
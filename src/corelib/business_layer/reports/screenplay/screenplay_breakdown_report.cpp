@@ -0,0 +1,280 @@
+#include "screenplay_breakdown_report.h"
+
+#include <3rd_party/qtxlsxwriter/xlsxdocument.h>
+#include <business_layer/model/screenplay/screenplay_dictionaries_model.h>
+#include <business_layer/model/screenplay/text/screenplay_breakdown_index.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model_scene_item.h>
+#include <ui/design_system/design_system.h>
+#include <utils/helpers/color_helper.h>
+#include <utils/tracing.h>
+
+#include <QCoreApplication>
+#include <QStandardItemModel>
+
+
+namespace BusinessLayer {
+
+class ScreenplayBreakdownReport::Implementation
+{
+public:
+    /**
+     * @brief Листы разработки сцен
+     */
+    QScopedPointer<QStandardItemModel> scenesModel;
+
+    /**
+     * @brief Сводка по категориям ресурсов
+     */
+    QScopedPointer<QStandardItemModel> categoriesModel;
+};
+
+
+// ****
+
+
+ScreenplayBreakdownReport::ScreenplayBreakdownReport()
+    : d(new Implementation)
+{
+}
+
+ScreenplayBreakdownReport::~ScreenplayBreakdownReport() = default;
+
+void ScreenplayBreakdownReport::build(QAbstractItemModel* _model)
+{
+    TRACE_SCOPE("report", "ScreenplayBreakdownReport::build");
+
+    if (_model == nullptr) {
+        return;
+    }
+
+    auto screenplayModel = qobject_cast<ScreenplayTextModel*>(_model);
+    if (screenplayModel == nullptr || screenplayModel->dictionariesModel() == nullptr) {
+        return;
+    }
+
+    //
+    // Подготовим справочники ресурсов
+    //
+    const auto categories = screenplayModel->dictionariesModel()->resourceCategories();
+    QHash<QUuid, QString> categoriesNames;
+    for (const auto& category : categories) {
+        categoriesNames.insert(category.uuid, category.name);
+    }
+    const auto resources = screenplayModel->dictionariesModel()->resources();
+    QHash<QUuid, BreakdownResource> resourcesByUuid;
+    for (const auto& resource : resources) {
+        resourcesByUuid.insert(resource.uuid, resource);
+    }
+
+    auto createModelItem = [](const QString& _text, const QVariant _backgroundColor = {}) {
+        auto item = new QStandardItem(_text);
+        item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        if (_backgroundColor.isValid()) {
+            item->setData(_backgroundColor, Qt::BackgroundRole);
+        }
+        return item;
+    };
+    const auto titleBackgroundColor = QVariant::fromValue(ColorHelper::transparent(
+        Ui::DesignSystem::color().onBackground(), Ui::DesignSystem::elevationEndOpacity()));
+
+    //
+    // Формируем листы разработки сцен, в которых задействованы ресурсы
+    //
+    if (d->scenesModel.isNull()) {
+        d->scenesModel.reset(new QStandardItemModel);
+    } else {
+        d->scenesModel->clear();
+    }
+    std::function<void(const TextModelItem*)> includeInReport;
+    includeInReport = [this, &includeInReport, &createModelItem, &titleBackgroundColor,
+                       &categoriesNames, &resourcesByUuid](const TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            auto childItem = _item->childAt(childIndex);
+            if (childItem->type() == TextModelItemType::Folder) {
+                includeInReport(childItem);
+                continue;
+            }
+
+            if (childItem->type() != TextModelItemType::Group
+                || static_cast<TextModelGroupItem*>(childItem)->groupType()
+                    != TextGroupType::Scene) {
+                continue;
+            }
+
+            const auto sceneItem = static_cast<ScreenplayTextModelSceneItem*>(childItem);
+            const auto sceneResources = sceneItem->resources();
+            if (sceneResources.isEmpty()) {
+                continue;
+            }
+
+            const auto sceneNumber = sceneItem->number();
+            auto sceneModelItem = createModelItem(sceneItem->heading(), titleBackgroundColor);
+            for (const auto& sceneResource : sceneResources) {
+                const auto resource = resourcesByUuid.value(sceneResource.uuid);
+                sceneModelItem->appendRow({
+                    createModelItem(resource.name),
+                    createModelItem({}),
+                    createModelItem(categoriesNames.value(resource.categoryUuid)),
+                    createModelItem(QString::number(sceneResource.qty)),
+                    createModelItem(sceneResource.description),
+                });
+            }
+            d->scenesModel->appendRow({
+                sceneModelItem,
+                createModelItem(sceneNumber.has_value() ? sceneNumber->text : QString(),
+                                titleBackgroundColor),
+                createModelItem({}, titleBackgroundColor),
+                createModelItem({}, titleBackgroundColor),
+                createModelItem({}, titleBackgroundColor),
+            });
+        }
+    };
+    includeInReport(screenplayModel->itemForIndex({}));
+    //
+    d->scenesModel->setHeaderData(
+        0, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Scene/resource"),
+        Qt::DisplayRole);
+    d->scenesModel->setHeaderData(
+        1, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Number"),
+        Qt::DisplayRole);
+    d->scenesModel->setHeaderData(
+        2, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Category"),
+        Qt::DisplayRole);
+    d->scenesModel->setHeaderData(
+        3, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Quantity"),
+        Qt::DisplayRole);
+    d->scenesModel->setHeaderData(
+        4, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Description"),
+        Qt::DisplayRole);
+
+    //
+    // Формируем сводку по категориям, беря готовые итоги из индекса ресурсов модели
+    //
+    if (d->categoriesModel.isNull()) {
+        d->categoriesModel.reset(new QStandardItemModel);
+    } else {
+        d->categoriesModel->clear();
+    }
+    const auto breakdownIndex = screenplayModel->breakdownIndex();
+    for (const auto& category : categories) {
+        const auto categoryTotals = breakdownIndex->categoryTotals(category.uuid);
+        if (categoryTotals.resourcesCount == 0) {
+            continue;
+        }
+
+        auto categoryItem = createModelItem(category.name, titleBackgroundColor);
+        for (const auto& resource : resources) {
+            if (resource.categoryUuid != category.uuid) {
+                continue;
+            }
+
+            const auto resourceTotals = breakdownIndex->resourceTotals(resource.uuid);
+            if (resourceTotals.scenesCount == 0) {
+                continue;
+            }
+
+            categoryItem->appendRow({
+                createModelItem(resource.name),
+                createModelItem({}),
+                createModelItem(QString::number(resourceTotals.scenesCount)),
+                createModelItem(QString::number(resourceTotals.qty)),
+            });
+        }
+        d->categoriesModel->appendRow({
+            categoryItem,
+            createModelItem(QString::number(categoryTotals.resourcesCount), titleBackgroundColor),
+            createModelItem(QString::number(categoryTotals.scenesCount), titleBackgroundColor),
+            createModelItem(QString::number(categoryTotals.qty), titleBackgroundColor),
+        });
+    }
+    //
+    d->categoriesModel->setHeaderData(0, Qt::Horizontal,
+                                      QCoreApplication::translate(
+                                          "BusinessLayer::ScreenplayBreakdownReport",
+                                          "Category/resource"),
+                                      Qt::DisplayRole);
+    d->categoriesModel->setHeaderData(
+        1, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Resources"),
+        Qt::DisplayRole);
+    d->categoriesModel->setHeaderData(
+        2, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Scenes"),
+        Qt::DisplayRole);
+    d->categoriesModel->setHeaderData(
+        3, Qt::Horizontal,
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Quantity"),
+        Qt::DisplayRole);
+}
+
+void ScreenplayBreakdownReport::saveToFile(const QString& _fileName) const
+{
+    if (scenesModel() == nullptr || categoriesModel() == nullptr) {
+        return;
+    }
+
+    QXlsx::Document xlsx;
+    QXlsx::Format headerFormat;
+    headerFormat.setFontBold(true);
+    QXlsx::Format textHeaderFormat;
+    textHeaderFormat.setFillPattern(QXlsx::Format::PatternLightUp);
+
+    //
+    // Каждая таблица отчёта сохраняется на отдельный лист, при этом строки верхнего уровня
+    // (сцены и категории) выделяются, а под ними идут строки их ресурсов
+    //
+    auto writeSheet = [&xlsx, &headerFormat, &textHeaderFormat](const QString& _sheetName,
+                                                                const QAbstractItemModel* _model) {
+        xlsx.addSheet(_sheetName);
+        xlsx.selectSheet(_sheetName);
+
+        constexpr int firstRow = 1;
+        constexpr int firstColumn = 1;
+        int reportRow = firstRow;
+        for (int column = 0; column < _model->columnCount(); ++column) {
+            xlsx.write(reportRow, column + firstColumn, _model->headerData(column, Qt::Horizontal),
+                       headerFormat);
+        }
+        for (int row = 0; row < _model->rowCount(); ++row) {
+            ++reportRow;
+            for (int column = 0; column < _model->columnCount(); ++column) {
+                xlsx.write(reportRow, column + firstColumn, _model->index(row, column).data(),
+                           textHeaderFormat);
+            }
+
+            const auto parentIndex = _model->index(row, 0);
+            for (int childRow = 0; childRow < _model->rowCount(parentIndex); ++childRow) {
+                ++reportRow;
+                for (int column = 0; column < _model->columnCount(parentIndex); ++column) {
+                    xlsx.write(reportRow, column + firstColumn,
+                               _model->index(childRow, column, parentIndex).data());
+                }
+            }
+        }
+    };
+    writeSheet(QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Scenes"),
+               scenesModel());
+    writeSheet(
+        QCoreApplication::translate("BusinessLayer::ScreenplayBreakdownReport", "Categories"),
+        categoriesModel());
+
+    xlsx.saveAs(_fileName);
+}
+
+QAbstractItemModel* ScreenplayBreakdownReport::scenesModel() const
+{
+    return d->scenesModel.data();
+}
+
+QAbstractItemModel* ScreenplayBreakdownReport::categoriesModel() const
+{
+    return d->categoriesModel.data();
+}
+
+} // namespace BusinessLayer
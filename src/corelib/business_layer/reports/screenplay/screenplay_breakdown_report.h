@@ -0,0 +1,44 @@
+#pragma once
+
+#include <business_layer/reports/abstract_report.h>
+
+#include <QScopedPointer>
+
+
+namespace BusinessLayer {
+
+/**
+ * @brief Отчёт по разработке сценария
+ */
+class CORE_LIBRARY_EXPORT ScreenplayBreakdownReport : public AbstractReport
+{
+public:
+    ScreenplayBreakdownReport();
+    ~ScreenplayBreakdownReport() override;
+
+    /**
+     * @brief Сформировать отчёт из модели
+     */
+    void build(QAbstractItemModel* _model) override;
+
+    /**
+     * @brief Сохранить отчёт в файл
+     */
+    void saveToFile(const QString& _fileName) const override;
+
+    /**
+     * @brief Получить листы разработки сцен
+     */
+    QAbstractItemModel* scenesModel() const;
+
+    /**
+     * @brief Получить сводку по категориям ресурсов
+     */
+    QAbstractItemModel* categoriesModel() const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
@@ -10,6 +10,7 @@
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/text_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -45,6 +46,8 @@ ScreenplayCastReport::~ScreenplayCastReport() = default;
 
 void ScreenplayCastReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ScreenplayCastReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -12,6 +12,7 @@
 #include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -45,6 +46,8 @@ ScreenplayGenderReport::~ScreenplayGenderReport() = default;
 
 void ScreenplayGenderReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ScreenplayGenderReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -14,6 +14,7 @@
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -50,6 +51,8 @@ ScreenplayLocationReport::~ScreenplayLocationReport() = default;
 
 void ScreenplayLocationReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ScreenplayLocationReport::build");
+
     if (_model == nullptr) {
         return;
     }
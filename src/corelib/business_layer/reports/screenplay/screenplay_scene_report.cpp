@@ -15,6 +15,7 @@
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -51,6 +52,8 @@ ScreenplaySceneReport::~ScreenplaySceneReport() = default;
 
 void ScreenplaySceneReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ScreenplaySceneReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -12,6 +12,7 @@
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
+#include <utils/tracing.h>
 
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -48,6 +49,8 @@ ScreenplaySummaryReport::~ScreenplaySummaryReport() = default;
 
 void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
 {
+    TRACE_SCOPE("report", "ScreenplaySummaryReport::build");
+
     if (_model == nullptr) {
         return;
     }
@@ -125,12 +128,11 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
                 if (paragraphsToCounters.contains(textItem->paragraphType())) {
                     auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
                     ++paragraphCounters.occurrences;
-                    const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                    paragraphCounters.words += paragraphWords;
-                    totalWords += paragraphWords;
-                    totalCharacters.withSpaces += textItem->text().length();
-                    totalCharacters.withoutSpaces
-                        += textItem->text().length() - textItem->text().count(' ');
+                    const auto textCounters = TextHelper::counters(textItem->text());
+                    paragraphCounters.words += textCounters.words;
+                    totalWords += textCounters.words;
+                    totalCharacters.withSpaces += textCounters.characters;
+                    totalCharacters.withoutSpaces += textCounters.charactersWithoutSpaces;
                 }
 
                 //
@@ -1,12 +1,14 @@
 #include "text_template.h"
 
 #include <ui/widgets/text_edit/page/page_text_edit.h>
+#include <utils/helpers/font_helper.h>
 #include <utils/helpers/measurement_helper.h>
 #include <utils/helpers/string_helper.h>
 #include <utils/helpers/text_helper.h>
 
 #include <QCoreApplication>
 #include <QFile>
+#include <QSet>
 #include <QTextBlock>
 #include <QTextBlockFormat>
 #include <QUuid>
@@ -101,6 +103,27 @@ TextBlockStyle::LineSpacingType lineSpacingFromString(const QString& _lineSpacin
     return kLineSpacingToString.key(_lineSpacing);
 }
 
+/**
+ * @brief Семейства шрифтов, используемых в стилях блоков шаблона, включая шаблоны титульной
+ *        страницы и синопсиса
+ */
+QSet<QString> fontFamilies(const QString& _templateXml)
+{
+    QSet<QString> families;
+    QXmlStreamReader reader(_templateXml);
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        const auto fontFamily = reader.attributes().value(QLatin1String("font_family"));
+        if (!fontFamily.isEmpty()) {
+            families.insert(fontFamily.toString());
+        }
+    }
+    return families;
+}
+
 } // namespace
 
 
@@ -964,6 +987,13 @@ void TextTemplate::load(const QString& _fromFile)
         return;
     }
     const QString templateXml = templateFile.readAll();
+
+    //
+    // Встроенные шрифты шаблонов загружаются по мере необходимости, поэтому регистрируем их
+    // до разбора стилей, ведь высота строк блоков рассчитывается по метрикам шрифта
+    //
+    FontHelper::loadFontFamilies(fontFamilies(templateXml));
+
     QXmlStreamReader reader(templateXml);
 
     //
@@ -12,6 +12,13 @@ greaterThan(QT_MAJOR_VERSION, 5) {
 DEFINES += CORE_LIBRARY
 DEFINES += QT_DEPRECATED_WARNINGS
 
+#
+# Трассировка выполнения включается через qmake CONFIG+=tracing
+#
+tracing {
+    DEFINES += STARC_TRACING
+}
+
 mac {
     DESTDIR = ../_build/starcapp.app/Contents/Frameworks
 } else {
@@ -180,6 +187,7 @@ SOURCES += \
     business_layer/model/screenplay/screenplay_information_model.cpp \
     business_layer/model/screenplay/screenplay_statistics_model.cpp \
     business_layer/model/screenplay/screenplay_synopsis_model.cpp \
+    business_layer/model/screenplay/text/screenplay_breakdown_index.cpp \
     business_layer/model/screenplay/text/screenplay_text_block_parser.cpp \
     business_layer/model/screenplay/text/screenplay_text_mime_handler.cpp \
     business_layer/model/screenplay/text/screenplay_text_model.cpp \
@@ -187,6 +195,7 @@ SOURCES += \
     business_layer/model/screenplay/text/screenplay_text_model_folder_item.cpp \
     business_layer/model/screenplay/text/screenplay_text_model_scene_item.cpp \
     business_layer/model/screenplay/text/screenplay_text_model_text_item.cpp \
+    business_layer/model/screenplay/text/screenplay_text_timeline_index.cpp \
     business_layer/model/screenplay/screenplay_title_page_model.cpp \
     business_layer/model/simple_text/simple_text_model.cpp \
     business_layer/model/simple_text/simple_text_model_chapter_item.cpp \
@@ -202,11 +211,17 @@ SOURCES += \
     business_layer/model/structure/structure_model_item.cpp \
     business_layer/model/structure/structure_proxy_model.cpp \
     business_layer/model/text/text_model.cpp \
+    business_layer/model/text/text_model_dialogues_index.cpp \
     business_layer/model/text/text_model_folder_item.cpp \
     business_layer/model/text/text_model_group_item.cpp \
     business_layer/model/text/text_model_item.cpp \
+    business_layer/model/text/text_model_items_writer.cpp \
+    business_layer/model/text/text_model_mime_data.cpp \
+    business_layer/model/text/text_model_name_replacement.cpp \
     business_layer/model/text/text_model_splitter_item.cpp \
+    business_layer/model/text/text_model_structure_proxy_model.cpp \
     business_layer/model/text/text_model_text_item.cpp \
+    business_layer/model/text/text_model_text_items_index.cpp \
     business_layer/model/text/text_model_xml_writer.cpp \
     business_layer/model/worlds/world_model.cpp \
     business_layer/model/worlds/worlds_model.cpp \
@@ -215,6 +230,7 @@ SOURCES += \
     business_layer/reports/audioplay/audioplay_summary_report.cpp \
     business_layer/reports/comic_book/comic_book_summary_report.cpp \
     business_layer/reports/novel/novel_summary_report.cpp \
+    business_layer/reports/screenplay/screenplay_breakdown_report.cpp \
     business_layer/reports/screenplay/screenplay_cast_report.cpp \
     business_layer/reports/screenplay/screenplay_gender_report.cpp \
     business_layer/reports/screenplay/screenplay_location_report.cpp \
@@ -235,11 +251,13 @@ SOURCES += \
     data_layer/mapper/document_mapper.cpp \
     data_layer/mapper/mapper_facade.cpp \
     data_layer/mapper/settings_mapper.cpp \
+    data_layer/persistence_worker.cpp \
     data_layer/storage/document_change_storage.cpp \
     data_layer/storage/document_image_storage.cpp \
     data_layer/storage/document_storage.cpp \
     data_layer/storage/settings_storage.cpp \
     data_layer/storage/storage_facade.cpp \
+    data_layer/storage/writing_session_storage.cpp \
     domain/document_change_object.cpp \
     domain/document_object.cpp \
     domain/domain_object.cpp \
@@ -269,6 +287,8 @@ SOURCES += \
     ui/modules/images_list/images_list_preview.cpp \
     ui/modules/logline_generator/logline_generator_dialog.cpp \
     ui/modules/cards/card_item_parameters_view.cpp \
+    ui/modules/cards/cards_graphics_view.cpp \
+    ui/modules/cards/cards_layout.cpp \
     ui/modules/script_text_edit/script_text_edit.cpp \
     ui/modules/text_generation/text_generation_dialog.cpp \
     ui/widgets/animations/click_animation.cpp \
@@ -349,9 +369,11 @@ SOURCES += \
     utils/3rd_party/WAF/Animation/Slide/SlideForegroundDecorator.cpp \
     utils/diff_match_patch/diff_match_patch.cpp \
     utils/diff_match_patch/diff_match_patch_controller.cpp \
+    utils/diff_match_patch/myers_diff.cpp \
     utils/helpers/color_helper.cpp \
     utils/helpers/dialog_helper.cpp \
     utils/helpers/extension_helper.cpp \
+    utils/helpers/font_helper.cpp \
     utils/helpers/icon_helper.cpp \
     utils/helpers/image_helper.cpp \
     utils/helpers/measurement_helper.cpp \
@@ -372,6 +394,7 @@ SOURCES += \
     utils/tools/debouncer.cpp \
     utils/tools/model_index_path.cpp \
     utils/tools/run_once.cpp \
+    utils/tracing.cpp \
     utils/validators/email_validator.cpp
 
 HEADERS += \
@@ -490,6 +513,7 @@ HEADERS += \
     business_layer/model/screenplay/screenplay_information_model.h \
     business_layer/model/screenplay/screenplay_statistics_model.h \
     business_layer/model/screenplay/screenplay_synopsis_model.h \
+    business_layer/model/screenplay/text/screenplay_breakdown_index.h \
     business_layer/model/screenplay/text/screenplay_text_block_parser.h \
     business_layer/model/screenplay/text/screenplay_text_mime_handler.h \
     business_layer/model/screenplay/text/screenplay_text_model.h \
@@ -497,6 +521,7 @@ HEADERS += \
     business_layer/model/screenplay/text/screenplay_text_model_folder_item.h \
     business_layer/model/screenplay/text/screenplay_text_model_scene_item.h \
     business_layer/model/screenplay/text/screenplay_text_model_text_item.h \
+    business_layer/model/screenplay/text/screenplay_text_timeline_index.h \
     business_layer/model/screenplay/screenplay_title_page_model.h \
     business_layer/model/simple_text/simple_text_model.h \
     business_layer/model/simple_text/simple_text_model_chapter_item.h \
@@ -512,11 +537,18 @@ HEADERS += \
     business_layer/model/structure/structure_model_item.h \
     business_layer/model/structure/structure_proxy_model.h \
     business_layer/model/text/text_model.h \
+    business_layer/model/text/text_model_dialogues_index.h \
     business_layer/model/text/text_model_folder_item.h \
     business_layer/model/text/text_model_group_item.h \
     business_layer/model/text/text_model_item.h \
+    business_layer/model/text/text_model_items_writer.h \
+    business_layer/model/text/text_model_mime_data.h \
+    business_layer/model/text/text_model_name_replacement.h \
+    business_layer/model/text/text_model_numbering.h \
     business_layer/model/text/text_model_splitter_item.h \
+    business_layer/model/text/text_model_structure_proxy_model.h \
     business_layer/model/text/text_model_text_item.h \
+    business_layer/model/text/text_model_text_items_index.h \
     business_layer/model/text/text_model_xml.h \
     business_layer/model/text/text_model_xml_writer.h \
     business_layer/model/worlds/world_model.h \
@@ -528,6 +560,7 @@ HEADERS += \
     business_layer/reports/audioplay/audioplay_summary_report.h \
     business_layer/reports/comic_book/comic_book_summary_report.h \
     business_layer/reports/novel/novel_summary_report.h \
+    business_layer/reports/screenplay/screenplay_breakdown_report.h \
     business_layer/reports/screenplay/screenplay_cast_report.h \
     business_layer/reports/screenplay/screenplay_gender_report.h \
     business_layer/reports/screenplay/screenplay_location_report.h \
@@ -549,11 +582,13 @@ HEADERS += \
     data_layer/mapper/document_mapper.h \
     data_layer/mapper/mapper_facade.h \
     data_layer/mapper/settings_mapper.h \
+    data_layer/persistence_worker.h \
     data_layer/storage/document_change_storage.h \
     data_layer/storage/document_image_storage.h \
     data_layer/storage/document_storage.h \
     data_layer/storage/settings_storage.h \
     data_layer/storage/storage_facade.h \
+    data_layer/storage/writing_session_storage.h \
     domain/document_change_object.h \
     domain/document_object.h \
     domain/domain_object.h \
@@ -585,6 +620,8 @@ HEADERS += \
     ui/modules/images_list/images_list_preview.h \
     ui/modules/logline_generator/logline_generator_dialog.h \
     ui/modules/cards/card_item_parameters_view.h \
+    ui/modules/cards/cards_graphics_view.h \
+    ui/modules/cards/cards_layout.h \
     ui/modules/script_text_edit/script_text_edit.h \
     ui/modules/text_generation/text_generation_dialog.h \
     ui/widgets/animations/click_animation.h \
@@ -669,9 +706,11 @@ HEADERS += \
     utils/3rd_party/WAF/WAF.h \
     utils/diff_match_patch/diff_match_patch.h \
     utils/diff_match_patch/diff_match_patch_controller.h \
+    utils/diff_match_patch/myers_diff.h \
     utils/helpers/color_helper.h \
     utils/helpers/dialog_helper.h \
     utils/helpers/extension_helper.h \
+    utils/helpers/font_helper.h \
     utils/helpers/icon_helper.h \
     utils/helpers/image_helper.h \
     utils/helpers/measurement_helper.h \
@@ -694,6 +733,7 @@ HEADERS += \
     utils/tools/model_index_path.h \
     utils/tools/once.h \
     utils/tools/run_once.h \
+    utils/tracing.h \
     utils/validators/email_validator.h
 
 RESOURCES += \
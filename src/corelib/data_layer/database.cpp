@@ -1,5 +1,7 @@
 #include "database.h"
 
+#include "persistence_worker.h"
+
 #include <QApplication>
 #include <QDateTime>
 #include <QSqlDatabase>
@@ -8,6 +10,8 @@
 #include <QStringList>
 #include <QVariant>
 
+#include <atomic>
+
 namespace DatabaseLayer {
 
 namespace {
@@ -21,10 +25,15 @@ static QString s_connectionName = "local_database";
  */
 static QString s_sqlDriver = "QSQLITE";
 
+/**
+ * @brief Имя базы данных, размещаемой во временной памяти
+ */
+const QString kInMemoryDatabaseName = QLatin1String(":memory:");
+
 /**
  * @brief Имя файла базы данных, если не задан, то база будет размещаться во временной памяти
  */
-static QString s_databaseName = ":memory:";
+static QString s_databaseName = kInMemoryDatabaseName;
 
 /**
  * @brief Текст ошибки открытия последнего загружаемого файла
@@ -41,6 +50,39 @@ static QString s_lastError;
  */
 static int s_openedTransactions = 0;
 
+/**
+ * @brief Количество страниц журнала упреждающей записи до автоматического переноса изменений
+ *        в основной файл (значение SQLite по умолчанию)
+ */
+static int s_walAutoCheckpoint = 1000;
+
+/**
+ * @brief Счётчик вложенных сборов запросов на отложенную запись и собираемый пакет
+ */
+static int s_deferredWritesCounter = 0;
+static WriteBatch s_deferredWrites;
+
+/**
+ * @brief Номер последнего собранного пакета
+ */
+static int s_lastBatchNumber = 0;
+
+/**
+ * @brief Количество запросов, созданных для основного соединения
+ */
+static std::atomic<int> s_queriesCount{ 0 };
+
+/**
+ * @brief Объект фоновой записи изменений
+ */
+static PersistenceWorker* s_persistenceWorker = nullptr;
+
+/**
+ * @brief Обслуживающие запросы, запрошенные во время сбора пакета, которые нужно выполнить
+ *        после его записи
+ */
+static QVector<WriteBatch> s_deferredMaintenance;
+
 /**
  * @brief Получить ключ хранения номера версии приложения
  */
@@ -126,7 +168,36 @@ void Database::setCurrentFile(const QString& _databaseFileName)
 
 void Database::closeCurrentFile()
 {
+    //
+    // Дописываем все отложенные изменения и закрываем соединение потока записи
+    //
+    if (s_persistenceWorker != nullptr) {
+        WriteBatch closeBatch;
+        closeBatch.databaseFile = s_databaseName;
+        s_persistenceWorker->enqueue(closeBatch);
+        s_persistenceWorker->waitForFinished();
+
+        //
+        // ... если какие-то изменения так и не удалось записать, то сообщаем об этом, т.к.
+        //     после закрытия файла повторить их запись уже не получится
+        //
+        const auto error = s_persistenceWorker->lastError();
+        if (!error.isEmpty()) {
+            setLastError(error);
+        }
+    }
+
     if (QSqlDatabase::contains(s_connectionName)) {
+        //
+        // Переносим журнал в основной файл, чтобы файл проекта оставался самодостаточным
+        //
+        {
+            auto database = QSqlDatabase::database(s_connectionName, false);
+            if (database.isOpen() && database.databaseName() != kInMemoryDatabaseName) {
+                QSqlQuery query(database);
+                query.exec("PRAGMA wal_checkpoint(TRUNCATE)");
+            }
+        }
         QSqlDatabase::removeDatabase(s_connectionName);
     }
 }
@@ -138,11 +209,29 @@ QString Database::currentFile()
 
 QSqlQuery Database::query()
 {
+    //
+    // Фоновая запись идёт в режиме журнала упреждающей записи, поэтому не блокирует чтение через
+    // основное соединение, а согласованность с ещё не записанными пакетами обеспечивают мапперы
+    //
+    ++s_queriesCount;
     return QSqlQuery(instanse());
 }
 
+int Database::queriesCount()
+{
+    return s_queriesCount;
+}
+
 void Database::transaction()
 {
+    //
+    // Изменения файла проекта в транзакции собираются в один пакет для фоновой записи
+    //
+    if (isWritesInBackground()) {
+        beginDeferredWrites();
+        return;
+    }
+
     //
     // Для первого запроса открываем транзакцию
     //
@@ -158,6 +247,11 @@ void Database::transaction()
 
 void Database::commit()
 {
+    if (isWritesInBackground()) {
+        endDeferredWrites();
+        return;
+    }
+
     //
     // Уменьшаем счётчик транзакций
     //
@@ -173,12 +267,187 @@ void Database::commit()
 
 void Database::vacuum()
 {
+    if (isWritesInBackground()) {
+        enqueueMaintenance("VACUUM");
+        return;
+    }
+
     auto query = Database::query();
     query.exec("VACUUM");
 }
 
+void Database::checkpoint()
+{
+    if (!isWritesInBackground()) {
+        return;
+    }
+
+    enqueueMaintenance("PRAGMA wal_checkpoint(TRUNCATE)");
+}
+
+int Database::walAutoCheckpoint()
+{
+    return s_walAutoCheckpoint;
+}
+
+void Database::setWalAutoCheckpoint(int _pages)
+{
+    s_walAutoCheckpoint = qMax(0, _pages);
+}
+
+void Database::configureConnection(QSqlDatabase& _database)
+{
+    if (_database.databaseName() == kInMemoryDatabaseName) {
+        return;
+    }
+
+    //
+    // Журнал упреждающей записи позволяет потоку записи не блокировать чтение, а при
+    // синхронизации NORMAL диск синхронизируется только при переносе журнала в основной файл.
+    // Режим журнала задаётся при каждом открытии, а не в обновлении схемы, т.к. обновление не
+    // выполняется для файлов текущей версии, которые были созданы ещё с журналом отката
+    //
+    QSqlQuery query(_database);
+    query.exec("PRAGMA busy_timeout = 5000");
+    query.exec("PRAGMA journal_mode = WAL");
+    query.exec("PRAGMA synchronous = NORMAL");
+    query.exec(QString("PRAGMA wal_autocheckpoint = %1").arg(s_walAutoCheckpoint));
+}
+
+void Database::beginDeferredWrites()
+{
+    if (s_deferredWritesCounter == 0) {
+        s_deferredWrites = {};
+        s_deferredWrites.number = ++s_lastBatchNumber;
+        s_deferredWrites.databaseFile = s_databaseName;
+    }
+
+    ++s_deferredWritesCounter;
+}
+
+void Database::endDeferredWrites()
+{
+    Q_ASSERT(s_deferredWritesCounter > 0);
+
+    --s_deferredWritesCounter;
+    if (s_deferredWritesCounter > 0) {
+        return;
+    }
+
+    if (!s_deferredWrites.statements.isEmpty()) {
+        persistenceWorker()->enqueue(s_deferredWrites);
+    }
+    s_deferredWrites = {};
+
+    //
+    // Обслуживающие запросы выполняем после собранных изменений, чтобы они их тоже затронули
+    //
+    for (const auto& batch : std::as_const(s_deferredMaintenance)) {
+        persistenceWorker()->enqueue(batch);
+    }
+    s_deferredMaintenance.clear();
+}
+
+bool Database::isWritesDeferred()
+{
+    //
+    // База в памяти доступна только через основное соединение, поэтому пишем в неё сразу
+    //
+    return s_deferredWritesCounter > 0 && isWritesInBackground();
+}
+
+bool Database::isWritesInBackground()
+{
+    return s_databaseName != kInMemoryDatabaseName;
+}
+
+int Database::deferWrite(const QString& _statement, const QVariantList& _values)
+{
+    Q_ASSERT(isWritesDeferred());
+
+    s_deferredWrites.statements.append({ _statement, _values });
+    return s_deferredWrites.number;
+}
+
+bool Database::isBatchWritten(int _batchNumber)
+{
+    if (s_persistenceWorker == nullptr) {
+        return true;
+    }
+
+    return s_persistenceWorker->isBatchWritten(_batchNumber);
+}
+
+bool Database::isBatchLost(int _batchNumber)
+{
+    if (s_persistenceWorker == nullptr) {
+        return false;
+    }
+
+    return s_persistenceWorker->isBatchLost(_batchNumber);
+}
+
+void Database::waitForBatch(int _batchNumber)
+{
+    if (s_persistenceWorker == nullptr) {
+        return;
+    }
+
+    s_persistenceWorker->waitForBatch(_batchNumber);
+}
+
+void Database::waitForPendingWrites()
+{
+    if (s_persistenceWorker == nullptr) {
+        return;
+    }
+
+    s_persistenceWorker->waitForFinished();
+}
+
+PersistenceWorker* Database::persistenceWorker()
+{
+    if (s_persistenceWorker == nullptr) {
+        s_persistenceWorker = new PersistenceWorker(QCoreApplication::instance());
+        //
+        // При завершении работы приложения дописываем все изменения, повторяя запись тех, что
+        // не удалось записать ранее
+        //
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                         s_persistenceWorker, [] {
+                             WriteBatch closeBatch;
+                             closeBatch.databaseFile = s_databaseName;
+                             s_persistenceWorker->enqueue(closeBatch);
+                             s_persistenceWorker->waitForFinished();
+                         });
+        QObject::connect(s_persistenceWorker, &QObject::destroyed,
+                         [] { s_persistenceWorker = nullptr; });
+    }
+
+    return s_persistenceWorker;
+}
+
 // ****
 
+void Database::enqueueMaintenance(const QString& _statement)
+{
+    WriteBatch batch;
+    batch.number = ++s_lastBatchNumber;
+    batch.databaseFile = s_databaseName;
+    batch.isTransactional = false;
+    batch.statements.append({ _statement, {} });
+
+    //
+    // Если сейчас собирается пакет изменений, то обслуживающий запрос выполним после его записи
+    //
+    if (s_deferredWritesCounter > 0) {
+        s_deferredMaintenance.append(batch);
+        return;
+    }
+
+    persistenceWorker()->enqueue(batch);
+}
+
 QSqlDatabase Database::instanse()
 {
     QSqlDatabase database;
@@ -200,6 +469,7 @@ void Database::open(QSqlDatabase& _database, const QString& _connectionName,
     _database = QSqlDatabase::addDatabase(s_sqlDriver, _connectionName);
     _database.setDatabaseName(_databaseName);
     _database.open();
+    configureConnection(_database);
 
     Database::States states = checkState(_database);
 
@@ -211,6 +481,8 @@ void Database::open(QSqlDatabase& _database, const QString& _connectionName,
         createEnums(_database);
     if (states.testFlag(OldVersionFlag))
         updateDatabase(_database);
+    if (states.testFlag(SchemeFlag))
+        addMissingColumns(_database);
 }
 
 // Проверка состояния базы данных
@@ -298,6 +570,7 @@ void Database::createTables(QSqlDatabase& _database)
                "uuid TEXT UNIQUE NOT NULL, "
                "undo_patch BLOB NOT NULL, " // отмена изменения
                "redo_patch BLOB NOT NULL, " // повтор изменения
+               "result_hash BLOB DEFAULT(NULL), " // хэш документа после изменения
                "date_time TEXT NOT NULL, " // yyyy.mm.dd.hh.mm.ss.zzz
                "user_name TEXT NOT NULL, "
                "user_email TEXT DEFAULT(NULL), "
@@ -529,4 +802,27 @@ void Database::updateDatabaseTo_0_2_4(QSqlDatabase& _database)
     _database.commit();
 }
 
+void Database::addMissingColumns(QSqlDatabase& _database)
+{
+    //
+    // Колонки, которые добавлялись без смены версии файла, проверяем по фактической схеме при
+    // каждом открытии, т.к. файлы, уже сохранённые в текущей версии, миграцию не проходят
+    //
+    QSqlQuery q_checker(_database);
+    q_checker.exec("PRAGMA table_info(documents_changes)");
+    while (q_checker.next()) {
+        if (q_checker.record().value("name").toString() == "result_hash") {
+            return;
+        }
+    }
+
+    QSqlQuery q_updater(_database);
+
+    _database.transaction();
+
+    q_updater.exec("ALTER TABLE documents_changes ADD result_hash BLOB DEFAULT(NULL)");
+
+    _database.commit();
+}
+
 } // namespace DatabaseLayer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QVariantList>
 #include <QtGlobal>
 
 #include <corelib_global.h>
@@ -11,6 +12,8 @@ class QSqlDatabase;
 
 namespace DatabaseLayer {
 
+class PersistenceWorker;
+
 class CORE_LIBRARY_EXPORT Database
 {
 public:
@@ -51,11 +54,21 @@ public:
 
     /**
      * @brief Получить объект для выполнения запросов в БД
+     * @note Не дожидается фоновой записи, поэтому запись в файл проекта идёт только через пакеты
+     *       фоновой записи, а перед выборками, которые могут затронуть ещё не записанные
+     *       изменения, нужно дождаться записи пакетов
      */
     static QSqlQuery query();
 
+    /**
+     * @brief Количество запросов, созданных для основного соединения
+     * @note Позволяет проверить, что при отложенной записи нет обращений к основному соединению
+     */
+    static int queriesCount();
+
     /**
      * @brief Запустить транзакцию, если ещё не запущена
+     * @note Для файла проекта изменения в транзакции собираются в один пакет фоновой записи
      */
     static void transaction();
 
@@ -66,9 +79,87 @@ public:
 
     /**
      * @brief Сжать базу данных
+     * @note Для файла проекта выполняется в фоне после уже отправленных на запись изменений
      */
     static void vacuum();
 
+    /**
+     * @brief Перенести журнал упреждающей записи в основной файл базы данных
+     * @note Выполняется в фоне после уже отправленных на запись изменений, поэтому перед
+     *       копированием файла проекта средствами файловой системы нужно дождаться фоновой записи
+     */
+    static void checkpoint();
+
+    /**
+     * @brief Количество страниц в журнале упреждающей записи, при котором изменения
+     *        автоматически переносятся в основной файл
+     * @note Применяется к соединениям, открываемым после установки
+     */
+    /** @{ */
+    static int walAutoCheckpoint();
+    static void setWalAutoCheckpoint(int _pages);
+    /** @} */
+
+    /**
+     * @brief Настроить режим журналирования соединения с файлом проекта
+     */
+    static void configureConnection(QSqlDatabase& _database);
+
+    /**
+     * @brief Начать сбор запросов на запись для отложенной записи в фоновом потоке
+     * @note Пока сбор активен, транзакции основного соединения не открываются, т.к. собранные
+     *       запросы записываются одной транзакцией
+     */
+    static void beginDeferredWrites();
+
+    /**
+     * @brief Завершить сбор запросов на запись и отправить их в фоновый поток
+     */
+    static void endDeferredWrites();
+
+    /**
+     * @brief Активен ли сбор запросов на запись
+     */
+    static bool isWritesDeferred();
+
+    /**
+     * @brief Идёт ли запись в базу данных через фоновый поток
+     * @note Только база в памяти доступна лишь через основное соединение и пишется сразу
+     */
+    static bool isWritesInBackground();
+
+    /**
+     * @brief Добавить запрос на запись в собираемый пакет
+     * @return Номер пакета, в который добавлен запрос
+     */
+    static int deferWrite(const QString& _statement, const QVariantList& _values);
+
+    /**
+     * @brief Записан ли в базу данных пакет с заданным номером
+     */
+    static bool isBatchWritten(int _batchNumber);
+
+    /**
+     * @brief Потерян ли пакет с заданным номером, т.е. его так и не удалось записать
+     */
+    static bool isBatchLost(int _batchNumber);
+
+    /**
+     * @brief Дождаться фоновой записи пакета с заданным номером
+     */
+    static void waitForBatch(int _batchNumber);
+
+    /**
+     * @brief Дождаться окончания фоновой записи
+     * @note Потокобезопасный
+     */
+    static void waitForPendingWrites();
+
+    /**
+     * @brief Объект фоновой записи изменений
+     */
+    static PersistenceWorker* persistenceWorker();
+
     /**
      * @brief Состояния базы данных
      */
@@ -87,6 +178,11 @@ public:
     Q_DECLARE_FLAGS(States, State)
 
 private:
+    /**
+     * @brief Отправить обслуживающий запрос на выполнение в фоновом потоке
+     */
+    static void enqueueMaintenance(const QString& _statement);
+
     /**
      * @brief Получить объект текущей базы данных
      */
@@ -106,6 +202,11 @@ private:
     static void updateDatabaseTo_0_0_10(QSqlDatabase& _database);
     static void updateDatabaseTo_0_1_3(QSqlDatabase& _database);
     static void updateDatabaseTo_0_2_4(QSqlDatabase& _database);
+
+    /**
+     * @brief Добавить колонки, которых нет в схеме открытого файла
+     */
+    static void addMissingColumns(QSqlDatabase& _database);
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Database::States)
@@ -17,6 +17,14 @@ using Domain::Identifier;
 
 namespace DataMappingLayer {
 
+namespace {
+/**
+ * @brief Максимальное количество параметров в одном запросе, которое гарантированно
+ *        поддерживается всеми версиями SQLite
+ */
+constexpr int kMaximumBindValues = 999;
+} // namespace
+
 void AbstractMapper::clear()
 {
     m_isLastIdentifierLoaded = false;
@@ -25,6 +33,9 @@ void AbstractMapper::clear()
         value = nullptr;
     }
     m_loadedObjectsMap.clear();
+    m_deferredUpdates.clear();
+    m_deferredDeletes.clear();
+    m_lastDeferredBatch = 0;
 }
 
 DomainObject* AbstractMapper::abstractFind(const Identifier& _id)
@@ -41,6 +52,8 @@ DomainObject* AbstractMapper::abstractFind(const Identifier& _id)
 
 QVector<Domain::DomainObject*> AbstractMapper::abstractFind(const QString& _filter)
 {
+    waitForDeferredWrites();
+
     QSqlQuery query = Database::query();
     query.prepare(findAllStatement() + _filter);
     query.exec();
@@ -48,6 +61,12 @@ QVector<Domain::DomainObject*> AbstractMapper::abstractFind(const QString& _filt
     while (query.next()) {
         QSqlRecord record = query.record();
         DomainObject* domainObject = load(record);
+        //
+        // ... удалённые, но ещё не записанные в фоне объекты пропускаем
+        //
+        if (domainObject == nullptr) {
+            continue;
+        }
         result.append(domainObject);
     }
     return result;
@@ -64,6 +83,7 @@ void AbstractMapper::abstractInsert(DomainObject* _object)
     // Добавим вновь созданный объект в список загруженных объектов
     //
     m_loadedObjectsMap.emplace(_object->id(), _object);
+    m_deferredDeletes.erase(_object->id());
 
     //
     // Получим данные для формирования запроса на их добавление
@@ -71,6 +91,14 @@ void AbstractMapper::abstractInsert(DomainObject* _object)
     QVariantList insertValues;
     QString insertQueryString = insertStatement(_object, insertValues);
 
+    //
+    // Если запись идёт в фоне, то добавляем запрос в пакет для фоновой записи
+    //
+    if (Database::isWritesInBackground()) {
+        deferWrite(insertQueryString, insertValues);
+        return;
+    }
+
     //
     // Сформируем запрос на добавление данных в базу
     //
@@ -86,6 +114,78 @@ void AbstractMapper::abstractInsert(DomainObject* _object)
     executeSql(insertQuery);
 }
 
+void AbstractMapper::abstractInsert(const QVector<Domain::DomainObject*>& _objects)
+{
+    if (_objects.isEmpty()) {
+        return;
+    }
+
+    //
+    // Установим идентификаторы новым объектам и сформируем значения для их добавления
+    //
+    QString insertQueryString;
+    QVector<QVariantList> objectsValues;
+    objectsValues.reserve(_objects.size());
+    for (auto object : _objects) {
+        object->setId(findNextIdentifier());
+        m_loadedObjectsMap.emplace(object->id(), object);
+        m_deferredDeletes.erase(object->id());
+
+        QVariantList insertValues;
+        insertQueryString = insertStatement(object, insertValues);
+        objectsValues.append(insertValues);
+    }
+
+    //
+    // Сформируем шаблон многострочного запроса
+    //
+    const auto valuesIndex = insertQueryString.lastIndexOf("VALUES", -1, Qt::CaseInsensitive);
+    Q_ASSERT(valuesIndex != -1);
+    const auto valuesPrefix = insertQueryString.left(valuesIndex) + "VALUES ";
+    const auto valuesCount = static_cast<int>(objectsValues.constFirst().size());
+    QStringList placeholders;
+    for (int index = 0; index < valuesCount; ++index) {
+        placeholders.append("?");
+    }
+    const auto rowPlaceholder = QString("(%1)").arg(placeholders.join(", "));
+    const auto rowsPerQuery = std::max(1, kMaximumBindValues / std::max(1, valuesCount));
+
+    //
+    // Добавляем данные пачками строк, чтобы не выполнять по запросу на каждый объект, а при
+    // фоновой записи отправляем их одним пакетом
+    //
+    const auto isWritesInBackground = Database::isWritesInBackground();
+    if (isWritesInBackground) {
+        Database::beginDeferredWrites();
+    }
+    for (int firstRow = 0; firstRow < objectsValues.size(); firstRow += rowsPerQuery) {
+        const auto rowsCount
+            = std::min(rowsPerQuery, static_cast<int>(objectsValues.size()) - firstRow);
+        QStringList rows;
+        QVariantList values;
+        for (int row = firstRow; row < firstRow + rowsCount; ++row) {
+            rows.append(rowPlaceholder);
+            values.append(objectsValues.at(row));
+        }
+        const auto queryString = valuesPrefix + rows.join(", ");
+
+        if (isWritesInBackground) {
+            deferWrite(queryString, values);
+            continue;
+        }
+
+        QSqlQuery insertQuery = Database::query();
+        insertQuery.prepare(queryString);
+        for (const QVariant& value : std::as_const(values)) {
+            insertQuery.addBindValue(value);
+        }
+        executeSql(insertQuery);
+    }
+    if (isWritesInBackground) {
+        Database::endDeferredWrites();
+    }
+}
+
 bool AbstractMapper::abstractUpdate(DomainObject* _object)
 {
     //
@@ -95,6 +195,14 @@ bool AbstractMapper::abstractUpdate(DomainObject* _object)
         return false;
     }
 
+    //
+    // Если эти изменения уже были записаны в фоне, то и обновлять нечего
+    //
+    markDeferredWritesStored();
+    if (_object->isChangesStored()) {
+        return false;
+    }
+
     //
     // т.к. в m_loadedObjectsMap хранится список указателей, то после обновления элементов
     // обновлять элемент непосредственно в списке не нужно
@@ -106,6 +214,25 @@ bool AbstractMapper::abstractUpdate(DomainObject* _object)
     QVariantList updateValues;
     const QString updateQueryString = updateStatement(_object, updateValues);
 
+    //
+    // Если запись идёт в фоне, то добавляем запрос в пакет для фоновой записи, а сохранённым
+    // объект будет отмечен только после того, как пакет будет записан
+    //
+    if (Database::isWritesInBackground()) {
+        const auto deferredUpdate = m_deferredUpdates.find(_object->id());
+        if (deferredUpdate != m_deferredUpdates.end()
+            && deferredUpdate->second.changesRevision == _object->changesRevision()) {
+            //
+            // ... текущая версия объекта уже отправлена на запись
+            //
+            return true;
+        }
+
+        const auto batchNumber = deferWrite(updateQueryString, updateValues);
+        m_deferredUpdates[_object->id()] = { batchNumber, _object->changesRevision() };
+        return true;
+    }
+
     //
     // Сформируем запрос на обновление данных в базе
     //
@@ -121,6 +248,7 @@ bool AbstractMapper::abstractUpdate(DomainObject* _object)
     const bool isUpdateSuccesful = executeSql(updateQuery);
     if (isUpdateSuccesful) {
         _object->markChangesStored();
+        m_deferredUpdates.erase(_object->id());
     }
     return isUpdateSuccesful;
 }
@@ -133,6 +261,19 @@ void AbstractMapper::abstractDelete(DomainObject* _object)
     QVariantList deleteValues;
     QString deleteQueryString = deleteStatement(_object, deleteValues);
 
+    //
+    // Если запись идёт в фоне, то добавляем запрос в пакет для фоновой записи
+    //
+    if (Database::isWritesInBackground()) {
+        const auto batchNumber = deferWrite(deleteQueryString, deleteValues);
+        m_deferredUpdates.erase(_object->id());
+        m_deferredDeletes[_object->id()] = batchNumber;
+        m_loadedObjectsMap.erase(_object->id());
+        delete _object;
+        _object = nullptr;
+        return;
+    }
+
     //
     // Сформируем запрос на удаление данных из базы
     //
@@ -150,6 +291,7 @@ void AbstractMapper::abstractDelete(DomainObject* _object)
         //
         // Удалим объекст из списка загруженных
         //
+        m_deferredUpdates.erase(_object->id());
         m_loadedObjectsMap.erase(_object->id());
         delete _object;
         _object = nullptr;
@@ -175,6 +317,19 @@ bool AbstractMapper::executeSql(QSqlQuery& _sqlQuery)
     return false;
 }
 
+int AbstractMapper::deferWrite(const QString& _statement, const QVariantList& _values)
+{
+    Database::beginDeferredWrites();
+    m_lastDeferredBatch = Database::deferWrite(_statement, _values);
+    Database::endDeferredWrites();
+    return m_lastDeferredBatch;
+}
+
+void AbstractMapper::waitForDeferredWrites() const
+{
+    Database::waitForBatch(m_lastDeferredBatch);
+}
+
 DomainObject* AbstractMapper::loadObjectFromDatabase(const Identifier& _id)
 {
     QSqlQuery query = Database::query();
@@ -190,7 +345,9 @@ Identifier AbstractMapper::findNextIdentifier()
 {
     if (!m_isLastIdentifierLoaded) {
         //
-        // Если нет ещё последнего индекса по таблице, загрузим его
+        // Если нет ещё последнего индекса по таблице, загрузим его, не дожидаясь фоновой записи,
+        // т.к. ещё не записанные новые объекты уже есть среди загруженных, а ещё не записанные
+        // удаления пропускаются при загрузке
         //
         QSqlQuery query = Database::query();
         query.prepare(findLastOneStatement());
@@ -234,6 +391,15 @@ DomainObject* AbstractMapper::load(const QSqlRecord& _record)
         }
     }
     //
+    // Если объект удалён, но удаление ещё не записано, то в БД он пока остаётся, но загружать его
+    // уже не нужно
+    //
+    else if (const auto deleteIter = m_deferredDeletes.find(id);
+             deleteIter != m_deferredDeletes.end()
+             && !Database::isBatchWritten(deleteIter->second)) {
+        return nullptr;
+    }
+    //
     // В противном случае создаём новый объект и сохраняем указатель на него
     //
     else {
@@ -243,4 +409,45 @@ DomainObject* AbstractMapper::load(const QSqlRecord& _record)
     return result;
 }
 
+void AbstractMapper::markDeferredWritesStored()
+{
+    for (auto iter = m_deferredUpdates.begin(); iter != m_deferredUpdates.end();) {
+        //
+        // Если пакет так и не удалось записать, то объект остаётся несохранённым и будет
+        // отправлен на запись при следующем сохранении
+        //
+        if (Database::isBatchLost(iter->second.batchNumber)) {
+            iter = m_deferredUpdates.erase(iter);
+            continue;
+        }
+
+        if (!Database::isBatchWritten(iter->second.batchNumber)) {
+            ++iter;
+            continue;
+        }
+
+        //
+        // Если объект изменился после того, как был отправлен на запись, то он остаётся
+        // несохранённым
+        //
+        const auto objectIter = m_loadedObjectsMap.find(iter->first);
+        if (objectIter != m_loadedObjectsMap.end()
+            && objectIter->second->changesRevision() == iter->second.changesRevision) {
+            objectIter->second->markChangesStored();
+        }
+        iter = m_deferredUpdates.erase(iter);
+    }
+
+    for (auto iter = m_deferredDeletes.begin(); iter != m_deferredDeletes.end();) {
+        //
+        // ... а объект, удаление которого потеряно, остаётся в БД и будет загружен заново
+        //
+        if (Database::isBatchWritten(iter->second) || Database::isBatchLost(iter->second)) {
+            iter = m_deferredDeletes.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
 } // namespace DataMappingLayer
@@ -51,6 +51,11 @@ protected:
     Domain::DomainObject* abstractFind(const Domain::Identifier& _id);
     QVector<Domain::DomainObject*> abstractFind(const QString& _filter);
     void abstractInsert(Domain::DomainObject* _object);
+    /**
+     * @brief Добавить объекты многострочными запросами
+     * @note Запрос на добавление должен иметь вид "INSERT INTO ... VALUES(?, ...)"
+     */
+    void abstractInsert(const QVector<Domain::DomainObject*>& _objects);
     bool abstractUpdate(Domain::DomainObject* _object);
     void abstractDelete(Domain::DomainObject* _object);
 
@@ -59,6 +64,20 @@ protected:
      */
     bool executeSql(QSqlQuery& _sqlQuery);
 
+    /**
+     * @brief Отправить запрос на фоновую запись, добавив его в собираемый пакет, если сбор
+     *        активен, или отдельным пакетом
+     * @return Номер пакета, в который попал запрос
+     */
+    int deferWrite(const QString& _statement, const QVariantList& _values);
+
+    /**
+     * @brief Дождаться фоновой записи изменений объектов маппера
+     * @note Нужно делать перед выборками, которые не сводятся к поиску по идентификатору, т.к.
+     *       их результат нельзя согласовать с загруженными объектами
+     */
+    void waitForDeferredWrites() const;
+
 protected:
     /**
      * @brief Скрываем конструктор от публичного доступа
@@ -81,6 +100,12 @@ private:
      */
     Domain::DomainObject* load(const QSqlRecord& _record);
 
+    /**
+     * @brief Отметить сохранёнными объекты, изменения которых уже записаны в фоне, и забыть
+     *        о записанных в фоне удалениях
+     */
+    void markDeferredWritesStored();
+
 private:
     /**
      * @brief Был ли загружен идентификатор последнего элемента
@@ -91,6 +116,39 @@ private:
      * @brief Загруженные объекты из базы данных
      */
     std::map<Domain::Identifier, Domain::DomainObject*> m_loadedObjectsMap;
+
+    /**
+     * @brief Отложенное обновление объекта
+     */
+    struct DeferredUpdate {
+        /**
+         * @brief Номер пакета, в который попал запрос на обновление
+         */
+        int batchNumber = 0;
+
+        /**
+         * @brief Версия изменений объекта, которая была отправлена на запись
+         */
+        int changesRevision = 0;
+    };
+
+    /**
+     * @brief Обновления объектов, которые ещё могут быть не записаны в фоне
+     * @note Объект считается сохранённым только после записи пакета, до этого его изменения
+     *       не затираются данными из БД, которые ещё не содержат этих изменений
+     */
+    std::map<Domain::Identifier, DeferredUpdate> m_deferredUpdates;
+
+    /**
+     * @brief Удалённые объекты, удаление которых ещё может быть не записано в фоне
+     *        <идентификатор, номер пакета>
+     */
+    std::map<Domain::Identifier, int> m_deferredDeletes;
+
+    /**
+     * @brief Номер последнего пакета, в который попали изменения объектов маппера
+     */
+    int m_lastDeferredBatch = 0;
 };
 
 } // namespace DataMappingLayer
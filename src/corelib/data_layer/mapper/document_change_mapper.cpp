@@ -15,8 +15,8 @@ using Domain::Identifier;
 namespace DataMappingLayer {
 
 namespace {
-const QString kColumns = " id, fk_document_uuid, uuid, undo_patch, redo_patch, date_time, "
-                         "user_name, user_email, is_synced ";
+const QString kColumns = " id, fk_document_uuid, uuid, undo_patch, redo_patch, result_hash, "
+                         "date_time, user_name, user_email, is_synced ";
 const QString kTableName = " documents_changes ";
 const QString kDateTimeFormat = "yyyy-MM-dd hh:mm:ss:zzz";
 QString uuidFilter(const QUuid& _uuid)
@@ -50,6 +50,8 @@ QString unsyncedFilter()
 
 bool DataMappingLayer::DocumentChangeMapper::isEmpty()
 {
+    waitForDeferredWrites();
+
     QSqlQuery query = DatabaseLayer::Database::query();
     query.prepare(QString("SELECT COUNT(*) FROM %1").arg(kTableName));
 
@@ -120,6 +122,11 @@ void DocumentChangeMapper::insert(DocumentChangeObject* _object)
     abstractInsert(_object);
 }
 
+void DocumentChangeMapper::insert(const QVector<DocumentChangeObject*>& _objects)
+{
+    abstractInsert(QVector<DomainObject*>(_objects.begin(), _objects.end()));
+}
+
 bool DocumentChangeMapper::update(DocumentChangeObject* _object)
 {
     return abstractUpdate(_object);
@@ -132,8 +139,14 @@ void DocumentChangeMapper::remove(DocumentChangeObject* _object)
 
 void DocumentChangeMapper::removeAll()
 {
+    const auto statement = QString("DELETE FROM %1").arg(kTableName);
+    if (DatabaseLayer::Database::isWritesInBackground()) {
+        deferWrite(statement, {});
+        return;
+    }
+
     QSqlQuery query = DatabaseLayer::Database::query();
-    query.prepare(QString("DELETE FROM %1").arg(kTableName));
+    query.prepare(statement);
 
     executeSql(query);
 }
@@ -164,7 +177,7 @@ QString DocumentChangeMapper::insertStatement(Domain::DomainObject* _object,
 {
     const QString insertStatement = QString("INSERT INTO " + kTableName + " (" + kColumns
                                             + ") "
-                                              " VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?) ");
+                                              " VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
 
     const auto documentChangeObject = static_cast<DocumentChangeObject*>(_object);
     _insertValues.clear();
@@ -173,6 +186,7 @@ QString DocumentChangeMapper::insertStatement(Domain::DomainObject* _object,
     _insertValues.append(documentChangeObject->uuid().toString());
     _insertValues.append(qCompress(documentChangeObject->undoPatch()));
     _insertValues.append(qCompress(documentChangeObject->redoPatch()));
+    _insertValues.append(documentChangeObject->resultHash());
     _insertValues.append(documentChangeObject->dateTime().toString(kDateTimeFormat));
     _insertValues.append(documentChangeObject->userName());
     _insertValues.append(documentChangeObject->userEmail());
@@ -189,6 +203,7 @@ QString DocumentChangeMapper::updateStatement(Domain::DomainObject* _object,
                                               " uuid = ?, "
                                               " undo_patch = ?, "
                                               " redo_patch = ?, "
+                                              " result_hash = ?, "
                                               " date_time = ?, "
                                               " user_name = ?, "
                                               " user_email = ?,"
@@ -201,6 +216,7 @@ QString DocumentChangeMapper::updateStatement(Domain::DomainObject* _object,
     _updateValues.append(documentChangeObject->uuid().toString());
     _updateValues.append(qCompress(documentChangeObject->undoPatch()));
     _updateValues.append(qCompress(documentChangeObject->redoPatch()));
+    _updateValues.append(documentChangeObject->resultHash());
     _updateValues.append(documentChangeObject->dateTime().toString(kDateTimeFormat));
     _updateValues.append(documentChangeObject->userName());
     _updateValues.append(documentChangeObject->userEmail());
@@ -228,14 +244,16 @@ Domain::DomainObject* DocumentChangeMapper::doLoad(const Domain::Identifier& _id
     const auto uuid = QUuid::fromString(_record.value("uuid").toString());
     const auto undoPatch = qUncompress(_record.value("undo_patch").toByteArray());
     const auto redoPatch = qUncompress(_record.value("redo_patch").toByteArray());
+    const auto resultHash = _record.value("result_hash").toByteArray();
     const auto dateTime
         = QDateTime::fromString(_record.value("date_time").toString(), kDateTimeFormat);
     const auto userName = _record.value("user_name").toString();
     const auto userEmail = _record.value("user_email").toString();
     const auto isSynced = _record.value("is_synced").toBool();
 
-    return Domain::ObjectsBuilder::createDocumentChange(
-        _id, documentUuid, uuid, undoPatch, redoPatch, dateTime, userName, userEmail, isSynced);
+    return Domain::ObjectsBuilder::createDocumentChange(_id, documentUuid, uuid, undoPatch,
+                                                        redoPatch, resultHash, dateTime, userName,
+                                                        userEmail, isSynced);
 }
 
 void DocumentChangeMapper::doLoad(Domain::DomainObject* _object, const QSqlRecord& _record)
@@ -257,6 +275,9 @@ void DocumentChangeMapper::doLoad(Domain::DomainObject* _object, const QSqlRecor
     const auto redoPatch = qUncompress(_record.value("redo_patch").toByteArray());
     documentChangeObject->setRedoPatch(redoPatch);
 
+    const auto resultHash = _record.value("result_hash").toByteArray();
+    documentChangeObject->setResultHash(resultHash);
+
     const auto dateTime
         = QDateTime::fromString(_record.value("date_time").toString(), kDateTimeFormat);
     documentChangeObject->setDateTime(dateTime);
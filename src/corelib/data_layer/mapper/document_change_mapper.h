@@ -24,6 +24,7 @@ public:
     QVector<QUuid> unsyncedDocuments();
 
     void insert(Domain::DocumentChangeObject* _object);
+    void insert(const QVector<Domain::DocumentChangeObject*>& _objects);
     bool update(Domain::DocumentChangeObject* _object);
     void remove(Domain::DocumentChangeObject* _object);
     void removeAll();
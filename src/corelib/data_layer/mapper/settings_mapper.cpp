@@ -11,6 +11,8 @@ namespace DataMappingLayer {
 
 void SettingsMapper::setValue(const QString& _key, const QString& _value)
 {
+    DatabaseLayer::Database::waitForPendingWrites();
+
     QSqlQuery q_loader = DatabaseLayer::Database::query();
     q_loader.prepare("INSERT INTO system_variables VALUES (?, ?)");
     q_loader.addBindValue(_key);
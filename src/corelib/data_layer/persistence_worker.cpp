@@ -0,0 +1,390 @@
+#include "persistence_worker.h"
+
+#include "database.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QUuid>
+#include <QWaitCondition>
+
+
+namespace DatabaseLayer {
+
+class PersistenceWorker::Implementation
+{
+public:
+    explicit Implementation(PersistenceWorker* _q);
+
+    /**
+     * @brief Цикл потока записи
+     */
+    void run();
+
+    /**
+     * @brief Записать пакет в базу данных
+     * @return Текст ошибки, если записать не удалось
+     */
+    QString write(const WriteBatch& _batch);
+
+    /**
+     * @brief Закрыть соединение с базой данных
+     */
+    void closeDatabase();
+
+    /**
+     * @brief Забыть о пакетах, которые не удалось записать, т.к. они либо записаны повторно,
+     *        либо потеряны
+     */
+    void resolveFailedBatches(bool _isLost);
+
+
+    PersistenceWorker* q = nullptr;
+
+    QThread* thread = nullptr;
+
+    mutable QMutex mutex;
+    QWaitCondition queueChanged;
+    QWaitCondition batchProcessed;
+    QQueue<WriteBatch> queue;
+    bool isStopping = false;
+
+    /**
+     * @brief Номер последнего обработанного пакета
+     */
+    int processedBatchNumber = 0;
+
+    /**
+     * @brief Номера пакетов, которые не удалось записать и которые ждут повторной записи, и
+     *        пакетов, которые так и не удалось записать
+     */
+    QVector<int> failedBatchNumbers;
+    QSet<int> lostBatchNumbers;
+
+    /**
+     * @brief Ошибка записи последнего обработанного пакета
+     */
+    QString lastError;
+
+    /**
+     * @brief Запросы пакета, который не удалось записать, и файл, в который они пишутся
+     * @note Используются только из потока записи
+     */
+    QVector<WriteBatch::Statement> failedStatements;
+    QString failedDatabaseFile;
+
+    /**
+     * @brief Соединение потока записи и файл, с которым оно открыто
+     * @note Используются только из потока записи
+     */
+    QString connectionName;
+    QString databaseFile;
+
+    /**
+     * @brief Подготовленные запросы текущего соединения
+     * @note Журнал изменений пишется однотипными запросами, поэтому повторно их не разбираем
+     */
+    QHash<QString, QSqlQuery> preparedQueries;
+};
+
+PersistenceWorker::Implementation::Implementation(PersistenceWorker* _q)
+    : q(_q)
+    , connectionName(QString("persistence_%1").arg(QUuid::createUuid().toString()))
+{
+}
+
+void PersistenceWorker::Implementation::run()
+{
+    forever
+    {
+        WriteBatch batch;
+        {
+            QMutexLocker locker(&mutex);
+            while (queue.isEmpty() && !isStopping) {
+                queueChanged.wait(&mutex);
+            }
+            if (queue.isEmpty()) {
+                break;
+            }
+
+            //
+            // Пакет остаётся в очереди до окончания записи, чтобы ожидающие видели его
+            //
+            batch = queue.head();
+        }
+
+        //
+        // Если ранее изменения записать не удалось, то повторяем их запись вместе с текущим
+        // пакетом, если он пишется в тот же файл в транзакции, в том числе и перед закрытием файла
+        //
+        const bool isCloseBatch = batch.statements.isEmpty();
+        QString lostError;
+        bool isFailedStatementsMerged = false;
+        if (!failedStatements.isEmpty() && failedDatabaseFile == batch.databaseFile
+            && batch.isTransactional) {
+            batch.statements = failedStatements + batch.statements;
+            isFailedStatementsMerged = true;
+        }
+        //
+        // ... а в противном случае повторяем их запись отдельно
+        //
+        else if (!failedStatements.isEmpty()) {
+            WriteBatch failedBatch;
+            failedBatch.databaseFile = failedDatabaseFile;
+            failedBatch.statements = failedStatements;
+            const auto failedError = write(failedBatch);
+            if (failedError.isEmpty()) {
+                resolveFailedBatches(false);
+            }
+            //
+            // ... если файл уже сменился, то больше повторить запись не получится
+            //
+            else if (failedDatabaseFile != batch.databaseFile) {
+                lostError = failedError;
+                resolveFailedBatches(true);
+            }
+        }
+
+        QString error;
+        if (!batch.statements.isEmpty()) {
+            error = write(batch);
+        }
+        if (isCloseBatch && batch.databaseFile == databaseFile) {
+            closeDatabase();
+        }
+
+        if (isFailedStatementsMerged) {
+            if (error.isEmpty()) {
+                resolveFailedBatches(false);
+            }
+            //
+            // ... при закрытии файла повторить запись больше не получится
+            //
+            else if (isCloseBatch) {
+                lostError = error;
+                resolveFailedBatches(true);
+            }
+        }
+        //
+        // Если пакет записать не удалось, то запомним его для повторной записи, а обслуживающие
+        // запросы не повторяем
+        //
+        if (!error.isEmpty() && !isCloseBatch && batch.isTransactional) {
+            failedStatements = batch.statements;
+            failedDatabaseFile = batch.databaseFile;
+            QMutexLocker locker(&mutex);
+            failedBatchNumbers.append(batch.number);
+        }
+
+        //
+        // Сообщаем о результате до того, как пакет будет считаться обработанным, чтобы
+        // дождавшиеся записи уже получили уведомления
+        //
+        if (!lostError.isEmpty() && lostError != error) {
+            emit q->writeFailed(lostError);
+        }
+        if (!batch.statements.isEmpty()) {
+            if (error.isEmpty()) {
+                emit q->batchWritten();
+            } else {
+                emit q->writeFailed(error);
+            }
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            queue.dequeue();
+            if (batch.number > 0) {
+                processedBatchNumber = batch.number;
+            }
+            lastError = error;
+            batchProcessed.wakeAll();
+        }
+    }
+
+    closeDatabase();
+}
+
+QString PersistenceWorker::Implementation::write(const WriteBatch& _batch)
+{
+    if (databaseFile != _batch.databaseFile) {
+        closeDatabase();
+
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_batch.databaseFile);
+        if (!database.open()) {
+            const auto error = database.lastError().text();
+            database = {};
+            QSqlDatabase::removeDatabase(connectionName);
+            return error;
+        }
+        Database::configureConnection(database);
+        databaseFile = _batch.databaseFile;
+    }
+
+    auto database = QSqlDatabase::database(connectionName, false);
+
+    //
+    // Обслуживающие запросы выполняем по одному и без транзакции
+    //
+    if (!_batch.isTransactional) {
+        for (const auto& statement : _batch.statements) {
+            QSqlQuery query(database);
+            query.prepare(statement.sql);
+            for (int index = 0; index < statement.values.size(); ++index) {
+                query.bindValue(index, statement.values.at(index));
+            }
+            if (!query.exec()) {
+                return query.lastError().text();
+            }
+        }
+        return {};
+    }
+
+    if (!database.transaction()) {
+        return database.lastError().text();
+    }
+
+    for (const auto& statement : _batch.statements) {
+        auto queryIter = preparedQueries.find(statement.sql);
+        if (queryIter == preparedQueries.end()) {
+            QSqlQuery query(database);
+            if (!query.prepare(statement.sql)) {
+                const auto error = query.lastError().text();
+                database.rollback();
+                return error;
+            }
+            queryIter = preparedQueries.insert(statement.sql, query);
+        }
+
+        auto& query = queryIter.value();
+        for (int index = 0; index < statement.values.size(); ++index) {
+            query.bindValue(index, statement.values.at(index));
+        }
+        const auto isExecuted = query.exec();
+        query.finish();
+        if (!isExecuted) {
+            const auto error = query.lastError().text();
+            database.rollback();
+            return error;
+        }
+    }
+
+    if (!database.commit()) {
+        const auto error = database.lastError().text();
+        database.rollback();
+        return error;
+    }
+
+    return {};
+}
+
+void PersistenceWorker::Implementation::closeDatabase()
+{
+    if (databaseFile.isEmpty()) {
+        return;
+    }
+
+    preparedQueries.clear();
+    {
+        auto database = QSqlDatabase::database(connectionName, false);
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    databaseFile.clear();
+}
+
+void PersistenceWorker::Implementation::resolveFailedBatches(bool _isLost)
+{
+    failedStatements.clear();
+    failedDatabaseFile.clear();
+
+    QMutexLocker locker(&mutex);
+    if (_isLost) {
+        for (const auto batchNumber : std::as_const(failedBatchNumbers)) {
+            lostBatchNumbers.insert(batchNumber);
+        }
+    }
+    failedBatchNumbers.clear();
+}
+
+
+// ****
+
+
+PersistenceWorker::PersistenceWorker(QObject* _parent)
+    : QObject(_parent)
+    , d(new Implementation(this))
+{
+    d->thread = QThread::create([this] { d->run(); });
+    d->thread->setObjectName("PersistenceWorker");
+    d->thread->start();
+}
+
+PersistenceWorker::~PersistenceWorker()
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->isStopping = true;
+        d->queueChanged.wakeAll();
+    }
+    d->thread->wait();
+    delete d->thread;
+}
+
+void PersistenceWorker::enqueue(const WriteBatch& _batch)
+{
+    QMutexLocker locker(&d->mutex);
+    d->queue.enqueue(_batch);
+    d->queueChanged.wakeAll();
+}
+
+bool PersistenceWorker::hasPendingWrites() const
+{
+    QMutexLocker locker(&d->mutex);
+    return !d->queue.isEmpty();
+}
+
+bool PersistenceWorker::isBatchWritten(int _batchNumber) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->processedBatchNumber >= _batchNumber
+        && !d->failedBatchNumbers.contains(_batchNumber)
+        && !d->lostBatchNumbers.contains(_batchNumber);
+}
+
+bool PersistenceWorker::isBatchLost(int _batchNumber) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->lostBatchNumbers.contains(_batchNumber);
+}
+
+QString PersistenceWorker::lastError() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->lastError;
+}
+
+void PersistenceWorker::waitForBatch(int _batchNumber)
+{
+    QMutexLocker locker(&d->mutex);
+    while (!d->queue.isEmpty() && d->processedBatchNumber < _batchNumber) {
+        d->batchProcessed.wait(&d->mutex);
+    }
+}
+
+void PersistenceWorker::waitForFinished()
+{
+    QMutexLocker locker(&d->mutex);
+    while (!d->queue.isEmpty()) {
+        d->batchProcessed.wait(&d->mutex);
+    }
+}
+
+} // namespace DatabaseLayer
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QObject>
+#include <QVariantList>
+#include <QVector>
+
+#include <corelib_global.h>
+
+
+namespace DatabaseLayer {
+
+/**
+ * @brief Пакет изменений, который записывается в базу данных одной транзакцией
+ * @note Все данные пакета копируются при формировании, поэтому он не зависит от дальнейших
+ *       изменений объектов, из которых был сформирован
+ */
+struct CORE_LIBRARY_EXPORT WriteBatch {
+    struct Statement {
+        QString sql;
+        QVariantList values;
+    };
+
+    /**
+     * @brief Порядковый номер пакета
+     * @note Номера возрастают в порядке постановки пакетов в очередь, у пакета закрытия номера нет
+     */
+    int number = 0;
+
+    /**
+     * @brief Файл базы данных, в который нужно записать изменения
+     */
+    QString databaseFile;
+
+    /**
+     * @brief Запросы на запись
+     * @note Пакет без запросов закрывает соединение с заданным файлом, предварительно повторив
+     *       запись изменений, которые не удалось записать ранее
+     */
+    QVector<Statement> statements;
+
+    /**
+     * @brief Выполнять ли запросы пакета в транзакции
+     * @note Обслуживающие запросы (VACUUM, перенос журнала) в транзакции не выполняются, а если
+     *       их не удалось выполнить, то повторно они не выполняются
+     */
+    bool isTransactional = true;
+};
+
+
+/**
+ * @brief Фоновая запись изменений в базу данных
+ *
+ * Запись производится в отдельном потоке через собственное соединение с базой данных, поэтому
+ * сохранение изменений не блокирует интерфейс
+ */
+class CORE_LIBRARY_EXPORT PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PersistenceWorker(QObject* _parent = nullptr);
+
+    /**
+     * @brief При удалении дожидается записи всех поставленных в очередь пакетов
+     */
+    ~PersistenceWorker() override;
+
+    /**
+     * @brief Поставить пакет в очередь на запись
+     */
+    void enqueue(const WriteBatch& _batch);
+
+    /**
+     * @brief Есть ли незаписанные пакеты
+     */
+    bool hasPendingWrites() const;
+
+    /**
+     * @brief Записан ли в базу данных пакет с заданным номером
+     */
+    bool isBatchWritten(int _batchNumber) const;
+
+    /**
+     * @brief Потерян ли пакет с заданным номером, т.е. его не удалось записать даже при закрытии
+     *        файла, для которого он был сформирован
+     */
+    bool isBatchLost(int _batchNumber) const;
+
+    /**
+     * @brief Ошибка записи последнего обработанного пакета
+     * @note После закрытия файла непустая ошибка означает, что часть изменений потеряна
+     */
+    QString lastError() const;
+
+    /**
+     * @brief Дождаться записи пакета с заданным номером и всех поставленных в очередь до него
+     * @note Потокобезопасный
+     */
+    void waitForBatch(int _batchNumber);
+
+    /**
+     * @brief Дождаться записи всех поставленных в очередь пакетов
+     * @note Потокобезопасный
+     */
+    void waitForFinished();
+
+signals:
+    /**
+     * @brief Пакет записан в базу данных
+     * @note Испускается из потока записи
+     */
+    void batchWritten();
+
+    /**
+     * @brief Не удалось записать пакет
+     * @note Пакет повторно записывается перед следующим пакетом и при закрытии файла, а если
+     *       не удастся и тогда, то сигнал испускается повторно и пакет считается потерянным.
+     *       Испускается из потока записи
+     */
+    void writeFailed(const QString& _error);
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace DatabaseLayer
@@ -24,12 +24,13 @@ DocumentChangeStorage::~DocumentChangeStorage() = default;
 
 Domain::DocumentChangeObject* DocumentChangeStorage::appendDocumentChange(
     const QUuid& _documentUuid, const QUuid& _uuid, const QByteArray& _undoPatch,
-    const QByteArray& _redoPatch, const QString& _userEmail, const QString& _userName)
+    const QByteArray& _redoPatch, const QString& _userEmail, const QString& _userName,
+    const QByteArray& _resultHash)
 {
     const auto isSynced = false;
     auto newDocumentChange = Domain::ObjectsBuilder::createDocumentChange(
-        {}, _documentUuid, _uuid, _undoPatch, _redoPatch, QDateTime::currentDateTimeUtc(),
-        _userEmail, _userName, isSynced);
+        {}, _documentUuid, _uuid, _undoPatch, _redoPatch, _resultHash,
+        QDateTime::currentDateTimeUtc(), _userEmail, _userName, isSynced);
     d->newDocumentChanges.append(newDocumentChange);
     return newDocumentChange;
 }
@@ -100,11 +101,13 @@ QVector<Domain::DocumentChangeObject*> DocumentChangeStorage::unsyncedDocumentCh
 
 void DocumentChangeStorage::store()
 {
-    DatabaseLayer::Database::transaction();
-    while (!d->newDocumentChanges.isEmpty()) {
-        auto change = d->newDocumentChanges.takeFirst();
-        DataMappingLayer::MapperFacade::documentChangeMapper()->insert(change);
+    if (d->newDocumentChanges.isEmpty()) {
+        return;
     }
+
+    DatabaseLayer::Database::transaction();
+    DataMappingLayer::MapperFacade::documentChangeMapper()->insert(d->newDocumentChanges);
+    d->newDocumentChanges.clear();
     DatabaseLayer::Database::commit();
 }
 
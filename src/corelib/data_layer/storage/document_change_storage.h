@@ -24,10 +24,13 @@ public:
 
     /**
      * @brief Сохранить документ
+     * @param _resultHash Хэш содержимого документа после применения изменения, по которому
+     *        проверяется корректность повторного наложения изменения
      */
     Domain::DocumentChangeObject* appendDocumentChange(
         const QUuid& _documentUuid, const QUuid& _uuid, const QByteArray& _undoPatch,
-        const QByteArray& _redoPatch, const QString& _userEmail, const QString& _userName);
+        const QByteArray& _redoPatch, const QString& _userEmail, const QString& _userName,
+        const QByteArray& _resultHash = {});
 
     /**
      * @brief Пуст ли список изменений документов
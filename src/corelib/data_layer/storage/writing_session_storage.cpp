@@ -0,0 +1,314 @@
+#include "writing_session_storage.h"
+
+#include <data_layer/storage/settings_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <domain/starcloud_api.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QStandardPaths>
+#include <QVariant>
+
+
+namespace DataStorageLayer {
+
+namespace {
+/**
+ * @brief Название соединения с базой данных
+ */
+const QLatin1String kConnectionName("session_statistics_database");
+
+/**
+ * @brief Путь с файлом локальных сессий
+ */
+QString sessionsFilePath()
+{
+    const QString appDataFolderPath
+        = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    const QString sessionsFilePath = appDataFolderPath + QDir::separator() + "sessions.db";
+    return sessionsFilePath;
+}
+
+/**
+ * @brief Ключ для хранния информации о последней синхронизации
+ */
+const QLatin1String kLastSyncDateTimeKey("last_sync_date_time");
+
+/**
+ * @brief Ключ и текущая версия структуры агрегатов статистики
+ * @note При изменении способа агрегации или структуры агрегатов версию нужно увеличить, чтобы
+ *       агрегаты построились заново
+ */
+const QLatin1String kRollupsVersionKey("rollups_version");
+const QLatin1String kRollupsVersion("2");
+
+/**
+ * @brief Сформировать сессию из записи таблицы сессий
+ */
+Domain::SessionStatistics sessionFromRecord(const QSqlRecord& _record)
+{
+    return {
+        _record.value(0).toUuid(),     _record.value(1).toUuid(),
+        _record.value(2).toString(),   _record.value(3).toString(),
+        _record.value(4).toString(),   _record.value(5).toDateTime(),
+        _record.value(6).toDateTime(), _record.value(7).toInt(),
+        _record.value(8).toInt(),
+    };
+}
+
+/**
+ * @brief Добавить сессию в агрегаты, или убрать её из них, если множитель отрицательный
+ */
+void updateRollups(QSqlDatabase& _database, const Domain::SessionStatistics& _session,
+                   const QString& _accountEmail, int _multiplier)
+{
+    QSqlQuery query(_database);
+    const auto date = _session.startDateTime.date().toString(Qt::ISODate);
+
+    query.prepare("INSERT OR IGNORE INTO daily_rollups VALUES(?,?,?,?,0,0,0)");
+    query.addBindValue(date);
+    query.addBindValue(_accountEmail);
+    query.addBindValue(_session.deviceUuid);
+    query.addBindValue(_session.deviceName);
+    query.exec();
+
+    query.prepare(QString("UPDATE daily_rollups SET "
+                          "words = words + ?, "
+                          "characters = characters + ?, "
+                          "sessions = sessions + ? "
+                          "%1"
+                          "WHERE date = ? AND account_email = ? AND device_uuid = ?")
+                      .arg(_multiplier > 0 ? ", device_name = ? " : " "));
+    query.addBindValue(_session.words * _multiplier);
+    query.addBindValue(_session.characters * _multiplier);
+    query.addBindValue(_multiplier);
+    if (_multiplier > 0) {
+        query.addBindValue(_session.deviceName);
+    }
+    query.addBindValue(date);
+    query.addBindValue(_accountEmail);
+    query.addBindValue(_session.deviceUuid);
+    query.exec();
+
+    //
+    // Убираем опустевшие агрегаты, чтобы они совпадали с полным пересчётом
+    //
+    if (_multiplier < 0) {
+        query.prepare("DELETE FROM daily_rollups "
+                      "WHERE date = ? AND account_email = ? AND device_uuid = ? "
+                      "AND sessions <= 0");
+        query.addBindValue(date);
+        query.addBindValue(_accountEmail);
+        query.addBindValue(_session.deviceUuid);
+        query.exec();
+    }
+}
+
+} // namespace
+
+WritingSessionStorage::WritingSessionStorage(const QString& _sessionsFilePath)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    database.setDatabaseName(_sessionsFilePath.isEmpty() ? sessionsFilePath()
+                                                         : _sessionsFilePath);
+    database.open();
+
+    QSqlQuery query(database);
+    //
+    // Проверяем создана ли структура базы данных файла сессий
+    //
+    if (query.exec("SELECT COUNT(*) as size FROM sqlite_master WHERE type = 'table' ")
+        && query.next() && query.record().value("size").toInt() > 0) {
+        //
+        // ... если структура создана, то ничего не делаем
+        //
+    } else {
+        //
+        // ... а если структура не создана, то создаём её
+        //
+        query.exec("CREATE TABLE sessions "
+                   "("
+                   "uuid TEXT PRIMARY KEY ON CONFLICT REPLACE, "
+                   "project_uuid TEXT NOT NULL, "
+                   "project_name TEXT NOT NULL, "
+                   "device_uuid TEXT NOT NULL, "
+                   "device_name TEXT NOT NULL, "
+                   "started_at TEXT NOT NULL, "
+                   "ends_at TEXT NOT NULL, "
+                   "words INTEGER NOT NULL, "
+                   "characters INTEGER NOT NULL, "
+                   "account_email TEXT NOT NULL "
+                   ");");
+        query.exec("CREATE TABLE system_variables "
+                   "("
+                   "variable TEXT PRIMARY KEY ON CONFLICT REPLACE, "
+                   "value TEXT NOT NULL "
+                   ");");
+    }
+
+    //
+    // Агрегаты статистики появились позже сессий, поэтому создаём их и для существующих файлов,
+    // а если они были построены по другой схеме, то пересоздаём их
+    //
+    query.exec("CREATE INDEX IF NOT EXISTS sessions_ends_at_idx ON sessions (ends_at)");
+    query.prepare("SELECT value FROM system_variables WHERE variable = ?");
+    query.addBindValue(kRollupsVersionKey);
+    query.exec();
+    if (!query.next() || query.record().value(0).toString() != kRollupsVersion) {
+        query.exec("DROP TABLE IF EXISTS weekly_rollups");
+        query.exec("DROP TABLE IF EXISTS daily_rollups");
+        query.exec("CREATE TABLE daily_rollups "
+                   "("
+                   "date TEXT NOT NULL, "
+                   "account_email TEXT NOT NULL, "
+                   "device_uuid TEXT NOT NULL, "
+                   "device_name TEXT NOT NULL, "
+                   "words INTEGER NOT NULL, "
+                   "characters INTEGER NOT NULL, "
+                   "sessions INTEGER NOT NULL, "
+                   "PRIMARY KEY (date, account_email, device_uuid) "
+                   ");");
+
+        //
+        // ... и заполняем их по уже сохранённым сессиям
+        //
+        rebuildRollups();
+    }
+}
+
+QDateTime WritingSessionStorage::sessionStatisticsLastSyncDateTime() const
+{
+    QSqlQuery query(QSqlDatabase::database(kConnectionName));
+    query.prepare("SELECT value FROM system_variables WHERE variable = ?");
+    query.addBindValue(kLastSyncDateTimeKey);
+    query.exec();
+    query.next();
+    return query.record().value(0).toDateTime();
+}
+
+void WritingSessionStorage::saveSessionStatisticsLastSyncDateTime(const QDateTime& _dateTime)
+{
+    QSqlQuery query(QSqlDatabase::database(kConnectionName));
+    query.prepare("INSERT INTO system_variables VALUES (?,?)");
+    query.addBindValue(kLastSyncDateTimeKey);
+    query.addBindValue(_dateTime);
+    query.exec();
+}
+
+QVector<Domain::SessionStatistics> WritingSessionStorage::sessionStatistics(
+    const QDateTime& _fromDateTime) const
+{
+    //
+    // Берём статистику только с пустым имейлом или таким же как текущий
+    // Сортируем по времени создания
+    //
+    QSqlQuery query(QSqlDatabase::database(kConnectionName));
+    if (_fromDateTime.isValid()) {
+        query.prepare("SELECT * FROM sessions "
+                      "WHERE ends_at >= ? AND (account_email = '' OR account_email = ?) "
+                      "ORDER BY started_at ASC");
+        query.addBindValue(_fromDateTime);
+    } else {
+        query.prepare("SELECT * FROM sessions "
+                      "WHERE account_email = '' OR account_email = ? "
+                      "ORDER BY started_at ASC");
+    }
+    query.addBindValue(DataStorageLayer::StorageFacade::settingsStorage()->accountEmail());
+    query.exec();
+    QVector<Domain::SessionStatistics> sessionStatistics;
+    while (query.next()) {
+        sessionStatistics.append(sessionFromRecord(query.record()));
+    }
+    return sessionStatistics;
+}
+
+void WritingSessionStorage::saveSessionStatistics(
+    const QVector<Domain::SessionStatistics>& _sessionStatistics)
+{
+    auto database = QSqlDatabase::database(kConnectionName);
+    database.transaction();
+    QSqlQuery query(database);
+    const auto accountEmail = DataStorageLayer::StorageFacade::settingsStorage()->accountEmail();
+    for (const auto& session : _sessionStatistics) {
+        //
+        // Если сессия уже была сохранена, то она будет заменена, поэтому убираем её из агрегатов
+        //
+        query.prepare("SELECT * FROM sessions WHERE uuid = ?");
+        query.addBindValue(session.uuid);
+        query.exec();
+        if (query.next()) {
+            const auto storedSession = query.record();
+            updateRollups(database, sessionFromRecord(storedSession),
+                          storedSession.value(9).toString(), -1);
+        }
+
+        query.prepare("INSERT INTO sessions VALUES(?,?,?,?,?,?,?,?,?,?)");
+        query.addBindValue(session.uuid);
+        query.addBindValue(session.projectUuid);
+        query.addBindValue(session.projectName);
+        query.addBindValue(session.deviceUuid);
+        query.addBindValue(session.deviceName);
+        query.addBindValue(session.startDateTime);
+        query.addBindValue(session.endDateTime);
+        query.addBindValue(session.words);
+        query.addBindValue(session.characters);
+        query.addBindValue(accountEmail);
+        query.exec();
+
+        updateRollups(database, session, accountEmail, 1);
+    }
+    database.commit();
+}
+
+QVector<WritingStatisticsRollup> WritingSessionStorage::rollups() const
+{
+    //
+    // Как и для сессий, берём агрегаты с пустым имейлом или таким же как текущий
+    //
+    QSqlQuery query(QSqlDatabase::database(kConnectionName));
+    query.prepare("SELECT date, device_uuid, MAX(device_name), SUM(words), "
+                  "SUM(characters), SUM(sessions) FROM daily_rollups "
+                  "WHERE account_email = '' OR account_email = ? "
+                  "GROUP BY date, device_uuid "
+                  "ORDER BY date ASC");
+    query.addBindValue(DataStorageLayer::StorageFacade::settingsStorage()->accountEmail());
+    query.exec();
+    QVector<WritingStatisticsRollup> rollups;
+    while (query.next()) {
+        const auto rollup = query.record();
+        rollups.append({
+            QDate::fromString(rollup.value(0).toString(), Qt::ISODate),
+            rollup.value(1).toString(),
+            rollup.value(2).toString(),
+            rollup.value(3).toInt(),
+            rollup.value(4).toInt(),
+            rollup.value(5).toInt(),
+        });
+    }
+    return rollups;
+}
+
+void WritingSessionStorage::rebuildRollups()
+{
+    auto database = QSqlDatabase::database(kConnectionName);
+    database.transaction();
+    QSqlQuery query(database);
+    query.exec("DELETE FROM daily_rollups");
+
+    query.exec("SELECT * FROM sessions");
+    while (query.next()) {
+        const auto session = query.record();
+        updateRollups(database, sessionFromRecord(session), session.value(9).toString(), 1);
+    }
+
+    query.prepare("INSERT INTO system_variables VALUES (?,?)");
+    query.addBindValue(kRollupsVersionKey);
+    query.addBindValue(kRollupsVersion);
+    query.exec();
+    database.commit();
+}
+
+} // namespace DataStorageLayer
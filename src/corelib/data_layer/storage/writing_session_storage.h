@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QDateTime>
+#include <QtContainerFwd>
+
+#include <corelib_global.h>
+
+namespace Domain {
+struct SessionStatistics;
+}
+
+
+namespace DataStorageLayer {
+
+/**
+ * @brief Статистика устройства за день
+ */
+struct WritingStatisticsRollup {
+    QDate date;
+    QString deviceUuid;
+    QString deviceName;
+    int words = 0;
+    int characters = 0;
+    int sessions = 0;
+};
+
+/**
+ * @brief Хранилище сессий работы с приложением
+ */
+class CORE_LIBRARY_EXPORT WritingSessionStorage
+{
+public:
+    /**
+     * @param _sessionsFilePath Файл сессий, если не задан, то используется файл в папке данных
+     *        приложения
+     */
+    explicit WritingSessionStorage(const QString& _sessionsFilePath = {});
+
+    /**
+     * @brief Дата и время последней синхронизации сессий
+     */
+    QDateTime sessionStatisticsLastSyncDateTime() const;
+
+    /**
+     * @brief Сохранить дату/время последней синхронизации сессий
+     */
+    void saveSessionStatisticsLastSyncDateTime(const QDateTime& _dateTime);
+
+    /**
+     * @brief Получить список сессий с заданной даты
+     */
+    QVector<Domain::SessionStatistics> sessionStatistics(const QDateTime& _fromDateTime = {}) const;
+
+    /**
+     * @brief Сохранить заданный список сессий
+     */
+    void saveSessionStatistics(const QVector<Domain::SessionStatistics>& _sessionStatistics);
+
+    /**
+     * @brief Получить агрегированную по устройствам статистику за дни, упорядоченную по дате
+     * @note Агрегаты обновляются при сохранении сессий, поэтому запрос не зависит от количества
+     *       сессий, а только от количества дней
+     */
+    QVector<WritingStatisticsRollup> rollups() const;
+
+    /**
+     * @brief Пересчитать агрегаты по всем сохранённым сессиям
+     */
+    void rebuildRollups();
+};
+
+} // namespace DataStorageLayer
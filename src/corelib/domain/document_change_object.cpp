@@ -63,6 +63,21 @@ void DocumentChangeObject::setRedoPatch(const QByteArray& _patch)
     markChangesNotStored();
 }
 
+const QByteArray& DocumentChangeObject::resultHash() const
+{
+    return m_resultHash;
+}
+
+void DocumentChangeObject::setResultHash(const QByteArray& _hash)
+{
+    if (m_resultHash == _hash) {
+        return;
+    }
+
+    m_resultHash = _hash;
+    markChangesNotStored();
+}
+
 const QDateTime& DocumentChangeObject::dateTime() const
 {
     return m_dateTime;
@@ -125,14 +140,16 @@ void DocumentChangeObject::setSynced(bool _synced)
 
 DocumentChangeObject::DocumentChangeObject(const Identifier& _id, const QUuid& _documentUuid,
                                            const QUuid& _uuid, const QByteArray& _undoPatch,
-                                           const QByteArray& _redoPatch, const QDateTime& _dateTime,
-                                           const QString& _userName, const QString& _userEmail,
-                                           bool _isSynced)
+                                           const QByteArray& _redoPatch,
+                                           const QByteArray& _resultHash,
+                                           const QDateTime& _dateTime, const QString& _userName,
+                                           const QString& _userEmail, bool _isSynced)
     : DomainObject(_id)
     , m_documentUuid(_documentUuid)
     , m_uuid(_uuid)
     , m_undoPatch(_undoPatch)
     , m_redoPatch(_redoPatch)
+    , m_resultHash(_resultHash)
     , m_dateTime(_dateTime)
     , m_userName(_userName)
     , m_userEmail(_userEmail)
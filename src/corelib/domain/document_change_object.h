@@ -38,6 +38,13 @@ public:
     const QByteArray& redoPatch() const;
     void setRedoPatch(const QByteArray& _patch);
 
+    /**
+     * @brief Хэш содержимого документа, которое получается после применения изменения
+     * @note Пуст для изменений, сохранённых старыми версиями приложения
+     */
+    const QByteArray& resultHash() const;
+    void setResultHash(const QByteArray& _hash);
+
     /**
      * @brief Дата и время создания изменения
      */
@@ -65,15 +72,16 @@ public:
 private:
     explicit DocumentChangeObject(const Identifier& _id, const QUuid& _documentUuid,
                                   const QUuid& _uuid, const QByteArray& _undoPatch,
-                                  const QByteArray& _redoPatch, const QDateTime& _dateTime,
-                                  const QString& _userEmail, const QString& _userName,
-                                  bool _isSynced);
+                                  const QByteArray& _redoPatch, const QByteArray& _resultHash,
+                                  const QDateTime& _dateTime, const QString& _userEmail,
+                                  const QString& _userName, bool _isSynced);
     friend class ObjectsBuilder;
 
     QUuid m_documentUuid;
     QUuid m_uuid;
     QByteArray m_undoPatch;
     QByteArray m_redoPatch;
+    QByteArray m_resultHash;
     QDateTime m_dateTime;
     QString m_userName;
     QString m_userEmail;
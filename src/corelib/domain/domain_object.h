@@ -34,6 +34,11 @@ public:
      */
     void markChangesNotStored();
 
+    /**
+     * @brief Номер версии изменений объекта, увеличивается при каждом изменении
+     */
+    int changesRevision() const;
+
 private:
     /**
      * @brief Идентификатор объекта
@@ -44,6 +49,11 @@ private:
      * @brief Флаг изменений объекта
      */
     bool m_isChangesStored = false;
+
+    /**
+     * @brief Номер версии изменений объекта
+     */
+    int m_changesRevision = 0;
 };
 
 // ****
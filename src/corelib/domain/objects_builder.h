@@ -32,8 +32,9 @@ public:
      */
     static DocumentChangeObject* createDocumentChange(
         const Identifier& _id, const QUuid& _documentUuid, const QUuid& _uuid,
-        const QByteArray& _undoPatch, const QByteArray& _redoPatch, const QDateTime& _dateTime,
-        const QString& _userName, const QString& _userEmail, bool _isSynced);
+        const QByteArray& _undoPatch, const QByteArray& _redoPatch, const QByteArray& _resultHash,
+        const QDateTime& _dateTime, const QString& _userName, const QString& _userEmail,
+        bool _isSynced);
 };
 
 } // namespace Domain
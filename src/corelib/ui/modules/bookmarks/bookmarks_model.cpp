@@ -2,11 +2,11 @@
 
 #include <business_layer/model/text/text_model.h>
 #include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/model/text/text_model_text_items_index.h>
 #include <business_layer/templates/text_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <utils/shugar.h>
-#include <utils/tools/model_index_path.h>
 
 #include <QColor>
 #include <QDateTime>
@@ -37,14 +37,9 @@ public:
      */
     QPointer<TextModel> model;
     /**
-     * @brief Список всех текстовых элементов модели, для того, чтобы понимать их последовательность
+     * @brief Список элементов сценария с закладками в порядке их следования в документе
      */
-    QVector<TextModelTextItem*> modelTextItems;
-
-    /**
-     * @brief Список элементов сценария с заметками
-     */
-    QVector<TextModelTextItem*> bookmarks;
+    TextModelTextItemsIndex bookmarks;
 };
 
 BookmarksModel::Implementation::Implementation(BookmarksModel* _q)
@@ -58,8 +53,6 @@ void BookmarksModel::Implementation::processSourceModelRowsInserted(const QModel
     //
     // Для каждого из вставленных
     //
-    const int invalidPosition = -1;
-    int lastInsertPosition = invalidPosition;
     for (int row = _firstRow; row <= _lastRow; ++row) {
         //
         // Игнорируем не текстовые элементы
@@ -89,27 +82,6 @@ void BookmarksModel::Implementation::processSourceModelRowsInserted(const QModel
             break;
         }
 
-        //
-        // Вставляем текстовый элемент в общий список на своё место
-        //
-        if (lastInsertPosition == invalidPosition) {
-            const auto itemIndexPath = ModelIndexPath(itemIndex);
-            for (int index = 0; index < modelTextItems.size(); ++index) {
-                const auto modelTextItem = modelTextItems.at(index);
-                const auto modelTextItemIndex = model->indexForItem(modelTextItem);
-                if (itemIndexPath < ModelIndexPath(modelTextItemIndex)) {
-                    lastInsertPosition = index;
-                    break;
-                }
-            }
-            if (lastInsertPosition == invalidPosition) {
-                lastInsertPosition = modelTextItems.size();
-            }
-        } else {
-            ++lastInsertPosition;
-        }
-        modelTextItems.insert(lastInsertPosition, textItem);
-
         if (!textItem->bookmark().has_value() || !textItem->bookmark()->isValid()) {
             continue;
         }
@@ -145,11 +117,6 @@ void BookmarksModel::Implementation::processSourceModelRowsRemoved(const QModelI
         //
         auto textItem = static_cast<TextModelTextItem*>(item);
 
-        //
-        // Исключим удаляемый элемент из списка
-        //
-        modelTextItems.removeAll(textItem);
-
         //
         // Пропускаем корректировочные блоки и блоки не проходящие фильтр
         //
@@ -172,11 +139,6 @@ void BookmarksModel::Implementation::processSourceModelRowsRemoved(const QModelI
         q->beginRemoveRows({}, indexToRemove, indexToRemove);
         bookmarks.removeAt(indexToRemove);
         q->endRemoveRows();
-
-        //
-        // Удаляем текстовый элемент из общего списка
-        //
-        modelTextItems.removeAll(textItem);
     }
 }
 
@@ -198,10 +160,6 @@ void BookmarksModel::Implementation::processSourceModelDataChanged(const QModelI
     //
     if (textItem->isCorrection()
         || (!typesFilter.isEmpty() && !typesFilter.contains(textItem->paragraphType()))) {
-        //
-        // А если раньше блок был не корректировочным, исключим его из списка
-        //
-        modelTextItems.removeAll(textItem);
         return;
     }
 
@@ -214,30 +172,10 @@ void BookmarksModel::Implementation::processSourceModelDataChanged(const QModelI
             //
             // Определим правильное место для вставки
             //
-            bool inserted = false;
-            for (int siblingIndex = modelTextItems.indexOf(textItem) - 1; siblingIndex >= 0;
-                 --siblingIndex) {
-                const auto siblingItem = modelTextItems.at(siblingIndex);
-                const auto& siblingItemBookmark = siblingItem->bookmark();
-                if (!siblingItemBookmark.has_value() || !siblingItemBookmark->isValid()) {
-                    continue;
-                }
-
-                const auto indexToInsert = bookmarks.indexOf(siblingItem) + 1;
-                q->beginInsertRows({}, indexToInsert, indexToInsert);
-                bookmarks.insert(indexToInsert, textItem);
-                q->endInsertRows();
-                inserted = true;
-                break;
-            }
-            //
-            // Если перед элементом не нашлось другого с закладкой, то вставим в самое начало
-            //
-            if (!inserted) {
-                q->beginInsertRows({}, 0, 0);
-                bookmarks.prepend(textItem);
-                q->endInsertRows();
-            }
+            const auto indexToInsert = bookmarks.lowerBound(textItem);
+            q->beginInsertRows({}, indexToInsert, indexToInsert);
+            bookmarks.insert(indexToInsert, textItem);
+            q->endInsertRows();
         }
         //
         // А если закладка была сохранена, то уведомим о том, что элемент изменился
@@ -251,7 +189,12 @@ void BookmarksModel::Implementation::processSourceModelDataChanged(const QModelI
     // или удалим
     //
     else {
-        bookmarks.removeAll(textItem);
+        const auto bookmarkItemIndex = bookmarks.indexOf(textItem);
+        if (bookmarkItemIndex != -1) {
+            q->beginRemoveRows({}, bookmarkItemIndex, bookmarkItemIndex);
+            bookmarks.removeAt(bookmarkItemIndex);
+            q->endRemoveRows();
+        }
     }
 }
 
@@ -293,11 +236,10 @@ void BookmarksModel::setTextModel(TextModel* _model)
 
     if (d->model != nullptr) {
         d->model->disconnect(this);
-        d->modelTextItems.clear();
-        d->bookmarks.clear();
     }
 
     d->model = _model;
+    d->bookmarks.setModel(d->model);
 
     if (d->model != nullptr) {
         std::function<void(const QModelIndex&)> readBookmarksFromModel;
@@ -316,11 +258,6 @@ void BookmarksModel::setTextModel(TextModel* _model)
                         continue;
                     }
 
-                    //
-                    // Сохраним текстовый элемент в плоском списке
-                    //
-                    d->modelTextItems.append(textItem);
-
                     //
                     // Если вставился абзац без закладок, пропускаем его
                     //
@@ -351,7 +288,6 @@ void BookmarksModel::setTextModel(TextModel* _model)
         readBookmarksFromModel({});
 
         connect(d->model, &TextModel::modelAboutToBeReset, this, [this] {
-            d->modelTextItems.clear();
             d->bookmarks.clear();
         });
         connect(d->model, &TextModel::modelReset, this, [this] { setTextModel(d->model); });
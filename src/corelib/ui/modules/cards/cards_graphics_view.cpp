@@ -0,0 +1,425 @@
+#include "cards_graphics_view.h"
+
+#include "cards_layout.h"
+
+#include <business_layer/model/text/text_model.h>
+#include <business_layer/model/text/text_model_folder_item.h>
+#include <business_layer/model/text/text_model_group_item.h>
+#include <ui/design_system/design_system.h>
+#include <utils/helpers/text_helper.h>
+
+#include <QApplication>
+#include <QFontMetricsF>
+#include <QGraphicsScene>
+#include <QHash>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPointer>
+
+#include <algorithm>
+
+using BusinessLayer::TextModelItem;
+
+
+namespace Ui {
+
+class CardsGraphicsView::Implementation
+{
+public:
+    explicit Implementation(CardsGraphicsView* _q);
+
+    /**
+     * @brief Пересчитать раскладку карточек и обновить доску
+     */
+    void relayout();
+
+    /**
+     * @brief Подобрать количество колонок под ширину доски
+     * @return Изменилось ли количество колонок
+     */
+    bool updateColumnsCount();
+
+    /**
+     * @brief Получить картинку карточки, отрисовав её, если её ещё нет в кеше
+     */
+    QPixmap cardPixmap(const CardsLayout::Card& _card);
+
+    /**
+     * @brief Сбросить картинку карточки элемента и перерисовать её место на доске
+     */
+    void invalidateCard(TextModelItem* _item);
+
+    /**
+     * @brief Забыть элемент и всех его детей перед удалением из модели
+     */
+    void forget(TextModelItem* _item);
+
+    /**
+     * @brief Прекратить перетаскивание карточки
+     */
+    void resetDragging();
+
+
+    CardsGraphicsView* q = nullptr;
+
+    QGraphicsScene* scene = nullptr;
+    QPointer<BusinessLayer::TextModel> model;
+    CardsLayout layout;
+
+    /**
+     * @brief Идёт ли групповое изменение структуры модели, после которого раскладка
+     *        пересчитывается один раз
+     */
+    bool isStructureChanging = false;
+
+    /**
+     * @brief Картинки карточек
+     */
+    QHash<TextModelItem*, QPixmap> cardsPixmaps;
+
+    /**
+     * @brief Параметры перетаскивания карточки
+     */
+    TextModelItem* pressedItem = nullptr;
+    QPoint pressPosition;
+    QPointF pressOffset;
+    bool isDragging = false;
+    QPointF dragPosition;
+};
+
+CardsGraphicsView::Implementation::Implementation(CardsGraphicsView* _q)
+    : q(_q)
+    , scene(new QGraphicsScene(_q))
+{
+    layout.setCardSize({ Ui::DesignSystem::layout().px(240), Ui::DesignSystem::layout().px(160) });
+    layout.setFolderHeight(Ui::DesignSystem::layout().px48());
+    layout.setSpacing(Ui::DesignSystem::layout().px16());
+}
+
+void CardsGraphicsView::Implementation::relayout()
+{
+    layout.relayout();
+    scene->setSceneRect({ QPointF(), layout.size() });
+    q->viewport()->update();
+}
+
+bool CardsGraphicsView::Implementation::updateColumnsCount()
+{
+    const auto spacing = Ui::DesignSystem::layout().px16();
+    const auto width = q->viewport()->width() / std::max(q->transform().m11(), 0.01);
+    const auto columnsCount
+        = std::max(1, static_cast<int>((width - spacing) / (layout.cardSize().width() + spacing)));
+    if (columnsCount == layout.columnsCount()) {
+        return false;
+    }
+
+    layout.setColumnsCount(columnsCount);
+    return true;
+}
+
+QPixmap CardsGraphicsView::Implementation::cardPixmap(const CardsLayout::Card& _card)
+{
+    const auto cachedPixmap = cardsPixmaps.constFind(_card.item);
+    if (cachedPixmap != cardsPixmaps.constEnd()) {
+        return cachedPixmap.value();
+    }
+
+    //
+    // Рисуем карточку с учётом масштаба доски, чтобы при увеличении она оставалась чёткой
+    //
+    const auto pixelRatio = q->devicePixelRatioF() * std::max(1.0, q->transform().m11());
+    QPixmap pixmap((_card.rect.size() * pixelRatio).toSize());
+    pixmap.setDevicePixelRatio(pixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QColor color;
+    QString number;
+    QString heading;
+    QString text;
+    if (_card.isFolder) {
+        const auto folderItem = static_cast<BusinessLayer::TextModelFolderItem*>(_card.item);
+        color = folderItem->color();
+        heading = folderItem->heading();
+    } else {
+        const auto groupItem = static_cast<BusinessLayer::TextModelGroupItem*>(_card.item);
+        color = groupItem->color();
+        const auto groupNumber = groupItem->number();
+        number = groupNumber.has_value() ? groupNumber->text : QString();
+        heading = groupItem->heading();
+        text = groupItem->text();
+    }
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QRectF cardRect({}, _card.rect.size());
+    const auto borderRadius = Ui::DesignSystem::card().borderRadius();
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Ui::DesignSystem::color().background());
+    painter.drawRoundedRect(cardRect, borderRadius, borderRadius);
+    if (color.isValid()) {
+        painter.setBrush(color);
+        painter.drawRect(QRectF(cardRect.topLeft(),
+                                QSizeF(Ui::DesignSystem::layout().px4(), cardRect.height())));
+    }
+
+    const auto margin = Ui::DesignSystem::layout().px12();
+    const auto contentRect = cardRect.adjusted(margin, margin, -margin, -margin);
+    painter.setPen(Ui::DesignSystem::color().onBackground());
+    painter.setFont(Ui::DesignSystem::font().subtitle2());
+    const auto headingHeight = QFontMetricsF(painter.font()).lineSpacing();
+    const QRectF headingRect(contentRect.topLeft(), QSizeF(contentRect.width(), headingHeight));
+    const auto headingText = number.isEmpty() ? heading : QString("%1 %2").arg(number, heading);
+    painter.drawText(headingRect, Qt::AlignLeft | Qt::AlignVCenter,
+                     TextHelper::elidedText(headingText, painter.font(), headingRect.width()));
+    if (!text.isEmpty()) {
+        painter.setFont(Ui::DesignSystem::font().body2());
+        const auto textRect = contentRect.adjusted(0, headingHeight + margin / 2, 0, 0);
+        painter.drawText(textRect, Qt::TextWordWrap,
+                         TextHelper::elidedText(text, painter.font(), textRect));
+    }
+    painter.end();
+
+    return cardsPixmaps.insert(_card.item, pixmap).value();
+}
+
+void CardsGraphicsView::Implementation::invalidateCard(TextModelItem* _item)
+{
+    cardsPixmaps.remove(_item);
+
+    const auto cardIndex = layout.indexOf(_item);
+    if (cardIndex == -1) {
+        return;
+    }
+
+    const auto cardRect = layout.cards().at(cardIndex).rect;
+    q->viewport()->update(q->mapFromScene(cardRect).boundingRect());
+}
+
+void CardsGraphicsView::Implementation::forget(TextModelItem* _item)
+{
+    cardsPixmaps.remove(_item);
+    if (_item == pressedItem) {
+        resetDragging();
+    }
+
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        forget(_item->childAt(childIndex));
+    }
+}
+
+void CardsGraphicsView::Implementation::resetDragging()
+{
+    pressedItem = nullptr;
+    isDragging = false;
+    q->viewport()->update();
+}
+
+
+// ****
+
+
+CardsGraphicsView::CardsGraphicsView(QWidget* _parent)
+    : ScalableGraphicsView(_parent)
+    , d(new Implementation(this))
+{
+    setScene(d->scene);
+
+    connect(this, &CardsGraphicsView::scaleChanged, this, [this] {
+        d->cardsPixmaps.clear();
+        if (d->updateColumnsCount()) {
+            d->relayout();
+        }
+    });
+}
+
+CardsGraphicsView::~CardsGraphicsView() = default;
+
+void CardsGraphicsView::setModel(BusinessLayer::TextModel* _model)
+{
+    if (d->model == _model) {
+        return;
+    }
+
+    if (!d->model.isNull()) {
+        d->model->disconnect(this);
+    }
+
+    d->model = _model;
+    d->layout.setModel(_model);
+    d->cardsPixmaps.clear();
+    d->resetDragging();
+    d->relayout();
+
+    if (d->model.isNull()) {
+        return;
+    }
+
+    using BusinessLayer::TextModel;
+    connect(d->model, &TextModel::modelAboutToBeReset, this, [this] {
+        d->cardsPixmaps.clear();
+        d->resetDragging();
+    });
+    connect(d->model, &TextModel::modelReset, this, [this] { d->relayout(); });
+    //
+    // ... групповое изменение структуры, например перемещение элемента, раскладываем один раз
+    //     по его завершении
+    //
+    connect(d->model, &TextModel::rowsAboutToBeChanged, this,
+            [this] { d->isStructureChanging = true; });
+    connect(d->model, &TextModel::rowsChanged, this, [this] {
+        d->isStructureChanging = false;
+        d->relayout();
+    });
+    connect(d->model, &TextModel::afterRowsInserted, this, [this] {
+        if (!d->isStructureChanging) {
+            d->relayout();
+        }
+    });
+    connect(d->model, &TextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                const auto parentItem = d->model->itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->forget(parentItem->childAt(row));
+                }
+            });
+    connect(d->model, &TextModel::afterRowsRemoved, this, [this] {
+        if (!d->isStructureChanging) {
+            d->relayout();
+        }
+    });
+    //
+    // ... изменение элемента сбрасывает только его картинку, не трогая раскладку
+    //
+    connect(d->model, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                if (!_topLeft.isValid()) {
+                    return;
+                }
+
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    d->invalidateCard(d->model->itemForIndex(_topLeft.siblingAtRow(row)));
+                }
+            });
+}
+
+const CardsLayout& CardsGraphicsView::cardsLayout() const
+{
+    return d->layout;
+}
+
+bool CardsGraphicsView::moveCard(const QModelIndex& _index, const QPointF& _scenePosition)
+{
+    if (d->model.isNull() || !_index.isValid()) {
+        return false;
+    }
+
+    const auto item = d->model->itemForIndex(_index);
+    const auto dropPosition = d->layout.dropPosition(item, _scenePosition);
+    if (!dropPosition.isValid) {
+        return false;
+    }
+
+    d->model->moveItem(item, dropPosition.afterSibling, dropPosition.parent);
+    return true;
+}
+
+int CardsGraphicsView::cachedCardsCount() const
+{
+    return d->cardsPixmaps.size();
+}
+
+void CardsGraphicsView::drawBackground(QPainter* _painter, const QRectF& _rect)
+{
+    _painter->fillRect(_rect, Ui::DesignSystem::color().surface());
+
+    for (const auto cardIndex : d->layout.cardsIn(_rect)) {
+        const auto& card = d->layout.cards().at(cardIndex);
+        if (d->isDragging && card.item == d->pressedItem) {
+            _painter->setOpacity(Ui::DesignSystem::inactiveItemOpacity());
+            _painter->drawPixmap(card.rect.topLeft(), d->cardPixmap(card));
+            _painter->setOpacity(1.0);
+            continue;
+        }
+
+        _painter->drawPixmap(card.rect.topLeft(), d->cardPixmap(card));
+    }
+}
+
+void CardsGraphicsView::drawForeground(QPainter* _painter, const QRectF& _rect)
+{
+    Q_UNUSED(_rect)
+
+    if (!d->isDragging) {
+        return;
+    }
+
+    const auto cardIndex = d->layout.indexOf(d->pressedItem);
+    if (cardIndex == -1) {
+        return;
+    }
+
+    _painter->drawPixmap(d->dragPosition - d->pressOffset,
+                         d->cardPixmap(d->layout.cards().at(cardIndex)));
+}
+
+void CardsGraphicsView::resizeEvent(QResizeEvent* _event)
+{
+    ScalableGraphicsView::resizeEvent(_event);
+
+    if (d->updateColumnsCount()) {
+        d->relayout();
+    }
+}
+
+void CardsGraphicsView::mousePressEvent(QMouseEvent* _event)
+{
+    ScalableGraphicsView::mousePressEvent(_event);
+
+    if (isScrolling() || _event->button() != Qt::LeftButton) {
+        return;
+    }
+
+    const auto scenePosition = mapToScene(_event->pos());
+    const auto cardIndex = d->layout.cardAt(scenePosition);
+    if (cardIndex == -1) {
+        return;
+    }
+
+    const auto& card = d->layout.cards().at(cardIndex);
+    d->pressedItem = card.item;
+    d->pressPosition = _event->pos();
+    d->pressOffset = scenePosition - card.rect.topLeft();
+}
+
+void CardsGraphicsView::mouseMoveEvent(QMouseEvent* _event)
+{
+    if (d->pressedItem == nullptr || isScrolling() || !(_event->buttons() & Qt::LeftButton)) {
+        ScalableGraphicsView::mouseMoveEvent(_event);
+        return;
+    }
+
+    if (!d->isDragging
+        && (_event->pos() - d->pressPosition).manhattanLength()
+            < QApplication::startDragDistance()) {
+        return;
+    }
+
+    d->isDragging = true;
+    d->dragPosition = mapToScene(_event->pos());
+    viewport()->update();
+}
+
+void CardsGraphicsView::mouseReleaseEvent(QMouseEvent* _event)
+{
+    if (d->isDragging && !d->model.isNull()) {
+        const auto item = d->pressedItem;
+        d->resetDragging();
+        moveCard(d->model->indexForItem(item), mapToScene(_event->pos()));
+    } else {
+        d->resetDragging();
+    }
+
+    ScalableGraphicsView::mouseReleaseEvent(_event);
+}
+
+} // namespace Ui
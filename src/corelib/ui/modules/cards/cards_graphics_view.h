@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ui/widgets/scalable_graphics_view/scalable_graphics_view.h>
+
+namespace BusinessLayer {
+class TextModel;
+}
+
+
+namespace Ui {
+
+class CardsLayout;
+
+/**
+ * @brief Доска карточек сцен и папок текстовой модели
+ *
+ * Карточки не являются элементами графической сцены: доска рисует только те из них, которые
+ * попадают в перерисовываемую область, из закешированных картинок. Картинка карточки сбрасывается
+ * при изменении её элемента модели, а при изменении структуры модели пересчитывается только
+ * раскладка. Перетаскивание карточки превращается в одно перемещение элемента в модели.
+ */
+class CORE_LIBRARY_EXPORT CardsGraphicsView : public ScalableGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit CardsGraphicsView(QWidget* _parent = nullptr);
+    ~CardsGraphicsView() override;
+
+    /**
+     * @brief Задать модель, элементы которой выводятся на доске
+     */
+    void setModel(BusinessLayer::TextModel* _model);
+
+    /**
+     * @brief Раскладка карточек на доске
+     */
+    const CardsLayout& cardsLayout() const;
+
+    /**
+     * @brief Переместить элемент заданного индекса в место доски, куда он был брошен
+     * @return Был ли перемещён элемент
+     */
+    bool moveCard(const QModelIndex& _index, const QPointF& _scenePosition);
+
+    /**
+     * @brief Количество закешированных картинок карточек
+     */
+    int cachedCardsCount() const;
+
+protected:
+    /**
+     * @brief Рисуем карточки, попадающие в перерисовываемую область
+     */
+    void drawBackground(QPainter* _painter, const QRectF& _rect) override;
+
+    /**
+     * @brief Рисуем перетаскиваемую карточку
+     */
+    void drawForeground(QPainter* _painter, const QRectF& _rect) override;
+
+    /**
+     * @brief Подстраиваем количество колонок под ширину доски
+     */
+    void resizeEvent(QResizeEvent* _event) override;
+
+    /**
+     * @brief Реализация перетаскивания карточек
+     */
+    /** @{ */
+    void mousePressEvent(QMouseEvent* _event) override;
+    void mouseMoveEvent(QMouseEvent* _event) override;
+    void mouseReleaseEvent(QMouseEvent* _event) override;
+    /** @} */
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace Ui
@@ -0,0 +1,340 @@
+#include "cards_layout.h"
+
+#include <business_layer/model/text/text_model.h>
+#include <business_layer/model/text/text_model_group_item.h>
+#include <business_layer/templates/text_template.h>
+
+#include <QHash>
+
+#include <algorithm>
+#include <cmath>
+
+using BusinessLayer::TextGroupType;
+using BusinessLayer::TextModelItem;
+using BusinessLayer::TextModelItemType;
+
+
+namespace Ui {
+
+class CardsLayout::Implementation
+{
+public:
+    /**
+     * @brief Разложить детей заданного элемента
+     */
+    void layoutChildren(TextModelItem* _item, int _level);
+
+    /**
+     * @brief Добавить карточку элемента
+     */
+    void addCard(TextModelItem* _item, const QRectF& _rect, bool _isFolder, int _level);
+
+    /**
+     * @brief Завершить текущую строку карточек
+     */
+    void finishRow();
+
+    /**
+     * @brief Левая граница карточек заданного уровня вложенности
+     */
+    qreal left(int _level) const;
+
+    /**
+     * @brief Позиция первой карточки, нижняя граница которой не выше заданной координаты
+     */
+    int firstCardBelow(qreal _y) const;
+
+
+    BusinessLayer::TextModel* model = nullptr;
+
+    QSizeF cardSize = { 240, 160 };
+    qreal folderHeight = 40;
+    qreal spacing = 16;
+    int columnsCount = 4;
+
+    /**
+     * @brief Карточки в порядке следования элементов в модели
+     */
+    QVector<Card> cards;
+
+    /**
+     * @brief Позиции карточек элементов
+     */
+    QHash<TextModelItem*, int> cardsIndexes;
+
+    /**
+     * @brief Размер доски
+     */
+    QSizeF size;
+
+    /**
+     * @brief Текущее положение при раскладке
+     */
+    qreal y = 0;
+    int column = 0;
+};
+
+void CardsLayout::Implementation::layoutChildren(TextModelItem* _item, int _level)
+{
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        auto childItem = _item->childAt(childIndex);
+        switch (childItem->type()) {
+        case TextModelItemType::Folder: {
+            finishRow();
+            const auto width = columnsCount * (cardSize.width() + spacing) - spacing;
+            addCard(childItem, { left(_level), y, width, folderHeight }, true, _level);
+            y += folderHeight + spacing;
+
+            layoutChildren(childItem, _level + 1);
+            finishRow();
+            break;
+        }
+
+        case TextModelItemType::Group: {
+            //
+            // Биты выводятся внутри карточек своих сцен, поэтому отдельных карточек у них нет
+            //
+            const auto groupItem = static_cast<BusinessLayer::TextModelGroupItem*>(childItem);
+            if (groupItem->groupType() == TextGroupType::Beat) {
+                break;
+            }
+
+            const auto x = left(_level) + column * (cardSize.width() + spacing);
+            addCard(childItem, { QPointF(x, y), cardSize }, false, _level);
+            if (++column == columnsCount) {
+                finishRow();
+            }
+            break;
+        }
+
+        default: {
+            break;
+        }
+        }
+    }
+}
+
+void CardsLayout::Implementation::addCard(TextModelItem* _item, const QRectF& _rect,
+                                          bool _isFolder, int _level)
+{
+    cardsIndexes.insert(_item, cards.size());
+    cards.append({ _item, _rect, _isFolder, _level });
+    size.setWidth(std::max(size.width(), _rect.right() + spacing));
+}
+
+void CardsLayout::Implementation::finishRow()
+{
+    if (column == 0) {
+        return;
+    }
+
+    y += cardSize.height() + spacing;
+    column = 0;
+}
+
+qreal CardsLayout::Implementation::left(int _level) const
+{
+    return spacing * (_level + 1);
+}
+
+int CardsLayout::Implementation::firstCardBelow(qreal _y) const
+{
+    const auto card = std::lower_bound(
+        cards.begin(), cards.end(), _y,
+        [](const Card& _card, qreal _value) { return _card.rect.bottom() < _value; });
+    return static_cast<int>(std::distance(cards.begin(), card));
+}
+
+
+// ****
+
+
+CardsLayout::CardsLayout()
+    : d(new Implementation)
+{
+}
+
+CardsLayout::~CardsLayout() = default;
+
+void CardsLayout::setModel(BusinessLayer::TextModel* _model)
+{
+    d->model = _model;
+}
+
+BusinessLayer::TextModel* CardsLayout::model() const
+{
+    return d->model;
+}
+
+void CardsLayout::setCardSize(const QSizeF& _size)
+{
+    d->cardSize = _size;
+}
+
+QSizeF CardsLayout::cardSize() const
+{
+    return d->cardSize;
+}
+
+void CardsLayout::setFolderHeight(qreal _height)
+{
+    d->folderHeight = _height;
+}
+
+void CardsLayout::setSpacing(qreal _spacing)
+{
+    d->spacing = _spacing;
+}
+
+void CardsLayout::setColumnsCount(int _count)
+{
+    d->columnsCount = std::max(1, _count);
+}
+
+int CardsLayout::columnsCount() const
+{
+    return d->columnsCount;
+}
+
+void CardsLayout::relayout()
+{
+    d->cards.clear();
+    d->cardsIndexes.clear();
+    d->size = {};
+    d->y = d->spacing;
+    d->column = 0;
+
+    if (d->model != nullptr) {
+        d->layoutChildren(d->model->itemForIndex({}), 0);
+        d->finishRow();
+    }
+
+    d->size.setHeight(d->y);
+}
+
+QSizeF CardsLayout::size() const
+{
+    return d->size;
+}
+
+const QVector<CardsLayout::Card>& CardsLayout::cards() const
+{
+    return d->cards;
+}
+
+int CardsLayout::indexOf(BusinessLayer::TextModelItem* _item) const
+{
+    return d->cardsIndexes.value(_item, -1);
+}
+
+QVector<int> CardsLayout::cardsIn(const QRectF& _rect) const
+{
+    QVector<int> indexes;
+    for (int index = d->firstCardBelow(_rect.top()); index < d->cards.size(); ++index) {
+        const auto& cardRect = d->cards.at(index).rect;
+        if (cardRect.top() > _rect.bottom()) {
+            break;
+        }
+
+        if (cardRect.intersects(_rect)) {
+            indexes.append(index);
+        }
+    }
+    return indexes;
+}
+
+int CardsLayout::cardAt(const QPointF& _position) const
+{
+    for (int index = d->firstCardBelow(_position.y()); index < d->cards.size(); ++index) {
+        const auto& cardRect = d->cards.at(index).rect;
+        if (cardRect.top() > _position.y()) {
+            break;
+        }
+
+        if (cardRect.contains(_position)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+CardsLayout::DropPosition CardsLayout::dropPosition(BusinessLayer::TextModelItem* _item,
+                                                    const QPointF& _position) const
+{
+    if (_item == nullptr || d->cards.isEmpty()) {
+        return {};
+    }
+
+    //
+    // Ищем ближайшую по горизонтали карточку в строке под точкой бросания, а если точка ниже
+    // всех карточек, то кладём элемент после последней из них
+    //
+    int targetIndex = d->firstCardBelow(_position.y());
+    bool isAfterTarget = false;
+    if (targetIndex == d->cards.size()) {
+        targetIndex = d->cards.size() - 1;
+        isAfterTarget = true;
+    } else {
+        const auto rowTop = d->cards.at(targetIndex).rect.top();
+        auto distance = [&_position](const QRectF& _rect) {
+            return std::abs(_rect.center().x() - _position.x());
+        };
+        for (int index = targetIndex + 1;
+             index < d->cards.size() && qFuzzyCompare(d->cards.at(index).rect.top(), rowTop);
+             ++index) {
+            if (distance(d->cards.at(index).rect) < distance(d->cards.at(targetIndex).rect)) {
+                targetIndex = index;
+            }
+        }
+
+        const auto& targetRect = d->cards.at(targetIndex).rect;
+        isAfterTarget = d->cards.at(targetIndex).isFolder
+            ? _position.y() > targetRect.center().y()
+            : _position.x() > targetRect.center().x();
+    }
+
+    const auto& target = d->cards.at(targetIndex);
+    if (target.item == _item || _item->hasChild(target.item, true)) {
+        return {};
+    }
+
+    DropPosition position;
+    position.isValid = true;
+    if (target.isFolder && isAfterTarget) {
+        //
+        // ... бросание на нижнюю половину заголовка папки кладёт элемент в её начало, сразу после
+        //     блока заголовка
+        //
+        position.parent = target.item;
+        position.afterSibling = target.item->hasChildren()
+                && target.item->childAt(0)->type() == TextModelItemType::Text
+            ? target.item->childAt(0)
+            : nullptr;
+    } else if (isAfterTarget) {
+        position.parent = target.item->parent();
+        position.afterSibling = target.item;
+    } else {
+        const auto parent = target.item->parent();
+        const auto targetRow = parent->rowOfChild(target.item);
+        position.parent = parent;
+        position.afterSibling = targetRow > 0 ? parent->childAt(targetRow - 1) : nullptr;
+    }
+
+    //
+    // ... если элемент уже находится на этом месте, то перемещать его некуда
+    //
+    if (position.afterSibling == _item) {
+        return {};
+    }
+    if (_item->parent() == position.parent) {
+        const auto itemRow = position.parent->rowOfChild(_item);
+        const auto previousSibling = itemRow > 0 ? position.parent->childAt(itemRow - 1) : nullptr;
+        if (position.afterSibling == previousSibling) {
+            return {};
+        }
+    }
+
+    return position;
+}
+
+} // namespace Ui
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QRectF>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <corelib_global.h>
+
+namespace BusinessLayer {
+class TextModel;
+class TextModelItem;
+} // namespace BusinessLayer
+
+
+namespace Ui {
+
+/**
+ * @brief Раскладка карточек текстовой модели на доске
+ *
+ * Папки выводятся заголовками во всю ширину доски, а сцены - карточками одинакового размера,
+ * которые заполняют строки сетки под заголовком своей папки. Карточки хранятся в порядке следования
+ * элементов в модели, поэтому их вертикальные координаты не убывают и поиск карточек, попадающих
+ * в заданную область, выполняется двоичным поиском без перебора всей доски.
+ */
+class CORE_LIBRARY_EXPORT CardsLayout
+{
+public:
+    /**
+     * @brief Карточка на доске
+     */
+    struct Card {
+        BusinessLayer::TextModelItem* item = nullptr;
+        QRectF rect;
+        bool isFolder = false;
+        int level = 0;
+    };
+
+    /**
+     * @brief Место, в которое будет перемещён элемент при бросании
+     */
+    struct DropPosition {
+        bool isValid = false;
+        BusinessLayer::TextModelItem* parent = nullptr;
+        BusinessLayer::TextModelItem* afterSibling = nullptr;
+    };
+
+public:
+    CardsLayout();
+    ~CardsLayout();
+
+    /**
+     * @brief Задать модель, элементы которой раскладываются на доске
+     */
+    void setModel(BusinessLayer::TextModel* _model);
+    BusinessLayer::TextModel* model() const;
+
+    /**
+     * @brief Размер карточки сцены
+     */
+    void setCardSize(const QSizeF& _size);
+    QSizeF cardSize() const;
+
+    /**
+     * @brief Высота заголовка папки
+     */
+    void setFolderHeight(qreal _height);
+
+    /**
+     * @brief Расстояние между карточками и отступ вложенных папок
+     */
+    void setSpacing(qreal _spacing);
+
+    /**
+     * @brief Количество карточек в строке
+     */
+    void setColumnsCount(int _count);
+    int columnsCount() const;
+
+    /**
+     * @brief Разложить все элементы модели
+     */
+    void relayout();
+
+    /**
+     * @brief Размер доски
+     */
+    QSizeF size() const;
+
+    /**
+     * @brief Карточки в порядке следования элементов в модели
+     */
+    const QVector<Card>& cards() const;
+
+    /**
+     * @brief Позиция карточки элемента, либо -1, если элемент не выводится на доске
+     */
+    int indexOf(BusinessLayer::TextModelItem* _item) const;
+
+    /**
+     * @brief Позиции карточек, пересекающихся с заданной областью
+     */
+    QVector<int> cardsIn(const QRectF& _rect) const;
+
+    /**
+     * @brief Позиция карточки в заданной точке, либо -1, если там нет карточки
+     */
+    int cardAt(const QPointF& _position) const;
+
+    /**
+     * @brief Определить, куда попадёт элемент, брошенный в заданную точку
+     */
+    DropPosition dropPosition(BusinessLayer::TextModelItem* _item,
+                              const QPointF& _position) const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace Ui
@@ -2,16 +2,18 @@
 
 #include <business_layer/model/text/text_model.h>
 #include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/model/text/text_model_text_items_index.h>
 #include <business_layer/templates/text_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <utils/shugar.h>
-#include <utils/tools/model_index_path.h>
 
 #include <QColor>
 #include <QDateTime>
 #include <QPointer>
 
+#include <algorithm>
+
 
 namespace BusinessLayer {
 
@@ -20,6 +22,50 @@ class CommentsModel::Implementation
 public:
     explicit Implementation(CommentsModel* _q);
 
+    struct ReviewMarkWrapper;
+
+    /**
+     * @brief Строки заметок, в которые входит заданный абзац
+     */
+    QVector<int> reviewMarkRows(TextModelTextItem* _textItem) const;
+
+    /**
+     * @brief Заметки, в которые входит заданный абзац
+     */
+    QVector<ReviewMarkWrapper> reviewMarkWrappers(TextModelTextItem* _textItem) const;
+
+    /**
+     * @brief Строка заданной заметки
+     */
+    int reviewMarkRow(const ReviewMarkWrapper& _reviewMarkWrapper) const;
+
+    /**
+     * @brief Строка, в которую нужно вставить заметку, чтобы не нарушить порядок заметок
+     */
+    int reviewMarkInsertRow(const ReviewMarkWrapper& _reviewMarkWrapper) const;
+
+    /**
+     * @brief Заменить заметку в заданной строке, переместив её, если изменилось её начало
+     * @note Если в заметке не осталось абзацев, она удаляется
+     */
+    void replaceReviewMark(int _row, const ReviewMarkWrapper& _reviewMarkWrapper);
+
+    /**
+     * @brief Удалить заметку в заданной строке
+     */
+    void removeReviewMark(int _row);
+
+    /**
+     * @brief Обновить максимальное количество абзацев в заметке
+     */
+    void updateMaximumReviewMarkSpan(const ReviewMarkWrapper& _reviewMarkWrapper);
+
+    /**
+     * @brief Пересчитать максимальное количество абзацев в заметке, если самая длинная из заметок
+     *        стала короче, чем была
+     */
+    void recalculateMaximumReviewMarkSpan(int _previousReviewMarkSpan, int _reviewMarkSpan);
+
     void saveReviewMark(TextModelTextItem* _textItem,
                         const TextModelTextItem::ReviewMark& _reviewMark);
 
@@ -42,7 +88,7 @@ public:
     /**
      * @brief Список всех текстовых элементов модели, для того, чтобы понимать их последовательность
      */
-    QVector<TextModelTextItem*> modelTextItems;
+    TextModelTextItemsIndex modelTextItems;
 
     /**
      * @brief Вспомогательная структура для хранения заметки и группы элементов, к которой она
@@ -73,9 +119,16 @@ public:
         bool operator==(const ReviewMarkWrapper& _other) const;
     };
     /**
-     * @brief Список заметок сценария
+     * @brief Список заметок сценария, упорядоченный по первым абзацам заметок, а в рамках одного
+     *        абзаца - по началу заметки
      */
     QVector<ReviewMarkWrapper> reviewMarks;
+
+    /**
+     * @brief Максимальное количество абзацев, на которое растягивается одна заметка
+     * @note Используется, чтобы ограничить область поиска заметок заданного абзаца
+     */
+    int maximumReviewMarkSpan = 1;
 };
 
 CommentsModel::Implementation::Implementation(CommentsModel* _q)
@@ -83,6 +136,164 @@ CommentsModel::Implementation::Implementation(CommentsModel* _q)
 {
 }
 
+QVector<int> CommentsModel::Implementation::reviewMarkRows(TextModelTextItem* _textItem) const
+{
+    if (reviewMarks.isEmpty()) {
+        return {};
+    }
+
+    const auto textItemPosition = modelTextItems.contains(_textItem)
+        ? modelTextItems.indexOf(_textItem)
+        : modelTextItems.lowerBound(_textItem);
+    auto firstItemPosition = [this](const ReviewMarkWrapper& _reviewMarkWrapper) {
+        return modelTextItems.indexOf(_reviewMarkWrapper.items.constFirst());
+    };
+
+    //
+    // Заметки упорядочены по их первым абзацам, поэтому начинаем с первой заметки, которая может
+    // дотянуться до заданного абзаца, и заканчиваем на тех, что начинаются в нём самом
+    //
+    auto iter = std::lower_bound(reviewMarks.cbegin(), reviewMarks.cend(),
+                                 textItemPosition - maximumReviewMarkSpan + 1,
+                                 [firstItemPosition](const ReviewMarkWrapper& _reviewMarkWrapper,
+                                                     int _position) {
+                                     return firstItemPosition(_reviewMarkWrapper) < _position;
+                                 });
+    QVector<int> rows;
+    for (; iter != reviewMarks.cend(); ++iter) {
+        if (firstItemPosition(*iter) > textItemPosition) {
+            break;
+        }
+
+        if (iter->items.contains(_textItem)) {
+            rows.append(static_cast<int>(std::distance(reviewMarks.cbegin(), iter)));
+        }
+    }
+    return rows;
+}
+
+QVector<CommentsModel::Implementation::ReviewMarkWrapper> CommentsModel::Implementation::
+    reviewMarkWrappers(TextModelTextItem* _textItem) const
+{
+    QVector<ReviewMarkWrapper> wrappers;
+    for (const auto row : reviewMarkRows(_textItem)) {
+        wrappers.append(reviewMarks.at(row));
+    }
+    return wrappers;
+}
+
+int CommentsModel::Implementation::reviewMarkRow(
+    const ReviewMarkWrapper& _reviewMarkWrapper) const
+{
+    if (_reviewMarkWrapper.items.isEmpty()) {
+        return reviewMarks.indexOf(_reviewMarkWrapper);
+    }
+
+    for (const auto row : reviewMarkRows(_reviewMarkWrapper.items.constFirst())) {
+        if (reviewMarks.at(row) == _reviewMarkWrapper) {
+            return row;
+        }
+    }
+
+    //
+    // Сюда попадаем, только если порядок заметок был нарушен, поэтому ищем по старинке
+    //
+    return reviewMarks.indexOf(_reviewMarkWrapper);
+}
+
+int CommentsModel::Implementation::reviewMarkInsertRow(
+    const ReviewMarkWrapper& _reviewMarkWrapper) const
+{
+    const auto firstItemPosition = modelTextItems.indexOf(_reviewMarkWrapper.items.constFirst());
+    const auto insertBefore = std::upper_bound(
+        reviewMarks.cbegin(), reviewMarks.cend(), _reviewMarkWrapper,
+        [this, firstItemPosition](const ReviewMarkWrapper& _reviewMarkWrapper,
+                                  const ReviewMarkWrapper& _insertBeforeReviewMarkWrapper) {
+            const auto insertBeforeFirstItemPosition
+                = modelTextItems.indexOf(_insertBeforeReviewMarkWrapper.items.constFirst());
+            //
+            // Если заметка начинается в элементе, который идёт после первого элемента вставляемой
+            //
+            return firstItemPosition < insertBeforeFirstItemPosition
+                //
+                // ... или если в том же элементе, тогда сортируем по расположению самой заметки
+                //
+                || (firstItemPosition == insertBeforeFirstItemPosition
+                    && _reviewMarkWrapper.fromInFirstItem
+                        < _insertBeforeReviewMarkWrapper.fromInFirstItem);
+        });
+    return static_cast<int>(std::distance(reviewMarks.cbegin(), insertBefore));
+}
+
+void CommentsModel::Implementation::replaceReviewMark(int _row,
+                                                      const ReviewMarkWrapper& _reviewMarkWrapper)
+{
+    if (_reviewMarkWrapper.items.isEmpty()) {
+        removeReviewMark(_row);
+        return;
+    }
+
+    const auto previousReviewMarkSpan = static_cast<int>(reviewMarks.at(_row).items.size());
+
+    //
+    // Определяем новое место заметки без учёта её самой
+    //
+    reviewMarks.remove(_row);
+    const auto newRow = reviewMarkInsertRow(_reviewMarkWrapper);
+    reviewMarks.insert(_row, _reviewMarkWrapper);
+
+    //
+    // ... и если оно изменилось, перемещаем заметку
+    //
+    if (newRow != _row) {
+        q->beginMoveRows({}, _row, _row, {}, newRow > _row ? newRow + 1 : newRow);
+        reviewMarks.move(_row, newRow);
+        q->endMoveRows();
+    }
+
+    const auto changedItemModelIndex = q->index(newRow, 0);
+    emit q->dataChanged(changedItemModelIndex, changedItemModelIndex);
+
+    recalculateMaximumReviewMarkSpan(previousReviewMarkSpan,
+                                     static_cast<int>(_reviewMarkWrapper.items.size()));
+}
+
+void CommentsModel::Implementation::removeReviewMark(int _row)
+{
+    const auto previousReviewMarkSpan = static_cast<int>(reviewMarks.at(_row).items.size());
+
+    q->beginRemoveRows({}, _row, _row);
+    reviewMarks.remove(_row);
+    q->endRemoveRows();
+
+    recalculateMaximumReviewMarkSpan(previousReviewMarkSpan, 0);
+}
+
+void CommentsModel::Implementation::updateMaximumReviewMarkSpan(
+    const ReviewMarkWrapper& _reviewMarkWrapper)
+{
+    maximumReviewMarkSpan
+        = std::max(maximumReviewMarkSpan, static_cast<int>(_reviewMarkWrapper.items.size()));
+}
+
+void CommentsModel::Implementation::recalculateMaximumReviewMarkSpan(int _previousReviewMarkSpan,
+                                                                     int _reviewMarkSpan)
+{
+    //
+    // Пересчитываем, только если укоротилась одна из самых длинных заметок, в остальных случаях
+    // максимум остаётся прежним
+    //
+    if (maximumReviewMarkSpan == 1 || _previousReviewMarkSpan < maximumReviewMarkSpan
+        || _reviewMarkSpan >= _previousReviewMarkSpan) {
+        return;
+    }
+
+    maximumReviewMarkSpan = 1;
+    for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
+        updateMaximumReviewMarkSpan(reviewMarkWrapper);
+    }
+}
+
 void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
                                                    const TextModelTextItem::ReviewMark& _reviewMark)
 {
@@ -93,7 +304,7 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
             break;
         }
 
-        if (!modelTextItems.isEmpty() && _textItem == modelTextItems.constFirst()) {
+        if (!modelTextItems.isEmpty() && _textItem == modelTextItems.at(0)) {
             break;
         }
 
@@ -110,17 +321,7 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
                 break;
             }
             auto previousTextItem = modelTextItems.at(previewTextItemIndex);
-            QVector<ReviewMarkWrapper> previosTextItemReviewMarkWrappers;
-            for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
-                if (reviewMarkWrapper.items.contains(previousTextItem)) {
-                    previosTextItemReviewMarkWrappers.append(reviewMarkWrapper);
-                    continue;
-                }
-
-                if (!previosTextItemReviewMarkWrappers.isEmpty()) {
-                    break;
-                }
-            }
+            const auto previosTextItemReviewMarkWrappers = reviewMarkWrappers(previousTextItem);
             if (previosTextItemReviewMarkWrappers.isEmpty()) {
                 break;
             }
@@ -138,9 +339,10 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
                 && previousTextItemLastReviewMarkWrapper.toInLastItem
                     == previousTextItem->text().length()) {
                 auto& reviewMarkWrapper
-                    = reviewMarks[reviewMarks.indexOf(previousTextItemLastReviewMarkWrapper)];
+                    = reviewMarks[reviewMarkRow(previousTextItemLastReviewMarkWrapper)];
                 reviewMarkWrapper.items.append(_textItem);
                 reviewMarkWrapper.toInLastItem = _reviewMark.length;
+                updateMaximumReviewMarkSpan(reviewMarkWrapper);
                 reviewMarkAdded = true;
             }
         }
@@ -151,17 +353,7 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
             //
             // Смотрим заметки которые есть в текущем блоке
             //
-            QVector<ReviewMarkWrapper> textItemReviewMarkWrappers;
-            for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
-                if (reviewMarkWrapper.items.contains(_textItem)) {
-                    textItemReviewMarkWrappers.append(reviewMarkWrapper);
-                    continue;
-                }
-
-                if (!textItemReviewMarkWrappers.isEmpty()) {
-                    break;
-                }
-            }
+            const auto textItemReviewMarkWrappers = reviewMarkWrappers(_textItem);
             if (textItemReviewMarkWrappers.isEmpty()) {
                 break;
             }
@@ -176,8 +368,7 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
                 // конце абзаца
                 //
                 if (textItemReviewMarkWrapper.reviewMark.isPartiallyEqual(_reviewMark)) {
-                    auto& reviewMarkWrapper
-                        = reviewMarks[reviewMarks.indexOf(textItemReviewMarkWrapper)];
+                    auto& reviewMarkWrapper = reviewMarks[reviewMarkRow(textItemReviewMarkWrapper)];
                     //
                     // ... если выделения в одном блоке
                     //
@@ -240,25 +431,7 @@ void CommentsModel::Implementation::saveReviewMark(TextModelTextItem* _textItem,
     reviewMarkWrapper.fromInFirstItem = _reviewMark.from;
     reviewMarkWrapper.toInLastItem = _reviewMark.end();
 
-    int insertIndex = 0;
-    const auto textItemIndex = modelTextItems.indexOf(_textItem);
-    for (; insertIndex < reviewMarks.size(); ++insertIndex) {
-        const auto insertBeforeReviewMarkWrapper = reviewMarks.at(insertIndex);
-        const auto reviewMarkWrapperTextItemIndex
-            = modelTextItems.indexOf(insertBeforeReviewMarkWrapper.items.constLast());
-        //
-        // Если элемент идёт после вставляемого
-        //
-        if (textItemIndex < reviewMarkWrapperTextItemIndex
-            //
-            // ... или если в том же элементе, тогда сортируем по расположению самой заметки
-            //
-            || (textItemIndex == reviewMarkWrapperTextItemIndex
-                && reviewMarkWrapper.fromInFirstItem
-                    < insertBeforeReviewMarkWrapper.fromInFirstItem)) {
-            break;
-        }
-    }
+    const auto insertIndex = reviewMarkInsertRow(reviewMarkWrapper);
     q->beginInsertRows({}, insertIndex, insertIndex);
     reviewMarks.insert(insertIndex, reviewMarkWrapper);
     q->endInsertRows();
@@ -270,8 +443,6 @@ void CommentsModel::Implementation::processSourceModelRowsInserted(const QModelI
     //
     // Для каждого из вставленных
     //
-    const int invalidPosition = -1;
-    int lastInsertPosition = invalidPosition;
     for (int row = _firstRow; row <= _lastRow; ++row) {
         //
         // Игнорируем не текстовые элементы
@@ -304,40 +475,14 @@ void CommentsModel::Implementation::processSourceModelRowsInserted(const QModelI
             break;
         }
 
-        if (lastInsertPosition == invalidPosition) {
-            const auto itemIndexPath = ModelIndexPath(itemIndex);
-            for (int index = 0; index < modelTextItems.size(); ++index) {
-                const auto modelTextItem = modelTextItems.at(index);
-                const auto modelTextItemIndex = model->indexForItem(modelTextItem);
-                if (itemIndexPath < ModelIndexPath(modelTextItemIndex)) {
-                    lastInsertPosition = index;
-                    break;
-                }
-            }
-            if (lastInsertPosition == invalidPosition) {
-                lastInsertPosition = modelTextItems.size();
-            }
-        } else {
-            ++lastInsertPosition;
-        }
-        modelTextItems.insert(lastInsertPosition, textItem);
+        const auto lastInsertPosition = modelTextItems.insert(textItem);
 
         //
         // Если новый элемент вставился посередине уже существующей заметки
         //
         if (lastInsertPosition > 0) {
             auto previousTextItem = modelTextItems.value(lastInsertPosition - 1);
-            QVector<ReviewMarkWrapper> previousItemReviewMarkWrappers;
-            for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
-                if (reviewMarkWrapper.items.contains(previousTextItem)) {
-                    previousItemReviewMarkWrappers.append(reviewMarkWrapper);
-                    continue;
-                }
-
-                if (!previousItemReviewMarkWrappers.isEmpty()) {
-                    break;
-                }
-            }
+            const auto previousItemReviewMarkWrappers = reviewMarkWrappers(previousTextItem);
 
             //
             // Если на границе вставляемого элемента есть состовная редакторская заметка
@@ -347,7 +492,7 @@ void CommentsModel::Implementation::processSourceModelRowsInserted(const QModelI
                 const auto previousItemReviewMarkWrapper
                     = previousItemReviewMarkWrappers.constLast();
                 const auto previousItemReviewMarkWrapperIndex
-                    = reviewMarks.indexOf(previousItemReviewMarkWrapper);
+                    = reviewMarkRow(previousItemReviewMarkWrapper);
                 //
                 // ... и вставляемый блок находится у неё в середине, то разделяем её на две
                 //
@@ -364,7 +509,8 @@ void CommentsModel::Implementation::processSourceModelRowsInserted(const QModelI
                               ->reviewMarks()
                               .constLast()
                               .end();
-                    reviewMarks[previousItemReviewMarkWrapperIndex] = topCorrectedReviewMarkWrapper;
+                    replaceReviewMark(previousItemReviewMarkWrapperIndex,
+                                      topCorrectedReviewMarkWrapper);
                     //
                     // ... добавим заметку снизу
                     //
@@ -380,12 +526,13 @@ void CommentsModel::Implementation::processSourceModelRowsInserted(const QModelI
                               .constFirst()
                               .from;
                     const int bottomCorrectedReviewMarkWrapperIndex
-                        = previousItemReviewMarkWrapperIndex + 1;
+                        = reviewMarkInsertRow(bottomCorrectedReviewMarkWrapper);
                     q->beginInsertRows({}, bottomCorrectedReviewMarkWrapperIndex,
                                        bottomCorrectedReviewMarkWrapperIndex);
                     reviewMarks.insert(bottomCorrectedReviewMarkWrapperIndex,
                                        bottomCorrectedReviewMarkWrapper);
                     q->endInsertRows();
+                    updateMaximumReviewMarkSpan(bottomCorrectedReviewMarkWrapper);
                 }
             }
         }
@@ -429,35 +576,23 @@ void CommentsModel::Implementation::processSourceModelRowsRemoved(const QModelIn
             //
             // Исключим его из списка
             //
-            modelTextItems.removeAll(textItem);
+            modelTextItems.remove(textItem);
             continue;
         }
 
-        QVector<ReviewMarkWrapper> reviewMarkWrappersToDelete;
-        for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
-            if (reviewMarkWrapper.items.contains(textItem)) {
-                reviewMarkWrappersToDelete.append(reviewMarkWrapper);
-                continue;
-            }
-
-            if (!reviewMarkWrappersToDelete.isEmpty()) {
-                break;
-            }
-        }
+        const auto reviewMarkWrappersToDelete = reviewMarkWrappers(textItem);
 
         //
         // Удаляем заметки
         //
         for (const auto& reviewMarkWrapper : reviewMarkWrappersToDelete) {
-            const auto reviewMarkWrapperIndex = reviewMarks.lastIndexOf(reviewMarkWrapper);
+            const auto reviewMarkWrapperIndex = reviewMarkRow(reviewMarkWrapper);
 
             //
             // Если эта заметка относится только к текущему блоку, просто удалим её
             //
             if (reviewMarkWrapper.items.size() == 1) {
-                q->beginRemoveRows({}, reviewMarkWrapperIndex, reviewMarkWrapperIndex);
-                reviewMarks.removeAll(reviewMarkWrapper);
-                q->endRemoveRows();
+                removeReviewMark(reviewMarkWrapperIndex);
             }
             //
             // В противном случае исключаем текущий блок из блоков заметки
@@ -474,7 +609,7 @@ void CommentsModel::Implementation::processSourceModelRowsRemoved(const QModelIn
                               ->reviewMarks()
                               .constFirst()
                               .from;
-                    reviewMarks[reviewMarkWrapperIndex] = correctedReviewMarkWrapper;
+                    replaceReviewMark(reviewMarkWrapperIndex, correctedReviewMarkWrapper);
                 }
                 //
                 // ... отрезаем от конца
@@ -487,7 +622,7 @@ void CommentsModel::Implementation::processSourceModelRowsRemoved(const QModelIn
                               ->reviewMarks()
                               .constLast()
                               .end();
-                    reviewMarks[reviewMarkWrapperIndex] = correctedReviewMarkWrapper;
+                    replaceReviewMark(reviewMarkWrapperIndex, correctedReviewMarkWrapper);
                 }
                 //
                 // ... вырезаем из середины
@@ -495,7 +630,7 @@ void CommentsModel::Implementation::processSourceModelRowsRemoved(const QModelIn
                 else {
                     auto correctedReviewMarkWrapper = reviewMarkWrapper;
                     correctedReviewMarkWrapper.items.removeAll(textItem);
-                    reviewMarks[reviewMarkWrapperIndex] = correctedReviewMarkWrapper;
+                    replaceReviewMark(reviewMarkWrapperIndex, correctedReviewMarkWrapper);
                 }
             }
         }
@@ -503,7 +638,7 @@ void CommentsModel::Implementation::processSourceModelRowsRemoved(const QModelIn
         //
         // Удаляем текстовый элемент из общего списка
         //
-        modelTextItems.removeAll(textItem);
+        modelTextItems.remove(textItem);
     }
 }
 
@@ -526,26 +661,18 @@ void CommentsModel::Implementation::processSourceModelDataChanged(const QModelIn
     if (textItem->isCorrection()
         || (!typesFilter.isEmpty() && !typesFilter.contains(textItem->paragraphType()))) {
         //
-        // А если раньше блок был не корректировочным, исключим его из списка
+        // А если раньше блок был не корректировочным, исключим его из заметок и из списка
         //
-        modelTextItems.removeAll(textItem);
-        for (auto& reviewMark : reviewMarks) {
-            reviewMark.items.removeAll(textItem);
+        for (const auto& reviewMarkWrapper : reviewMarkWrappers(textItem)) {
+            auto correctedReviewMarkWrapper = reviewMarkWrapper;
+            correctedReviewMarkWrapper.items.removeAll(textItem);
+            replaceReviewMark(reviewMarkRow(reviewMarkWrapper), correctedReviewMarkWrapper);
         }
+        modelTextItems.remove(textItem);
         return;
     }
 
-    QVector<ReviewMarkWrapper> oldReviewMarkWrappers;
-    for (const auto& reviewMarkWrapper : std::as_const(reviewMarks)) {
-        if (reviewMarkWrapper.items.contains(textItem)) {
-            oldReviewMarkWrappers.append(reviewMarkWrapper);
-            continue;
-        }
-
-        if (!oldReviewMarkWrappers.isEmpty()) {
-            break;
-        }
-    }
+    auto oldReviewMarkWrappers = reviewMarkWrappers(textItem);
 
     //
     // Если в абзаце не было заметок
@@ -594,10 +721,7 @@ void CommentsModel::Implementation::processSourceModelDataChanged(const QModelIn
                     //
                     // Перезаписываем на обновлённый
                     //
-                    const auto wrapperIndex = reviewMarks.indexOf(oldReviewMarkWrapper);
-                    reviewMarks[wrapperIndex] = newReviewMarkWrapper;
-                    const auto changedItemModelIndex = q->index(wrapperIndex, 0);
-                    emit q->dataChanged(changedItemModelIndex, changedItemModelIndex);
+                    replaceReviewMark(reviewMarkRow(oldReviewMarkWrapper), newReviewMarkWrapper);
 
                     oldReviewMarkWrappers.removeAt(oldReviewMarkIndex);
                     hasSimilar = true;
@@ -619,10 +743,7 @@ void CommentsModel::Implementation::processSourceModelDataChanged(const QModelIn
         for (int oldReviewMarkIndex = 0; oldReviewMarkIndex < oldReviewMarkWrappers.size();
              ++oldReviewMarkIndex) {
             const auto oldReviewMarkWrapper = oldReviewMarkWrappers.value(oldReviewMarkIndex);
-            const auto oldReviewMarkWrapperIndex = reviewMarks.indexOf(oldReviewMarkWrapper);
-            q->beginRemoveRows({}, oldReviewMarkWrapperIndex, oldReviewMarkWrapperIndex);
-            reviewMarks.remove(oldReviewMarkWrapperIndex);
-            q->endRemoveRows();
+            removeReviewMark(reviewMarkRow(oldReviewMarkWrapper));
 
             //
             // Если заметка включала в себя несколько блоков, то перестроим для них заметки
@@ -683,11 +804,12 @@ void CommentsModel::setTextModel(TextModel* _model)
 
     if (d->model != nullptr) {
         d->model->disconnect(this);
-        d->modelTextItems.clear();
-        d->reviewMarks.clear();
     }
 
     d->model = _model;
+    d->modelTextItems.setModel(d->model);
+    d->reviewMarks.clear();
+    d->maximumReviewMarkSpan = 1;
 
     if (d->model != nullptr) {
         std::function<void(const QModelIndex&)> readReviewMarksFromModel;
@@ -751,6 +873,7 @@ void CommentsModel::setTextModel(TextModel* _model)
                                                .length()) {
                                     lastReviewMarkWrapper.items.append(textItem);
                                     lastReviewMarkWrapper.toInLastItem = reviewMark.length;
+                                    d->updateMaximumReviewMarkSpan(lastReviewMarkWrapper);
                                     continue;
                                 }
                             }
@@ -769,6 +892,7 @@ void CommentsModel::setTextModel(TextModel* _model)
                                     && lastReviewMarkWrapper.toInLastItem == reviewMark.from) {
                                     lastReviewMarkWrapper.items.append(textItem);
                                     lastReviewMarkWrapper.toInLastItem = reviewMark.end();
+                                    d->updateMaximumReviewMarkSpan(lastReviewMarkWrapper);
                                     continue;
                                 }
                             }
@@ -802,6 +926,7 @@ void CommentsModel::setTextModel(TextModel* _model)
         connect(d->model, &TextModel::modelAboutToBeReset, this, [this] {
             d->modelTextItems.clear();
             d->reviewMarks.clear();
+            d->maximumReviewMarkSpan = 1;
         });
         connect(d->model, &TextModel::modelReset, this, [this] { setTextModel(d->model); });
         connect(d->model, &TextModel::rowsInserted, this,
@@ -853,18 +978,15 @@ QModelIndex CommentsModel::mapFromModel(const QModelIndex& _index, int _position
         return {};
     }
 
-    for (const auto& reviewMarkWrapper : std::as_const(d->reviewMarks)) {
-        if (!reviewMarkWrapper.items.contains(textItem)) {
-            continue;
-        }
-
+    for (const auto row : d->reviewMarkRows(textItem)) {
+        const auto& reviewMarkWrapper = d->reviewMarks.at(row);
         for (const auto& reviewMark : textItem->reviewMarks()) {
             if (!reviewMark.isPartiallyEqual(reviewMarkWrapper.reviewMark)) {
                 continue;
             }
 
             if (reviewMark.from <= _positionInBlock && _positionInBlock <= reviewMark.end()) {
-                return index(d->reviewMarks.indexOf(reviewMarkWrapper), 0);
+                return index(row, 0);
             }
         }
     }
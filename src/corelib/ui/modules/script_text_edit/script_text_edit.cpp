@@ -4,31 +4,123 @@
 #include <business_layer/templates/text_template.h>
 #include <utils/helpers/text_helper.h>
 
+#include <QAbstractTextDocumentLayout>
+#include <QHash>
+#include <QPointer>
 #include <QRegularExpression>
 #include <QScrollBar>
 #include <QTextTable>
 
 using BusinessLayer::TextBlockStyle;
+using BusinessLayer::TextParagraphType;
 
 
 namespace Ui {
 
+namespace {
+/**
+ * @brief Максимальное кол-во позиций прокрутки, для которых храним рассчитанные диапазоны
+ */
+constexpr int kVisibleBlocksCacheMaxSize = 512;
+} // namespace
+
 class ScriptTextEdit::Implementation
 {
 public:
+    explicit Implementation(ScriptTextEdit* _q);
+
+    /**
+     * @brief Обновить отслеживание документа, если он был сменён в редакторе
+     */
+    void updateVisibleBlocksCacheDocument();
+
+    /**
+     * @brief Сбросить кэш видимых блоков
+     */
+    void invalidateVisibleBlocksCache();
+
+
+    ScriptTextEdit* q = nullptr;
+
     /**
      * @brief Показывать автодополения в пустых блоках
      */
     bool showSuggestionsInEmptyBlocks = true;
+
+    /**
+     * @brief Кэш диапазонов видимых блоков
+     */
+    struct {
+        QPointer<QTextDocument> document;
+        QVector<QMetaObject::Connection> connections;
+        QSize viewportSize;
+        int horizontalScrollValue = 0;
+        QVector<TextParagraphType> headingTypes;
+        //
+        // Позиция вертикальной прокрутки -> диапазон блоков
+        //
+        QHash<int, QPair<QTextBlock, QTextBlock>> ranges;
+    } visibleBlocksCache;
 };
 
+ScriptTextEdit::Implementation::Implementation(ScriptTextEdit* _q)
+    : q(_q)
+{
+}
+
+void ScriptTextEdit::Implementation::updateVisibleBlocksCacheDocument()
+{
+    if (visibleBlocksCache.document == q->document()) {
+        return;
+    }
+
+    for (const auto& connection : std::as_const(visibleBlocksCache.connections)) {
+        QObject::disconnect(connection);
+    }
+    visibleBlocksCache.connections.clear();
+    invalidateVisibleBlocksCache();
+
+    visibleBlocksCache.document = q->document();
+    if (visibleBlocksCache.document.isNull()) {
+        return;
+    }
+
+    //
+    // Сбрасываем кэш при любых изменениях текста и его компоновки
+    //
+    const auto document = visibleBlocksCache.document.data();
+    auto connectLayout = [this, document] {
+        auto layout = document->documentLayout();
+        visibleBlocksCache.connections.append(
+            QObject::connect(layout, &QAbstractTextDocumentLayout::update, q,
+                             [this] { invalidateVisibleBlocksCache(); }));
+        visibleBlocksCache.connections.append(
+            QObject::connect(layout, &QAbstractTextDocumentLayout::documentSizeChanged, q,
+                             [this] { invalidateVisibleBlocksCache(); }));
+    };
+    connectLayout();
+    visibleBlocksCache.connections.append(
+        QObject::connect(document, &QTextDocument::contentsChange, q,
+                         [this] { invalidateVisibleBlocksCache(); }));
+    visibleBlocksCache.connections.append(
+        QObject::connect(document, &QTextDocument::documentLayoutChanged, q, [this, connectLayout] {
+            invalidateVisibleBlocksCache();
+            connectLayout();
+        }));
+}
+
+void ScriptTextEdit::Implementation::invalidateVisibleBlocksCache()
+{
+    visibleBlocksCache.ranges.clear();
+}
+
 
 // ****
 
 
 ScriptTextEdit::ScriptTextEdit(QWidget* _parent)
     : BaseTextEdit(_parent)
-    , d(new Implementation)
+    , d(new Implementation(this))
 {
 }
 
@@ -154,4 +246,78 @@ bool ScriptTextEdit::updateEnteredText(const QString& _eventText)
     return BaseTextEdit::updateEnteredText(_eventText);
 }
 
+QPair<QTextBlock, QTextBlock> ScriptTextEdit::visibleBlocksRange(
+    const QVector<TextParagraphType>& _headingTypes) const
+{
+    d->updateVisibleBlocksCacheDocument();
+
+    //
+    // Если изменились параметры области просмотра, то ранее рассчитанные диапазоны неактуальны
+    //
+    auto& cache = d->visibleBlocksCache;
+    if (cache.viewportSize != viewport()->size()
+        || cache.horizontalScrollValue != horizontalScrollBar()->value()
+        || cache.headingTypes != _headingTypes
+        || cache.ranges.size() > kVisibleBlocksCacheMaxSize) {
+        cache.viewportSize = viewport()->size();
+        cache.horizontalScrollValue = horizontalScrollBar()->value();
+        cache.headingTypes = _headingTypes;
+        cache.ranges.clear();
+    }
+
+    const auto verticalScrollValue = verticalScrollBar()->value();
+    if (const auto cachedRange = cache.ranges.constFind(verticalScrollValue);
+        cachedRange != cache.ranges.constEnd()) {
+        return cachedRange.value();
+    }
+
+    //
+    // Определим начальный блок на экране
+    //
+    QTextBlock topBlock = document()->lastBlock();
+    {
+        const auto topCursor = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, 0)));
+        if (topBlock.blockNumber() > topCursor.block().blockNumber()) {
+            topBlock = topCursor.block();
+        }
+    }
+    //
+    // ... идём до начала сцены
+    //
+    while (!_headingTypes.contains(TextBlockStyle::forBlock(topBlock))
+           && topBlock != document()->firstBlock()) {
+        topBlock = topBlock.previous();
+    }
+
+    //
+    // Определим последний блок на экране
+    //
+    QTextBlock bottomBlock = document()->firstBlock();
+    {
+        const auto bottomCursor
+            = cursorForPositionReimpl(viewport()->mapFromParent(QPoint(0, viewport()->height())));
+        if (bottomBlock.blockNumber() < bottomCursor.block().blockNumber()) {
+            bottomBlock = bottomCursor.block();
+        }
+    }
+    if (bottomBlock == document()->firstBlock()) {
+        bottomBlock = document()->lastBlock();
+    }
+    bottomBlock = bottomBlock.next();
+    //
+    // ... в случае, если блок попал в таблицу, нужно дойти до конца таблицы
+    //
+    {
+        BusinessLayer::TextCursor bottomCursor(document());
+        bottomCursor.setPosition(bottomBlock.position());
+        while (bottomCursor.inTable() && bottomCursor.movePosition(QTextCursor::NextBlock)) {
+            bottomBlock = bottomCursor.block();
+        }
+    }
+
+    const auto range = qMakePair(topBlock, bottomBlock);
+    cache.ranges.insert(verticalScrollValue, range);
+    return range;
+}
+
 } // namespace Ui
@@ -2,6 +2,11 @@
 
 #include <ui/widgets/text_edit/base/base_text_edit.h>
 
+#include <QTextBlock>
+
+namespace BusinessLayer {
+enum class TextParagraphType;
+}
 
 namespace Ui {
 
@@ -33,6 +38,18 @@ protected:
      */
     bool updateEnteredText(const QString& _eventText) override;
 
+    /**
+     * @brief Определить диапазон блоков, которые видны на экране
+     * @param _headingTypes - типы заголовков, до ближайшего из которых расширяется начало диапазона
+     * @return Первый блок диапазона и блок, следующий за последним видимым
+     *
+     * @note Если последний видимый блок находится в таблице, то диапазон расширяется до её конца.
+     *       Рассчитанные диапазоны кэшируются для позиций прокрутки и сбрасываются только при
+     *       изменении компоновки документа, либо размеров области просмотра
+     */
+    QPair<QTextBlock, QTextBlock> visibleBlocksRange(
+        const QVector<BusinessLayer::TextParagraphType>& _headingTypes) const;
+
 private:
     class Implementation;
     QScopedPointer<Implementation> d;
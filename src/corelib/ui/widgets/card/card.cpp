@@ -125,29 +125,14 @@ void Card::paintEvent(QPaintEvent* _event)
     }
 
     //
-    // Заливаем фон
-    //
-    QPixmap backgroundImage(backgroundRect.size().toSize());
-    backgroundImage.fill(Qt::transparent);
-    QPainter backgroundImagePainter(&backgroundImage);
-    backgroundImagePainter.setPen(Qt::NoPen);
-    backgroundImagePainter.setBrush(backgroundColor());
-    const auto borderRadius = Ui::DesignSystem::card().borderRadius();
-    backgroundImagePainter.drawRoundedRect(QRect({ 0, 0 }, backgroundImage.size()), borderRadius,
-                                           borderRadius);
-    //
-    // ... рисуем тень
+    // Рисуем тень
     //
     QPainter painter(this);
-    auto dropShadow = [&painter, backgroundRect, backgroundImage](qreal _radius) {
-        const auto cacheShadow = true;
-        const auto shadow
-            = ImageHelper::dropShadow(backgroundImage, Ui::DesignSystem::card().shadowMargins(),
-                                      _radius, Ui::DesignSystem::color().shadow(), cacheShadow);
-        painter.drawPixmap(
-            backgroundRect.marginsAdded(Ui::DesignSystem::card().shadowMargins().toMargins())
-                .topLeft(),
-            shadow);
+    const auto borderRadius = Ui::DesignSystem::card().borderRadius();
+    auto dropShadow = [&painter, backgroundRect, borderRadius](qreal _radius) {
+        ImageHelper::drawRoundedRectShadow(painter, backgroundRect, borderRadius,
+                                           Ui::DesignSystem::card().shadowMargins(), _radius,
+                                           Ui::DesignSystem::color().shadow());
     };
     if (d->shadowOpacityAnimation.currentValue().isValid()) {
         const auto shadowOpacity = d->shadowOpacityAnimation.currentValue().toReal();
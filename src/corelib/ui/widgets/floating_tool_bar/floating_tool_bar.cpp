@@ -376,31 +376,39 @@ void FloatingToolBar::paintEvent(QPaintEvent* _event)
     }
 
     //
-    // Заливаем фон
+    // Рисуем тень
     //
-    QPixmap backgroundImage(backgroundRect.size());
-    backgroundImage.fill(Qt::transparent);
-    QPainter backgroundImagePainter(&backgroundImage);
-    backgroundImagePainter.setPen(Qt::NoPen);
-    backgroundImagePainter.setBrush(backgroundColor());
     const qreal radius = Ui::DesignSystem::floatingToolBar().height() / 2.0;
-    {
+    const qreal shadowBlurRadius
+        = std::max(Ui::DesignSystem::floatingToolBar().minimumShadowBlurRadius(),
+                   d->shadowBlurRadiusAnimation.currentValue().toReal());
+    //
+    // ... у шторки скруглён только низ, поэтому её тень формируем по изображению фона
+    //
+    if (d->isCurtain) {
+        QPixmap backgroundImage(backgroundRect.size());
+        backgroundImage.fill(Qt::transparent);
+        QPainter backgroundImagePainter(&backgroundImage);
+        backgroundImagePainter.setPen(Qt::NoPen);
+        backgroundImagePainter.setBrush(backgroundColor());
         const auto rect = QRect({ 0, 0 }, backgroundImage.size());
         backgroundImagePainter.drawRoundedRect(rect, radius, radius);
-        if (d->isCurtain) {
-            backgroundImagePainter.fillRect(rect.adjusted(0, 0, 0, -radius), backgroundColor());
-        }
+        backgroundImagePainter.fillRect(rect.adjusted(0, 0, 0, -radius), backgroundColor());
+        backgroundImagePainter.end();
+
+        const QPixmap shadow = ImageHelper::dropShadow(
+            backgroundImage, Ui::DesignSystem::floatingToolBar().shadowMargins(),
+            shadowBlurRadius, Ui::DesignSystem::color().shadow());
+        painter.drawPixmap(0, 0, shadow);
     }
     //
-    // ... рисуем тень
+    // ... а для остальных случаев собираем из фрагментов
     //
-    const qreal shadowBlurRadius
-        = std::max(Ui::DesignSystem::floatingToolBar().minimumShadowBlurRadius(),
-                   d->shadowBlurRadiusAnimation.currentValue().toReal());
-    const QPixmap shadow = ImageHelper::dropShadow(
-        backgroundImage, Ui::DesignSystem::floatingToolBar().shadowMargins(), shadowBlurRadius,
-        Ui::DesignSystem::color().shadow());
-    painter.drawPixmap(0, 0, shadow);
+    else {
+        ImageHelper::drawRoundedRectShadow(painter, backgroundRect, radius,
+                                           Ui::DesignSystem::floatingToolBar().shadowMargins(),
+                                           shadowBlurRadius, Ui::DesignSystem::color().shadow());
+    }
     //
     // ... рисуем сам фон
     //
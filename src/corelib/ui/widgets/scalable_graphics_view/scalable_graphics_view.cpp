@@ -165,6 +165,11 @@ QImage ScalableGraphicsView::saveSceneToPng(qreal _scaleFactor)
     return image;
 }
 
+bool ScalableGraphicsView::isScrolling() const
+{
+    return m_inScrolling;
+}
+
 bool ScalableGraphicsView::event(QEvent* _event)
 {
     //
@@ -63,6 +63,11 @@ signals:
     void deletePressed();
 
 protected:
+    /**
+     * @brief Происходит ли в данный момент прокрутка полотна
+     */
+    bool isScrolling() const;
+
     /**
      * @brief Переопределяем для обработки жестов
      */
@@ -1765,8 +1765,18 @@ QList<Patch> diff_match_patch::patch_deepCopy(QList<Patch>& patches)
 
 QPair<QString, QVector<bool>> diff_match_patch::patch_apply(QList<Patch>& patches,
                                                             const QString& sourceText)
+{
+    QVector<bool> exactMatches;
+    return patch_apply(patches, sourceText, exactMatches);
+}
+
+
+QPair<QString, QVector<bool>> diff_match_patch::patch_apply(QList<Patch>& patches,
+                                                            const QString& sourceText,
+                                                            QVector<bool>& exactMatches)
 {
     QString text = sourceText; // Copy to preserve original.
+    exactMatches.clear();
     if (patches.isEmpty()) {
         return QPair<QString, QVector<bool>>(text, QVector<bool>(0));
     }
@@ -1785,6 +1795,7 @@ QPair<QString, QVector<bool>> diff_match_patch::patch_apply(QList<Patch>& patche
     // has an effective expected position of 22.
     int delta = 0;
     QVector<bool> results(patchesCopy.size());
+    exactMatches.fill(false, patchesCopy.size());
     foreach (Patch aPatch, patchesCopy) {
         int expected_loc = aPatch.start2 + delta;
         QString text1 = diff_text1(aPatch.diffs);
@@ -1822,6 +1833,7 @@ QPair<QString, QVector<bool>> diff_match_patch::patch_apply(QList<Patch>& patche
             }
             if (text1 == text2) {
                 // Perfect match, just shove the replacement text in.
+                exactMatches[x] = start_loc == expected_loc;
                 text = text.left(start_loc) + diff_text2(aPatch.diffs)
                     + safeMid(text, start_loc + text1.length());
             } else {
@@ -571,6 +571,20 @@ public:
 public:
     QPair<QString, QVector<bool>> patch_apply(QList<Patch>& patches, const QString& text);
 
+    /**
+     * Merge a set of patches onto the text, same as above, but also report
+     * which of the applied patches matched their context exactly at the
+     * expected location (as opposed to a fuzzy match found nearby).
+     * @param patches Array of patch objects.
+     * @param text Old text.
+     * @param exactMatches Array of boolean values, filled in for each patch.
+     * @return Two element Object array, containing the new text and an array of
+     *      boolean values.
+     */
+public:
+    QPair<QString, QVector<bool>> patch_apply(QList<Patch>& patches, const QString& text,
+                                              QVector<bool>& exactMatches);
+
     /**
      * Add some padding on text start and end so that edges can match something.
      * Intended to be called only from within patch_apply.
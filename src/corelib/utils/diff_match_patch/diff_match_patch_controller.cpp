@@ -1,34 +1,20 @@
 #include "diff_match_patch_controller.h"
 
 #include "diff_match_patch.h"
+#include "myers_diff.h"
 
+#include <QCryptographicHash>
 
-namespace {
+#include <algorithm>
 
-/**
- * @brief Является ли строка тэгом
- */
-static bool isTag(const QString& _tag)
-{
-    return !_tag.isEmpty() && _tag.startsWith(QLatin1String("<"))
-        && _tag.endsWith(QLatin1String(">"));
-}
 
-/**
- * @brief Является ли тэг открывающим
- */
-static bool isOpenTag(const QString& _tag)
-{
-    return isTag(_tag) && !_tag.contains(QLatin1String("/"));
-}
+namespace {
 
 /**
- * @brief Является ли тэг закрывающим
+ * @brief Первый символ зарезервированной секции кодов юникода U+E000–U+F8FF, из которой берутся
+ *        служебные символы для тэгов
  */
-static bool isCloseTag(const QString& _tag)
-{
-    return isTag(_tag) && _tag.contains(QLatin1String("/"));
-}
+constexpr ushort kFirstTagCharacter = 0xE000;
 
 } // namespace
 
@@ -38,15 +24,51 @@ class DiffMatchPatchController::Implementation
 public:
     explicit Implementation(const QVector<QString>& _tags);
 
+    /**
+     * @brief Позиция служебного символа в плоском тексте и суммарная разница длин xml и
+     *        плоского текста с учётом всех служебных символов до неё включительно
+     */
+    struct TagOffset {
+        int plainPosition = 0;
+        int xmlShift = 0;
+    };
+
     /**
      * @brief Преобразовать xml в плоский текст, заменяя тэги спецсимволами
+     * @param _tagsOffsets Индекс для перевода позиций плоского текста в позиции исходного xml,
+     *        заполняется, если задан
      */
-    QString xmlToPlain(const QString& _xml);
+    QString xmlToPlain(const QString& _xml, QVector<TagOffset>* _tagsOffsets = nullptr) const;
 
     /**
      * @brief Преобразовать плоский текст в xml, заменяя спецсимволы на тэги
      */
-    QString plainToXml(const QString& _plain);
+    QString plainToXml(const QString& _plain) const;
+
+    /**
+     * @brief Тэг, которому соответствует служебный символ
+     */
+    struct Tag {
+        QString xml;
+        bool isOpen = false;
+    };
+
+    /**
+     * @brief Получить тэг по служебному символу, или nullptr, если символ не служебный
+     */
+    const Tag* tag(QChar _character) const;
+
+    /**
+     * @brief Определить позицию в xml, соответствующую позиции в плоском тексте
+     */
+    static int xmlPosition(const QVector<TagOffset>& _tagsOffsets, int _plainPosition);
+
+    /**
+     * @brief Сформировать список патчей между двумя простыми текстами
+     * @note Используется детерминированное сравнение, поэтому для одних и тех же текстов
+     *       патч всегда одинаковый, вне зависимости от загруженности компьютера
+     */
+    QList<Patch> makePatches(const QString& _plain1, const QString& _plain2);
 
     /**
      * @brief Сформировать патч между двумя простыми текстами
@@ -61,61 +83,182 @@ public:
     /**
      * @brief Применить патч для простого текста
      */
-    QString applyPatchPlain(const QString& _plain, const QString& _patch);
+    QString applyPatchPlain(const QString& _plain, const QString& _patch,
+                            QVector<HunkStatus>* _hunks = nullptr);
 
     /**
      * @brief Применить патч для xml-текста
      */
-    QString applyPatchXml(const QString& _xml, const QString& _patch);
+    QString applyPatchXml(const QString& _xml, const QString& _patch,
+                          QVector<HunkStatus>* _hunks = nullptr);
+
+
+    /**
+     * @brief Тэги по служебным символам, индекс - смещение кода символа от kFirstTagCharacter
+     */
+    QVector<Tag> characterTags;
+
+    /**
+     * @brief Служебные символы по тэгам, ключи ссылаются на строки из characterTags
+     */
+    QHash<QStringView, QChar> tagsCharacters;
 
+    /**
+     * @brief Длина самого длинного тэга
+     */
+    int maximumTagLength = 0;
 
-    QHash<QString, QChar> tagsMap;
+    /**
+     * @brief Символы, которыми заканчиваются абзацы плоского текста (переносы строк и
+     *        закрывающие тэги)
+     */
+    QSet<QChar> paragraphSeparators = { '\n' };
+
+    /**
+     * @brief Строить ли патчи детерминированным сравнением
+     */
+    bool isDeterministicDiff = true;
 };
 
 DiffMatchPatchController::Implementation::Implementation(const QVector<QString>& _tags)
 {
     //
     // Используем зарезервированную секцию кодов юникода U+E000–U+F8FF,
-    // для генерации служебных символов для карты тэгов
+    // для генерации служебных символов для карты тэгов, открывающему тэгу соответствует
+    // чётное смещение от начала секции, а закрывающему - нечётное
     //
-    uint characterIndex = 0xE000;
-    auto nextCharacter = [&characterIndex] { return QChar(characterIndex++); };
+    characterTags.reserve(_tags.size() * 2);
+    for (const auto& tag : _tags) {
+        characterTags.append({ "<" + tag + ">", true });
+        characterTags.append({ "</" + tag + ">", false });
+    }
 
     //
-    // Добавить заданный тэг в карту служебных символов
+    // Строим обратную карту после заполнения списка тэгов, т.к. её ключи ссылаются на его строки
     //
-    auto addTag = [this, nextCharacter](const QString& _tag) {
-        tagsMap.insert("<" + _tag + ">", nextCharacter());
-        tagsMap.insert("</" + _tag + ">", nextCharacter());
-    };
-    for (const auto& tag : _tags) {
-        addTag(tag);
+    tagsCharacters.reserve(characterTags.size());
+    for (int index = 0; index < characterTags.size(); ++index) {
+        const auto& tagXml = characterTags.at(index).xml;
+        const QChar character(kFirstTagCharacter + index);
+        tagsCharacters.insert(tagXml, character);
+        if (!characterTags.at(index).isOpen) {
+            paragraphSeparators.insert(character);
+        }
+        maximumTagLength = std::max(maximumTagLength, static_cast<int>(tagXml.length()));
     }
 }
 
-QString DiffMatchPatchController::Implementation::xmlToPlain(const QString& _xml)
+QString DiffMatchPatchController::Implementation::xmlToPlain(
+    const QString& _xml, QVector<TagOffset>* _tagsOffsets) const
 {
-    QString plain = _xml;
-    for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
-        plain.replace(iter.key(), iter.value());
+    if (_tagsOffsets != nullptr) {
+        _tagsOffsets->clear();
     }
+
+    QString plain;
+    plain.reserve(_xml.length());
+    const QStringView xml(_xml);
+    int textStart = 0;
+    for (int position = _xml.indexOf('<'); position != -1;
+         position = _xml.indexOf('<', position + 1)) {
+        //
+        // Внутри тэгов нет угловых скобок, поэтому конец тэга ищем только в пределах длины
+        // самого длинного из них
+        //
+        const int candidateLength
+            = std::min(maximumTagLength, static_cast<int>(xml.size()) - position);
+        const auto candidate = xml.mid(position, candidateLength);
+        const int tagEnd = candidate.indexOf('>');
+        if (tagEnd == -1) {
+            continue;
+        }
+
+        const auto character = tagsCharacters.constFind(candidate.left(tagEnd + 1));
+        if (character == tagsCharacters.constEnd()) {
+            continue;
+        }
+
+        plain.append(_xml.constData() + textStart, position - textStart);
+        plain.append(character.value());
+        if (_tagsOffsets != nullptr) {
+            const int xmlShift = _tagsOffsets->isEmpty() ? 0 : _tagsOffsets->constLast().xmlShift;
+            _tagsOffsets->append({ static_cast<int>(plain.length()) - 1, xmlShift + tagEnd });
+        }
+        position += tagEnd;
+        textStart = position + 1;
+    }
+    plain.append(_xml.constData() + textStart, _xml.length() - textStart);
     return plain;
 }
 
-QString DiffMatchPatchController::Implementation::plainToXml(const QString& _plain)
+QString DiffMatchPatchController::Implementation::plainToXml(const QString& _plain) const
 {
-    QString xml = _plain;
-    for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
-        xml.replace(iter.value(), iter.key());
+    QString xml;
+    xml.reserve(_plain.length() + _plain.length() / 2);
+    int textStart = 0;
+    for (int position = 0; position < _plain.length(); ++position) {
+        const auto characterTag = tag(_plain.at(position));
+        if (characterTag == nullptr) {
+            continue;
+        }
+
+        xml.append(_plain.constData() + textStart, position - textStart);
+        xml.append(characterTag->xml);
+        textStart = position + 1;
     }
+    xml.append(_plain.constData() + textStart, _plain.length() - textStart);
     return xml;
 }
 
+const DiffMatchPatchController::Implementation::Tag* DiffMatchPatchController::Implementation::tag(
+    QChar _character) const
+{
+    const int index = _character.unicode() - kFirstTagCharacter;
+    if (index < 0 || index >= characterTags.size()) {
+        return nullptr;
+    }
+
+    return &characterTags.at(index);
+}
+
+int DiffMatchPatchController::Implementation::xmlPosition(const QVector<TagOffset>& _tagsOffsets,
+                                                          int _plainPosition)
+{
+    //
+    // Находим последний служебный символ перед заданной позицией и добавляем к ней разницу длин,
+    // накопленную до него включительно
+    //
+    const auto nextTag = std::lower_bound(
+        _tagsOffsets.begin(), _tagsOffsets.end(), _plainPosition,
+        [](const TagOffset& _offset, int _position) { return _offset.plainPosition < _position; });
+    if (nextTag == _tagsOffsets.begin()) {
+        return _plainPosition;
+    }
+
+    return _plainPosition + std::prev(nextTag)->xmlShift;
+}
+
+QList<Patch> DiffMatchPatchController::Implementation::makePatches(const QString& _plain1,
+                                                                   const QString& _plain2)
+{
+    diff_match_patch dmp;
+    if (!isDeterministicDiff) {
+        return dmp.patch_make(_plain1, _plain2);
+    }
+
+    auto diffs = MyersDiff::diff(_plain1, _plain2, paragraphSeparators);
+    if (diffs.size() > 2) {
+        dmp.diff_cleanupSemantic(diffs);
+        dmp.diff_cleanupEfficiency(diffs);
+    }
+    return dmp.patch_make(_plain1, diffs);
+}
+
 QString DiffMatchPatchController::Implementation::makePatchPlain(const QString& _plain1,
                                                                  const QString& _plain2)
 {
     diff_match_patch dmp;
-    return dmp.patch_toText(dmp.patch_make(_plain1, _plain2));
+    return dmp.patch_toText(makePatches(_plain1, _plain2));
 }
 
 QString DiffMatchPatchController::Implementation::makePatchXml(const QString& _xml1,
@@ -125,17 +268,56 @@ QString DiffMatchPatchController::Implementation::makePatchXml(const QString& _x
 }
 
 QString DiffMatchPatchController::Implementation::applyPatchPlain(const QString& _plain,
-                                                                  const QString& _patch)
+                                                                  const QString& _patch,
+                                                                  QVector<HunkStatus>* _hunks)
 {
     diff_match_patch dmp;
     QList<Patch> patches = dmp.patch_fromText(_patch);
-    return dmp.patch_apply(patches, _plain).first;
+    if (_hunks == nullptr) {
+        return dmp.patch_apply(patches, _plain).first;
+    }
+
+    QVector<bool> exactMatches;
+    const auto result = dmp.patch_apply(patches, _plain, exactMatches);
+    _hunks->clear();
+    _hunks->reserve(result.second.size());
+    for (int index = 0; index < result.second.size(); ++index) {
+        if (!result.second.at(index)) {
+            _hunks->append(HunkStatus::Failed);
+        } else if (exactMatches.at(index)) {
+            _hunks->append(HunkStatus::Exact);
+        } else {
+            _hunks->append(HunkStatus::Fuzzy);
+        }
+    }
+    return result.first;
 }
 
 QString DiffMatchPatchController::Implementation::applyPatchXml(const QString& _xml,
-                                                                const QString& _patch)
+                                                                const QString& _patch,
+                                                                QVector<HunkStatus>* _hunks)
 {
-    return plainToXml(applyPatchPlain(xmlToPlain(_xml), xmlToPlain(_patch)));
+    return plainToXml(applyPatchPlain(xmlToPlain(_xml), xmlToPlain(_patch), _hunks));
+}
+
+
+// ****
+
+
+bool DiffMatchPatchController::PatchResult::isApplied() const
+{
+    return !hunks.contains(HunkStatus::Failed);
+}
+
+bool DiffMatchPatchController::PatchResult::isExact() const
+{
+    return std::all_of(hunks.begin(), hunks.end(),
+                       [](HunkStatus _status) { return _status == HunkStatus::Exact; });
+}
+
+bool DiffMatchPatchController::PatchResult::isValid() const
+{
+    return isApplied() && isHashMatched;
 }
 
 
@@ -149,6 +331,11 @@ DiffMatchPatchController::DiffMatchPatchController(const QVector<QString>& _tags
 
 DiffMatchPatchController::~DiffMatchPatchController() = default;
 
+void DiffMatchPatchController::setDeterministicDiff(bool _isDeterministic)
+{
+    d->isDeterministicDiff = _isDeterministic;
+}
+
 QByteArray DiffMatchPatchController::makePatch(const QString& _lhs, const QString& _rhs) const
 {
     return d->makePatchXml(_lhs, _rhs).toUtf8();
@@ -160,31 +347,43 @@ QByteArray DiffMatchPatchController::applyPatch(const QByteArray& _content,
     return d->applyPatchXml(_content, _patch).toUtf8();
 }
 
+DiffMatchPatchController::PatchResult DiffMatchPatchController::applyPatchVerified(
+    const QByteArray& _content, const QByteArray& _patch, const QByteArray& _expectedHash) const
+{
+    PatchResult result;
+    result.content = d->applyPatchXml(_content, _patch, &result.hunks).toUtf8();
+    if (!_expectedHash.isEmpty()) {
+        result.isHashMatched = contentHash(result.content) == _expectedHash;
+    }
+    return result;
+}
+
+QByteArray DiffMatchPatchController::contentHash(const QByteArray& _content)
+{
+    return QCryptographicHash::hash(_content, QCryptographicHash::Sha1);
+}
+
 QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMatchPatchController::
     changedXml(const QString& _xml, const QString& _patch) const
 {
     //
     // Применим патчи
     //
-    const QString oldXmlPlain = d->xmlToPlain(_xml);
-    const QString newXml = d->applyPatchXml(_xml, _patch);
-    const QString newXmlPlain = d->xmlToPlain(newXml);
+    QVector<Implementation::TagOffset> oldTagsOffsets;
+    const QString oldXmlPlain = d->xmlToPlain(_xml, &oldTagsOffsets);
+    QVector<Implementation::TagOffset> newTagsOffsets;
+    const QString newXmlPlain
+        = d->xmlToPlain(d->applyPatchXml(_xml, _patch), &newTagsOffsets);
 
     //
     // Формируем новый патч, он будет содержать корректные данные,
     // для текста сценария текущего пользователя
     //
-    const QString newPatch = makePatch(oldXmlPlain, newXmlPlain);
-    if (newPatch.isEmpty()) {
+    const QList<Patch> patches = d->makePatches(oldXmlPlain, newXmlPlain);
+    if (patches.isEmpty()) {
         return {};
     }
 
-    //
-    // Разберём патчи на список
-    //
-    diff_match_patch dmp;
-    const QList<Patch> patches = dmp.patch_fromText(newPatch);
-
     //
     // Рассчитаем метрики для формирования xml для обновления
     //
@@ -226,69 +425,47 @@ QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMa
     oldEndPos -= 1;
     newEndPos -= 1;
 
-
     //
-    // Определим кусок xml из текущего документа для обновления
+    // Определить кусок xml для обновления, расширив изменённую область до открывающего тэга
+    // в начале и до закрывающего тэга в конце
     //
-    int oldStartPosForXmlPlain = oldStartPos;
-    for (; oldStartPosForXmlPlain > 0; --oldStartPosForXmlPlain) {
-        //
-        // Идём до открывающего тега
-        //
-        if (isOpenTag(d->tagsMap.key(oldXmlPlain.at(oldStartPosForXmlPlain)))) {
-            break;
-        }
-    }
-    int oldEndPosForXml = oldEndPos;
-    for (; oldEndPosForXml < oldXmlPlain.length(); ++oldEndPosForXml) {
-        //
-        // Идём до закрывающего тэга, он находится в конце строки
-        //
-        if (isCloseTag(d->tagsMap.key(oldXmlPlain.at(oldEndPosForXml)))) {
-            ++oldEndPosForXml;
-            break;
-        }
-    }
-    const QString oldXmlForUpdate
-        = oldXmlPlain.mid(oldStartPosForXmlPlain, oldEndPosForXml - oldStartPosForXmlPlain);
-
-
-    //
-    // Определим кусок из нового документа для обновления
-    //
-    int newStartPosForXmlPlain = newStartPos;
-    for (; newStartPosForXmlPlain > 0; --newStartPosForXmlPlain) {
-        //
-        // Идём до открывающего тега
-        //
-        if (isOpenTag(d->tagsMap.key(newXmlPlain.at(newStartPosForXmlPlain)))) {
-            break;
+    auto changeForUpdate = [this](const QString& _xmlPlain,
+                                  const QVector<Implementation::TagOffset>& _tagsOffsets,
+                                  int _startPos, int _endPos) {
+        int startPosForXmlPlain = _startPos;
+        for (; startPosForXmlPlain > 0; --startPosForXmlPlain) {
+            //
+            // Идём до открывающего тега
+            //
+            const auto tag = d->tag(_xmlPlain.at(startPosForXmlPlain));
+            if (tag != nullptr && tag->isOpen) {
+                break;
+            }
         }
-    }
-    int newEndPosForXml = newEndPos;
-    for (; newEndPosForXml < newXmlPlain.length(); ++newEndPosForXml) {
-        //
-        // Идём до закрывающего тэга, он находится в конце строки
-        //
-        if (isCloseTag(d->tagsMap.key(newXmlPlain.at(newEndPosForXml)))) {
-            ++newEndPosForXml;
-            break;
+        int endPosForXml = _endPos;
+        for (; endPosForXml < _xmlPlain.length(); ++endPosForXml) {
+            //
+            // Идём до закрывающего тэга, он находится в конце строки
+            //
+            const auto tag = d->tag(_xmlPlain.at(endPosForXml));
+            if (tag != nullptr && !tag->isOpen) {
+                ++endPosForXml;
+                break;
+            }
         }
-    }
-    const QString newXmlForUpdate
-        = newXmlPlain.mid(newStartPosForXmlPlain, newEndPosForXml - newStartPosForXmlPlain);
-
+        const QString xmlForUpdate
+            = _xmlPlain.mid(startPosForXmlPlain, endPosForXml - startPosForXmlPlain);
+        return Change{ d->plainToXml(xmlForUpdate).toUtf8(),
+                       d->xmlPosition(_tagsOffsets, startPosForXmlPlain) };
+    };
 
-    return { { d->plainToXml(oldXmlForUpdate).toUtf8(),
-               d->plainToXml(oldXmlPlain.left(oldStartPosForXmlPlain)).length() },
-             { d->plainToXml(newXmlForUpdate).toUtf8(),
-               d->plainToXml(newXmlPlain.left(newStartPosForXmlPlain)).length() } };
+    return { changeForUpdate(oldXmlPlain, oldTagsOffsets, oldStartPos, oldEndPos),
+             changeForUpdate(newXmlPlain, newTagsOffsets, newStartPos, newEndPos) };
 }
 
 int DiffMatchPatchController::changeEndPosition(const QString& _before, const QString& _after) const
 {
-    diff_match_patch dmp;
-    const auto patches = dmp.patch_make(_before, _after);
+    const auto patches = d->makePatches(_before, _after);
     if (patches.isEmpty()) {
         return _after.length();
     }
@@ -2,6 +2,9 @@
 
 #include <QScopedPointer>
 #include <QString>
+#include <QVector>
+
+#include <corelib_global.h>
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
 template<typename, typename>
@@ -12,12 +15,19 @@ struct QPair;
 /**
  * @brief Управляющий классом сравнения данных документов
  */
-class DiffMatchPatchController final
+class CORE_LIBRARY_EXPORT DiffMatchPatchController final
 {
 public:
     explicit DiffMatchPatchController(const QVector<QString>& _tags);
     ~DiffMatchPatchController();
 
+    /**
+     * @brief Задать, строить ли патчи детерминированным сравнением (по умолчанию), либо как
+     *        раньше, методом patch_make из diff_match_patch с ограничением по времени
+     * @note Прежний способ оставлен только для сравнения в замерах производительности
+     */
+    void setDeterministicDiff(bool _isDeterministic);
+
     /**
      * @brief Сформировать патч
      */
@@ -28,6 +38,63 @@ public:
      */
     QByteArray applyPatch(const QByteArray& _content, const QByteArray& _patch) const;
 
+    /**
+     * @brief Результат наложения отдельного куска патча
+     */
+    enum class HunkStatus {
+        Exact, // контекст куска найден в ожидаемом месте без изменений
+        Fuzzy, // контекст куска найден неточно или со смещением
+        Failed, // кусок наложить не удалось
+    };
+
+    /**
+     * @brief Результат проверенного наложения патча
+     */
+    struct PatchResult {
+        /**
+         * @brief Содержимое документа после наложения
+         */
+        QByteArray content;
+
+        /**
+         * @brief Статусы наложения кусков патча
+         */
+        QVector<HunkStatus> hunks;
+
+        /**
+         * @brief Совпал ли хэш результата с ожидаемым (если ожидаемый хэш был задан)
+         */
+        bool isHashMatched = true;
+
+        /**
+         * @brief Наложены ли все куски патча
+         */
+        bool isApplied() const;
+
+        /**
+         * @brief Наложены ли все куски патча точно
+         */
+        bool isExact() const;
+
+        /**
+         * @brief Можно ли использовать результат наложения
+         */
+        bool isValid() const;
+    };
+
+    /**
+     * @brief Применить патч с проверкой результата наложения каждого куска
+     * @param _expectedHash Хэш содержимого, которое должно получиться после наложения, если
+     *        патч накладывается на тот же документ, для которого он был сформирован
+     */
+    PatchResult applyPatchVerified(const QByteArray& _content, const QByteArray& _patch,
+                                   const QByteArray& _expectedHash = {}) const;
+
+    /**
+     * @brief Хэш содержимого документа для проверки результата наложения патчей
+     */
+    static QByteArray contentHash(const QByteArray& _content);
+
     /**
      * @brief Определить куски xml из документов, которые затрагивает данное изменение
      * @return Пара: 1) текст, который был изменён; 2) текст замены
@@ -0,0 +1,387 @@
+#include "myers_diff.h"
+
+#include <QHash>
+#include <QStringView>
+#include <QVector>
+
+#include <algorithm>
+
+
+namespace {
+
+/**
+ * @brief Максимальное количество правок при сравнении по абзацам и по символам, при превышении
+ *        которого сравниваемые куски считаются заменёнными целиком
+ * @note Так время сравнения сильно изменённых кусков ограничивается детерминированно, а не по
+ *       таймеру, как в diff_match_patch
+ */
+constexpr int kMaximumParagraphsDistance = 4096;
+constexpr int kMaximumCharactersDistance = 1024;
+
+/**
+ * @brief Правка последовательности
+ */
+struct Edit {
+    Operation operation = EQUAL;
+    int length = 0;
+};
+
+/**
+ * @brief Сравнение двух последовательностей алгоритмом Майерса с поиском середины пути правок
+ */
+template<typename T>
+class SequenceDiff
+{
+public:
+    SequenceDiff(const T* _lhs, const T* _rhs, int _maximumDistance)
+        : m_lhs(_lhs)
+        , m_rhs(_rhs)
+        , m_maximumDistance(_maximumDistance)
+    {
+    }
+
+    /**
+     * @brief Сравнить участки последовательностей и добавить правки в результат
+     */
+    void compare(int _lhsBegin, int _lhsEnd, int _rhsBegin, int _rhsEnd)
+    {
+        //
+        // Отбрасываем общие начало и конец
+        //
+        int prefix = 0;
+        while (_lhsBegin + prefix < _lhsEnd && _rhsBegin + prefix < _rhsEnd
+               && m_lhs[_lhsBegin + prefix] == m_rhs[_rhsBegin + prefix]) {
+            ++prefix;
+        }
+        append(EQUAL, prefix);
+        _lhsBegin += prefix;
+        _rhsBegin += prefix;
+
+        int suffix = 0;
+        while (_lhsEnd - suffix > _lhsBegin && _rhsEnd - suffix > _rhsBegin
+               && m_lhs[_lhsEnd - suffix - 1] == m_rhs[_rhsEnd - suffix - 1]) {
+            ++suffix;
+        }
+        _lhsEnd -= suffix;
+        _rhsEnd -= suffix;
+
+        //
+        // Сравниваем то, что осталось
+        //
+        if (_lhsBegin == _lhsEnd) {
+            append(INSERT, _rhsEnd - _rhsBegin);
+        } else if (_rhsBegin == _rhsEnd) {
+            append(DELETE, _lhsEnd - _lhsBegin);
+        } else {
+            int lhsMiddle = 0;
+            int rhsMiddle = 0;
+            if (findMiddle(_lhsBegin, _lhsEnd, _rhsBegin, _rhsEnd, lhsMiddle, rhsMiddle)) {
+                compare(_lhsBegin, lhsMiddle, _rhsBegin, rhsMiddle);
+                compare(lhsMiddle, _lhsEnd, rhsMiddle, _rhsEnd);
+            } else {
+                append(DELETE, _lhsEnd - _lhsBegin);
+                append(INSERT, _rhsEnd - _rhsBegin);
+            }
+        }
+
+        append(EQUAL, suffix);
+    }
+
+    /**
+     * @brief Список правок в порядке следования
+     */
+    const QVector<Edit>& edits() const
+    {
+        return m_edits;
+    }
+
+private:
+    /**
+     * @brief Добавить правку, объединив её с предыдущей такой же
+     */
+    void append(Operation _operation, int _length)
+    {
+        if (_length == 0) {
+            return;
+        }
+
+        if (!m_edits.isEmpty() && m_edits.constLast().operation == _operation) {
+            m_edits.last().length += _length;
+        } else {
+            m_edits.append({ _operation, _length });
+        }
+    }
+
+    /**
+     * @brief Найти точку, через которую проходит кратчайший путь правок, двигаясь одновременно
+     *        с начала и с конца участков
+     * @return false, если путь длиннее максимально допустимого
+     */
+    bool findMiddle(int _lhsBegin, int _lhsEnd, int _rhsBegin, int _rhsEnd, int& _lhsMiddle,
+                    int& _rhsMiddle)
+    {
+        const T* lhs = m_lhs + _lhsBegin;
+        const T* rhs = m_rhs + _rhsBegin;
+        const int lhsLength = _lhsEnd - _lhsBegin;
+        const int rhsLength = _rhsEnd - _rhsBegin;
+        const int maximumDistance
+            = std::min((lhsLength + rhsLength + 1) / 2, m_maximumDistance);
+        const int offset = maximumDistance;
+        const int length = 2 * maximumDistance + 2;
+
+        //
+        // Буферы переиспользуются между вызовами, т.к. после нахождения середины они уже не нужны
+        //
+        m_forward.fill(-1, length);
+        m_reverse.fill(-1, length);
+        int* forward = m_forward.data();
+        int* reverse = m_reverse.data();
+        forward[offset + 1] = 0;
+        reverse[offset + 1] = 0;
+
+        //
+        // Если разница длин нечётная, то пути встретятся при движении с начала, иначе - с конца
+        //
+        const int delta = lhsLength - rhsLength;
+        const bool isFront = delta % 2 != 0;
+        int forwardStart = 0;
+        int forwardEnd = 0;
+        int reverseStart = 0;
+        int reverseEnd = 0;
+        for (int distance = 0; distance < maximumDistance; ++distance) {
+            //
+            // Шаг с начала
+            //
+            for (int k = -distance + forwardStart; k <= distance - forwardEnd; k += 2) {
+                const int kOffset = offset + k;
+                int x = 0;
+                if (k == -distance
+                    || (k != distance && forward[kOffset - 1] < forward[kOffset + 1])) {
+                    x = forward[kOffset + 1];
+                } else {
+                    x = forward[kOffset - 1] + 1;
+                }
+                int y = x - k;
+                while (x < lhsLength && y < rhsLength && lhs[x] == rhs[y]) {
+                    ++x;
+                    ++y;
+                }
+                forward[kOffset] = x;
+                if (x > lhsLength) {
+                    forwardEnd += 2;
+                } else if (y > rhsLength) {
+                    forwardStart += 2;
+                } else if (isFront) {
+                    const int reverseOffset = offset + delta - k;
+                    if (reverseOffset >= 0 && reverseOffset < length
+                        && reverse[reverseOffset] != -1
+                        && x >= lhsLength - reverse[reverseOffset]) {
+                        _lhsMiddle = _lhsBegin + x;
+                        _rhsMiddle = _rhsBegin + y;
+                        return true;
+                    }
+                }
+            }
+
+            //
+            // Шаг с конца
+            //
+            for (int k = -distance + reverseStart; k <= distance - reverseEnd; k += 2) {
+                const int kOffset = offset + k;
+                int x = 0;
+                if (k == -distance
+                    || (k != distance && reverse[kOffset - 1] < reverse[kOffset + 1])) {
+                    x = reverse[kOffset + 1];
+                } else {
+                    x = reverse[kOffset - 1] + 1;
+                }
+                int y = x - k;
+                while (x < lhsLength && y < rhsLength
+                       && lhs[lhsLength - x - 1] == rhs[rhsLength - y - 1]) {
+                    ++x;
+                    ++y;
+                }
+                reverse[kOffset] = x;
+                if (x > lhsLength) {
+                    reverseEnd += 2;
+                } else if (y > rhsLength) {
+                    reverseStart += 2;
+                } else if (!isFront) {
+                    const int forwardOffset = offset + delta - k;
+                    if (forwardOffset >= 0 && forwardOffset < length
+                        && forward[forwardOffset] != -1
+                        && forward[forwardOffset] >= lhsLength - x) {
+                        const int forwardX = forward[forwardOffset];
+                        _lhsMiddle = _lhsBegin + forwardX;
+                        _rhsMiddle = _rhsBegin + forwardX - (delta - k);
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    const T* m_lhs = nullptr;
+    const T* m_rhs = nullptr;
+    const int m_maximumDistance = 0;
+    QVector<Edit> m_edits;
+    QVector<int> m_forward;
+    QVector<int> m_reverse;
+};
+
+} // namespace
+
+
+QList<Diff> MyersDiff::diff(const QString& _text1, const QString& _text2,
+                            const QSet<QChar>& _separators)
+{
+    QList<Diff> diffs;
+    if (_text1 == _text2) {
+        if (!_text1.isEmpty()) {
+            diffs.append(Diff(EQUAL, _text1));
+        }
+        return diffs;
+    }
+
+    //
+    // Отбрасываем общие начало и конец текстов
+    //
+    const int length1 = _text1.length();
+    const int length2 = _text2.length();
+    const int minimumLength = std::min(length1, length2);
+    int prefix = 0;
+    while (prefix < minimumLength && _text1.at(prefix) == _text2.at(prefix)) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < minimumLength - prefix
+           && _text1.at(length1 - suffix - 1) == _text2.at(length2 - suffix - 1)) {
+        ++suffix;
+    }
+    if (prefix > 0) {
+        diffs.append(Diff(EQUAL, _text1.left(prefix)));
+    }
+
+    //
+    // Разбиваем оставшиеся части на абзацы и заменяем одинаковые абзацы одинаковыми номерами
+    //
+    QHash<QStringView, int> paragraphsIds;
+    auto splitParagraphs = [&_separators, &paragraphsIds](const QString& _text, int _begin,
+                                                          int _end, QVector<int>& _ids,
+                                                          QVector<int>& _bounds) {
+        _bounds.append(_begin);
+        for (int position = _begin; position < _end; ++position) {
+            if (!_separators.contains(_text.at(position)) && position + 1 != _end) {
+                continue;
+            }
+
+            const auto paragraph
+                = QStringView(_text).mid(_bounds.constLast(), position + 1 - _bounds.constLast());
+            auto paragraphId = paragraphsIds.find(paragraph);
+            if (paragraphId == paragraphsIds.end()) {
+                paragraphId
+                    = paragraphsIds.insert(paragraph, static_cast<int>(paragraphsIds.size()));
+            }
+            _ids.append(paragraphId.value());
+            _bounds.append(position + 1);
+        }
+    };
+    QVector<int> ids1;
+    QVector<int> bounds1;
+    splitParagraphs(_text1, prefix, length1 - suffix, ids1, bounds1);
+    QVector<int> ids2;
+    QVector<int> bounds2;
+    splitParagraphs(_text2, prefix, length2 - suffix, ids2, bounds2);
+
+    //
+    // Сравниваем тексты по абзацам
+    //
+    SequenceDiff<int> paragraphsDiff(ids1.constData(), ids2.constData(),
+                                     kMaximumParagraphsDistance);
+    paragraphsDiff.compare(0, static_cast<int>(ids1.size()), 0, static_cast<int>(ids2.size()));
+
+    //
+    // ... а изменившиеся абзацы, идущие подряд, сравниваем посимвольно
+    //
+    int paragraph1 = 0;
+    int paragraph2 = 0;
+    int changedParagraph1 = 0;
+    int changedParagraph2 = 0;
+    auto compareChangedParagraphs = [&] {
+        const int begin1 = bounds1.at(changedParagraph1);
+        const int end1 = bounds1.at(paragraph1);
+        const int begin2 = bounds2.at(changedParagraph2);
+        const int end2 = bounds2.at(paragraph2);
+        changedParagraph1 = paragraph1;
+        changedParagraph2 = paragraph2;
+        if (begin1 == end1 && begin2 == end2) {
+            return;
+        }
+
+        SequenceDiff<QChar> charactersDiff(_text1.constData(), _text2.constData(),
+                                           kMaximumCharactersDistance);
+        charactersDiff.compare(begin1, end1, begin2, end2);
+        int position1 = begin1;
+        int position2 = begin2;
+        for (const auto& edit : charactersDiff.edits()) {
+            switch (edit.operation) {
+            case EQUAL: {
+                diffs.append(Diff(EQUAL, _text1.mid(position1, edit.length)));
+                position1 += edit.length;
+                position2 += edit.length;
+                break;
+            }
+
+            case DELETE: {
+                diffs.append(Diff(DELETE, _text1.mid(position1, edit.length)));
+                position1 += edit.length;
+                break;
+            }
+
+            case INSERT: {
+                diffs.append(Diff(INSERT, _text2.mid(position2, edit.length)));
+                position2 += edit.length;
+                break;
+            }
+            }
+        }
+    };
+    for (const auto& edit : paragraphsDiff.edits()) {
+        switch (edit.operation) {
+        case EQUAL: {
+            compareChangedParagraphs();
+            const int begin = bounds1.at(paragraph1);
+            paragraph1 += edit.length;
+            paragraph2 += edit.length;
+            diffs.append(Diff(EQUAL, _text1.mid(begin, bounds1.at(paragraph1) - begin)));
+            changedParagraph1 = paragraph1;
+            changedParagraph2 = paragraph2;
+            break;
+        }
+
+        case DELETE: {
+            paragraph1 += edit.length;
+            break;
+        }
+
+        case INSERT: {
+            paragraph2 += edit.length;
+            break;
+        }
+        }
+    }
+    compareChangedParagraphs();
+
+    if (suffix > 0) {
+        diffs.append(Diff(EQUAL, _text1.right(suffix)));
+    }
+
+    //
+    // Объединяем соседние правки одного типа и выносим общие части замен
+    //
+    diff_match_patch().diff_cleanupMerge(diffs);
+
+    return diffs;
+}
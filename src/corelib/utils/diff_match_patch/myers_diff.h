@@ -0,0 +1,26 @@
+#pragma once
+
+#include "diff_match_patch.h"
+
+#include <QSet>
+
+
+/**
+ * @brief Детерминированное сравнение текстов алгоритмом Майерса в линейной памяти
+ *
+ * В отличие от diff_match_patch::diff_main сравнение не ограничено по времени, поэтому для одних
+ * и тех же текстов результат всегда один и тот же. Сначала отбрасываются общие начало и конец
+ * текстов, затем оставшиеся части сравниваются по абзацам, и посимвольно сравниваются только
+ * изменившиеся абзацы, поэтому стоимость сравнения определяется размером изменения, а не
+ * размером документа.
+ */
+class MyersDiff
+{
+public:
+    /**
+     * @brief Сравнить тексты
+     * @param _separators Символы, которыми заканчиваются абзацы текста
+     */
+    static QList<Diff> diff(const QString& _text1, const QString& _text2,
+                            const QSet<QChar>& _separators);
+};
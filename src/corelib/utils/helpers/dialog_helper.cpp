@@ -40,6 +40,12 @@ QString DialogHelper::starcTemplateFilter()
                       ExtensionHelper::starct());
 }
 
+QString DialogHelper::starcBackupFilter()
+{
+    return makeFilter(QApplication::translate("DialogHelper", "Story Architect project backup"),
+                      ExtensionHelper::starcBackup());
+}
+
 QString DialogHelper::kitScenaristFilter()
 {
     return makeFilter(QApplication::translate("DialogHelper", "KIT Scenarist project"),
@@ -116,10 +122,12 @@ QString DialogHelper::filtersForOpenProject()
     QString filters = makeFilter(QApplication::translate("DialogHelper", "All supported files"),
                                  {
                                      ExtensionHelper::starc(),
+                                     ExtensionHelper::starcBackup(),
                                      ExtensionHelper::fountain(),
                                  });
     for (const auto& filter : {
              starcProjectFilter(),
+             starcBackupFilter(),
              fountainFilter(),
          }) {
         filters.append(";;");
@@ -16,6 +16,7 @@ public:
      */
     static QString starcProjectFilter();
     static QString starcTemplateFilter();
+    static QString starcBackupFilter();
     static QString kitScenaristFilter();
     static QString finalDraftFilter();
     static QString finalDraftTemplateFilter();
@@ -13,6 +13,11 @@ QString ExtensionHelper::starct()
     return QLatin1String("starct");
 }
 
+QString ExtensionHelper::starcBackup()
+{
+    return QLatin1String("starc.snapshot");
+}
+
 QString ExtensionHelper::kitScenarist()
 {
     return QLatin1String("kitsp");
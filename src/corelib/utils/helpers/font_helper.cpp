@@ -0,0 +1,171 @@
+#include "font_helper.h"
+
+#include <utils/tracing.h>
+
+#include <QFontDatabase>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+
+namespace {
+
+/**
+ * @brief Семейства шрифтов интерфейса
+ */
+const QVector<QString> kInterfaceFontFamilies = {
+    QLatin1String("Material Design Icons"),
+    QLatin1String("Font Awesome 6 Brands"),
+    QLatin1String("Roboto"),
+    QLatin1String("Noto Sans"),
+};
+
+/**
+ * @brief Семейства шрифтов, по метрикам которых настраиваются размеры страницы и высота строк
+ *        текста, поэтому они должны быть загружены до первого обращения к шаблонам
+ */
+const QVector<QString> kMetricsFontFamilies = {
+    QLatin1String("Courier New"),
+    QLatin1String("Courier Prime"),
+};
+
+/**
+ * @brief Файлы встроенных шрифтов в ресурсах приложения <семейство, файлы>
+ */
+const QHash<QString, QVector<QString>>& fontFamiliesFiles()
+{
+    static const QHash<QString, QVector<QString>> kFontFamiliesFiles = {
+        { QLatin1String("Material Design Icons"),
+          { QLatin1String(":/fonts/materialdesignicons") } },
+        { QLatin1String("Font Awesome 6 Brands"),
+          { QLatin1String(":/fonts/font-awesome-brands") } },
+        { QLatin1String("Roboto"),
+          {
+              QLatin1String(":/fonts/roboto-bold"),
+              QLatin1String(":/fonts/roboto-light"),
+              QLatin1String(":/fonts/roboto-medium"),
+              QLatin1String(":/fonts/roboto-regular"),
+          } },
+        { QLatin1String("Noto Sans"),
+          {
+              QLatin1String(":/fonts/noto-sans"),
+              QLatin1String(":/fonts/noto-sans-light"),
+              QLatin1String(":/fonts/noto-sans-medium"),
+          } },
+        //
+        { QLatin1String("Arial"),
+          {
+              QLatin1String(":/fonts/arial"),
+              QLatin1String(":/fonts/arial-bold"),
+              QLatin1String(":/fonts/arial-italic"),
+              QLatin1String(":/fonts/arial-bold-italic"),
+          } },
+        { QLatin1String("Courier New"),
+          {
+              QLatin1String(":/fonts/courier-new"),
+              QLatin1String(":/fonts/courier-new-bold"),
+              QLatin1String(":/fonts/courier-new-italic"),
+              QLatin1String(":/fonts/courier-new-bold-italic"),
+          } },
+        { QLatin1String("Courier Prime"),
+          {
+              QLatin1String(":/fonts/courier-prime"),
+              QLatin1String(":/fonts/courier-prime-bold"),
+              QLatin1String(":/fonts/courier-prime-italic"),
+              QLatin1String(":/fonts/courier-prime-bold-italic"),
+          } },
+        { QLatin1String("Mallanna"), { QLatin1String(":/fonts/mallanna-regular") } },
+        { QLatin1String("Mukta Malar"),
+          {
+              QLatin1String(":/fonts/muktamalar-bold"),
+              QLatin1String(":/fonts/muktamalar-regular"),
+          } },
+        { QLatin1String("Times New Roman"),
+          {
+              QLatin1String(":/fonts/times-new-roman"),
+              QLatin1String(":/fonts/times-new-roman-bold"),
+              QLatin1String(":/fonts/times-new-roman-italic"),
+              QLatin1String(":/fonts/times-new-roman-bold-italic"),
+          } },
+        //
+        { QLatin1String("Montserrat"),
+          {
+              QLatin1String(":/fonts/montserrat-regular"),
+              QLatin1String(":/fonts/montserrat-bold"),
+              QLatin1String(":/fonts/montserrat-italic"),
+              QLatin1String(":/fonts/montserrat-bold-italic"),
+          } },
+        { QLatin1String("SF Movie Poster"), { QLatin1String(":/fonts/sf-movie-poster") } },
+    };
+    return kFontFamiliesFiles;
+}
+
+/**
+ * @brief Семейства шрифтов, которые уже загружены
+ */
+QSet<QString> s_loadedFontFamilies;
+
+/**
+ * @brief Загрузить шрифты заданного семейства
+ */
+void loadFontFamily(const QString& _fontFamily)
+{
+    if (s_loadedFontFamilies.contains(_fontFamily)) {
+        return;
+    }
+
+    const auto fontFiles = fontFamiliesFiles().value(_fontFamily);
+    if (fontFiles.isEmpty()) {
+        return;
+    }
+
+    for (const auto& fontFile : fontFiles) {
+        QFontDatabase::addApplicationFont(fontFile);
+    }
+    s_loadedFontFamilies.insert(_fontFamily);
+}
+
+} // namespace
+
+
+void FontHelper::loadInterfaceFonts()
+{
+    for (const auto& fontFamily : kInterfaceFontFamilies) {
+        loadFontFamily(fontFamily);
+    }
+    for (const auto& fontFamily : kMetricsFontFamilies) {
+        loadFontFamily(fontFamily);
+    }
+}
+
+void FontHelper::loadFontFamilies(const QSet<QString>& _fontFamilies)
+{
+    for (const auto& fontFamily : _fontFamilies) {
+        loadFontFamily(fontFamily);
+    }
+}
+
+void FontHelper::loadRemainingFonts()
+{
+    //
+    // Регистрировать шрифты можно только в потоке интерфейса, поэтому, чтобы не блокировать его,
+    // загружаем по одному семейству за итерацию цикла событий, планируя загрузку следующего
+    // только после того, как будут обработаны накопившиеся события
+    //
+    for (auto iter = fontFamiliesFiles().begin(); iter != fontFamiliesFiles().end(); ++iter) {
+        if (s_loadedFontFamilies.contains(iter.key())) {
+            continue;
+        }
+
+        QTimer::singleShot(0, [fontFamily = iter.key()] {
+            {
+                TRACE_SCOPE("fonts", "FontHelper::loadRemainingFonts");
+                loadFontFamily(fontFamily);
+            }
+            loadRemainingFonts();
+        });
+        return;
+    }
+}
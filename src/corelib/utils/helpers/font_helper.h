@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QtContainerFwd>
+
+#include <corelib_global.h>
+
+class QString;
+
+
+/**
+ * @brief Вспомогательный класс для работы со встроенными в приложение шрифтами
+ */
+class CORE_LIBRARY_EXPORT FontHelper
+{
+public:
+    /**
+     * @brief Загрузить шрифты, необходимые для отображения интерфейса и расчёта метрик текста
+     */
+    static void loadInterfaceFonts();
+
+    /**
+     * @brief Загрузить шрифты заданных семейств, если они встроены в приложение и ещё не загружены
+     */
+    static void loadFontFamilies(const QSet<QString>& _fontFamilies);
+
+    /**
+     * @brief Загрузить все ещё не загруженные встроенные шрифты
+     * @note Шрифты регистрируются в потоке интерфейса по одному семейству за итерацию цикла
+     *       событий, поэтому метод должен вызываться из потока интерфейса после запуска
+     */
+    static void loadRemainingFonts();
+};
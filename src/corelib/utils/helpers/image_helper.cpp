@@ -362,6 +362,193 @@ QPixmap ImageHelper::dropShadow(const QPixmap& _sourcePixmap, const QMarginsF& _
     return shadowedPixmap;
 }
 
+namespace {
+
+/**
+ * @brief Шаг, с которым квантуется радиус размытия тени
+ */
+const qreal kShadowBlurRadiusStep = 2.0;
+
+/**
+ * @brief Ключ закешированной тени скруглённого прямоугольника
+ * @note Дробные параметры храним в сотых долях пикселя
+ */
+struct ShadowKey {
+    int width = 0;
+    int height = 0;
+    int blurRadius = 0;
+    QRgb color = 0;
+    int borderRadius = 0;
+    int marginLeft = 0;
+    int marginTop = 0;
+    int marginRight = 0;
+    int marginBottom = 0;
+
+    ShadowKey(const QSize& _size, qreal _blurRadius, const QColor& _color, qreal _borderRadius,
+              const QMarginsF& _margins)
+        : width(_size.width())
+        , height(_size.height())
+        , blurRadius(qCeil(_blurRadius * 100.0))
+        , color(_color.rgba())
+        , borderRadius(qCeil(_borderRadius * 100.0))
+        , marginLeft(qCeil(_margins.left() * 100.0))
+        , marginTop(qCeil(_margins.top() * 100.0))
+        , marginRight(qCeil(_margins.right() * 100.0))
+        , marginBottom(qCeil(_margins.bottom() * 100.0))
+    {
+    }
+
+    bool operator==(const ShadowKey& _other) const
+    {
+        return width == _other.width && height == _other.height
+            && blurRadius == _other.blurRadius && color == _other.color
+            && borderRadius == _other.borderRadius && marginLeft == _other.marginLeft
+            && marginTop == _other.marginTop && marginRight == _other.marginRight
+            && marginBottom == _other.marginBottom;
+    }
+};
+
+uint qHash(const ShadowKey& _key, uint _seed = 0)
+{
+    //
+    // Все поля ключа целочисленные одного размера, поэтому выравнивания между ними нет
+    //
+    return qHashBits(&_key, sizeof(ShadowKey), _seed);
+}
+
+/**
+ * @brief Нарисовать тень скруглённого прямоугольника с заданным радиусом размытия
+ */
+void drawNinePatchShadow(QPainter& _painter, const QRectF& _rect, qreal _borderRadius,
+                         const QMarginsF& _shadowMargins, qreal _blurRadius, const QColor& _color)
+{
+    const QSize rectSize = _rect.size().toSize();
+    const QSize deltaSize = QSizeF(_shadowMargins.left() + _shadowMargins.right(),
+                                   _shadowMargins.top() + _shadowMargins.bottom())
+                                .toSize();
+    const QPointF shadowTopLeft
+        = _rect.topLeft() - QPointF(_shadowMargins.left(), _shadowMargins.top());
+
+    auto roundedRectImage = [_borderRadius](const QSize& _size) {
+        QPixmap image(_size);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(Qt::black);
+        painter.drawRoundedRect(QRect({ 0, 0 }, _size), _borderRadius, _borderRadius);
+        return image;
+    };
+
+    //
+    // Угол заготовки включает в себя скругление и область, на которую распространяется размытие,
+    // а между углами оставляем по одному пикселю, который и будет растягиваться
+    //
+    const int cornerSize = qCeil(_borderRadius) + qCeil(_blurRadius * 2.0);
+    const int patchSourceSize = cornerSize * 2 + 1;
+
+    //
+    // Тени маленьких прямоугольников и заготовки больших храним в общем кэше, ключ которого
+    // учитывает все параметры, влияющие на форму тени, а не только её размер
+    //
+    static QCache<ShadowKey, QPixmap> s_shadowsCache;
+    auto cachedShadow = [_borderRadius, &_shadowMargins, _blurRadius, &_color,
+                         &roundedRectImage](const QSize& _size) {
+        const ShadowKey shadowKey(_size, _blurRadius, _color, _borderRadius, _shadowMargins);
+        if (auto shadow = s_shadowsCache.object(shadowKey)) {
+            return *shadow;
+        }
+
+        const bool useCache = false;
+        const auto shadow = ImageHelper::dropShadow(roundedRectImage(_size), _shadowMargins,
+                                                    _blurRadius, _color, useCache);
+        s_shadowsCache.insert(shadowKey, new QPixmap(shadow));
+        return shadow;
+    };
+
+    //
+    // Если прямоугольник меньше заготовки, то рисуем тень целиком
+    //
+    if (rectSize.width() < patchSourceSize || rectSize.height() < patchSourceSize) {
+        _painter.drawPixmap(shadowTopLeft, cachedShadow(rectSize));
+        return;
+    }
+
+    //
+    // Берём заготовку из кэша, а если её там нет, то размываем
+    //
+    const QPixmap patch = cachedShadow({ patchSourceSize, patchSourceSize });
+
+    //
+    // Собираем тень: углы рисуем как есть, а стороны и центр растягиваем
+    //
+    const QSize shadowSize = rectSize + deltaSize;
+    const int left = deltaSize.width() / 2 + cornerSize;
+    const int top = deltaSize.height() / 2 + cornerSize;
+    const int targetX[] = { 0, left, shadowSize.width() - (patch.width() - left - 1),
+                            shadowSize.width() };
+    const int targetY[] = { 0, top, shadowSize.height() - (patch.height() - top - 1),
+                            shadowSize.height() };
+    const int sourceX[] = { 0, left, left + 1, patch.width() };
+    const int sourceY[] = { 0, top, top + 1, patch.height() };
+
+    _painter.save();
+    _painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    _painter.translate(shadowTopLeft);
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            const QRect targetRect(targetX[column], targetY[row],
+                                   targetX[column + 1] - targetX[column],
+                                   targetY[row + 1] - targetY[row]);
+            const QRect sourceRect(sourceX[column], sourceY[row],
+                                   sourceX[column + 1] - sourceX[column],
+                                   sourceY[row + 1] - sourceY[row]);
+            _painter.drawPixmap(targetRect, patch, sourceRect);
+        }
+    }
+    _painter.restore();
+}
+
+} // namespace
+
+void ImageHelper::drawRoundedRectShadow(QPainter& _painter, const QRectF& _rect,
+                                        qreal _borderRadius, const QMarginsF& _shadowMargins,
+                                        qreal _blurRadius, const QColor& _color)
+{
+    if (_rect.isEmpty()) {
+        return;
+    }
+
+    //
+    // Маленькие радиусы не квантуем
+    //
+    if (_blurRadius <= kShadowBlurRadiusStep) {
+        drawNinePatchShadow(_painter, _rect, _borderRadius, _shadowMargins, _blurRadius, _color);
+        return;
+    }
+
+    //
+    // Промежуточный радиус получаем смешиванием теней двух соседних радиусов, чтобы при анимации
+    // не размывать новую тень в каждом кадре
+    //
+    const qreal lowerBlurRadius
+        = std::floor(_blurRadius / kShadowBlurRadiusStep) * kShadowBlurRadiusStep;
+    const qreal upperBlurRadiusWeight = (_blurRadius - lowerBlurRadius) / kShadowBlurRadiusStep;
+    if (qFuzzyIsNull(upperBlurRadiusWeight)) {
+        drawNinePatchShadow(_painter, _rect, _borderRadius, _shadowMargins, lowerBlurRadius,
+                            _color);
+        return;
+    }
+
+    const auto opacity = _painter.opacity();
+    _painter.setOpacity(opacity * (1.0 - upperBlurRadiusWeight));
+    drawNinePatchShadow(_painter, _rect, _borderRadius, _shadowMargins, lowerBlurRadius, _color);
+    _painter.setOpacity(opacity * upperBlurRadiusWeight);
+    drawNinePatchShadow(_painter, _rect, _borderRadius, _shadowMargins,
+                        lowerBlurRadius + kShadowBlurRadiusStep, _color);
+    _painter.setOpacity(opacity);
+}
+
 void ImageHelper::drawRoundedImage(QPainter& _painter, const QRectF& _rect, const QPixmap& _image,
                                    qreal _roundingRadius, int _notRoundedEdge)
 {
@@ -76,6 +76,17 @@ public:
     static QPixmap dropShadow(const QPixmap& _sourcePixmap, const QMarginsF& _shadowMargins,
                               qreal _blurRadius, const QColor& _color, bool _useCache = false);
 
+    /**
+     * @brief Нарисовать тень прямоугольника со скруглёнными углами
+     * @note Тень собирается из девяти фрагментов заготовки, которая размывается единожды для
+     *       каждого сочетания радиуса размытия, цвета и радиуса скругления, поэтому её отрисовка
+     *       не зависит от размера прямоугольника. Радиус размытия квантуется, а промежуточные
+     *       значения (например при анимации) получаются смешиванием двух соседних заготовок
+     */
+    static void drawRoundedRectShadow(QPainter& _painter, const QRectF& _rect, qreal _borderRadius,
+                                      const QMarginsF& _shadowMargins, qreal _blurRadius,
+                                      const QColor& _color);
+
     /**
      * @brief Нарисовать изображение в заданной области со скруглёнными краями
      */
@@ -5,13 +5,21 @@
 #include <QApplication>
 #include <QDebug>
 #include <QFontMetricsF>
-#include <QRegularExpression>
 #include <QScreen>
 #include <QTextBlock>
 #include <QTextDocument>
 #include <QTextLayout>
 #include <QtMath>
 
+//
+// Векторный подсчёт собирается только под SSE2, который есть у всех поддерживаемых x86-64
+// процессоров, варианта под AVX2 и выбора реализации во время выполнения нет
+//
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXT_HELPER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 
 namespace {
 /**
@@ -46,6 +54,24 @@ void testFontsMetrics()
  */
 static QHash<QString, qreal> sFontToLineSpacing;
 
+/**
+ * @brief Значения высоты шрифта из файла самого шрифта, платформы тут могут выдавать разные
+ *        значения (HHead group summary)
+ */
+static const QHash<QString, qreal> kFontsMetricsHeights = {
+    { QLatin1String("Courier New"), 2320.0 },
+    { QLatin1String("Courier Prime"), 2060.0 },
+    { QLatin1String("Courier Screenplay"), 2370.0 },
+    { QLatin1String("Courier Final Draft"), 2318.0 },
+    { QLatin1String("Arial"), 2355.0 },
+    { QLatin1String("Times New Roman"), 2355.0 },
+};
+
+/**
+ * @brief Высота строки шрифта Courier New, по которой отстраиваются остальные шрифты
+ */
+static qreal sCourierNewLineSpacing = 0.0;
+
 /**
  * @brief Настраиваем метрики шрифтов и коэффициент масштабровнаия таким образом,
  *        чтобы текст на всех платформах выглядел одинаково
@@ -56,11 +82,6 @@ static void initFontMetrics()
         return;
     }
 
-    //
-    // Значения высоты шрифта из файла самого шрифта, платформы тут могут выдавать разные значения
-    //
-    constexpr auto courierNewHeight = 2320.0;
-
     //
     // Отстраиваем параметры по Courier New, а все остальные адаптируем исходя из этой настройки
     //
@@ -77,38 +98,36 @@ static void initFontMetrics()
         courierNewLineSpacing = courierNewMetrics.lineSpacing() + courierNewDelta;
     }
     sFontToLineSpacing[courierNewFont.family()] = courierNewDelta;
+    sCourierNewLineSpacing = courierNewLineSpacing;
+}
 
-    //
-    // Остальные дельты высчитываются на основе Courier New
-    //
-    auto addFontDelta = [courierNewHeight, courierNewLineSpacing](const QString& _fontFamily,
-                                                                  int _fontMetricsHeight) {
-        if (!QFontDatabase().hasFamily(_fontFamily)) {
-            return;
-        }
+/**
+ * @brief Высчитать дельту для шрифта на основе Courier New
+ * @note Встроенные шрифты шаблонов загружаются по мере необходимости, поэтому дельта считается
+ *       при первом обращении к уже загруженному шрифту, а не один раз при настройке метрик
+ */
+static void addFontDelta(const QString& _fontFamily)
+{
+    if (sFontToLineSpacing.contains(_fontFamily) || !kFontsMetricsHeights.contains(_fontFamily)
+        || !QFontDatabase().hasFamily(_fontFamily)) {
+        return;
+    }
 
-        QFont font(_fontFamily);
-        font.setPixelSize(MeasurementHelper::ptToPx(12));
-        QFontMetricsF fontMetrics(font);
-        const qreal fontDelta =
-            //
-            // ... такой Line Spacing должен быть у настраимого шрифта
-            //
-            courierNewLineSpacing * (_fontMetricsHeight / courierNewHeight)
-            //
-            // ... вычитая из него Line Spacing из метрики, получим дельту
-            //
-            - fontMetrics.lineSpacing();
-        sFontToLineSpacing[_fontFamily] = fontDelta;
-    };
-    //
-    // ... собственно высчитываем дельту для других шрифтов (HHead group summary)
-    //
-    addFontDelta("Courier Prime", 2060.0);
-    addFontDelta("Courier Screenplay", 2370.0);
-    addFontDelta("Courier Final Draft", 2318.0);
-    addFontDelta("Arial", 2355.0);
-    addFontDelta("Times New Roman", 2355.0);
+    QFont font(_fontFamily);
+    font.setPixelSize(MeasurementHelper::ptToPx(12));
+    QFontMetricsF fontMetrics(font);
+    const qreal fontDelta =
+        //
+        // ... такой Line Spacing должен быть у настраимого шрифта
+        //
+        sCourierNewLineSpacing
+            * (kFontsMetricsHeights.value(_fontFamily)
+               / kFontsMetricsHeights.value(QLatin1String("Courier New")))
+        //
+        // ... вычитая из него Line Spacing из метрики, получим дельту
+        //
+        - fontMetrics.lineSpacing();
+    sFontToLineSpacing[_fontFamily] = fontDelta;
 }
 } // namespace
 
@@ -137,6 +156,7 @@ int TextHelper::fineTextWidth(const QString& _text, const QFont& _font)
 qreal TextHelper::fineLineSpacing(const QFont& _font)
 {
     initFontMetrics();
+    addFontDelta(_font.family());
 
     const QFontMetricsF metrics(_font);
 
@@ -388,15 +408,232 @@ QString TextHelper::toSentenceCase(const QString& _text, bool _capitalizeEveryWo
     return smartToUpper(_text[0]) + smartToLower(_text.mid(1));
 }
 
-int TextHelper::wordsCount(const QString& _text)
+namespace {
+
+/**
+ * @brief Состояние подсчёта счётчиков текста
+ */
+struct CountersState {
+    TextHelper::Counters counters;
+    bool isInsideWord = false;
+    bool isSentenceHasLetters = false;
+};
+
+/**
+ * @brief Является ли символ знаком конца предложения
+ */
+bool isSentenceEnd(uint _ucs4)
+{
+    return _ucs4 == '.' || _ucs4 == '!' || _ucs4 == '?' || _ucs4 == 0x2026;
+}
+
+/**
+ * @brief Является ли символ разделителем слов
+ * @note Набор разделителей тот же, что был у подсчёта слов регулярным выражением
+ *       "[\\s.,!():;]+", поэтому пробелы учитываются только из ASCII, а "?" и "…" слова не
+ *       разделяют
+ */
+bool isWordsSeparator(uint _ucs4)
+{
+    return _ucs4 == ' ' || (_ucs4 >= 0x09 && _ucs4 <= 0x0D) || _ucs4 == '.' || _ucs4 == ','
+        || _ucs4 == '!' || _ucs4 == '(' || _ucs4 == ')' || _ucs4 == ':' || _ucs4 == ';';
+}
+
+/**
+ * @brief Учесть в счётчиках символ, начинающийся в заданной позиции, и сдвинуть позицию за него
+ */
+void countCharacter(const ushort* _text, int _size, int& _position, CountersState& _state)
 {
+    uint ucs4 = _text[_position];
+    if (QChar::isHighSurrogate(ucs4) && _position + 1 < _size
+        && QChar::isLowSurrogate(_text[_position + 1])) {
+        ucs4 = QChar::surrogateToUcs4(_text[_position], _text[_position + 1]);
+        _position += 2;
+    } else {
+        ++_position;
+    }
+
+    ++_state.counters.characters;
+    if (!QChar::isSpace(ucs4)) {
+        ++_state.counters.charactersWithoutSpaces;
+    }
+
+    if (isSentenceEnd(ucs4)) {
+        if (_state.isSentenceHasLetters) {
+            ++_state.counters.sentences;
+            _state.isSentenceHasLetters = false;
+        }
+    } else if (QChar::isLetterOrNumber(ucs4)) {
+        _state.isSentenceHasLetters = true;
+    }
+
     //
-    // FIXME: Сделать более корректный подсчёт
-    //        - слова разделённые знаками препинания без пробелов
-    //        - не учитывать знаки препинания окружённые пробелами, типа " - "
+    // Словом считается любая последовательность символов между разделителями, в том числе и
+    // одиночное тире
     //
-    static QRegularExpression wordCountExpression("[\\s.,!():;]+");
-    return _text.split(wordCountExpression, Qt::SkipEmptyParts).count();
+    if (isWordsSeparator(ucs4)) {
+        _state.isInsideWord = false;
+    } else if (!_state.isInsideWord) {
+        ++_state.counters.words;
+        _state.isInsideWord = true;
+    }
+}
+
+#ifdef TEXT_HELPER_USE_SSE2
+
+/**
+ * @brief Количество символов, обрабатываемых за одну итерацию векторного подсчёта
+ */
+constexpr int kBlockSize = 16;
+
+/**
+ * @brief Маски символов блока текста, где каждый бит соответствует символу в той же позиции
+ */
+struct BlockMasks {
+    int letters = 0;
+    int spaces = 0;
+    int known = 0;
+};
+
+/**
+ * @brief Маска символов, попадающих в диапазон [_from, _to]
+ */
+__m128i inRange(__m128i _characters, ushort _from, ushort _to)
+{
+    const auto shifted = _mm_sub_epi16(_characters, _mm_set1_epi16(static_cast<short>(_from)));
+    const auto overflow
+        = _mm_subs_epu16(shifted, _mm_set1_epi16(static_cast<short>(_to - _from)));
+    return _mm_cmpeq_epi16(overflow, _mm_setzero_si128());
+}
+
+/**
+ * @brief Маска символов, равных заданному
+ */
+__m128i equal(__m128i _characters, ushort _character)
+{
+    return _mm_cmpeq_epi16(_characters, _mm_set1_epi16(static_cast<short>(_character)));
+}
+
+/**
+ * @brief Определить маски для восьми символов
+ */
+void classify(__m128i _characters, __m128i& _letters, __m128i& _spaces, __m128i& _known)
+{
+    //
+    // Буквами считаем только латиницу, цифры и основную кириллицу, всё остальное разбираем
+    // посимвольно
+    //
+    _letters = _mm_or_si128(
+        _mm_or_si128(inRange(_characters, '0', '9'), inRange(_characters, 'A', 'Z')),
+        _mm_or_si128(inRange(_characters, 'a', 'z'), inRange(_characters, 0x0400, 0x0481)));
+    _spaces = _mm_or_si128(equal(_characters, ' '), inRange(_characters, 0x09, 0x0D));
+    //
+    // Знаки конца предложения в известные не включаем, чтобы блоки с ними считались посимвольно
+    //
+    const auto separators = _mm_or_si128(
+        _mm_or_si128(equal(_characters, ','), equal(_characters, ':')),
+        _mm_or_si128(_mm_or_si128(equal(_characters, '('), equal(_characters, ')')),
+                     equal(_characters, ';')));
+    _known = _mm_or_si128(_mm_or_si128(_letters, _spaces), separators);
+}
+
+/**
+ * @brief Определить маски для блока из kBlockSize символов
+ */
+BlockMasks classify(const ushort* _text)
+{
+    const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_text));
+    const auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_text + 8));
+    __m128i firstLetters, firstSpaces, firstKnown;
+    classify(first, firstLetters, firstSpaces, firstKnown);
+    __m128i secondLetters, secondSpaces, secondKnown;
+    classify(second, secondLetters, secondSpaces, secondKnown);
+
+    BlockMasks masks;
+    masks.letters = _mm_movemask_epi8(_mm_packs_epi16(firstLetters, secondLetters));
+    masks.spaces = _mm_movemask_epi8(_mm_packs_epi16(firstSpaces, secondSpaces));
+    masks.known = _mm_movemask_epi8(_mm_packs_epi16(firstKnown, secondKnown));
+    return masks;
+}
+
+/**
+ * @brief Учесть в счётчиках блок, состоящий только из букв, пробелов и разделителей
+ */
+void countBlock(const BlockMasks& _masks, CountersState& _state)
+{
+    //
+    // В таком блоке всё, что не буква, является разделителем слов, поэтому слово начинается на
+    // букве, перед которой нет буквы, при этом слово, начатое в предыдущем блоке, уже засчитано
+    //
+    const auto previousLetters = (_masks.letters << 1) | (_state.isInsideWord ? 1 : 0);
+    const auto wordsStarts = static_cast<quint32>(_masks.letters & ~previousLetters & 0xFFFF);
+
+    _state.counters.words += qPopulationCount(wordsStarts);
+    _state.counters.characters += kBlockSize;
+    _state.counters.charactersWithoutSpaces
+        += kBlockSize - qPopulationCount(static_cast<quint32>(_masks.spaces));
+    if (_masks.letters != 0) {
+        _state.isSentenceHasLetters = true;
+    }
+    _state.isInsideWord = (_masks.letters & (1 << (kBlockSize - 1))) != 0;
+}
+
+#endif
+
+} // namespace
+
+TextHelper::Counters TextHelper::counters(const QString& _text)
+{
+    CountersState state;
+    const auto text = _text.utf16();
+    const auto size = static_cast<int>(_text.size());
+    int position = 0;
+
+#ifdef TEXT_HELPER_USE_SSE2
+    //
+    // Блоки из обычных символов обрабатываем целиком, а в блоках со знаками конца предложения,
+    // суррогатными парами и прочими редкими символами считаем посимвольно
+    //
+    while (position + kBlockSize <= size) {
+        const auto masks = classify(text + position);
+        if (masks.known == 0xFFFF) {
+            countBlock(masks, state);
+            position += kBlockSize;
+            continue;
+        }
+
+        const auto blockEnd = position + kBlockSize;
+        while (position < blockEnd) {
+            countCharacter(text, size, position, state);
+        }
+    }
+#endif
+
+    while (position < size) {
+        countCharacter(text, size, position, state);
+    }
+
+    if (state.isSentenceHasLetters) {
+        ++state.counters.sentences;
+    }
+
+    return state.counters;
+}
+
+int TextHelper::wordsCount(const QString& _text)
+{
+    return counters(_text).words;
+}
+
+int TextHelper::charactersCount(const QString& _text, bool _withSpaces)
+{
+    const auto textCounters = counters(_text);
+    return _withSpaces ? textCounters.characters : textCounters.charactersWithoutSpaces;
+}
+
+int TextHelper::sentencesCount(const QString& _text)
+{
+    return counters(_text).sentences;
 }
 
 void TextHelper::updateSelectionFormatting(
@@ -80,11 +80,53 @@ public:
      */
     static QString toSentenceCase(const QString& _text, bool _capitalizeEveryWord = false);
 
+    /**
+     * @brief Счётчики текста
+     */
+    struct Counters {
+        /**
+         * @brief Количество слов
+         * @note Словом считается любая непустая последовательность символов между пробелами
+         *       ASCII и знаками ".,!():;", в том числе и одиночное тире
+         */
+        int words = 0;
+
+        /**
+         * @brief Количество символов с пробелами и без них
+         * @note Суррогатная пара считается одним символом
+         */
+        int characters = 0;
+        int charactersWithoutSpaces = 0;
+
+        /**
+         * @brief Количество предложений
+         * @note Группа идущих подряд знаков конца предложения, типа "?!" или "...", считается
+         *       одним концом предложения, а текст без знака в конце считается предложением,
+         *       если в нём есть буквы или цифры
+         */
+        int sentences = 0;
+    };
+
+    /**
+     * @brief Посчитать все счётчики текста за один проход без выделения памяти
+     */
+    static Counters counters(const QString& _text);
+
     /**
      * @brief Определить количество слов в тексте
      */
     static int wordsCount(const QString& _text);
 
+    /**
+     * @brief Определить количество символов в тексте
+     */
+    static int charactersCount(const QString& _text, bool _withSpaces = true);
+
+    /**
+     * @brief Определить количество предложений в тексте
+     */
+    static int sentencesCount(const QString& _text);
+
     /**
      * @brief Применить заданный функтор форматирования для выделенного текста в курсоре
      */
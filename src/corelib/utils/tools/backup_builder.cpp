@@ -1,15 +1,319 @@
 #include "backup_builder.h"
 
+#include <utils/logging.h>
+
+#include <QCryptographicHash>
 #include <QDate>
 #include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QString>
+#include <QStringList>
+#include <QUuid>
+#include <QVector>
 
+#include <array>
 #include <set>
 
 
+namespace {
+
+/**
+ * @brief Параметры разбиения снимка на блоки
+ * @note Границы блоков определяются по содержимому файла, поэтому вставка или удаление данных
+ *       в середине проекта затрагивает только соседние блоки, а не все последующие
+ */
+constexpr qint64 kMinimumBlockSize = 16 * 1024;
+constexpr qint64 kMaximumBlockSize = 256 * 1024;
+constexpr quint64 kBlockBoundaryMask = (1 << 16) - 1;
+
+/**
+ * @brief Версия формата файла снимка
+ */
+constexpr int kSnapshotVersion = 1;
+
+/**
+ * @brief Расширение файла снимка и папка хранилища блоков внутри папки бэкапов
+ */
+const QString kSnapshotSuffix = QLatin1String("snapshot");
+const QString kBlocksFolder = QLatin1String(".blocks");
+
+/**
+ * @brief Ключи файла снимка
+ */
+const QString kVersionKey = QLatin1String("version");
+const QString kSizeKey = QLatin1String("size");
+const QString kHashKey = QLatin1String("sha256");
+const QString kBlocksKey = QLatin1String("blocks");
+
+/**
+ * @brief Блокировка хранилища, чтобы параллельные бэкапы не удаляли блоки друг друга
+ */
+QMutex& storeMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Таблица случайных чисел для скользящего хеша (gear hash)
+ */
+const std::array<quint64, 256>& gearTable()
+{
+    static const auto table = [] {
+        std::array<quint64, 256> result;
+        //
+        // Заполняем таблицу детерминированно (splitmix64), т.к. от неё зависят границы блоков
+        //
+        quint64 state = 0;
+        for (auto& value : result) {
+            state += 0x9E3779B97F4A7C15ull;
+            quint64 mixed = state;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            value = mixed ^ (mixed >> 31);
+        }
+        return result;
+    }();
+    return table;
+}
+
+/**
+ * @brief Определить размер очередного блока данных
+ */
+qint64 nextBlockSize(const uchar* _data, qint64 _size)
+{
+    if (_size <= kMinimumBlockSize) {
+        return _size;
+    }
+
+    const auto& table = gearTable();
+    const auto limit = std::min(_size, kMaximumBlockSize);
+    quint64 hash = 0;
+    for (qint64 position = kMinimumBlockSize; position < limit; ++position) {
+        hash = (hash << 1) + table[_data[position]];
+        if ((hash & kBlockBoundaryMask) == 0) {
+            return position + 1;
+        }
+    }
+    return limit;
+}
+
+QString hashOf(const QByteArray& _data)
+{
+    return QString::fromLatin1(
+        QCryptographicHash::hash(_data, QCryptographicHash::Sha256).toHex());
+}
+
+QString blockPath(const QString& _storeDir, const QString& _blockHash)
+{
+    return QString("%1/%2/%3").arg(_storeDir, _blockHash.left(2), _blockHash);
+}
+
+/**
+ * @brief Скопировать базу данных построчно в заданный файл
+ * @note Все выборки выполняются в одной транзакции, поэтому копия согласована и включает
+ *       изменения, которые ещё находятся в журнале упреждающей записи
+ */
+bool copyDatabase(const QString& _filePath, const QString& _snapshotFilePath)
+{
+    bool isCopied = false;
+    const auto connectionName = QString("backup_copy_%1").arg(QUuid::createUuid().toString());
+    {
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_snapshotFilePath);
+        if (database.open()) {
+            QString filePath = _filePath;
+            filePath.replace("'", "''");
+            QSqlQuery query(database);
+            isCopied = query.exec(QString("ATTACH DATABASE '%1' AS source").arg(filePath))
+                && database.transaction();
+
+            //
+            // Сперва создаём таблицы и переносим их данные, а индексы и триггеры после них
+            //
+            QVector<QPair<QString, QString>> tables;
+            QStringList otherStatements;
+            if (isCopied) {
+                isCopied = query.exec("SELECT type, name, sql FROM source.sqlite_master "
+                                      "WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite_%'");
+                while (query.next()) {
+                    if (query.value(0).toString() == "table") {
+                        tables.append({ query.value(1).toString(), query.value(2).toString() });
+                    } else {
+                        otherStatements.append(query.value(2).toString());
+                    }
+                }
+            }
+            for (const auto& table : std::as_const(tables)) {
+                auto tableName = table.first;
+                tableName.replace("\"", "\"\"");
+                isCopied = isCopied && query.exec(table.second)
+                    && query.exec(QString("INSERT INTO main.\"%1\" SELECT * FROM source.\"%1\"")
+                                      .arg(tableName));
+            }
+            for (const auto& statement : std::as_const(otherStatements)) {
+                isCopied = isCopied && query.exec(statement);
+            }
+
+            if (isCopied) {
+                isCopied = database.commit();
+            } else {
+                database.rollback();
+            }
+            query.exec("DETACH DATABASE source");
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return isCopied;
+}
+
+/**
+ * @brief Сделать согласованный снимок базы данных проекта
+ * @note Перед снимком переносим журнал упреждающей записи в основной файл, не дожидаясь
+ *       пишущих соединений, чтобы журнал не разрастался. Сам снимок от этого не зависит:
+ *       VACUUM INTO читает базу в одной транзакции чтения вместе с журналом, поэтому в снимок
+ *       попадают все зафиксированные изменения, даже ещё не перенесённые в основной файл, и не
+ *       попадают частично записанные, даже если проект в этот момент сохраняется
+ */
+bool makeSnapshot(const QString& _filePath, const QString& _snapshotFilePath)
+{
+    QFile::remove(_snapshotFilePath);
+
+    bool isSnapshotMade = false;
+    const auto connectionName = QString("backup_%1").arg(QUuid::createUuid().toString());
+    {
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_filePath);
+        if (database.open()) {
+            QSqlQuery query(database);
+            query.exec("PRAGMA wal_checkpoint(PASSIVE)");
+
+            QString snapshotFilePath = _snapshotFilePath;
+            snapshotFilePath.replace("'", "''");
+            isSnapshotMade = query.exec(QString("VACUUM INTO '%1'").arg(snapshotFilePath));
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    //
+    // Старые версии SQLite не умеют VACUUM INTO, в таком случае копируем базу построчно, т.к.
+    // копия файла не включала бы изменения из журнала и могла бы захватить частичную запись
+    //
+    if (!isSnapshotMade) {
+        QFile::remove(_snapshotFilePath);
+        isSnapshotMade = copyDatabase(_filePath, _snapshotFilePath);
+    }
+
+    return isSnapshotMade;
+}
+
+/**
+ * @brief Сохранить в хранилище блоки снимка, которых там ещё нет, и записать список блоков
+ */
+bool storeSnapshot(const QString& _snapshotFilePath, const QString& _storeDir,
+                   const QString& _manifestPath)
+{
+    QFile snapshotFile(_snapshotFilePath);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray snapshotContent;
+    const uchar* data = snapshotFile.map(0, snapshotFile.size());
+    if (data == nullptr) {
+        snapshotContent = snapshotFile.readAll();
+        data = reinterpret_cast<const uchar*>(snapshotContent.constData());
+    }
+    const auto size = snapshotFile.size();
+
+    QJsonArray blocks;
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    for (qint64 position = 0; position < size;) {
+        const auto blockSize = nextBlockSize(data + position, size - position);
+        const auto block = QByteArray::fromRawData(reinterpret_cast<const char*>(data + position),
+                                                   static_cast<int>(blockSize));
+        fileHash.addData(block);
+
+        const auto blockHash = hashOf(block);
+        const auto path = blockPath(_storeDir, blockHash);
+        if (!QFile::exists(path)) {
+            QDir::root().mkpath(QFileInfo(path).absolutePath());
+            QSaveFile blockFile(path);
+            if (!blockFile.open(QIODevice::WriteOnly) || blockFile.write(block) != blockSize
+                || !blockFile.commit()) {
+                return false;
+            }
+        }
+
+        blocks.append(blockHash);
+        position += blockSize;
+    }
+
+    QJsonObject manifest;
+    manifest[kVersionKey] = kSnapshotVersion;
+    manifest[kSizeKey] = size;
+    manifest[kHashKey] = QString::fromLatin1(fileHash.result().toHex());
+    manifest[kBlocksKey] = blocks;
+
+    QSaveFile manifestFile(_manifestPath);
+    if (!manifestFile.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    manifestFile.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+    return manifestFile.commit();
+}
+
+/**
+ * @brief Удалить из хранилища блоки, на которые не ссылается ни один из снимков
+ */
+void removeUnusedBlocks(const QString& _backupDir, const QString& _storeDir)
+{
+    QSet<QString> usedBlocks;
+    const auto snapshots = QDir(_backupDir).entryInfoList({ "*." + kSnapshotSuffix }, QDir::Files);
+    for (const auto& snapshot : snapshots) {
+        QFile snapshotFile(snapshot.absoluteFilePath());
+        if (!snapshotFile.open(QIODevice::ReadOnly)) {
+            //
+            // Если снимок не удаётся прочитать, то не рискуем удалять блоки
+            //
+            return;
+        }
+        const auto blocks = QJsonDocument::fromJson(snapshotFile.readAll())[kBlocksKey].toArray();
+        for (const auto& block : blocks) {
+            usedBlocks.insert(block.toString());
+        }
+    }
+
+    const auto blocksDirs = QDir(_storeDir).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto& blocksDir : blocksDirs) {
+        const auto blocks = QDir(blocksDir.absoluteFilePath()).entryInfoList(QDir::Files);
+        for (const auto& block : blocks) {
+            if (!usedBlocks.contains(block.fileName())) {
+                QFile::remove(block.absoluteFilePath());
+            }
+        }
+    }
+}
+
+} // namespace
+
+
 void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
                          const QString& _newName, int _maximumBackups)
 {
+    QMutexLocker locker(&storeMutex());
+
     //
     // Создаём папку для хранения резервных копий, если такой ещё нет
     //
@@ -22,9 +326,11 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
     if (!backupPath.endsWith(QDir::separator())) {
         backupPath.append(QDir::separator());
     }
+    const QString storeDir = backupPath + kBlocksFolder;
 
     //
-    // резервные копии создаются по принципу _maximumBackups последних копий
+    // резервные копии создаются по принципу _maximumBackups последних снимков, а последний
+    // снимок дополнительно хранится целиком, чтобы его можно было сразу открыть
     //
 
     QFileInfo fileInfo(_filePath);
@@ -34,32 +340,52 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
             .arg(backupPath, backupBaseName, _dateTime.toString("yyyy_MM_dd_hh_mm_ss"),
                  fileInfo.completeSuffix());
     };
+    const QString latestBackupFileName
+        = QString("%1%2_latest.%3").arg(backupPath, backupBaseName, fileInfo.completeSuffix());
 
     //
-    // Создаём копию
+    // Создаём снимок
     //
     const auto rightNow = QDateTime::currentDateTime();
     const QString tmpBackupFileName
         = QString("%1%2.tmp.%3").arg(backupPath, backupBaseName, fileInfo.completeSuffix());
-    //
-    // ... копируем файл во временную резервную копию
-    //
-    if (QFile::copy(_filePath, tmpBackupFileName)) {
+    if (makeSnapshot(_filePath, tmpBackupFileName)) {
         //
-        // ... если скопировать удалось, переименовываем временную копию
+        // ... если снимок удался, сохраняем изменившиеся блоки в хранилище
         //
         const QString backupFileName = backupFileNameFor(rightNow);
-        QFile::remove(backupFileName);
-        QFile::rename(tmpBackupFileName, backupFileName);
+        const QString snapshotFileName = QString("%1.%2").arg(backupFileName, kSnapshotSuffix);
+        if (!storeSnapshot(tmpBackupFileName, storeDir, snapshotFileName)) {
+            //
+            // ... а если не удалось, то сохраняем бэкап полной копией, чтобы не потерять его
+            //
+            Log::warning("Can't store backup snapshot %1, saving full copy instead",
+                         snapshotFileName);
+            QFile::remove(snapshotFileName);
+            QFile::remove(backupFileName);
+            QFile::copy(tmpBackupFileName, backupFileName);
+        }
+        //
+        // ... и обновляем полную копию последнего снимка
+        //
+        QFile::remove(latestBackupFileName);
+        QFile::rename(tmpBackupFileName, latestBackupFileName);
     }
+    QFile::remove(tmpBackupFileName);
 
     //
-    // Формируем список имеющихся резервных копий
+    // Формируем список имеющихся резервных копий, включая полные копии прошлых версий
     //
-    const auto nameFilter = QString("%1_*.%2").arg(backupBaseName, fileInfo.completeSuffix());
+    const QStringList nameFilters = {
+        QString("%1_*.%2").arg(backupBaseName, fileInfo.completeSuffix()),
+        QString("%1_*.%2.%3").arg(backupBaseName, fileInfo.completeSuffix(), kSnapshotSuffix),
+    };
     QVector<QString> backups;
-    const auto files = QDir(_backupDir).entryInfoList({ nameFilter }, QDir::Files);
+    const auto files = QDir(_backupDir).entryInfoList(nameFilters, QDir::Files);
     for (const auto& file : files) {
+        if (file.absoluteFilePath() == QFileInfo(latestBackupFileName).absoluteFilePath()) {
+            continue;
+        }
         backups.append(file.absoluteFilePath());
     }
     //
@@ -74,4 +400,86 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
         const auto backupToRemove = backups.takeLast();
         QFile::remove(backupToRemove);
     }
+
+    //
+    // Убираем из хранилища блоки удалённых снимков
+    //
+    removeUnusedBlocks(_backupDir, storeDir);
+}
+
+bool BackupBuilder::restore(const QString& _snapshotPath, const QString& _targetFilePath)
+{
+    QMutexLocker locker(&storeMutex());
+
+    QFile snapshotFile(_snapshotPath);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const auto manifest = QJsonDocument::fromJson(snapshotFile.readAll()).object();
+    if (manifest[kVersionKey].toInt() != kSnapshotVersion) {
+        return false;
+    }
+
+    const QString storeDir
+        = QString("%1/%2").arg(QFileInfo(_snapshotPath).absolutePath(), kBlocksFolder);
+    QSaveFile targetFile(_targetFilePath);
+    if (!targetFile.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    //
+    // Собираем файл из блоков, проверяя каждый из них и итоговый файл целиком
+    //
+    qint64 size = 0;
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    const auto blocks = manifest[kBlocksKey].toArray();
+    for (const auto& block : blocks) {
+        const auto blockHash = block.toString();
+        QFile blockFile(blockPath(storeDir, blockHash));
+        if (!blockFile.open(QIODevice::ReadOnly)) {
+            targetFile.cancelWriting();
+            return false;
+        }
+
+        const auto blockData = blockFile.readAll();
+        if (hashOf(blockData) != blockHash || targetFile.write(blockData) != blockData.size()) {
+            targetFile.cancelWriting();
+            return false;
+        }
+
+        fileHash.addData(blockData);
+        size += blockData.size();
+    }
+
+    if (size != manifest[kSizeKey].toVariant().toLongLong()
+        || QString::fromLatin1(fileHash.result().toHex()) != manifest[kHashKey].toString()) {
+        targetFile.cancelWriting();
+        return false;
+    }
+
+    return targetFile.commit();
+}
+
+bool BackupBuilder::isSnapshot(const QString& _filePath)
+{
+    return _filePath.endsWith("." + kSnapshotSuffix, Qt::CaseInsensitive);
+}
+
+QString BackupBuilder::restoreFullCopy(const QString& _snapshotPath)
+{
+    if (!isSnapshot(_snapshotPath)) {
+        return {};
+    }
+
+    const QString fullCopyPath = _snapshotPath.chopped(kSnapshotSuffix.length() + 1);
+    if (!QFile::exists(fullCopyPath) && !restore(_snapshotPath, fullCopyPath)) {
+        return {};
+    }
+
+    //
+    // Полная копия занимает место снимка в списке бэкапов, а неиспользуемые им блоки будут
+    // удалены из хранилища при следующем сохранении бэкапа
+    //
+    QFile::remove(_snapshotPath);
+    return fullCopyPath;
 }
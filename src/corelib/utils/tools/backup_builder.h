@@ -12,8 +12,29 @@ namespace BackupBuilder {
 
 /**
  * @brief Сохранить бэкап
+ * @note В папке бэкапов хранится полная копия последнего снимка проекта, а вся история снимков
+ *       хранится инкрементально, в виде списков блоков общего для всех проектов хранилища.
+ *       Если снимок сохранить не удалось, то бэкап сохраняется полной копией
  */
 CORE_LIBRARY_EXPORT extern void save(const QString& _filePath, const QString& _backupDir,
                                      const QString& _newName, int _maximumBackups);
 
+/**
+ * @brief Восстановить файл проекта из снимка с проверкой его целостности
+ * @return Удалось ли восстановить файл
+ */
+CORE_LIBRARY_EXPORT extern bool restore(const QString& _snapshotPath,
+                                        const QString& _targetFilePath);
+
+/**
+ * @brief Является ли файл снимком бэкапа
+ */
+CORE_LIBRARY_EXPORT extern bool isSnapshot(const QString& _filePath);
+
+/**
+ * @brief Восстановить снимок в полную копию проекта рядом с ним и заменить ею сам снимок
+ * @return Путь к полной копии, либо пустая строка, если восстановить снимок не удалось
+ */
+CORE_LIBRARY_EXPORT extern QString restoreFullCopy(const QString& _snapshotPath);
+
 } // namespace BackupBuilder
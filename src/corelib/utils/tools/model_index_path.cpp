@@ -11,6 +11,11 @@ ModelIndexPath::ModelIndexPath(const QModelIndex& _index)
     }
 }
 
+const QList<int>& ModelIndexPath::path() const
+{
+    return m_path;
+}
+
 bool ModelIndexPath::operator<(const ModelIndexPath& _other) const
 {
     return m_path < _other.m_path;
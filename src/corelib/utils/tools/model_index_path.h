@@ -13,6 +13,11 @@ class CORE_LIBRARY_EXPORT ModelIndexPath
 public:
     explicit ModelIndexPath(const QModelIndex& _index);
 
+    /**
+     * @brief Номера строк от верхнего уровня модели до самого элемента
+     */
+    const QList<int>& path() const;
+
     bool operator<(const ModelIndexPath& _other) const;
 
 private:
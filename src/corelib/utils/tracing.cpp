@@ -0,0 +1,171 @@
+#include "tracing.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+
+namespace {
+
+/**
+ * @brief Состояние трассировки, разделяемое между потоками
+ */
+struct TraceState {
+    QMutex mutex;
+    QFile file;
+    QElapsedTimer timer;
+    bool isFirstEvent = true;
+};
+
+TraceState& traceState()
+{
+    static TraceState state;
+    return state;
+}
+
+/**
+ * @brief Экранировать строку для JSON
+ */
+QByteArray escaped(const char* _text)
+{
+    QByteArray result;
+    for (const char* character = _text; character != nullptr && *character != '\0';
+         ++character) {
+        switch (*character) {
+        case '"':
+        case '\\': {
+            result.append('\\');
+            result.append(*character);
+            break;
+        }
+        case '\n': {
+            result.append("\\n");
+            break;
+        }
+        default: {
+            result.append(*character);
+            break;
+        }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Записать событие в файл
+ * @note Закрывающая скобка массива не пишется, формат допускает её отсутствие, поэтому файл
+ *       остаётся корректным даже при аварийном завершении приложения
+ */
+void writeEvent(const QByteArray& _event)
+{
+    auto& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    if (!state.file.isOpen()) {
+        return;
+    }
+
+    if (state.isFirstEvent) {
+        state.file.write("[\n");
+        state.isFirstEvent = false;
+    } else {
+        state.file.write(",\n");
+    }
+    state.file.write(_event);
+    state.file.flush();
+}
+
+QByteArray eventHeader(const char* _category, const char* _name, char _phase)
+{
+    return QByteArray("{\"name\":\"") + escaped(_name) + "\",\"cat\":\"" + escaped(_category)
+        + "\",\"ph\":\"" + _phase
+        + "\",\"pid\":" + QByteArray::number(QCoreApplication::applicationPid()) + ",\"tid\":"
+        + QByteArray::number(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+}
+
+} // namespace
+
+
+void Trace::init(const QString& _filePath)
+{
+    auto& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    if (state.file.isOpen()) {
+        return;
+    }
+
+    const QFileInfo traceFileInfo(_filePath);
+    if (!QDir::root().mkpath(traceFileInfo.absolutePath())) {
+        return;
+    }
+
+    state.file.setFileName(_filePath);
+    if (!state.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+
+    state.isFirstEvent = true;
+    state.timer.start();
+}
+
+QString Trace::traceFilePath()
+{
+    auto& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    return state.file.fileName();
+}
+
+bool Trace::isEnabled()
+{
+    auto& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    return state.file.isOpen();
+}
+
+void Trace::writeSpan(const char* _category, const char* _name, qint64 _startUs,
+                      qint64 _durationUs)
+{
+    writeEvent(eventHeader(_category, _name, 'X') + ",\"ts\":" + QByteArray::number(_startUs)
+               + ",\"dur\":" + QByteArray::number(_durationUs) + "}");
+}
+
+void Trace::writeInstant(const char* _category, const char* _name)
+{
+    writeEvent(eventHeader(_category, _name, 'i') + ",\"ts\":" + QByteArray::number(nowUs())
+               + ",\"s\":\"t\"}");
+}
+
+qint64 Trace::nowUs()
+{
+    auto& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    if (!state.timer.isValid()) {
+        return -1;
+    }
+
+    return state.timer.nsecsElapsed() / 1000;
+}
+
+
+// ****
+
+
+TraceSpan::TraceSpan(const char* _category, const char* _name)
+    : m_category(_category)
+    , m_name(_name)
+    , m_startUs(Trace::nowUs())
+{
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (m_startUs < 0) {
+        return;
+    }
+
+    Trace::writeSpan(m_category, m_name, m_startUs, Trace::nowUs() - m_startUs);
+}
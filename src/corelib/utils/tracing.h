@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+
+#include <corelib_global.h>
+
+
+/**
+ * @brief Трассировка выполнения в формате Chrome trace-event JSON (chrome://tracing, Perfetto)
+ *
+ * Трассировка включается на этапе сборки (qmake CONFIG+=tracing), при выключенной трассировке
+ * макросы ниже не генерируют никакого кода
+ */
+class CORE_LIBRARY_EXPORT Trace
+{
+public:
+    /**
+     * @brief Начать запись трассировки в заданный файл
+     */
+    static void init(const QString& _filePath);
+
+    /**
+     * @brief Путь к текущему файлу трассировки
+     */
+    static QString traceFilePath();
+
+    /**
+     * @brief Включена ли запись трассировки
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Записать завершённый интервал (время в микросекундах от старта трассировки)
+     */
+    static void writeSpan(const char* _category, const char* _name, qint64 _startUs,
+                          qint64 _durationUs);
+
+    /**
+     * @brief Записать мгновенное событие
+     */
+    static void writeInstant(const char* _category, const char* _name);
+
+    /**
+     * @brief Текущее время трассировки в микросекундах
+     */
+    static qint64 nowUs();
+};
+
+/**
+ * @brief Интервал трассировки, продолжающийся до конца области видимости
+ */
+class CORE_LIBRARY_EXPORT TraceSpan
+{
+public:
+    TraceSpan(const char* _category, const char* _name);
+    ~TraceSpan();
+
+private:
+    const char* m_category = nullptr;
+    const char* m_name = nullptr;
+    qint64 m_startUs = -1;
+};
+
+
+#ifdef STARC_TRACING
+#define STARC_TRACE_CONCAT_IMPL(_a, _b) _a##_b
+#define STARC_TRACE_CONCAT(_a, _b) STARC_TRACE_CONCAT_IMPL(_a, _b)
+#define TRACE_SCOPE(_category, _name)                                                            \
+    const TraceSpan STARC_TRACE_CONCAT(traceSpan, __LINE__)(_category, _name)
+#define TRACE_INSTANT(_category, _name) Trace::writeInstant(_category, _name)
+#else
+#define TRACE_SCOPE(_category, _name)
+#define TRACE_INSTANT(_category, _name)
+#endif
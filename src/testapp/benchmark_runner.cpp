@@ -0,0 +1,88 @@
+#include "benchmark_runner.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+
+class BenchmarkRunner::Implementation
+{
+public:
+    explicit Implementation(int _iterations);
+
+
+    const int iterations = 1;
+    QJsonObject parameters;
+    QJsonArray benchmarks;
+};
+
+BenchmarkRunner::Implementation::Implementation(int _iterations)
+    : iterations(std::max(1, _iterations))
+{
+}
+
+
+// ****
+
+
+BenchmarkRunner::BenchmarkRunner(int _iterations)
+    : d(new Implementation(_iterations))
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner() = default;
+
+void BenchmarkRunner::measure(const QString& _name, const std::function<void()>& _body,
+                              const std::function<void()>& _prepare)
+{
+    QVector<qint64> timings;
+    timings.reserve(d->iterations);
+    QElapsedTimer timer;
+    for (int iteration = 0; iteration < d->iterations; ++iteration) {
+        if (_prepare) {
+            _prepare();
+        }
+
+        timer.start();
+        _body();
+        timings.append(timer.nsecsElapsed());
+    }
+
+    std::sort(timings.begin(), timings.end());
+    const auto toMs = [](qint64 _nsecs) { return static_cast<double>(_nsecs) / 1000000.0; };
+    const auto total = std::accumulate(timings.begin(), timings.end(), qint64(0));
+
+    QJsonObject benchmark;
+    benchmark["name"] = _name;
+    benchmark["iterations"] = timings.size();
+    benchmark["min_ms"] = toMs(timings.constFirst());
+    benchmark["median_ms"] = toMs(timings.at(timings.size() / 2));
+    benchmark["max_ms"] = toMs(timings.constLast());
+    benchmark["mean_ms"] = toMs(total / timings.size());
+    d->benchmarks.append(benchmark);
+
+    //
+    // Выводим прогресс в поток ошибок, чтобы не смешивать его с результатами
+    //
+    std::cerr << qPrintable(_name) << ": " << benchmark["median_ms"].toDouble() << " ms"
+              << std::endl;
+}
+
+void BenchmarkRunner::setParameter(const QString& _name, int _value)
+{
+    d->parameters[_name] = _value;
+}
+
+QJsonDocument BenchmarkRunner::results() const
+{
+    QJsonObject results;
+    results["parameters"] = d->parameters;
+    results["benchmarks"] = d->benchmarks;
+    return QJsonDocument(results);
+}
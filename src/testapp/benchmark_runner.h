@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QScopedPointer>
+
+#include <functional>
+
+class QJsonDocument;
+class QString;
+
+
+/**
+ * @brief Запускает замеры и собирает их результаты в машиночитаемом виде
+ */
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(int _iterations);
+    ~BenchmarkRunner();
+
+    /**
+     * @brief Замерить выполнение заданной операции
+     * @param _prepare - подготовка к очередной итерации, время её выполнения не учитывается
+     */
+    void measure(const QString& _name, const std::function<void()>& _body,
+                 const std::function<void()>& _prepare = {});
+
+    /**
+     * @brief Добавить к результатам произвольный параметр запуска
+     */
+    void setParameter(const QString& _name, int _value);
+
+    /**
+     * @brief Результаты всех замеров
+     */
+    QJsonDocument results() const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
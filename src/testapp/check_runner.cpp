@@ -0,0 +1,83 @@
+#include "check_runner.h"
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <iostream>
+
+
+class CheckRunner::Implementation
+{
+public:
+    QTemporaryDir workingDir;
+
+    /**
+     * @brief Название выполняемой проверки
+     */
+    QString currentCheck;
+
+    /**
+     * @brief Количество расхождений, найденных в выполняемой проверке
+     */
+    int mismatchesCount = 0;
+
+    int failedChecksCount = 0;
+};
+
+
+// ****
+
+
+CheckRunner::CheckRunner()
+    : d(new Implementation)
+{
+}
+
+CheckRunner::~CheckRunner() = default;
+
+QString CheckRunner::workingDir() const
+{
+    return d->workingDir.path();
+}
+
+void CheckRunner::run(const QString& _name, const std::function<void()>& _check)
+{
+    d->currentCheck = _name;
+    d->mismatchesCount = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    _check();
+
+    //
+    // Как и прогресс замеров, выводим результаты проверок в поток ошибок
+    //
+    if (d->mismatchesCount == 0) {
+        std::cerr << qPrintable(_name) << ": ok, " << timer.elapsed() << " ms" << std::endl;
+    } else {
+        ++d->failedChecksCount;
+        std::cerr << qPrintable(_name) << ": FAILED with " << d->mismatchesCount
+                  << " mismatches" << std::endl;
+    }
+    d->currentCheck.clear();
+}
+
+bool CheckRunner::verify(const QString& _description, bool _isOk)
+{
+    if (!_isOk) {
+        mismatch() << qPrintable(_description) << std::endl;
+    }
+    return _isOk;
+}
+
+std::ostream& CheckRunner::mismatch()
+{
+    ++d->mismatchesCount;
+    return std::cerr << "  " << qPrintable(d->currentCheck) << " mismatch: ";
+}
+
+int CheckRunner::failedChecksCount() const
+{
+    return d->failedChecksCount;
+}
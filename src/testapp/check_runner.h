@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QScopedPointer>
+
+#include <functional>
+#include <iosfwd>
+
+class QString;
+
+
+/**
+ * @brief Запускает проверки корректности и подсчитывает найденные в них расхождения
+ */
+class CheckRunner
+{
+public:
+    CheckRunner();
+    ~CheckRunner();
+
+    /**
+     * @brief Папка для файлов, которые создаются в ходе проверок
+     */
+    QString workingDir() const;
+
+    /**
+     * @brief Выполнить проверку и вывести количество найденных в ней расхождений
+     */
+    void run(const QString& _name, const std::function<void()>& _check);
+
+    /**
+     * @brief Проверить условие и засчитать расхождение с заданным описанием, если оно нарушено
+     * @return Выполняется ли условие
+     */
+    bool verify(const QString& _description, bool _isOk);
+
+    /**
+     * @brief Засчитать расхождение
+     * @return Поток, в который выводятся подробности расхождения
+     */
+    std::ostream& mismatch();
+
+    /**
+     * @brief Количество проверок, в которых нашлись расхождения
+     */
+    int failedChecksCount() const;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <utils/helpers/text_helper.h>
+
+class CheckRunner;
+
+
+/**
+ * @brief Проверки корректности оптимизированных реализаций, сверяющие их с эталонными
+ */
+class Checks
+{
+public:
+    /**
+     * @brief Проверки счётчиков текста и патчей
+     */
+    static void runTextChecks(CheckRunner& _runner);
+
+    /**
+     * @brief Проверки индексов, нумерации, представлений и копирования текстовых моделей
+     */
+    static void runModelChecks(CheckRunner& _runner);
+
+    /**
+     * @brief Проверки бэкапов и хранения данных проектов
+     */
+    static void runStorageChecks(CheckRunner& _runner);
+
+    /**
+     * @brief Эталонный подсчёт счётчиков текста, с которым сверяется и замеряется оптимизированный
+     */
+    static TextHelper::Counters referenceCounters(const QString& _text);
+};
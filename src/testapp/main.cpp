@@ -1,58 +1,735 @@
-#include <ui/design_system/design_system.h>
-#include <ui/widgets/text_edit/completer/completer.h>
-#include <ui/widgets/text_field/text_field.h>
+#include "benchmark_runner.h"
+#include "check_runner.h"
+#include "checks.h"
+#include "synthetic_documents.h"
+#include "synthetic_projects.h"
+
+#include <business_layer/document/novel/text/novel_text_document.h>
+#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/export/screenplay/screenplay_docx_exporter.h>
+#include <business_layer/export/screenplay/screenplay_export_options.h>
+#include <business_layer/export/screenplay/screenplay_fdx_exporter.h>
+#include <business_layer/export/screenplay/screenplay_fountain_exporter.h>
+#include <business_layer/import/novel/novel_markdown_importer.h>
+#include <business_layer/import/screenplay/screenplay_fdx_importer.h>
+#include <business_layer/import/screenplay/screenplay_fountain_importer.h>
+#include <business_layer/import/screenplay/screenplay_import_options.h>
+#include <business_layer/model/screenplay/text/screenplay_breakdown_index.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model_scene_item.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/reports/novel/novel_summary_report.h>
+#include <business_layer/reports/screenplay/screenplay_breakdown_report.h>
+#include <business_layer/reports/screenplay/screenplay_summary_report.h>
+#include <business_layer/templates/novel_template.h>
+#include <business_layer/templates/screenplay_template.h>
+#include <business_layer/templates/templates_facade.h>
+#include <data_layer/database.h>
+#include <data_layer/mapper/document_change_mapper.h>
+#include <data_layer/mapper/mapper_facade.h>
+#include <data_layer/storage/document_change_storage.h>
+#include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <domain/document_change_object.h>
+#include <domain/document_object.h>
+#include <domain/objects_builder.h>
+#include <ui/modules/bookmarks/bookmarks_model.h>
+#include <ui/modules/cards/cards_graphics_view.h>
+#include <ui/modules/cards/cards_layout.h>
+#include <ui/modules/comments/comments_model.h>
+#include <ui/widgets/text_edit/page/page_text_edit.h>
+#include <utils/diff_match_patch/diff_match_patch_controller.h>
+#include <utils/helpers/text_helper.h>
 
 #include <QApplication>
-#include <QDebug>
-#include <QKeyEvent>
-#include <QStringListModel>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QScrollBar>
+#include <QTemporaryDir>
+#include <QUuid>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace BusinessLayer;
+
 
-class CompletableTextField : public TextField
+namespace {
+
+/**
+ * @brief Замерить сохранение изменений модели и наложение полученных патчей
+ */
+template<typename Project>
+void measureChanges(BenchmarkRunner& _runner, const QString& _prefix, Project& _project)
 {
-public:
-    explicit CompletableTextField(QWidget* _parent = nullptr)
-        : TextField(_parent)
-    {
+    //
+    // Приводим контент документа к виду, который формирует модель
+    //
+    _project.textModel->saveChanges();
+    const auto originalXml = _project.textDocument->content();
+    auto changedXml = originalXml;
+    changedXml.replace(SyntheticDocuments::marker().toUtf8(),
+                       (SyntheticDocuments::marker() + " changed").toUtf8());
+
+    _runner.measure(_prefix + "/save_changes_unchanged",
+                    [&_project] { _project.textModel->saveChanges(); });
+
+    QByteArray undoPatch;
+    QByteArray redoPatch;
+    QObject::connect(_project.textModel.data(), &AbstractModel::contentsChanged,
+                     [&undoPatch, &redoPatch](const QByteArray& _undo, const QByteArray& _redo) {
+                         undoPatch = _undo;
+                         redoPatch = _redo;
+                     });
+    _runner.measure(
+        _prefix + "/save_changes", [&_project] { _project.textModel->saveChanges(); },
+        [&_project, &changedXml] { _project.textDocument->setContent(changedXml); });
+
+    //
+    // Патч отмены переводит модель в изменённое состояние, а патч повтора возвращает обратно
+    //
+    bool isChanged = false;
+    _runner.measure(
+        _prefix + "/apply_patch",
+        [&_project, &undoPatch, &isChanged] {
+            _project.textModel->applyDocumentChanges({ undoPatch });
+            isChanged = true;
+        },
+        [&_project, &redoPatch, &isChanged] {
+            if (isChanged) {
+                _project.textModel->applyDocumentChanges({ redoPatch });
+                isChanged = false;
+            }
+        });
+    if (isChanged) {
+        _project.textModel->applyDocumentChanges({ redoPatch });
     }
+}
+
+/**
+ * @brief Замерить формирование патчей для больших правок документа и их размер, детерминированным
+ *        сравнением и, для сравнения, прежним способом через patch_make из diff_match_patch
+ */
+void measurePatchMaking(BenchmarkRunner& _runner, const QString& _prefix, const QString& _xml)
+{
+    const DiffMatchPatchController dmpController(QVector<QString>{});
+    DiffMatchPatchController legacyDmpController(QVector<QString>{});
+    legacyDmpController.setDeterministicDiff(false);
+    auto lines = _xml.split('\n');
+    const int middle = static_cast<int>(lines.size()) / 2;
+    const int blockSize = std::max(1, static_cast<int>(lines.size()) / 10);
+
+    QVector<QPair<QString, QString>> edits;
+    //
+    // ... правка одного слова
+    //
+    edits.append({ "word",
+                   QString(_xml).replace(SyntheticDocuments::marker(),
+                                         SyntheticDocuments::marker() + " changed") });
+    //
+    // ... вставка и удаление десятой части документа
+    //
+    auto insertedLines = lines;
+    for (int index = 0; index < blockSize; ++index) {
+        insertedLines.insert(middle, lines.at(middle + blockSize - index - 1));
+    }
+    edits.append({ "block_insert", insertedLines.join('\n') });
+    auto removedLines = lines;
+    removedLines.erase(removedLines.begin() + middle, removedLines.begin() + middle + blockSize);
+    edits.append({ "block_remove", removedLines.join('\n') });
+    //
+    // ... правки, разбросанные по всему документу
+    //
+    auto scatteredLines = lines;
+    for (int index = 0; index < scatteredLines.size(); index += 50) {
+        scatteredLines[index].insert(scatteredLines.at(index).size() / 2, " edited");
+    }
+    edits.append({ "scattered", scatteredLines.join('\n') });
+    //
+    // ... перестановка абзацев в середине документа
+    //
+    auto movedLines = lines;
+    std::reverse(movedLines.begin() + middle, movedLines.begin() + middle + blockSize / 2);
+    edits.append({ "reorder", movedLines.join('\n') });
+
+    for (const auto& edit : std::as_const(edits)) {
+        QByteArray patch;
+        _runner.measure(_prefix + "/make_patch_" + edit.first,
+                        [&dmpController, &_xml, &edit, &patch] {
+                            patch = dmpController.makePatch(_xml, edit.second);
+                        });
+        _runner.setParameter(_prefix + "/patch_size_" + edit.first,
+                             static_cast<int>(patch.size()));
 
-protected:
-    bool event(QEvent* _event) override
-    {
-        bool needComplete = false;
-        switch (_event->type()) {
-        case QEvent::FocusIn: {
-            needComplete = true;
-            break;
+        QByteArray legacyPatch;
+        _runner.measure(_prefix + "/make_patch_legacy_" + edit.first,
+                        [&legacyDmpController, &_xml, &edit, &legacyPatch] {
+                            legacyPatch = legacyDmpController.makePatch(_xml, edit.second);
+                        });
+        _runner.setParameter(_prefix + "/patch_size_legacy_" + edit.first,
+                             static_cast<int>(legacyPatch.size()));
+    }
+}
+
+/**
+ * @brief Замерить формирование документа для редактора с пагинацией и без
+ */
+template<typename Document>
+void measureDocumentLayout(BenchmarkRunner& _runner, const QString& _name, TextModel* _model,
+                           const TextTemplate& _template, Document& _document)
+{
+    PageTextEdit textEdit;
+    textEdit.setUsePageMode(true);
+    textEdit.setPageFormat(_template.pageSizeId());
+    textEdit.setPageMarginsMm(_template.pageMargins());
+    textEdit.setDocument(&_document);
+
+    _runner.measure(
+        _name, [&_document, _model] { _document.setModel(_model); },
+        [&_document] { _document.setModel(nullptr); });
+
+    _document.setModel(nullptr);
+}
+
+/**
+ * @brief Замерить построение и обновление панелей комментариев и закладок
+ */
+void measureReviewPanels(BenchmarkRunner& _runner, TextModel* _model, int _commentsCount)
+{
+    QVector<TextModelTextItem*> textItems;
+    std::function<void(TextModelItem*)> collectTextItems;
+    collectTextItems = [&textItems, &collectTextItems](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            auto childItem = _item->childAt(childIndex);
+            if (childItem->type() == TextModelItemType::Text) {
+                textItems.append(static_cast<TextModelTextItem*>(childItem));
+            } else {
+                collectTextItems(childItem);
+            }
         }
-        default: {
-            break;
+    };
+    collectTextItems(_model->itemForIndex({}));
+    if (textItems.isEmpty()) {
+        return;
+    }
+
+    //
+    // Равномерно раскидываем заметки по тексту, по несколько штук на абзац, если нужно,
+    // а в каждый четвёртый абзац с заметками добавляем ещё и закладку
+    //
+    const int markLength = 4;
+    const int markStep = 6;
+    const int marksPerItem = (_commentsCount + textItems.size() - 1) / textItems.size();
+    int commentsCount = 0;
+    for (int itemIndex = 0; itemIndex < textItems.size() && commentsCount < _commentsCount;
+         ++itemIndex) {
+        auto textItem = textItems.at(itemIndex);
+        QVector<TextModelTextItem::ReviewMark> reviewMarks;
+        for (int markIndex = 0; markIndex < marksPerItem && commentsCount < _commentsCount;
+             ++markIndex) {
+            TextModelTextItem::ReviewMark reviewMark;
+            reviewMark.from = markIndex * markStep;
+            reviewMark.length = markLength;
+            if (reviewMark.end() > textItem->text().length()) {
+                break;
+            }
+            reviewMark.backgroundColor = QColor(itemIndex % 2 == 0 ? "#f7e35a" : "#5ae3f7");
+            reviewMark.comments.append({ "Benchmark", "benchmark@starc.app",
+                                         "2022-10-18T12:00:00",
+                                         QString("Comment %1").arg(commentsCount) });
+            reviewMarks.append(reviewMark);
+            ++commentsCount;
         }
+        if (reviewMarks.isEmpty()) {
+            continue;
         }
-        if (needComplete) {
-            complete(new QStringListModel({ "One", "Two", "Three" }), text());
+
+        textItem->setReviewMarks(reviewMarks);
+        if (itemIndex % 4 == 0) {
+            textItem->setBookmark({ QColor("#e35af7"), QString("Bookmark %1").arg(itemIndex) });
         }
+        _model->updateItem(textItem);
+    }
+    _runner.setParameter("comments_generated", commentsCount);
+
+    CommentsModel comments;
+    _runner.measure(
+        "review/comments_set_model", [&comments, _model] { comments.setTextModel(_model); },
+        [&comments] { comments.setTextModel(nullptr); });
 
-        return TextField::event(_event);
+    BookmarksModel bookmarks;
+    _runner.measure(
+        "review/bookmarks_set_model", [&bookmarks, _model] { bookmarks.setTextModel(_model); },
+        [&bookmarks] { bookmarks.setTextModel(nullptr); });
+
+    _runner.measure("review/comments_map_from_model", [&comments, &textItems, _model] {
+        for (auto textItem : std::as_const(textItems)) {
+            comments.mapFromModel(_model->indexForItem(textItem), markLength / 2);
+        }
+    });
+
+    //
+    // Переключаем состояние заметки и закладки в середине текста, чтобы панели обновились
+    //
+    auto middleItem = textItems.at(textItems.size() / 2);
+    _runner.measure("review/comments_update_item", [middleItem, _model] {
+        auto reviewMarks = middleItem->reviewMarks();
+        for (auto& reviewMark : reviewMarks) {
+            reviewMark.isDone = !reviewMark.isDone;
+        }
+        middleItem->setReviewMarks(reviewMarks);
+        _model->updateItem(middleItem);
+    });
+    _runner.measure("review/bookmarks_update_item", [middleItem, _model] {
+        if (middleItem->bookmark().has_value()) {
+            middleItem->clearBookmark();
+        } else {
+            middleItem->setBookmark({ QColor("#e35af7"), "Bookmark" });
+        }
+        _model->updateItem(middleItem);
+    });
+
+    comments.setTextModel(nullptr);
+    bookmarks.setTextModel(nullptr);
+}
+
+/**
+ * @brief Замерить обновление нумерации комикса при правке его начала и конца
+ */
+void measureComicBook(BenchmarkRunner& _runner, int _pagesCount)
+{
+    ComicBookProject project;
+    auto textModel = project.textModel.data();
+    for (int pageIndex = 0; pageIndex < _pagesCount; ++pageIndex) {
+        textModel->appendItem(
+            project.createPage(pageIndex % 5 == 4 ? "PAGES" : "PAGE", 1 + pageIndex % 3));
     }
-};
 
+    const auto firstPage = textModel->itemForIndex(textModel->index(0, 0));
+    _runner.measure("comic_book/insert_remove_panel_first_page",
+                    [&project, textModel, firstPage] {
+                        auto panel = project.createPanel("PANEL");
+                        textModel->insertItem(panel, firstPage->childAt(0));
+                        textModel->removeItem(panel);
+                    });
+
+    const auto lastPage = textModel->itemForIndex(textModel->index(textModel->rowCount() - 1, 0));
+    _runner.measure("comic_book/insert_remove_panel_last_page", [&project, textModel, lastPage] {
+        auto panel = project.createPanel("PANEL");
+        textModel->appendItem(panel, lastPage);
+        textModel->removeItem(panel);
+    });
+}
+
+/**
+ * @brief Замерить раскладку, отрисовку и перемещение карточек на доске с заданным числом сцен
+ */
+void measureCardsBoard(BenchmarkRunner& _runner, int _cardsCount)
+{
+    ScreenplayProject project(_cardsCount);
+    auto textModel = project.textModel.data();
+
+    Ui::CardsGraphicsView view;
+    view.resize(1280, 800);
+    _runner.measure(
+        "cards/set_model", [&view, textModel] { view.setModel(textModel); },
+        [&view] { view.setModel(nullptr); });
+
+    //
+    // ... первая отрисовка рисует картинки видимых карточек, а прокрутка - только новых
+    //
+    _runner.measure(
+        "cards/render_viewport", [&view] { view.viewport()->grab(); },
+        [&view, textModel] {
+            view.setModel(nullptr);
+            view.setModel(textModel);
+        });
+    _runner.measure("cards/scroll_viewport", [&view] {
+        view.verticalScrollBar()->setValue(view.verticalScrollBar()->value()
+                                           + view.viewport()->height() / 2);
+        view.viewport()->grab();
+    });
+
+    const auto scenes = SyntheticProjects::screenplayScenes(textModel);
+    _runner.measure("cards/move_card", [&view, textModel, &scenes] {
+        const auto& cardsLayout = view.cardsLayout();
+        const auto lastRect = cardsLayout.cards().constLast().rect;
+        view.moveCard(textModel->indexForItem(scenes.constFirst()),
+                      { lastRect.right() - 1, lastRect.center().y() });
+        const auto firstRect = cardsLayout.cards().constFirst().rect;
+        view.moveCard(textModel->indexForItem(scenes.constFirst()),
+                      { firstRect.left() + 1, firstRect.center().y() });
+    });
+}
+
+void measureScreenplay(BenchmarkRunner& _runner, int _scenesCount, int _commentsCount,
+                       const QString& _workingDir)
+{
+    const auto fountain = SyntheticDocuments::screenplayFountain(_scenesCount);
+
+    QString xml;
+    _runner.measure("screenplay/import_fountain", [&xml, &fountain] {
+        xml = ScreenplayFountainImporter().importScreenplay(fountain).text;
+    });
+
+    ScreenplayProject project;
+    _runner.measure(
+        "screenplay/load_xml", [&project, &xml] { project.loadText(xml.toUtf8()); },
+        [&project] { project.unloadText(); });
+    auto textModel = project.textModel.data();
+
+    measureChanges(_runner, "screenplay", project);
+    measurePatchMaking(_runner, "screenplay",
+                       QString::fromUtf8(project.textDocument->content()));
+
+    ScreenplayTextDocument document;
+    document.setCorrectionOptions(false, false);
+    measureDocumentLayout(_runner, "screenplay/document_set_model", textModel,
+                          TemplatesFacade::screenplayTemplate(), document);
+    document.setCorrectionOptions(true, true);
+    measureDocumentLayout(_runner, "screenplay/document_set_model_paginated", textModel,
+                          TemplatesFacade::screenplayTemplate(), document);
+
+    ScreenplayTextDocument treatmentDocument;
+    treatmentDocument.setTreatmentDocument(true);
+    treatmentDocument.setCorrectionOptions(false, false);
+    measureDocumentLayout(_runner, "screenplay/treatment_set_model", textModel,
+                          TemplatesFacade::screenplayTemplate(), treatmentDocument);
+
+    _runner.measure("screenplay/duration", [textModel] { textModel->recalculateDuration(); });
+
+    const auto characters = textModel->findCharactersFromText();
+    _runner.measure("screenplay/character_dialogues", [textModel, &characters] {
+        for (const auto& character : characters) {
+            textModel->characterDialogues(character);
+        }
+    });
+
+    const auto character = std::find_if(characters.cbegin(), characters.cend(),
+                                        [](const QString& _name) { return !_name.isEmpty(); });
+    if (character != characters.cend()) {
+        const auto renamedCharacter = *character + " RENAMED";
+        _runner.measure("screenplay/rename_character", [textModel, character, &renamedCharacter] {
+            textModel->updateCharacterName(TextModelNameReplacement(*character, renamedCharacter));
+            textModel->updateCharacterName(TextModelNameReplacement(renamedCharacter, *character));
+        });
+    }
+
+    _runner.measure("screenplay/summary_report",
+                    [textModel] { ScreenplaySummaryReport().build(textModel); });
+
+    project.tagBreakdownResources();
+    const auto breakdownResource = project.dictionariesModel->resources().constFirst().uuid;
+    const auto breakdownScene = SyntheticProjects::screenplayScenes(textModel).constLast();
+    _runner.measure("screenplay/breakdown_retag_scene",
+                    [textModel, breakdownResource, breakdownScene] {
+                        breakdownScene->storeResource(breakdownResource, 3, {});
+                        textModel->updateItem(breakdownScene);
+                        textModel->breakdownIndex()->categoryTotals({});
+                        breakdownScene->removeResource(breakdownResource);
+                        textModel->updateItem(breakdownScene);
+                        textModel->breakdownIndex()->categoryTotals({});
+                    });
+    ScreenplayBreakdownReport breakdownReport;
+    _runner.measure("screenplay/breakdown_report",
+                    [textModel, &breakdownReport] { breakdownReport.build(textModel); });
+    const auto breakdownXlsxPath = _workingDir + "/breakdown.xlsx";
+    _runner.measure("screenplay/export_breakdown_xlsx", [&breakdownReport, &breakdownXlsxPath] {
+        breakdownReport.saveToFile(breakdownXlsxPath);
+    });
+
+    ScreenplayExportOptions exportOptions;
+    exportOptions.templateId = TemplatesFacade::screenplayTemplate().id();
+    exportOptions.filePath = _workingDir + "/screenplay.fountain";
+    _runner.measure("screenplay/export_fountain", [textModel, &exportOptions] {
+        ScreenplayFountainExporter().exportTo(textModel, exportOptions);
+    });
+    exportOptions.filePath = _workingDir + "/screenplay.docx";
+    _runner.measure("screenplay/export_docx", [textModel, &exportOptions] {
+        ScreenplayDocxExporter().exportTo(textModel, exportOptions);
+    });
+    exportOptions.filePath = _workingDir + "/screenplay.fdx";
+    _runner.measure("screenplay/export_fdx", [textModel, &exportOptions] {
+        ScreenplayFdxExporter().exportTo(textModel, exportOptions);
+    });
+
+    ScreenplayImportOptions importOptions;
+    importOptions.filePath = exportOptions.filePath;
+    _runner.measure("screenplay/import_fdx", [&importOptions] {
+        ScreenplayFdxImporter().importScreenplays(importOptions);
+    });
+
+    DatabaseLayer::Database::setCurrentFile(_workingDir + "/screenplay.starc");
+    auto storedDocument = DataStorageLayer::StorageFacade::documentStorage()->createDocument(
+        QUuid::createUuid(), Domain::DocumentObjectType::ScreenplayText);
+    const auto content = project.textDocument->content();
+    _runner.measure("screenplay/sqlite_save", [storedDocument, &content] {
+        storedDocument->setContent(content);
+        DataStorageLayer::StorageFacade::documentStorage()->saveDocument(storedDocument);
+    });
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+
+    measureReviewPanels(_runner, textModel, _commentsCount);
+}
+
+void measureNovel(BenchmarkRunner& _runner, int _chaptersCount)
+{
+    const auto markdown = SyntheticDocuments::novelMarkdown(_chaptersCount);
+
+    QString xml;
+    _runner.measure("novel/import_markdown", [&xml, &markdown] {
+        xml = NovelMarkdownImporter().importNovel(markdown).text;
+    });
+
+    NovelProject project;
+    _runner.measure(
+        "novel/load_xml", [&project, &xml] { project.loadText(xml.toUtf8()); },
+        [&project] { project.unloadText(); });
+    auto textModel = project.textModel.data();
+
+    measureChanges(_runner, "novel", project);
+
+    NovelTextDocument document;
+    document.setCorrectionOptions(false);
+    measureDocumentLayout(_runner, "novel/document_set_model", textModel,
+                          TemplatesFacade::novelTemplate(), document);
+    document.setCorrectionOptions(true);
+    measureDocumentLayout(_runner, "novel/document_set_model_paginated", textModel,
+                          TemplatesFacade::novelTemplate(), document);
+
+    NovelTextDocument outlineDocument;
+    outlineDocument.setOutlineDocument(true);
+    outlineDocument.setCorrectionOptions(false);
+    measureDocumentLayout(_runner, "novel/outline_set_model", textModel,
+                          TemplatesFacade::novelTemplate(), outlineDocument);
+
+    _runner.measure("novel/summary_report",
+                    [textModel] { NovelSummaryReport().build(textModel); });
+}
+
+/**
+ * @brief Замерить подсчёт счётчиков текста на абзацах романа
+ */
+void measureTextCounters(BenchmarkRunner& _runner, int _chaptersCount)
+{
+    const auto paragraphs
+        = SyntheticDocuments::novelMarkdown(_chaptersCount).split('\n', Qt::SkipEmptyParts);
+
+    int words = 0;
+    _runner.measure("text/counters_reference", [&paragraphs, &words] {
+        for (const auto& paragraph : paragraphs) {
+            words += Checks::referenceCounters(paragraph).words;
+        }
+    });
+    _runner.measure("text/counters", [&paragraphs, &words] {
+        for (const auto& paragraph : paragraphs) {
+            words += TextHelper::counters(paragraph).words;
+        }
+    });
+    _runner.measure("text/words_count", [&paragraphs, &words] {
+        for (const auto& paragraph : paragraphs) {
+            words += TextHelper::wordsCount(paragraph);
+        }
+    });
+    Q_UNUSED(words)
+}
+
+/**
+ * @brief Замерить наложение патчей с проверкой результата и без неё
+ */
+void measurePatches(BenchmarkRunner& _runner, int _historiesCount)
+{
+    const DiffMatchPatchController dmpController({ "document", "scene", "text" });
+    QVector<QByteArray> contents;
+    QVector<QByteArray> patches;
+    for (int seed = 0; seed < _historiesCount; ++seed) {
+        const auto history = SyntheticDocuments::editHistory(seed, 32);
+        for (int index = 1; index < history.size(); ++index) {
+            contents.append(history.at(index - 1).toUtf8());
+            patches.append(dmpController.makePatch(history.at(index - 1), history.at(index)));
+        }
+    }
+
+    int size = 0;
+    _runner.measure("patch/apply", [&dmpController, &contents, &patches, &size] {
+        for (int index = 0; index < patches.size(); ++index) {
+            size += dmpController.applyPatch(contents.at(index), patches.at(index)).size();
+        }
+    });
+    _runner.measure("patch/apply_verified", [&dmpController, &contents, &patches, &size] {
+        for (int index = 0; index < patches.size(); ++index) {
+            const auto result
+                = dmpController.applyPatchVerified(contents.at(index), patches.at(index));
+            size += DiffMatchPatchController::contentHash(result.content).size();
+        }
+    });
+    _runner.measure("patch/changed_xml", [&dmpController, &contents, &patches, &size] {
+        for (int index = 0; index < patches.size(); ++index) {
+            size += dmpController.changedXml(contents.at(index), patches.at(index)).first.from;
+        }
+    });
+    Q_UNUSED(size)
+}
+
+/**
+ * @brief Замерить запись журнала изменений в файл проекта, в том числе прежним способом, по
+ *        запросу на каждое изменение, на тех же данных
+ */
+void measureJournal(BenchmarkRunner& _runner, int _changesCount, const QString& _workingDir)
+{
+    DatabaseLayer::Database::setCurrentFile(_workingDir + "/journal.starc");
+
+    const auto documentUuid = QUuid::createUuid();
+    const auto undoPatch = SyntheticDocuments::marker().toUtf8().repeated(8);
+    const auto redoPatch = (SyntheticDocuments::marker() + " changed").toUtf8().repeated(8);
+    auto queueChanges = [_changesCount, &documentUuid, &undoPatch, &redoPatch] {
+        auto storage = DataStorageLayer::StorageFacade::documentChangeStorage();
+        for (int change = 0; change < _changesCount; ++change) {
+            storage->appendDocumentChange(documentUuid, QUuid::createUuid(), undoPatch,
+                                          redoPatch, "benchmark@starc.app", "Benchmark");
+        }
+    };
+
+    QVector<Domain::DocumentChangeObject*> changes;
+    auto createChanges = [_changesCount, &documentUuid, &undoPatch, &redoPatch, &changes] {
+        changes.clear();
+        const auto isSynced = false;
+        for (int change = 0; change < _changesCount; ++change) {
+            changes.append(Domain::ObjectsBuilder::createDocumentChange(
+                {}, documentUuid, QUuid::createUuid(), undoPatch, redoPatch, {},
+                QDateTime::currentDateTimeUtc(), "benchmark@starc.app", "Benchmark", isSynced));
+        }
+    };
+    _runner.measure(
+        "journal/store_per_row",
+        [&changes] {
+            DatabaseLayer::Database::transaction();
+            for (auto change : std::as_const(changes)) {
+                DataMappingLayer::MapperFacade::documentChangeMapper()->insert(change);
+            }
+            DatabaseLayer::Database::commit();
+            DatabaseLayer::Database::waitForPendingWrites();
+        },
+        createChanges);
+    _runner.measure(
+        "journal/store",
+        [] {
+            DataStorageLayer::StorageFacade::documentChangeStorage()->store();
+            DatabaseLayer::Database::waitForPendingWrites();
+        },
+        queueChanges);
+    _runner.measure(
+        "journal/store_deferred",
+        [] {
+            DatabaseLayer::Database::beginDeferredWrites();
+            DataStorageLayer::StorageFacade::documentChangeStorage()->store();
+            DatabaseLayer::Database::endDeferredWrites();
+            DatabaseLayer::Database::waitForPendingWrites();
+        },
+        queueChanges);
+
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+}
+
+} // namespace
+
+
+/**
+ * @brief Проверки корректности и замеры производительности основных операций над документами
+ *
+ * Запускается без отображения интерфейса, результаты замеров выводятся в формате JSON. Ключами
+ * --checks и --benchmarks можно запустить только проверки, либо только замеры
+ */
 int main(int argc, char* argv[])
 {
-    QApplication a(argc, argv);
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication application(argc, argv);
+    QApplication::setApplicationName("starc-benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Correctness checks and benchmarks of the documents processing hot paths");
+    parser.addHelpOption();
+    const QCommandLineOption scenesOption("scenes", "Scenes count in the screenplay", "count",
+                                          "300");
+    const QCommandLineOption chaptersOption("chapters", "Chapters count in the novel", "count",
+                                            "30");
+    const QCommandLineOption iterationsOption("iterations", "Iterations of each benchmark",
+                                              "count", "5");
+    const QCommandLineOption changesOption("changes", "Changes count in the journal", "count",
+                                           "10000");
+    const QCommandLineOption cardsOption("cards", "Scene cards count on the cards board", "count",
+                                         "2000");
+    const QCommandLineOption commentsOption("comments", "Review comments count in the screenplay",
+                                            "count", "10000");
+    const QCommandLineOption outputOption("output", "File to write results to", "file");
+    const QCommandLineOption checksOption("checks", "Run correctness checks only");
+    const QCommandLineOption benchmarksOption("benchmarks", "Run benchmarks only");
+    parser.addOptions({ scenesOption, chaptersOption, changesOption, commentsOption, cardsOption,
+                        iterationsOption, outputOption, checksOption, benchmarksOption });
+    parser.process(application);
+
+    const auto scenesCount = parser.value(scenesOption).toInt();
+    const auto chaptersCount = parser.value(chaptersOption).toInt();
+    const auto changesCount = parser.value(changesOption).toInt();
+    const auto commentsCount = parser.value(commentsOption).toInt();
+    const auto cardsCount = parser.value(cardsOption).toInt();
+    BenchmarkRunner runner(parser.value(iterationsOption).toInt());
+    runner.setParameter("scenes", scenesCount);
+    runner.setParameter("chapters", chaptersCount);
+    runner.setParameter("changes", changesCount);
+    runner.setParameter("comments", commentsCount);
+    runner.setParameter("cards", cardsCount);
+
+    QTemporaryDir workingDir;
+    if (!workingDir.isValid()) {
+        std::cerr << "Can't create temporary folder for benchmarks" << std::endl;
+        return 1;
+    }
 
-    TextField w;
-    w.setBackgroundColor(Qt::white);
-    w.setTextColor(Qt::black);
-    w.setLabel("Label");
-    w.resize(400, 110);
-    w.setCustomMargins({ 20, 20, 20, 20 });
-    w.setCompleterActive(true);
-    w.completer()->setModel(new QStringListModel({ "One", "Two", "Three" }));
-    w.show();
+    //
+    // Проверки корректности выполняются до замеров, чтобы не замерять неверно работающий код
+    //
+    if (!parser.isSet(benchmarksOption)) {
+        CheckRunner checks;
+        Checks::runTextChecks(checks);
+        Checks::runModelChecks(checks);
+        Checks::runStorageChecks(checks);
+        if (checks.failedChecksCount() > 0) {
+            std::cerr << checks.failedChecksCount() << " checks failed" << std::endl;
+            return 1;
+        }
+    }
+    if (parser.isSet(checksOption)) {
+        return 0;
+    }
 
-    //    QObject::connect(&w, &CompletableTextField::textChanged, &w, [&w] {
-    //        w.complete(new QStringListModel({ "One", "Two", "Three" }), w.text());
-    //    });
+    measureTextCounters(runner, chaptersCount);
+    measurePatches(runner, 100);
+    measureScreenplay(runner, scenesCount, commentsCount, workingDir.path());
+    measureNovel(runner, chaptersCount);
+    measureComicBook(runner, scenesCount);
+    measureCardsBoard(runner, cardsCount);
+    measureJournal(runner, changesCount, workingDir.path());
+
+    const auto results = runner.results().toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << "Can't open output file " << qPrintable(output.fileName()) << std::endl;
+            return 1;
+        }
+        output.write(results);
+    } else {
+        std::cout << results.constData() << std::endl;
+    }
 
-    return a.exec();
+    return 0;
 }
@@ -0,0 +1,1897 @@
+#include "check_runner.h"
+#include "checks.h"
+#include "synthetic_documents.h"
+#include "synthetic_projects.h"
+
+#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/export/screenplay/screenplay_docx_exporter.h>
+#include <business_layer/export/screenplay/screenplay_export_options.h>
+#include <business_layer/import/novel/novel_markdown_importer.h>
+#include <business_layer/model/comic_book/text/comic_book_text_model_page_item.h>
+#include <business_layer/model/comic_book/text/comic_book_text_model_panel_item.h>
+#include <business_layer/model/screenplay/text/screenplay_breakdown_index.h>
+#include <business_layer/model/screenplay/text/screenplay_text_block_parser.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model_scene_item.h>
+#include <business_layer/model/text/text_model_folder_item.h>
+#include <business_layer/model/text/text_model_group_item.h>
+#include <business_layer/model/text/text_model_mime_data.h>
+#include <business_layer/model/text/text_model_name_replacement.h>
+#include <business_layer/model/text/text_model_structure_proxy_model.h>
+#include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/reports/screenplay/screenplay_breakdown_report.h>
+#include <business_layer/templates/screenplay_template.h>
+#include <business_layer/templates/templates_facade.h>
+#include <ui/modules/cards/cards_graphics_view.h>
+#include <ui/modules/cards/cards_layout.h>
+#include <ui/modules/comments/comments_model.h>
+#include <utils/helpers/text_helper.h>
+
+#include <qtzip/QtZipReader>
+#include <qtzip/QtZipWriter>
+
+#include <QColor>
+#include <QFile>
+#include <QMap>
+#include <QMimeData>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSortFilterProxyModel>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+
+using namespace BusinessLayer;
+
+
+namespace {
+
+/**
+ * @brief Эталонный поиск реплик персонажа обходом всей модели в глубину
+ */
+QVector<QModelIndex> referenceCharacterDialogues(TextModel* _model, const QString& _name)
+{
+    QString lastCharacter;
+    QVector<QModelIndex> dialogues;
+    std::function<void(const QModelIndex&)> findDialogues;
+    findDialogues = [_model, &_name, &lastCharacter, &dialogues,
+                     &findDialogues](const QModelIndex& _parent) {
+        for (int row = 0; row < _model->rowCount(_parent); ++row) {
+            const auto itemIndex = _model->index(row, 0, _parent);
+            const auto item = _model->itemForIndex(itemIndex);
+            if (item->type() == TextModelItemType::Text) {
+                const auto textItem = static_cast<TextModelTextItem*>(item);
+                switch (textItem->paragraphType()) {
+                case TextParagraphType::Character: {
+                    lastCharacter = ScreenplayCharacterParser::name(textItem->text());
+                    break;
+                }
+
+                case TextParagraphType::Parenthetical: {
+                    break;
+                }
+
+                case TextParagraphType::Dialogue:
+                case TextParagraphType::Lyrics: {
+                    if (lastCharacter == _name) {
+                        dialogues.append(itemIndex);
+                    }
+                    break;
+                }
+
+                default: {
+                    lastCharacter.clear();
+                    break;
+                }
+                }
+            }
+            findDialogues(itemIndex);
+        }
+    };
+    findDialogues({});
+    return dialogues;
+}
+
+/**
+ * @brief Сверить индекс реплик персонажей с эталонным обходом модели до и после правок текста
+ */
+void checkCharacterDialogues(CheckRunner& _runner, int _scenesCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+    const QString newCharacter = "BENCHMARK CHARACTER";
+
+    auto check = [textModel, &newCharacter, &_runner](const char* _stage) {
+        auto characters = textModel->findCharactersFromText();
+        characters.insert(newCharacter);
+        characters.insert(QString());
+        for (const auto& character : std::as_const(characters)) {
+            const auto reference = referenceCharacterDialogues(textModel, character);
+            if (textModel->characterDialogues(character) == reference
+                && textModel->characterDialoguesCount(character) == reference.size()) {
+                continue;
+            }
+
+            _runner.mismatch() << _stage << " for \"" << qPrintable(character) << "\": "
+                               << textModel->characterDialoguesCount(character) << " vs "
+                               << reference.size() << std::endl;
+        }
+    };
+    auto findTextItem = [textModel](TextParagraphType _type, int _skip) {
+        std::function<TextModelTextItem*(TextModelItem*)> find;
+        find = [_type, &_skip, &find](TextModelItem* _item) -> TextModelTextItem* {
+            for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+                const auto childItem = _item->childAt(childIndex);
+                if (childItem->type() == TextModelItemType::Text) {
+                    const auto textItem = static_cast<TextModelTextItem*>(childItem);
+                    if (textItem->paragraphType() == _type && _skip-- == 0) {
+                        return textItem;
+                    }
+                } else if (const auto textItem = find(childItem)) {
+                    return textItem;
+                }
+            }
+            return nullptr;
+        };
+        return find(textModel->itemForIndex({}));
+    };
+
+    check("after loading");
+
+    if (auto character = findTextItem(TextParagraphType::Character, 3)) {
+        character->setText(newCharacter);
+        textModel->updateItem(character);
+        check("after renaming a character");
+    }
+
+    if (auto dialogue = findTextItem(TextParagraphType::Dialogue, 5)) {
+        dialogue->setParagraphType(TextParagraphType::Action);
+        textModel->updateItem(dialogue);
+        check("after turning a dialogue into an action");
+    }
+
+    if (auto parenthetical = findTextItem(TextParagraphType::Parenthetical, 0)) {
+        parenthetical->setParagraphType(TextParagraphType::Action);
+        textModel->updateItem(parenthetical);
+        check("after turning a parenthetical into an action");
+    }
+
+    if (auto character = findTextItem(TextParagraphType::Character, 7)) {
+        textModel->removeItem(character);
+        check("after removing a character");
+    }
+
+    if (auto action = findTextItem(TextParagraphType::Action, 10)) {
+        auto character = textModel->createTextItem();
+        character->setParagraphType(TextParagraphType::Character);
+        character->setText(newCharacter);
+        auto dialogue = textModel->createTextItem();
+        dialogue->setParagraphType(TextParagraphType::Dialogue);
+        dialogue->setText("Inserted dialogue");
+        textModel->insertItems({ character, dialogue }, action);
+        check("after inserting a dialogue");
+    }
+
+    if (auto action = findTextItem(TextParagraphType::Action, 20)) {
+        textModel->removeItem(action->parent());
+        check("after removing a scene");
+    }
+}
+
+/**
+ * @brief Проверить, что блоки, которые не отображаются в поэпизоднике, скрыты в документе, в том
+ *        числе вставленные в модель уже после загрузки документа
+ */
+void checkTreatmentDocument(CheckRunner& _runner, int _scenesCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+
+    ScreenplayTextDocument document;
+    document.setTreatmentDocument(true);
+    document.setCorrectionOptions(false, false);
+    document.setModel(textModel);
+    const auto visibleBlocksTypes = document.visibleBlocksTypes();
+
+    auto checkBlock = [&visibleBlocksTypes, &_runner](const QTextBlock& _block,
+                                                      const char* _stage) {
+        const auto blockType = TextBlockStyle::forBlock(_block);
+        const bool isVisible = visibleBlocksTypes.contains(blockType);
+        if (_block.isVisible() == isVisible
+            && (isVisible
+                || (qFuzzyIsNull(_block.blockFormat().topMargin())
+                    && qFuzzyIsNull(_block.blockFormat().bottomMargin())))) {
+            return;
+        }
+
+        _runner.mismatch() << "block " << _block.blockNumber() << " of type "
+                           << qPrintable(toString(blockType)) << " is wrongly "
+                           << (_block.isVisible() ? "visible " : "hidden ") << _stage
+                           << std::endl;
+    };
+
+    QTextBlock sceneHeadingBlock;
+    for (auto block = document.begin(); block != document.end(); block = block.next()) {
+        checkBlock(block, "after loading");
+        if (!sceneHeadingBlock.isValid()
+            && TextBlockStyle::forBlock(block) == TextParagraphType::SceneHeading) {
+            sceneHeadingBlock = block;
+        }
+    }
+
+    //
+    // Блок, вставленный в модель, должен оказаться скрытым сразу, не дожидаясь корректора
+    //
+    if (sceneHeadingBlock.isValid()) {
+        auto action = textModel->createTextItem();
+        action->setParagraphType(TextParagraphType::Action);
+        action->setText("Inserted action");
+        const auto sceneHeading = textModel->itemForIndex(document.itemIndex(sceneHeadingBlock));
+        textModel->insertItem(action, sceneHeading);
+        const auto position = document.itemStartPosition(textModel->indexForItem(action));
+        if (position < 0) {
+            _runner.mismatch() << "inserted action is missing in the document" << std::endl;
+        } else {
+            checkBlock(document.findBlock(position), "after inserting an action");
+        }
+    }
+
+    document.setModel(nullptr);
+}
+
+/**
+ * @brief Проверить замену имени в текстах и в модели сценария
+ */
+void checkNameReplacement(CheckRunner& _runner, int _scenesCount)
+{
+    auto replaced = [](bool (TextModelNameReplacement::*_replace)(QString&) const,
+                       const TextModelNameReplacement& _replacement, QString _text) {
+        (_replacement.*_replace)(_text);
+        return _text;
+    };
+    const auto replaceMentions = &TextModelNameReplacement::replaceMentions;
+    const auto replaceInList = &TextModelNameReplacement::replaceInList;
+    const auto replaceFirst = &TextModelNameReplacement::replaceFirst;
+
+    const TextModelNameReplacement anna("Anna", "Bob");
+    _runner.verify("mentions in every case",
+                   replaced(replaceMentions, anna, "Anna met ANNA and anna.")
+                       == "Bob met BOB and Bob.");
+    _runner.verify("mentions as a part of other words",
+                   replaced(replaceMentions, anna, "ANNABELLE and Joanna")
+                       == "ANNABELLE and Joanna");
+    _runner.verify("name at the end of a list",
+                   replaced(replaceInList, anna, "ANNABELLE, ANNA") == "ANNABELLE, Bob");
+    _runner.verify("name in a list after a longer name",
+                   replaced(replaceInList, anna, "JOANNA, ANNA, TOM") == "JOANNA, Bob, TOM");
+    _runner.verify("list without the name",
+                   replaced(replaceInList, anna, "JOANNA, ANNABELLE") == "JOANNA, ANNABELLE");
+    _runner.verify("first occurrence in a case variant",
+                   replaced(replaceFirst, anna, "anna (V.O.)") == "Bob (V.O.)");
+
+    const TextModelNameReplacement cyrillic(QString::fromUtf8("Анна"), QString::fromUtf8("Ольга"));
+    _runner.verify("mentions in a non-latin text",
+                   replaced(replaceMentions, cyrillic, QString::fromUtf8("Анна и Жанна, АННА"))
+                       == QString::fromUtf8("Ольга и Жанна, ОЛЬГА"));
+
+    const TextModelNameReplacement doctor("Dr. No", "Dr. Yes");
+    _runner.verify("name with regular expression symbols",
+                   replaced(replaceMentions, doctor, "DR. NO met Drx No") == "DR. YES met Drx No");
+
+    //
+    // Переименование в модели должно стать одним изменением документа
+    //
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+    auto characters = textModel->findCharactersFromText().values();
+    characters.removeAll(QString());
+    if (characters.isEmpty()) {
+        _runner.verify("characters in the synthetic screenplay", false);
+        return;
+    }
+    std::sort(characters.begin(), characters.end());
+
+    const auto oldName = characters.constFirst();
+    const QString newName = "RENAMED CHARACTER";
+    const auto dialoguesCount = textModel->characterDialoguesCount(oldName);
+    textModel->saveChanges();
+    const auto content = project.textDocument->content();
+    QVector<QPair<QByteArray, QByteArray>> changes;
+    QObject::connect(textModel, &TextModel::contentsChanged, textModel,
+                     [&changes](const QByteArray& _undo, const QByteArray& _redo) {
+                         changes.append({ _undo, _redo });
+                     });
+    textModel->updateCharacterName(TextModelNameReplacement(oldName, newName));
+    _runner.verify("single change of the document", changes.size() == 1);
+    _runner.verify("dialogues of the renamed character",
+                   textModel->characterDialoguesCount(oldName) == 0
+                       && textModel->characterDialoguesCount(newName) == dialoguesCount);
+    if (!changes.isEmpty()) {
+        textModel->undoChange(changes.constLast().first, changes.constLast().second);
+        _runner.verify("undo of the renaming in one step",
+                       project.textDocument->content() == content);
+    }
+}
+
+/**
+ * @brief Прочитать записи архива как есть, без распаковки
+ * @return Записи архива <имя, заголовок без даты изменения вместе со сжатыми данными>
+ */
+QMap<QString, QByteArray> rawZipEntries(const QString& _zipPath)
+{
+    QFile zipFile(_zipPath);
+    if (!zipFile.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    const auto zip = zipFile.readAll();
+    auto readNumber = [&zip](int _position, int _size) {
+        quint32 value = 0;
+        for (int byte = _size - 1; byte >= 0; --byte) {
+            value = (value << 8) | static_cast<uchar>(zip.at(_position + byte));
+        }
+        return static_cast<int>(value);
+    };
+
+    //
+    // Локальный заголовок: сигнатура, версия, флаги, метод сжатия, время и дата изменения,
+    // контрольная сумма, размеры, длины имени и дополнительного поля
+    //
+    const int kLocalHeaderSize = 30;
+    QMap<QString, QByteArray> entries;
+    for (int position = 0; position + kLocalHeaderSize <= zip.size()
+         && readNumber(position, 4) == 0x04034b50;) {
+        const auto compressedSize = readNumber(position + 18, 4);
+        const auto nameLength = readNumber(position + 26, 2);
+        const auto extraLength = readNumber(position + 28, 2);
+        const auto entrySize = kLocalHeaderSize + nameLength + extraLength + compressedSize;
+        if (position + entrySize > zip.size()) {
+            break;
+        }
+
+        const auto name = QString::fromUtf8(zip.mid(position + kLocalHeaderSize, nameLength));
+        entries.insert(name, zip.mid(position + 4, 6) + zip.mid(position + 14, entrySize - 14));
+        position += entrySize;
+    }
+    return entries;
+}
+
+/**
+ * @brief Привести xml к каноническому виду, чтобы сравнивать содержание, а не запись
+ */
+QByteArray canonicalXml(const QByteArray& _xml)
+{
+    QByteArray result;
+    QXmlStreamReader reader(_xml);
+    QXmlStreamWriter writer(&result);
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.hasError()) {
+            return {};
+        }
+        writer.writeCurrentToken(reader);
+    }
+    return result;
+}
+
+/**
+ * @brief Сверить запись файла в архив по частям с записью целиком, а DOCX сценария, документ
+ *        которого сжимается порциями, с DOCX, документ которого добавлен в архив целиком
+ */
+void checkDocxExport(CheckRunner& _runner, int _scenesCount)
+{
+    //
+    // Файл, записанный по частям, должен попасть в архив теми же байтами, что и записанный
+    // целиком
+    //
+    const QString streamedPath = _runner.workingDir() + "/streamed.zip";
+    const QString addedPath = _runner.workingDir() + "/added.zip";
+    for (const auto size : { 0, 1, 4093, 300000 }) {
+        QByteArray data;
+        for (int index = 0; data.size() < size; ++index) {
+            data.append(QByteArray::number(index * 7919 % 10007));
+            data.append(index % 13 == 0 ? "\n" : " ");
+        }
+        data.truncate(size);
+        const auto nextData = data.left(100);
+
+        {
+            QtZipWriter zip(streamedPath);
+            zip.beginFile("part.xml");
+            const int partSize = 4093;
+            for (int position = 0; position < data.size(); position += partSize) {
+                zip.writeToFile(data.mid(position, partSize));
+            }
+            zip.endFile();
+            zip.addFile("next.xml", nextData);
+            zip.close();
+        }
+        {
+            QtZipWriter zip(addedPath);
+            zip.addFile("part.xml", data);
+            zip.addFile("next.xml", nextData);
+            zip.close();
+        }
+
+        QtZipReader streamed(streamedPath);
+        const auto streamedEntries = rawZipEntries(streamedPath);
+        const auto addedEntries = rawZipEntries(addedPath);
+        if (streamed.fileData("part.xml") == data && streamed.fileData("next.xml") == nextData
+            && streamedEntries.size() == 2 && streamedEntries == addedEntries) {
+            continue;
+        }
+
+        _runner.mismatch() << "streamed zip file of " << size
+                           << " bytes differs from the added one" << std::endl;
+    }
+
+    //
+    // Документ, сжимаемый в архив порциями, должен совпадать с формируемым целиком
+    //
+    ScreenplayProject project(_scenesCount);
+    ScreenplayExportOptions exportOptions;
+    exportOptions.templateId = TemplatesFacade::screenplayTemplate().id();
+    exportOptions.filePath = _runner.workingDir() + "/check.docx";
+    ScreenplayDocxExporter().exportTo(project.textModel.data(), exportOptions);
+    auto wholeExportOptions = exportOptions;
+    wholeExportOptions.filePath = _runner.workingDir() + "/check_whole.docx";
+    ScreenplayDocxExporter wholeExporter;
+    wholeExporter.setDocumentStreamed(false);
+    wholeExporter.exportTo(project.textModel.data(), wholeExportOptions);
+
+    const QtZipReader streamedDocx(exportOptions.filePath);
+    const QtZipReader wholeDocx(wholeExportOptions.filePath);
+    const auto documentXml = streamedDocx.fileData("word/document.xml");
+    const auto canonicalDocumentXml = canonicalXml(documentXml);
+    if (canonicalDocumentXml.isEmpty()
+        || canonicalDocumentXml != canonicalXml(wholeDocx.fileData("word/document.xml"))) {
+        _runner.mismatch() << "streamed docx document differs from the whole one" << std::endl;
+    }
+    const auto filesNames = wholeDocx.fileList();
+    if (streamedDocx.fileList() != filesNames) {
+        _runner.mismatch() << "streamed docx has other files than the whole one" << std::endl;
+    }
+    for (const auto& fileName : filesNames) {
+        if (streamedDocx.fileData(fileName) != wholeDocx.fileData(fileName)) {
+            _runner.mismatch() << "streamed docx file " << qPrintable(fileName)
+                               << " differs from the whole one" << std::endl;
+        }
+    }
+
+    QXmlStreamReader reader(documentXml);
+    int paragraphsCount = 0;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement
+            && reader.qualifiedName() == QLatin1String("w:p")) {
+            ++paragraphsCount;
+        }
+    }
+    if (reader.hasError() || paragraphsCount < _scenesCount) {
+        _runner.mismatch() << "exported docx document is broken: "
+                           << qPrintable(reader.errorString()) << ", " << paragraphsCount
+                           << " paragraphs" << std::endl;
+    }
+}
+
+/**
+ * @brief Сводка по ресурсам разработки и их категориям
+ * @param _isReference - посчитать эталонную сводку полным обходом, а не взять её из индекса
+ */
+QStringList breakdownTotals(ScreenplayTextModel* _model, bool _isReference)
+{
+    const auto scenes = SyntheticProjects::screenplayScenes(_model);
+    QHash<const TextModelItem*, int> scenesNumbers;
+    for (int sceneIndex = 0; sceneIndex < scenes.size(); ++sceneIndex) {
+        scenesNumbers.insert(scenes.at(sceneIndex), sceneIndex);
+    }
+
+    const auto resources = _model->dictionariesModel()->resources();
+    const auto categories = _model->dictionariesModel()->resourceCategories();
+    QStringList totals;
+    if (_isReference) {
+        QHash<QUuid, QUuid> resourcesCategories;
+        for (const auto& resource : resources) {
+            resourcesCategories.insert(resource.uuid, resource.categoryUuid);
+        }
+        QHash<QUuid, QStringList> resourcesScenes;
+        QHash<QUuid, int> resourcesQty;
+        QHash<QUuid, QSet<QUuid>> categoriesResources;
+        QHash<QUuid, QSet<int>> categoriesScenes;
+        QHash<QUuid, int> categoriesQty;
+        for (int sceneIndex = 0; sceneIndex < scenes.size(); ++sceneIndex) {
+            for (const auto& resource : scenes.at(sceneIndex)->resources()) {
+                resourcesScenes[resource.uuid].append(QString::number(sceneIndex));
+                resourcesQty[resource.uuid] += resource.qty;
+                const auto categoryUuid = resourcesCategories.value(resource.uuid);
+                categoriesResources[categoryUuid].insert(resource.uuid);
+                categoriesScenes[categoryUuid].insert(sceneIndex);
+                categoriesQty[categoryUuid] += resource.qty;
+            }
+        }
+        for (const auto& resource : resources) {
+            const auto resourceScenes = resourcesScenes.value(resource.uuid);
+            totals.append(QString("%1: scenes %2, qty %3")
+                              .arg(resource.name, resourceScenes.join(' '))
+                              .arg(resourcesQty.value(resource.uuid)));
+        }
+        for (const auto& category : categories) {
+            totals.append(QString("%1: %2 resources, %3 scenes, qty %4")
+                              .arg(category.name)
+                              .arg(categoriesResources.value(category.uuid).size())
+                              .arg(categoriesScenes.value(category.uuid).size())
+                              .arg(categoriesQty.value(category.uuid)));
+        }
+        return totals;
+    }
+
+    const auto breakdownIndex = _model->breakdownIndex();
+    for (const auto& resource : resources) {
+        QStringList resourceScenes;
+        for (const auto& sceneIndex : breakdownIndex->resourceScenes(resource.uuid)) {
+            resourceScenes.append(
+                QString::number(scenesNumbers.value(_model->itemForIndex(sceneIndex), -1)));
+        }
+        totals.append(QString("%1: scenes %2, qty %3")
+                          .arg(resource.name, resourceScenes.join(' '))
+                          .arg(breakdownIndex->resourceTotals(resource.uuid).qty));
+    }
+    for (const auto& category : categories) {
+        const auto categoryTotals = breakdownIndex->categoryTotals(category.uuid);
+        totals.append(QString("%1: %2 resources, %3 scenes, qty %4")
+                          .arg(category.name)
+                          .arg(categoryTotals.resourcesCount)
+                          .arg(categoryTotals.scenesCount)
+                          .arg(categoryTotals.qty));
+    }
+    return totals;
+}
+
+/**
+ * @brief Сверить индекс ресурсов разработки с эталонным полным обходом после правок сценария и
+ *        проверить выгрузку отчёта по разработке в XLSX
+ */
+void checkBreakdown(CheckRunner& _runner, int _scenesCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+
+    auto check = [textModel, &_runner](const char* _stage) {
+        const auto totals = breakdownTotals(textModel, false);
+        const auto reference = breakdownTotals(textModel, true);
+        if (totals == reference) {
+            return;
+        }
+
+        int index = 0;
+        while (index < totals.size() && index < reference.size()
+               && totals.at(index) == reference.at(index)) {
+            ++index;
+        }
+        _runner.mismatch() << _stage << ": " << qPrintable(totals.value(index)) << " vs "
+                           << qPrintable(reference.value(index)) << std::endl;
+    };
+
+    //
+    // Строим индекс до разметки, чтобы все ресурсы попадали в него по ходу правок
+    //
+    check("before tagging");
+    project.tagBreakdownResources();
+    check("after tagging scenes");
+
+    const auto resources = project.dictionariesModel->resources();
+    auto scenes = SyntheticProjects::screenplayScenes(textModel);
+    scenes[1]->storeResource(resources.at(0).uuid, 42, "Changed");
+    textModel->updateItem(scenes[1]);
+    scenes[3]->removeResource(scenes[3]->resources().constFirst().uuid);
+    textModel->updateItem(scenes[3]);
+    check("after changing scene resources");
+
+    textModel->removeItem(scenes[5]);
+    check("after removing a scene");
+
+    auto newScene = static_cast<ScreenplayTextModelSceneItem*>(
+        textModel->createGroupItem(TextGroupType::Scene));
+    auto newSceneHeading = textModel->createTextItem();
+    newSceneHeading->setParagraphType(TextParagraphType::SceneHeading);
+    newSceneHeading->setText("INT. NEW PLACE - DAY");
+    newScene->appendItem(newSceneHeading);
+    newScene->storeResource(resources.at(1).uuid, 2, {});
+    newScene->storeResource(resources.at(4).uuid, 1, {});
+    textModel->insertItem(newScene, scenes[2]);
+    check("after inserting a tagged scene");
+
+    project.dictionariesModel->setResourceCategory(
+        resources.at(0).uuid, project.dictionariesModel->resourceCategories().constLast().uuid);
+    check("after moving a resource to another category");
+
+    //
+    // Отчёт содержит по листу на каждую сцену с ресурсами и выгружается в XLSX на два листа
+    //
+    ScreenplayBreakdownReport report;
+    report.build(textModel);
+    int taggedScenesCount = 0;
+    for (const auto scene : SyntheticProjects::screenplayScenes(textModel)) {
+        if (!scene->resources().isEmpty()) {
+            ++taggedScenesCount;
+        }
+    }
+    if (report.scenesModel()->rowCount() != taggedScenesCount
+        || report.categoriesModel()->rowCount()
+            != project.dictionariesModel->resourceCategories().size()) {
+        _runner.mismatch() << "report has " << report.scenesModel()->rowCount()
+                           << " scenes and " << report.categoriesModel()->rowCount()
+                           << " categories" << std::endl;
+    }
+    const auto xlsxPath = _runner.workingDir() + "/breakdown.xlsx";
+    report.saveToFile(xlsxPath);
+    QtZipReader xlsx(xlsxPath);
+    if (xlsx.fileData("xl/worksheets/sheet1.xml").isEmpty()
+        || xlsx.fileData("xl/worksheets/sheet2.xml").isEmpty()) {
+        _runner.mismatch() << "exported xlsx has no sheets of scenes and categories"
+                           << std::endl;
+    }
+}
+
+/**
+ * @brief Сверить раскладку доски карточек и перемещение карточек по ней
+ */
+void checkCardsBoard(CheckRunner& _runner, int _scenesCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+    const auto scenes = SyntheticProjects::screenplayScenes(textModel);
+
+    //
+    // Раскладка с заданными размерами: сцены заполняют строки по четыре карточки, а папка
+    // занимает отдельную строку, и её сцены сдвинуты на один отступ
+    //
+    Ui::CardsLayout layout;
+    layout.setModel(textModel);
+    layout.setCardSize({ 100, 50 });
+    layout.setFolderHeight(20);
+    layout.setSpacing(10);
+    layout.setColumnsCount(4);
+    auto cardRect = [&layout](TextModelItem* _item) {
+        const auto index = layout.indexOf(_item);
+        return index == -1 ? QRectF() : layout.cards().at(index).rect;
+    };
+    layout.relayout();
+    _runner.verify("cards count", layout.cards().size() == scenes.size());
+    _runner.verify("first row",
+                   cardRect(scenes[0]) == QRectF(10, 10, 100, 50)
+                       && cardRect(scenes[3]) == QRectF(340, 10, 100, 50));
+    _runner.verify("second row", cardRect(scenes[5]) == QRectF(120, 70, 100, 50));
+    _runner.verify("board size", layout.size().width() == 450);
+
+    auto folder = textModel->createFolderItem(TextFolderType::Sequence);
+    auto folderHeading = textModel->createTextItem();
+    folderHeading->setParagraphType(TextParagraphType::SequenceHeading);
+    folderHeading->setText("SEQUENCE");
+    folder->appendItem(folderHeading);
+    auto folderFooter = textModel->createTextItem();
+    folderFooter->setParagraphType(TextParagraphType::SequenceFooter);
+    folder->appendItem(folderFooter);
+    textModel->insertItem(folder, scenes[4]);
+    layout.relayout();
+    _runner.verify("folder row", cardRect(folder) == QRectF(10, 130, 430, 20));
+    _runner.verify("scene after folder", cardRect(scenes[5]) == QRectF(10, 160, 100, 50));
+
+    //
+    // Виртуализация: в видимую область попадают ровно те карточки, которые с ней пересекаются
+    //
+    const QRectF visibleRect(0, 100, 500, 300);
+    QVector<int> visibleCards;
+    for (int index = 0; index < layout.cards().size(); ++index) {
+        if (layout.cards().at(index).rect.intersects(visibleRect)) {
+            visibleCards.append(index);
+        }
+    }
+    _runner.verify("cards in the visible area", layout.cardsIn(visibleRect) == visibleCards);
+    _runner.verify("card at a point",
+                   layout.cardAt({ 130, 20 }) == layout.indexOf(scenes[1])
+                       && layout.cardAt({ 115, 20 }) == -1);
+
+    //
+    // Перетаскивание карточки на доске должно стать одним перемещением элемента в модели
+    //
+    Ui::CardsGraphicsView view;
+    view.resize(800, 600);
+    view.setModel(textModel);
+    int structureChangesCount = 0;
+    int insertionsCount = 0;
+    int removalsCount = 0;
+    QObject::connect(textModel, &TextModel::rowsAboutToBeChanged,
+                     [&structureChangesCount] { ++structureChangesCount; });
+    QObject::connect(textModel, &TextModel::rowsInserted,
+                     [&insertionsCount] { ++insertionsCount; });
+    QObject::connect(textModel, &TextModel::rowsRemoved, [&removalsCount] { ++removalsCount; });
+    auto viewCardRect = [&view](TextModelItem* _item) {
+        return view.cardsLayout().cards().at(view.cardsLayout().indexOf(_item)).rect;
+    };
+
+    const auto folderRect = viewCardRect(folder);
+    _runner.verify("moving a card into a folder",
+                   view.moveCard(textModel->indexForItem(scenes[5]),
+                                 { folderRect.center().x(), folderRect.bottom() - 1 }));
+    _runner.verify("moved card is inside the folder",
+                   scenes[5]->parent() == folder && folder->rowOfChild(scenes[5]) == 1);
+    _runner.verify("single structural move",
+                   structureChangesCount == 1 && insertionsCount == 1 && removalsCount == 1);
+    _runner.verify("moved card position on the board",
+                   viewCardRect(scenes[5]).left() > viewCardRect(scenes[6]).left()
+                       && viewCardRect(scenes[5]).top() < viewCardRect(scenes[6]).top());
+
+    const auto thirdRect = viewCardRect(scenes[2]);
+    _runner.verify("moving a card after another",
+                   view.moveCard(textModel->indexForItem(scenes[0]),
+                                 { thirdRect.right() - 1, thirdRect.center().y() }));
+    const auto rootItem = textModel->itemForIndex({});
+    _runner.verify("order after moving",
+                   rootItem->rowOfChild(scenes[0]) == rootItem->rowOfChild(scenes[2]) + 1
+                       && rootItem->rowOfChild(scenes[1]) < rootItem->rowOfChild(scenes[2]));
+
+    //
+    // Бросание карточки туда, где она и так находится, не должно менять модель
+    //
+    const auto structureChangesBefore = structureChangesCount;
+    const auto predecessorRect = viewCardRect(scenes[2]);
+    _runner.verify("card isn't moved after its predecessor",
+                   !view.moveCard(textModel->indexForItem(scenes[0]),
+                                  { predecessorRect.right() - 1, predecessorRect.center().y() }));
+    const auto currentFolderRect = viewCardRect(folder);
+    _runner.verify("card isn't moved to the start of its own folder",
+                   !view.moveCard(textModel->indexForItem(scenes[5]),
+                                  { currentFolderRect.center().x(),
+                                    currentFolderRect.bottom() - 1 }));
+    _runner.verify("no structural changes for dropping a card in place",
+                   structureChangesCount == structureChangesBefore
+                       && rootItem->rowOfChild(scenes[0]) == rootItem->rowOfChild(scenes[2]) + 1
+                       && folder->rowOfChild(scenes[5]) == 1);
+    _runner.verify("card can't be moved into itself",
+                   !view.moveCard(textModel->indexForItem(folder),
+                                  { folderRect.center().x(), folderRect.bottom() - 1 }));
+
+    //
+    // Отрисовываются только видимые карточки, а правка сцены сбрасывает лишь её картинку
+    //
+    view.viewport()->grab();
+    const auto cachedCardsCount = view.cachedCardsCount();
+    const auto visibleCardsIndexes = view.cardsLayout().cardsIn(
+        view.mapToScene(view.viewport()->rect().adjusted(-2, -2, 2, 2)).boundingRect());
+    _runner.verify("only visible cards are rendered",
+                   cachedCardsCount > 0 && cachedCardsCount <= visibleCardsIndexes.size());
+    TextModelItem* visibleScene = nullptr;
+    for (const auto index : visibleCardsIndexes) {
+        const auto& card = view.cardsLayout().cards().at(index);
+        if (!card.isFolder && card.item->parent() == rootItem) {
+            visibleScene = card.item;
+            break;
+        }
+    }
+    if (visibleScene == nullptr) {
+        _runner.verify("visible scene on the board", false);
+        return;
+    }
+    auto sceneHeading = static_cast<TextModelTextItem*>(visibleScene->childAt(0));
+    sceneHeading->setText(sceneHeading->text() + " EDITED");
+    textModel->updateItem(sceneHeading);
+    _runner.verify("edited card is invalidated", view.cachedCardsCount() == cachedCardsCount - 1);
+}
+
+/**
+ * @brief Номера страниц, панелей и реплик комикса в порядке обхода модели
+ * @param _isReference - посчитать эталонные номера полным обходом, а не взять их из элементов
+ */
+QStringList comicBookNumbers(TextModel* _model, bool _isReference)
+{
+    auto headingWord = [](const TextModelItem* _group, TextParagraphType _type) {
+        for (int childIndex = 0; childIndex < _group->childCount(); ++childIndex) {
+            const auto child = _group->childAt(childIndex);
+            if (child->type() != TextModelItemType::Text) {
+                continue;
+            }
+
+            const auto textItem = static_cast<const TextModelTextItem*>(child);
+            if (textItem->paragraphType() == _type) {
+                return TextHelper::smartToUpper(textItem->text()).split(' ').constFirst();
+            }
+        }
+        return QString();
+    };
+    auto numberText = [](int _from, int _count) {
+        return _count > 1 ? QString("%1-%2").arg(_from).arg(_from + _count - 1)
+                          : QString::number(_from);
+    };
+
+    int pageNumber = 1;
+    int panelNumber = 1;
+    int dialogueNumber = 0;
+    int panelsCount = 0;
+    QStringList numbers;
+    std::function<void(const TextModelItem*)> collectNumbers;
+    collectNumbers = [_isReference, &headingWord, &numberText, &pageNumber, &panelNumber,
+                      &dialogueNumber, &panelsCount, &numbers,
+                      &collectNumbers](const TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            switch (child->type()) {
+            case TextModelItemType::Folder: {
+                collectNumbers(child);
+                break;
+            }
+
+            case TextModelItemType::Group: {
+                if (static_cast<const TextModelGroupItem*>(child)->groupType()
+                    == TextGroupType::Page) {
+                    panelNumber = 1;
+                    dialogueNumber = 0;
+                    panelsCount = 0;
+                    collectNumbers(child);
+
+                    const auto pageItem = static_cast<const ComicBookTextModelPageItem*>(child);
+                    const auto pageCount
+                        = headingWord(child, TextParagraphType::PageHeading) == "PAGES" ? 2 : 1;
+                    if (_isReference) {
+                        numbers.append(QString("page %1, %2 panels")
+                                           .arg(numberText(pageNumber, pageCount))
+                                           .arg(panelsCount));
+                    } else {
+                        const auto number = pageItem->pageNumber();
+                        numbers.append(QString("page %1, %2 panels")
+                                           .arg(number.has_value() ? number->text : "?")
+                                           .arg(pageItem->panelsCount()));
+                    }
+                    pageNumber += pageCount;
+                } else {
+                    collectNumbers(child);
+
+                    const auto panelItem = static_cast<const ComicBookTextModelPanelItem*>(child);
+                    const auto panelCount
+                        = headingWord(child, TextParagraphType::PanelHeading) == "PANELS" ? 2 : 1;
+                    const auto number = panelItem->panelNumber();
+                    numbers.append(
+                        QString("panel %1")
+                            .arg(_isReference ? numberText(panelNumber, panelCount)
+                                              : (number.has_value() ? number->text : "?")));
+                    panelNumber += panelCount;
+                    panelsCount += panelCount;
+                }
+                break;
+            }
+
+            case TextModelItemType::Text: {
+                const auto textItem = static_cast<const TextModelTextItem*>(child);
+                if (textItem->isCorrection()) {
+                    break;
+                }
+
+                switch (textItem->paragraphType()) {
+                case TextParagraphType::Character: {
+                    ++dialogueNumber;
+                    Q_FALLTHROUGH();
+                }
+
+                case TextParagraphType::Dialogue:
+                case TextParagraphType::Lyrics: {
+                    const auto number = textItem->number();
+                    numbers.append(
+                        QString("dialogue %1")
+                            .arg(_isReference ? QString::number(dialogueNumber)
+                                              : (number.has_value() ? QString::number(number->value)
+                                                                    : "?")));
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+                }
+                break;
+            }
+
+            default: {
+                break;
+            }
+            }
+        }
+    };
+    collectNumbers(_model->itemForIndex({}));
+    return numbers;
+}
+
+/**
+ * @brief Сверить нумерацию комикса с эталонным полным пересчётом после правок текста
+ */
+void checkComicBookNumbering(CheckRunner& _runner, int _pagesCount)
+{
+    ComicBookProject project;
+    auto textModel = project.textModel.data();
+    for (int pageIndex = 0; pageIndex < _pagesCount; ++pageIndex) {
+        textModel->appendItem(
+            project.createPage(pageIndex % 5 == 4 ? "PAGES" : "PAGE", 1 + pageIndex % 3));
+    }
+
+    auto check = [textModel, &_runner](const char* _stage) {
+        const auto numbers = comicBookNumbers(textModel, false);
+        const auto reference = comicBookNumbers(textModel, true);
+        if (numbers == reference) {
+            return;
+        }
+
+        int index = 0;
+        while (index < numbers.size() && index < reference.size()
+               && numbers.at(index) == reference.at(index)) {
+            ++index;
+        }
+        _runner.mismatch() << _stage << " at " << index << ": "
+                           << qPrintable(numbers.value(index)) << " vs "
+                           << qPrintable(reference.value(index)) << std::endl;
+    };
+    auto page = [textModel](int _row) {
+        return textModel->itemForIndex(textModel->index(_row, 0));
+    };
+
+    check("after building");
+
+    textModel->insertItem(project.createPage("PAGES", 2), page(3));
+    check("after inserting a spread");
+
+    textModel->removeItem(page(5));
+    check("after removing a page");
+
+    textModel->insertItem(project.createPanel("PANELS"), page(1)->childAt(1));
+    check("after inserting a panel");
+
+    const auto panel = page(1)->childAt(1);
+    textModel->insertItems({ project.createText(TextParagraphType::Character, "HERO"),
+                             project.createText(TextParagraphType::Dialogue, "Inserted") },
+                           panel->childAt(0));
+    check("after inserting a dialogue");
+
+    textModel->removeItem(panel->childAt(4));
+    check("after removing a character");
+
+    //
+    // Изменение заголовка страницы не меняет строк модели, поэтому номера пересчитываются
+    // при следующей вставке
+    //
+    auto pageHeading = static_cast<TextModelTextItem*>(page(2)->childAt(0));
+    pageHeading->setText("PAGES");
+    textModel->updateItem(pageHeading);
+    textModel->appendItem(project.createPanel("PANEL"), page(textModel->rowCount() - 1));
+    check("after turning a page into a spread");
+
+    //
+    // Правка последней страницы не должна приводить к уведомлениям об изменении предыдущих
+    //
+    const auto lastPage = page(textModel->rowCount() - 1);
+    QSet<const TextModelItem*> changedPages;
+    const auto connection = QObject::connect(
+        textModel, &TextModel::dataChanged, [textModel, &changedPages](const QModelIndex& _index) {
+            const auto item = textModel->itemForIndex(_index);
+            if (item->type() == TextModelItemType::Group
+                && static_cast<const TextModelGroupItem*>(item)->groupType()
+                    == TextGroupType::Page) {
+                changedPages.insert(item);
+            }
+        });
+    textModel->appendItems({ project.createText(TextParagraphType::Character, "HERO"),
+                             project.createText(TextParagraphType::Dialogue, "Appended") },
+                           lastPage->childAt(lastPage->childCount() - 1));
+    QObject::disconnect(connection);
+    changedPages.remove(lastPage);
+    if (!changedPages.isEmpty()) {
+        _runner.mismatch() << "appending a dialogue to the last page updated "
+                           << changedPages.size() << " other pages" << std::endl;
+    }
+    check("after appending a dialogue to the last page");
+}
+
+/**
+ * @brief Сцены модели в порядке следования в документе
+ */
+QVector<TextModelGroupItem*> sceneItems(TextModel* _model)
+{
+    QVector<TextModelGroupItem*> scenes;
+    std::function<void(TextModelItem*)> collectScenes;
+    collectScenes = [&scenes, &collectScenes](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            if (child->type() == TextModelItemType::Folder) {
+                collectScenes(child);
+            } else if (child->type() == TextModelItemType::Group
+                       && static_cast<TextModelGroupItem*>(child)->groupType()
+                           == TextGroupType::Scene) {
+                scenes.append(static_cast<TextModelGroupItem*>(child));
+            }
+        }
+    };
+    collectScenes(_model->itemForIndex({}));
+    return scenes;
+}
+
+/**
+ * @brief Номера сцен и реплик в порядке обхода модели
+ */
+QStringList sceneAndDialogueNumbers(TextModel* _model)
+{
+    QStringList numbers;
+    std::function<void(const TextModelItem*)> collectNumbers;
+    collectNumbers = [&numbers, &collectNumbers](const TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            switch (child->type()) {
+            case TextModelItemType::Group: {
+                const auto number = static_cast<const TextModelGroupItem*>(child)->number();
+                numbers.append(number.has_value()
+                                   ? QString("scene %1%2%3%4")
+                                         .arg(number->followNumber, number->value,
+                                              number->isCustom ? " custom" : "",
+                                              number->isLocked ? " locked" : "")
+                                   : QString("scene without number"));
+                break;
+            }
+
+            case TextModelItemType::Text: {
+                //
+                // Номера есть только у реплик, а у блоков, которые перестали быть репликами,
+                // может остаться прежний номер, который больше нигде не используется
+                //
+                const auto textItem = static_cast<const TextModelTextItem*>(child);
+                if (textItem->paragraphType() != TextParagraphType::Character
+                    && textItem->paragraphType() != TextParagraphType::Dialogue
+                    && textItem->paragraphType() != TextParagraphType::Lyrics) {
+                    break;
+                }
+
+                const auto number = textItem->number();
+                numbers.append(QString("dialogue %1")
+                                   .arg(number.has_value() ? QString::number(number->value)
+                                                           : QString("without number")));
+                break;
+            }
+
+            default: {
+                break;
+            }
+            }
+            collectNumbers(child);
+        }
+    };
+    collectNumbers(_model->itemForIndex({}));
+    return numbers;
+}
+
+/**
+ * @brief Случайно править текст и после каждой правки сверять инкрементальную нумерацию сцен и
+ *        реплик с полной нумерацией того же текста, загруженного в новую модель
+ */
+template<typename ProjectType>
+void checkIncrementalNumbering(CheckRunner& _runner, int _scenesCount, int _mutationsCount)
+{
+    ProjectType project(_scenesCount);
+    auto textModel = project.textModel.data();
+
+    QRandomGenerator random(static_cast<quint32>(_scenesCount));
+    auto createText = [textModel](TextParagraphType _type, const QString& _text) {
+        auto textItem = textModel->createTextItem();
+        textItem->setParagraphType(_type);
+        textItem->setText(_text);
+        return textItem;
+    };
+    auto randomScene = [textModel, &random] {
+        const auto scenes = sceneItems(textModel);
+        return scenes.at(random.bounded(scenes.size()));
+    };
+    auto randomText = [&random](TextModelGroupItem* _scene) -> TextModelTextItem* {
+        QVector<TextModelTextItem*> textItems;
+        for (int childIndex = 1; childIndex < _scene->childCount(); ++childIndex) {
+            if (_scene->childAt(childIndex)->type() == TextModelItemType::Text) {
+                textItems.append(static_cast<TextModelTextItem*>(_scene->childAt(childIndex)));
+            }
+        }
+        return textItems.isEmpty() ? nullptr : textItems.at(random.bounded(textItems.size()));
+    };
+
+    //
+    // Кастомные и зафиксированные номера сцен есть только у сценария
+    //
+    constexpr bool isScreenplay = std::is_same_v<ProjectType, ScreenplayProject>;
+    bool isScenesNumbersLocked = false;
+    for (int mutationIndex = 0; mutationIndex < _mutationsCount; ++mutationIndex) {
+        const char* mutation = "";
+        switch (random.bounded(isScreenplay ? 6 : 5)) {
+        case 0: {
+            mutation = "inserting a scene";
+            auto scene = textModel->createGroupItem(TextGroupType::Scene);
+            scene->appendItem(createText(TextParagraphType::SceneHeading, "INT. INSERTED - DAY"));
+            scene->appendItem(createText(TextParagraphType::Action, "Inserted action"));
+            scene->appendItem(createText(TextParagraphType::Character, "HERO"));
+            scene->appendItem(createText(TextParagraphType::Dialogue, "Inserted dialogue"));
+            textModel->insertItem(scene, randomScene());
+            break;
+        }
+
+        case 1: {
+            mutation = "removing a scene";
+            if (sceneItems(textModel).size() > 2) {
+                textModel->removeItem(randomScene());
+            }
+            break;
+        }
+
+        case 2: {
+            mutation = "inserting a dialogue";
+            const auto scene = randomScene();
+            const auto textItem = randomText(scene);
+            textModel->insertItems({ createText(TextParagraphType::Character, "SIDEKICK"),
+                                     createText(TextParagraphType::Dialogue, "Inserted") },
+                                   textItem != nullptr ? textItem : scene->childAt(0));
+            break;
+        }
+
+        case 3: {
+            mutation = "removing a block";
+            if (const auto textItem = randomText(randomScene()); textItem != nullptr) {
+                textModel->removeItem(textItem);
+            }
+            break;
+        }
+
+        case 4: {
+            mutation = "changing a block type";
+            if (const auto textItem = randomText(randomScene()); textItem != nullptr) {
+                textItem->setParagraphType(
+                    textItem->paragraphType() == TextParagraphType::Character
+                        ? TextParagraphType::Action
+                        : TextParagraphType::Character);
+                textModel->updateItem(textItem);
+            }
+            break;
+        }
+
+        case 5: {
+            if constexpr (isScreenplay) {
+                if (mutationIndex > _mutationsCount / 2 && !isScenesNumbersLocked) {
+                    mutation = "locking scenes numbers";
+                    textModel->setScenesNumbersLocked(true);
+                    isScenesNumbersLocked = true;
+                } else {
+                    mutation = "setting a custom scene number";
+                    const auto scene = randomScene();
+                    scene->setCustomNumber(QString("%1A").arg(random.bounded(100)),
+                                           random.bounded(2) == 0);
+                    textModel->updateItem(scene);
+                }
+            }
+            break;
+        }
+        }
+
+        ProjectType reference;
+        reference.loadText(textModel->toXml());
+        const auto numbers = sceneAndDialogueNumbers(textModel);
+        const auto referenceNumbers = sceneAndDialogueNumbers(reference.textModel.data());
+        if (numbers == referenceNumbers) {
+            continue;
+        }
+
+        int index = 0;
+        while (index < numbers.size() && index < referenceNumbers.size()
+               && numbers.at(index) == referenceNumbers.at(index)) {
+            ++index;
+        }
+        _runner.mismatch() << "after " << mutation << " (mutation " << mutationIndex << ") at "
+                           << index << ": " << qPrintable(numbers.value(index)) << " vs "
+                           << qPrintable(referenceNumbers.value(index)) << std::endl;
+        break;
+    }
+}
+
+/**
+ * @brief Текстовые блоки модели в порядке обхода, кроме закрывающих блоков папок, которые не
+ *        попадают в майм-данные
+ */
+QVector<TextModelTextItem*> mimeTextItems(TextModel* _model)
+{
+    QVector<TextModelTextItem*> textItems;
+    std::function<void(TextModelItem*)> collectTextItems;
+    collectTextItems = [&textItems, &collectTextItems](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            if (child->type() != TextModelItemType::Text) {
+                collectTextItems(child);
+                continue;
+            }
+
+            const auto textItem = static_cast<TextModelTextItem*>(child);
+            if (textItem->paragraphType() != TextParagraphType::ActFooter
+                && textItem->paragraphType() != TextParagraphType::SequenceFooter
+                && textItem->paragraphType() != TextParagraphType::PartFooter
+                && textItem->paragraphType() != TextParagraphType::ChapterFooter) {
+                textItems.append(textItem);
+            }
+        }
+    };
+    collectTextItems(_model->itemForIndex({}));
+    return textItems;
+}
+
+/**
+ * @brief Непустые тексты блоков модели в порядке обхода
+ */
+QStringList mimeTexts(TextModel* _model)
+{
+    QStringList texts;
+    for (const auto textItem : mimeTextItems(_model)) {
+        if (!textItem->text().isEmpty()) {
+            texts.append(textItem->text());
+        }
+    }
+    return texts;
+}
+
+/**
+ * @brief Xml без идентификаторов элементов, которые генерируются заново при копировании и вставке
+ */
+QString xmlWithoutUuids(QString _xml)
+{
+    static const QRegularExpression uuidAttribute(" uuid=\"[^\"]*\"");
+    return _xml.remove(uuidAttribute);
+}
+
+QString xmlWithoutUuids(TextModel* _model)
+{
+    return xmlWithoutUuids(QString::fromUtf8(_model->toXml()));
+}
+
+/**
+ * @brief Скопировать случайные фрагменты документа и вставить их как внутри приложения, так и из
+ *        байтов, которые получило бы другое приложение, и сверить результаты вставки между собой
+ *        и с текстом скопированного фрагмента
+ * @note Внутри приложения фрагмент должен вставляться без преобразования в xml
+ * @param _createProject - создать проект с текстом документа, или с пустым документом
+ */
+template<typename ProjectType>
+void checkMimeRoundTrip(CheckRunner& _runner,
+                        const std::function<ProjectType*(bool)>& _createProject,
+                        int _selectionsCount)
+{
+    QScopedPointer<ProjectType> sourceProject(_createProject(true));
+    auto sourceModel = sourceProject->textModel.data();
+    const auto mimeType = sourceModel->mimeTypes().constFirst();
+    const auto sourceItems = mimeTextItems(sourceModel);
+    if (!_runner.verify("source document has no text", sourceItems.size() > 1)) {
+        return;
+    }
+
+    //
+    // Вставляем фрагмент в заданную позицию заданного блока пустого документа или документа
+    // с текстом
+    //
+    auto paste = [&_createProject](const QMimeData* _mimeData, bool _withText, int _itemIndex,
+                                   int _position) {
+        auto project = _createProject(_withText);
+        auto model = project->textModel.data();
+        const auto textItems = mimeTextItems(model);
+        const auto textItem = textItems.at(_itemIndex % textItems.size());
+        model->insertFromMime(model->indexForItem(textItem),
+                              std::min(_position, static_cast<int>(textItem->text().length())),
+                              _mimeData);
+        return project;
+    };
+
+    QRandomGenerator random(static_cast<quint32>(_selectionsCount));
+    for (int selectionIndex = 0; selectionIndex < _selectionsCount; ++selectionIndex) {
+        auto fromItemIndex = random.bounded(sourceItems.size());
+        auto toItemIndex = random.bounded(sourceItems.size());
+        if (toItemIndex < fromItemIndex) {
+            std::swap(fromItemIndex, toItemIndex);
+        }
+        const auto fromItem = sourceItems.at(fromItemIndex);
+        const auto toItem = sourceItems.at(toItemIndex);
+        const int fromPosition = random.bounded(fromItem->text().length() + 1);
+        const int toPosition = fromItem == toItem
+            ? fromPosition + random.bounded(toItem->text().length() - fromPosition + 1)
+            : random.bounded(toItem->text().length() + 1);
+        if (fromItem == toItem && fromPosition == toPosition) {
+            continue;
+        }
+
+        QStringList selectedTexts;
+        for (int itemIndex = fromItemIndex; itemIndex <= toItemIndex; ++itemIndex) {
+            auto text = sourceItems.at(itemIndex)->text();
+            if (itemIndex == toItemIndex) {
+                text.truncate(toPosition);
+            }
+            if (itemIndex == fromItemIndex) {
+                text.remove(0, fromPosition);
+            }
+            if (!text.isEmpty()) {
+                selectedTexts.append(text);
+            }
+        }
+
+        //
+        // Внутри приложения фрагмент передаётся копиями элементов модели
+        //
+        const bool clearUuid = true;
+        const auto fromIndex = sourceModel->indexForItem(fromItem);
+        const auto toIndex = sourceModel->indexForItem(toItem);
+        const auto xmlConversionsCount = TextModel::mimeXmlConversionsCount();
+        TextModelMimeData mimeData;
+        sourceModel->setMimeFromSelection(&mimeData, fromIndex, fromPosition, toIndex, toPosition,
+                                          clearUuid);
+
+        //
+        // Вставка в пустой документ должна дать ровно скопированный текст, а ни копирование, ни
+        // вставка внутри приложения не должны формировать и разбирать xml
+        //
+        const auto targetItemIndex = random.bounded(sourceItems.size());
+        const auto targetPosition = random.bounded(64);
+        QScopedPointer<ProjectType> pastedProject(paste(&mimeData, false, 0, 0));
+        QScopedPointer<ProjectType> pastedIntoTextProject(
+            paste(&mimeData, true, targetItemIndex, targetPosition));
+        _runner.verify(QString("selection %1 is converted to xml on in-process copy and paste")
+                           .arg(selectionIndex),
+                       TextModel::mimeXmlConversionsCount() == xmlConversionsCount);
+        const auto pastedTexts = mimeTexts(pastedProject->textModel.data());
+        if (pastedTexts != selectedTexts) {
+            _runner.mismatch() << "selection " << selectionIndex << " is pasted as "
+                               << pastedTexts.size() << " blocks instead of "
+                               << selectedTexts.size() << ": \""
+                               << qPrintable(pastedTexts.join('|')) << "\" vs \""
+                               << qPrintable(selectedTexts.join('|')) << "\"" << std::endl;
+        }
+
+        //
+        // ... другое приложение получает байты xml, который формируется только по его запросу
+        //     и должен совпадать с xml выделенного фрагмента
+        //
+        QMimeData externalMimeData;
+        externalMimeData.setData(mimeType, mimeData.data(mimeType));
+        const auto mime = sourceModel->mimeFromSelection(fromIndex, fromPosition, toIndex,
+                                                         toPosition, clearUuid);
+        if (xmlWithoutUuids(QString::fromUtf8(externalMimeData.data(mimeType)))
+            != xmlWithoutUuids(mime)) {
+            _runner.mismatch() << "selection " << selectionIndex
+                               << " is changed by passing it through mime data" << std::endl;
+            continue;
+        }
+
+        //
+        // ... и вставка этих байтов должна давать тот же результат, что и вставка внутри
+        //     приложения, как в пустой документ, так и в середину блока документа с текстом
+        //
+        QScopedPointer<ProjectType> externallyPastedProject(paste(&externalMimeData, false, 0, 0));
+        _runner.verify(QString("selection %1 is pasted differently from external data")
+                           .arg(selectionIndex),
+                       xmlWithoutUuids(pastedProject->textModel.data())
+                           == xmlWithoutUuids(externallyPastedProject->textModel.data()));
+        externallyPastedProject.reset(
+            paste(&externalMimeData, true, targetItemIndex, targetPosition));
+        _runner.verify(QString("selection %1 is pasted into the text differently from external "
+                               "data")
+                           .arg(selectionIndex),
+                       xmlWithoutUuids(pastedIntoTextProject->textModel.data())
+                           == xmlWithoutUuids(externallyPastedProject->textModel.data()));
+    }
+}
+
+/**
+ * @brief Отображается ли элемент в структуре сценария, как в навигаторе: папки, группы и кадры
+ */
+bool isStructureItem(TextModelItem* _item)
+{
+    switch (_item->type()) {
+    case TextModelItemType::Folder:
+    case TextModelItemType::Group: {
+        return true;
+    }
+
+    case TextModelItemType::Text: {
+        const auto textItem = static_cast<TextModelTextItem*>(_item);
+        return !textItem->isCorrection() && textItem->paragraphType() == TextParagraphType::Shot;
+    }
+
+    default: {
+        return false;
+    }
+    }
+}
+
+/**
+ * @brief Структура сценария, построенная по видимым элементам
+ */
+class StructureProxyModel : public TextModelStructureProxyModel
+{
+protected:
+    bool filterAcceptsItem(TextModelItem* _item) const override
+    {
+        return isStructureItem(_item);
+    }
+};
+
+/**
+ * @brief Структура сценария, как она строилась раньше, через фильтрацию всех строк модели
+ */
+class ReferenceStructureProxyModel : public QSortFilterProxyModel
+{
+protected:
+    bool filterAcceptsRow(int _sourceRow, const QModelIndex& _sourceParent) const override
+    {
+        const auto textModel = qobject_cast<TextModel*>(sourceModel());
+        return isStructureItem(textModel->itemForIndex(textModel->index(_sourceRow, 0,
+                                                                        _sourceParent)));
+    }
+};
+
+/**
+ * @brief Случайно править сценарий и после каждой правки сверять строки, родителей, индексы
+ *        исходной модели и данные структуры с фильтрацией всех строк модели
+ */
+void checkStructureProxyModel(CheckRunner& _runner, int _scenesCount, int _mutationsCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+    StructureProxyModel structure;
+    structure.setSourceModel(textModel);
+    ReferenceStructureProxyModel reference;
+    reference.setSourceModel(textModel);
+
+    QRandomGenerator random(static_cast<quint32>(_scenesCount));
+    auto createText = [textModel](TextParagraphType _type, const QString& _text) {
+        auto textItem = textModel->createTextItem();
+        textItem->setParagraphType(_type);
+        textItem->setText(_text);
+        return textItem;
+    };
+    auto randomScene = [textModel, &random] {
+        const auto scenes = sceneItems(textModel);
+        return scenes.at(random.bounded(scenes.size()));
+    };
+    auto randomText = [&random](TextModelGroupItem* _scene) -> TextModelTextItem* {
+        QVector<TextModelTextItem*> textItems;
+        for (int childIndex = 1; childIndex < _scene->childCount(); ++childIndex) {
+            if (_scene->childAt(childIndex)->type() == TextModelItemType::Text) {
+                textItems.append(static_cast<TextModelTextItem*>(_scene->childAt(childIndex)));
+            }
+        }
+        return textItems.isEmpty() ? nullptr : textItems.at(random.bounded(textItems.size()));
+    };
+
+    //
+    // Сравниваем структуры рекурсивно, возвращая описание первого расхождения
+    //
+    std::function<QString(const QModelIndex&, const QModelIndex&)> compare;
+    compare = [&structure, &reference, &compare](const QModelIndex& _parent,
+                                                 const QModelIndex& _referenceParent) {
+        const auto rowCount = structure.rowCount(_parent);
+        if (rowCount != reference.rowCount(_referenceParent)) {
+            return QString("%1 rows instead of %2 under \"%3\"")
+                .arg(rowCount)
+                .arg(reference.rowCount(_referenceParent))
+                .arg(_referenceParent.data().toString());
+        }
+
+        for (int row = 0; row < rowCount; ++row) {
+            const auto index = structure.index(row, 0, _parent);
+            const auto referenceIndex = reference.index(row, 0, _referenceParent);
+            if (structure.parent(index) != _parent) {
+                return QString("wrong parent of row %1 under \"%2\"")
+                    .arg(row)
+                    .arg(_referenceParent.data().toString());
+            }
+            const auto sourceIndex = structure.mapToSource(index);
+            if (sourceIndex != reference.mapToSource(referenceIndex)
+                || structure.mapFromSource(sourceIndex) != index) {
+                return QString("wrong source index of row %1 under \"%2\"")
+                    .arg(row)
+                    .arg(_referenceParent.data().toString());
+            }
+            for (const auto role : { Qt::DisplayRole, Qt::DecorationRole }) {
+                if (index.data(role) != referenceIndex.data(role)) {
+                    return QString("wrong data of row %1: \"%2\" vs \"%3\"")
+                        .arg(row)
+                        .arg(index.data(role).toString(), referenceIndex.data(role).toString());
+                }
+            }
+
+            const auto childrenMismatch = compare(index, referenceIndex);
+            if (!childrenMismatch.isEmpty()) {
+                return childrenMismatch;
+            }
+        }
+        return QString();
+    };
+
+    for (int mutationIndex = 0; mutationIndex < _mutationsCount; ++mutationIndex) {
+        const char* mutation = "";
+        switch (random.bounded(6)) {
+        case 0: {
+            mutation = "inserting a scene";
+            auto scene = textModel->createGroupItem(TextGroupType::Scene);
+            scene->appendItem(createText(TextParagraphType::SceneHeading, "INT. INSERTED - DAY"));
+            scene->appendItem(createText(TextParagraphType::Action, "Inserted action"));
+            scene->appendItem(createText(TextParagraphType::Shot, "CLOSE ON INSERTED"));
+            textModel->insertItem(scene, randomScene());
+            break;
+        }
+
+        case 1: {
+            mutation = "removing a scene";
+            if (sceneItems(textModel).size() > 2) {
+                textModel->removeItem(randomScene());
+            }
+            break;
+        }
+
+        case 2: {
+            mutation = "inserting blocks";
+            const auto scene = randomScene();
+            const auto textItem = randomText(scene);
+            textModel->insertItems({ createText(TextParagraphType::Shot, "ANGLE ON"),
+                                     createText(TextParagraphType::Action, "Inserted") },
+                                   textItem != nullptr ? textItem : scene->childAt(0));
+            break;
+        }
+
+        case 3: {
+            mutation = "removing a block";
+            if (const auto textItem = randomText(randomScene()); textItem != nullptr) {
+                textModel->removeItem(textItem);
+            }
+            break;
+        }
+
+        case 4: {
+            mutation = "changing a block type";
+            if (const auto textItem = randomText(randomScene()); textItem != nullptr) {
+                textItem->setParagraphType(textItem->paragraphType() == TextParagraphType::Shot
+                                               ? TextParagraphType::Action
+                                               : TextParagraphType::Shot);
+                textModel->updateItem(textItem);
+            }
+            break;
+        }
+
+        case 5: {
+            mutation = "moving a scene";
+            const auto scene = randomScene();
+            const auto afterScene = randomScene();
+            if (scene != afterScene) {
+                textModel->moveItem(scene, afterScene);
+            }
+            break;
+        }
+        }
+
+        const auto mismatch = compare({}, {});
+        if (mismatch.isEmpty()) {
+            continue;
+        }
+
+        _runner.mismatch() << "after " << mutation << " (mutation " << mutationIndex
+                           << "): " << qPrintable(mismatch) << std::endl;
+        break;
+    }
+}
+
+/**
+ * @brief Текстовые блоки модели в порядке обхода, кроме корректировочных
+ */
+QVector<TextModelTextItem*> reviewTextItems(TextModel* _model)
+{
+    QVector<TextModelTextItem*> textItems;
+    std::function<void(TextModelItem*)> collectTextItems;
+    collectTextItems = [&textItems, &collectTextItems](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            if (child->type() != TextModelItemType::Text) {
+                collectTextItems(child);
+                continue;
+            }
+
+            const auto textItem = static_cast<TextModelTextItem*>(child);
+            if (!textItem->isCorrection()) {
+                textItems.append(textItem);
+            }
+        }
+    };
+    collectTextItems(_model->itemForIndex({}));
+    return textItems;
+}
+
+/**
+ * @brief Сравнить модель заметок с моделью, заново построенной по тексту, возвращая описание
+ *        первого расхождения
+ */
+QString commentsModelMismatch(CommentsModel& _comments, TextModel* _model)
+{
+    CommentsModel reference;
+    reference.setTextModel(_model);
+
+    if (_comments.rowCount() != reference.rowCount()) {
+        return QString("%1 review marks instead of %2")
+            .arg(_comments.rowCount())
+            .arg(reference.rowCount());
+    }
+
+    for (int row = 0; row < reference.rowCount(); ++row) {
+        const auto position = _comments.mapToModel(_comments.index(row));
+        const auto referencePosition = reference.mapToModel(reference.index(row));
+        if (position.index != referencePosition.index
+            || position.blockPosition != referencePosition.blockPosition) {
+            return QString("review mark %1 starts at \"%2\":%3 instead of \"%4\":%5")
+                .arg(row)
+                .arg(position.index.data().toString())
+                .arg(position.blockPosition)
+                .arg(referencePosition.index.data().toString())
+                .arg(referencePosition.blockPosition);
+        }
+        for (const auto role : { CommentsModel::ReviewMarkAuthorNameRole,
+                                 CommentsModel::ReviewMarkCommentRole,
+                                 CommentsModel::ReviewMarkColorRole,
+                                 CommentsModel::ReviewMarkIsDoneRole }) {
+            if (_comments.index(row).data(role) != reference.index(row).data(role)) {
+                return QString("wrong data of review mark %1: \"%2\" vs \"%3\"")
+                    .arg(row)
+                    .arg(_comments.index(row).data(role).toString(),
+                         reference.index(row).data(role).toString());
+            }
+        }
+    }
+
+    //
+    // Заметки, растянутые на несколько абзацев, должны находиться из каждого своего абзаца
+    //
+    for (auto textItem : reviewTextItems(_model)) {
+        const auto itemIndex = _model->indexForItem(textItem);
+        for (const auto& reviewMark : textItem->reviewMarks()) {
+            const auto row = _comments.mapFromModel(itemIndex, reviewMark.from).row();
+            const auto referenceRow = reference.mapFromModel(itemIndex, reviewMark.from).row();
+            if (row != referenceRow) {
+                return QString("review mark at \"%1\":%2 maps to row %3 instead of %4")
+                    .arg(textItem->text())
+                    .arg(reviewMark.from)
+                    .arg(row)
+                    .arg(referenceRow);
+            }
+        }
+    }
+    return QString();
+}
+
+/**
+ * @brief Случайно править сценарий с заметками, в том числе растянутыми на несколько абзацев и
+ *        делящими абзац между собой, и после каждой правки сверять модель заметок с построенной
+ *        заново
+ */
+void checkCommentsModel(CheckRunner& _runner, int _scenesCount, int _mutationsCount)
+{
+    ScreenplayProject project(_scenesCount);
+    auto textModel = project.textModel.data();
+
+    //
+    // У каждой заметки свой автор, чтобы соседние заметки не склеивались между собой
+    //
+    int reviewMarksCount = 0;
+    auto createReviewMark = [&reviewMarksCount](int _from, int _length) {
+        TextModelTextItem::ReviewMark reviewMark;
+        reviewMark.from = _from;
+        reviewMark.length = _length;
+        reviewMark.backgroundColor = QColor(reviewMarksCount % 2 == 0 ? "#f7e35a" : "#5ae3f7");
+        reviewMark.comments.append({ QString("Author %1").arg(reviewMarksCount),
+                                     "author@starc.app", "2022-10-18T12:00:00",
+                                     QString("Comment %1").arg(reviewMarksCount) });
+        ++reviewMarksCount;
+        return reviewMark;
+    };
+    auto setReviewMarks = [textModel](TextModelTextItem* _textItem,
+                                      const QVector<TextModelTextItem::ReviewMark>& _marks) {
+        _textItem->setReviewMarks(_marks);
+        textModel->updateItem(_textItem);
+    };
+
+    //
+    // Размечаем текст группами по семь абзацев: заметка на три абзаца, вторая заметка, которая
+    // начинается в последнем абзаце первой и заканчивается в следующем, пара заметок внутри
+    // одного абзаца и два абзаца без заметок
+    //
+    const int minimumLength = 8;
+    const auto textItems = reviewTextItems(textModel);
+    for (int itemIndex = 0; itemIndex + 4 < textItems.size();) {
+        const auto isLongEnough
+            = std::all_of(textItems.begin() + itemIndex, textItems.begin() + itemIndex + 5,
+                          [](TextModelTextItem* _textItem) {
+                              return _textItem->text().length() >= minimumLength;
+                          });
+        if (!isLongEnough) {
+            ++itemIndex;
+            continue;
+        }
+
+        const auto first = textItems.at(itemIndex);
+        const auto middle = textItems.at(itemIndex + 1);
+        const auto shared = textItems.at(itemIndex + 2);
+        const auto last = textItems.at(itemIndex + 3);
+        const auto inner = textItems.at(itemIndex + 4);
+        const auto spanning = createReviewMark(0, 0);
+        const auto overlapping = createReviewMark(0, 0);
+        auto part = [](TextModelTextItem::ReviewMark _reviewMark, int _from, int _length) {
+            _reviewMark.from = _from;
+            _reviewMark.length = _length;
+            return _reviewMark;
+        };
+        const auto firstLength = first->text().length();
+        const auto sharedLength = shared->text().length();
+        setReviewMarks(first, { part(spanning, firstLength / 2, firstLength - firstLength / 2) });
+        setReviewMarks(middle, { part(spanning, 0, middle->text().length()) });
+        setReviewMarks(shared,
+                       { part(spanning, 0, sharedLength / 4),
+                         part(overlapping, sharedLength / 2, sharedLength - sharedLength / 2) });
+        setReviewMarks(last, { part(overlapping, 0, last->text().length() / 3) });
+        setReviewMarks(inner, { createReviewMark(1, 2), createReviewMark(5, 2) });
+        itemIndex += 7;
+    }
+
+    CommentsModel comments;
+    comments.setTextModel(textModel);
+    if (!_runner.verify("no review marks in the generated screenplay", comments.rowCount() > 0)) {
+        return;
+    }
+
+    QRandomGenerator random(static_cast<quint32>(_scenesCount));
+    auto randomText = [textModel, &random] {
+        const auto textItems = reviewTextItems(textModel);
+        return textItems.at(random.bounded(textItems.size()));
+    };
+    for (int mutationIndex = 0; mutationIndex < _mutationsCount; ++mutationIndex) {
+        const char* mutation = "";
+        switch (random.bounded(4)) {
+        case 0: {
+            mutation = "inserting a paragraph";
+            auto textItem = textModel->createTextItem();
+            textItem->setParagraphType(TextParagraphType::Action);
+            textItem->setText("Inserted paragraph");
+            textModel->insertItem(textItem, randomText());
+            break;
+        }
+
+        case 1: {
+            mutation = "removing a paragraph";
+            const auto textItem = randomText();
+            if (textItem->paragraphType() != TextParagraphType::SceneHeading) {
+                textModel->removeItem(textItem);
+            }
+            break;
+        }
+
+        case 2: {
+            mutation = "adding a review mark";
+            const auto textItem = randomText();
+            if (textItem->reviewMarks().isEmpty() && textItem->text().length() >= minimumLength) {
+                setReviewMarks(textItem, { createReviewMark(2, 2) });
+            }
+            break;
+        }
+
+        case 3: {
+            mutation = "removing review marks";
+            const auto textItem = randomText();
+            if (!textItem->reviewMarks().isEmpty()) {
+                setReviewMarks(textItem, {});
+            }
+            break;
+        }
+        }
+
+        const auto mismatch = commentsModelMismatch(comments, textModel);
+        if (mismatch.isEmpty()) {
+            continue;
+        }
+
+        _runner.mismatch() << "after " << mutation << " (mutation " << mutationIndex
+                           << "): " << qPrintable(mismatch) << std::endl;
+        break;
+    }
+}
+
+} // namespace
+
+
+void Checks::runModelChecks(CheckRunner& _runner)
+{
+    _runner.run("screenplay/character_dialogues",
+                [&_runner] { checkCharacterDialogues(_runner, 30); });
+    _runner.run("screenplay/treatment_document",
+                [&_runner] { checkTreatmentDocument(_runner, 30); });
+    _runner.run("screenplay/name_replacement", [&_runner] { checkNameReplacement(_runner, 30); });
+    _runner.run("screenplay/docx_export", [&_runner] { checkDocxExport(_runner, 30); });
+    _runner.run("screenplay/breakdown", [&_runner] { checkBreakdown(_runner, 120); });
+    _runner.run("cards/board", [&_runner] { checkCardsBoard(_runner, 60); });
+    _runner.run("screenplay/structure_proxy_model",
+                [&_runner] { checkStructureProxyModel(_runner, 30, 300); });
+    _runner.run("screenplay/comments_model", [&_runner] { checkCommentsModel(_runner, 30, 300); });
+    _runner.run("comic_book/numbering", [&_runner] { checkComicBookNumbering(_runner, 50); });
+    _runner.run("screenplay/incremental_numbering", [&_runner] {
+        checkIncrementalNumbering<ScreenplayProject>(_runner, 100, 200);
+    });
+    _runner.run("stageplay/incremental_numbering", [&_runner] {
+        checkIncrementalNumbering<StageplayProject>(_runner, 100, 200);
+    });
+    _runner.run("audioplay/incremental_numbering", [&_runner] {
+        checkIncrementalNumbering<AudioplayProject>(_runner, 100, 200);
+    });
+
+    //
+    // Копирование и вставка во всех текстовых моделях
+    //
+    _runner.run("screenplay/mime_round_trip", [&_runner] {
+        checkMimeRoundTrip<ScreenplayProject>(
+            _runner,
+            [](bool _withText) {
+                if (_withText) {
+                    return new ScreenplayProject(6);
+                }
+                auto project = new ScreenplayProject;
+                project->loadText({});
+                return project;
+            },
+            30);
+    });
+    _runner.run("stageplay/mime_round_trip", [&_runner] {
+        checkMimeRoundTrip<StageplayProject>(
+            _runner,
+            [](bool _withText) {
+                if (_withText) {
+                    return new StageplayProject(6);
+                }
+                auto project = new StageplayProject;
+                project->loadText({});
+                return project;
+            },
+            30);
+    });
+    _runner.run("audioplay/mime_round_trip", [&_runner] {
+        checkMimeRoundTrip<AudioplayProject>(
+            _runner,
+            [](bool _withText) {
+                if (_withText) {
+                    return new AudioplayProject(6);
+                }
+                auto project = new AudioplayProject;
+                project->loadText({});
+                return project;
+            },
+            30);
+    });
+    _runner.run("comic_book/mime_round_trip", [&_runner] {
+        checkMimeRoundTrip<ComicBookProject>(
+            _runner,
+            [](bool _withText) {
+                auto project = new ComicBookProject;
+                for (int pageIndex = 0; _withText && pageIndex < 6; ++pageIndex) {
+                    project->textModel->appendItem(project->createPage("PAGE", 1 + pageIndex % 3));
+                }
+                return project;
+            },
+            30);
+    });
+    _runner.run("novel/mime_round_trip", [&_runner] {
+        checkMimeRoundTrip<NovelProject>(
+            _runner,
+            [](bool _withText) {
+                auto project = new NovelProject;
+                project->loadText(
+                    _withText
+                        ? NovelMarkdownImporter()
+                              .importNovel(SyntheticDocuments::novelMarkdown(3))
+                              .text.toUtf8()
+                        : QByteArray());
+                return project;
+            },
+            30);
+    });
+}
@@ -0,0 +1,546 @@
+#include "check_runner.h"
+#include "checks.h"
+
+#include <data_layer/database.h>
+#include <data_layer/mapper/document_change_mapper.h>
+#include <data_layer/mapper/mapper_facade.h>
+#include <data_layer/persistence_worker.h>
+#include <data_layer/storage/document_change_storage.h>
+#include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <data_layer/storage/writing_session_storage.h>
+#include <domain/document_change_object.h>
+#include <domain/document_object.h>
+#include <domain/starcloud_api.h>
+#include <utils/tools/backup_builder.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QUuid>
+#include <QVariant>
+
+#include <algorithm>
+#include <iostream>
+
+
+namespace {
+
+/**
+ * @brief Открыть файл проекта средствами SQLite, проверить его целостность и прочитать
+ *        содержимое документов
+ * @return Содержимое документов <идентификатор, содержимое>, либо пустой список, если файл не
+ *         открывается или повреждён
+ */
+QMap<int, QByteArray> verifiedItemsContent(const QString& _filePath, QString& _integrity)
+{
+    QMap<int, QByteArray> result;
+    const QString connectionName = "backups_verification";
+    {
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_filePath);
+        database.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if (database.open()) {
+            QSqlQuery query(database);
+            query.exec("PRAGMA integrity_check");
+            _integrity = query.next() ? query.value(0).toString() : query.lastError().text();
+            if (_integrity == "ok") {
+                query.exec("SELECT id, content FROM items ORDER BY id");
+                while (query.next()) {
+                    result.insert(query.value(0).toInt(), query.value(1).toByteArray());
+                }
+            }
+        } else {
+            _integrity = database.lastError().text();
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return result;
+}
+
+/**
+ * @brief Сделать серию бэкапов открытого проекта, изменения которого остаются в журнале
+ *        упреждающей записи, затем повредить проект и восстановить его из каждого снимка,
+ *        проверив целостность восстановленного файла и содержимое документов
+ */
+void checkBackupSnapshots(CheckRunner& _runner, int _backupsCount, int _maximumBackups)
+{
+    const QString projectPath = _runner.workingDir() + "/backups.starc";
+    const QString backupsDir = _runner.workingDir() + "/backups";
+
+    //
+    // Снимки сохраняются с точностью до секунды, поэтому, чтобы они не перезаписывали друг
+    // друга, переименовываем каждый снимок так, будто он был сделан на секунду позже предыдущего
+    //
+    const QDateTime firstBackupDateTime(QDate(2000, 1, 1), QTime(0, 0));
+    auto snapshotPathFor = [backupsDir, firstBackupDateTime](int _backupIndex) {
+        return QString("%1/backups_%2.starc.snapshot")
+            .arg(backupsDir,
+                 firstBackupDateTime.addSecs(_backupIndex).toString("yyyy_MM_dd_hh_mm_ss"));
+    };
+
+    QHash<int, QMap<int, QByteArray>> backupsContents;
+    const QString connectionName = "backups_check";
+    {
+        //
+        // Проект открыт так же, как его открывает приложение, но журнал не переносится в основной
+        // файл автоматически, чтобы снимки обязательно включали изменения из журнала
+        //
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(projectPath);
+        database.open();
+        QSqlQuery query(database);
+        query.exec("PRAGMA journal_mode = WAL");
+        query.exec("PRAGMA wal_autocheckpoint = 0");
+        query.exec("CREATE TABLE items (id INTEGER PRIMARY KEY, content BLOB)");
+
+        QMap<int, QByteArray> itemsContent;
+        for (int backupIndex = 0; backupIndex < _backupsCount; ++backupIndex) {
+            //
+            // Дописываем новые данные и меняем часть старых, чтобы изменились не все блоки снимка
+            //
+            const QByteArray newContent(48 * 1024, static_cast<char>('a' + backupIndex % 26));
+            query.prepare("INSERT INTO items (content) VALUES (?)");
+            query.addBindValue(newContent);
+            query.exec();
+            itemsContent.insert(query.lastInsertId().toInt(), newContent);
+            const QByteArray changedContent(4 * 1024, static_cast<char>('A' + backupIndex % 26));
+            const int changedId = 1 + backupIndex / 2;
+            query.prepare("UPDATE items SET content = ? WHERE id = ?");
+            query.addBindValue(changedContent);
+            query.addBindValue(changedId);
+            query.exec();
+            itemsContent.insert(changedId, changedContent);
+
+            BackupBuilder::save(projectPath, backupsDir, {}, _maximumBackups);
+
+            const auto snapshots = QDir(backupsDir).entryInfoList({ "*.snapshot" }, QDir::Files,
+                                                                   QDir::Name | QDir::Reversed);
+            if (!_runner.verify(QString("No snapshot is saved for backup %1").arg(backupIndex),
+                                !snapshots.isEmpty())) {
+                break;
+            }
+            QFile::rename(snapshots.constFirst().absoluteFilePath(),
+                          snapshotPathFor(backupIndex));
+            backupsContents.insert(backupIndex, itemsContent);
+        }
+
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    //
+    // Повреждаем проект: затираем заголовок и середину файла
+    //
+    {
+        QFile file(projectPath);
+        file.open(QIODevice::ReadWrite);
+        const QByteArray garbage(4 * 1024, '\xFF');
+        file.write(garbage);
+        file.seek(file.size() / 2);
+        file.write(garbage);
+    }
+
+    QString integrity;
+    _runner.verify("Corrupted project passes the integrity check",
+                   verifiedItemsContent(projectPath, integrity).isEmpty() || integrity != "ok");
+
+    //
+    // Старые снимки должны быть удалены, а оставшиеся восстанавливать целый проект с теми
+    // документами, какими они были в момент снимка, даже после того как из хранилища были
+    // удалены блоки удалённых снимков
+    //
+    const auto snapshots = QDir(backupsDir).entryInfoList({ "*.snapshot" }, QDir::Files);
+    _runner.verify(QString("%1 snapshots are kept instead of %2")
+                       .arg(snapshots.size())
+                       .arg(std::min(_backupsCount, _maximumBackups)),
+                   snapshots.size() == std::min(_backupsCount, _maximumBackups));
+    for (int backupIndex = 0; backupIndex < _backupsCount; ++backupIndex) {
+        const auto snapshotPath = snapshotPathFor(backupIndex);
+        if (!QFile::exists(snapshotPath)) {
+            continue;
+        }
+
+        QFile::remove(projectPath);
+        QFile::remove(projectPath + "-wal");
+        QFile::remove(projectPath + "-shm");
+        if (!_runner.verify(QString("Backup %1 is not restored").arg(backupIndex),
+                            BackupBuilder::restore(snapshotPath, projectPath))) {
+            continue;
+        }
+        const auto restoredContent = verifiedItemsContent(projectPath, integrity);
+        _runner.verify(QString("Restored backup %1 fails the integrity check: %2")
+                           .arg(backupIndex)
+                           .arg(integrity),
+                       integrity == "ok");
+        _runner.verify(QString("Restored backup %1 has %2 of %3 documents or differs in content")
+                           .arg(backupIndex)
+                           .arg(restoredContent.size())
+                           .arg(backupsContents.value(backupIndex).size()),
+                       restoredContent == backupsContents.value(backupIndex));
+    }
+
+    //
+    // Открытие снимка заменяет его полной копией
+    //
+    const auto lastSnapshotPath = snapshotPathFor(_backupsCount - 1);
+    const auto fullCopyPath = BackupBuilder::restoreFullCopy(lastSnapshotPath);
+    _runner.verify("Full copy of the snapshot differs from the backup",
+                   !fullCopyPath.isEmpty()
+                       && verifiedItemsContent(fullCopyPath, integrity)
+                           == backupsContents.value(_backupsCount - 1));
+    _runner.verify("Snapshot is kept after its full copy is restored",
+                   !QFile::exists(lastSnapshotPath));
+}
+
+/**
+ * @brief Сверить агрегаты статистики с полным пересчётом по сессиям после сохранения как новых
+ *        сессий, так и повторного сохранения уже сохранённых, например при синхронизации
+ */
+void checkWritingSessionRollups(CheckRunner& _runner, int _batchesCount)
+{
+    using DataStorageLayer::WritingStatisticsRollup;
+
+    DataStorageLayer::WritingSessionStorage storage(_runner.workingDir() + "/sessions.db");
+
+    QRandomGenerator random(static_cast<quint32>(_batchesCount));
+    const QStringList devicesNames = { "Desktop", "Laptop", "Tablet" };
+    const QDateTime firstSessionDateTime(QDate(2020, 1, 1), QTime(9, 0));
+    auto makeSession = [&random, &devicesNames, firstSessionDateTime](const QUuid& _uuid) {
+        const auto device = random.bounded(devicesNames.size());
+        const auto startDateTime
+            = firstSessionDateTime.addSecs(60 * random.bounded(800 * 24 * 60));
+        return Domain::SessionStatistics{
+            _uuid,
+            QUuid::createUuid(),
+            "Project",
+            QString::number(device),
+            devicesNames.at(device),
+            startDateTime,
+            startDateTime.addSecs(60 * (1 + random.bounded(180))),
+            random.bounded(2000),
+            random.bounded(12000),
+        };
+    };
+
+    QHash<QUuid, Domain::SessionStatistics> sessions;
+    auto check = [&_runner, &storage, &sessions](int _batchIndex) {
+        QMap<QPair<QDate, QString>, WritingStatisticsRollup> reference;
+        for (const auto& session : std::as_const(sessions)) {
+            const auto date = session.startDateTime.date();
+            auto& rollup = reference[{ date, session.deviceUuid }];
+            rollup.date = date;
+            rollup.deviceUuid = session.deviceUuid;
+            rollup.deviceName = session.deviceName;
+            rollup.words += session.words;
+            rollup.characters += session.characters;
+            ++rollup.sessions;
+        }
+
+        auto rollups = storage.rollups();
+        std::sort(rollups.begin(), rollups.end(),
+                  [](const WritingStatisticsRollup& _lhs, const WritingStatisticsRollup& _rhs) {
+                      return qMakePair(_lhs.date, _lhs.deviceUuid)
+                          < qMakePair(_rhs.date, _rhs.deviceUuid);
+                  });
+        if (rollups.size() != reference.size()) {
+            _runner.mismatch() << rollups.size() << " daily rollups instead of "
+                               << reference.size() << " after batch " << _batchIndex << std::endl;
+            return;
+        }
+
+        int rollupIndex = 0;
+        for (const auto& referenceRollup : std::as_const(reference)) {
+            const auto& rollup = rollups.at(rollupIndex++);
+            if (rollup.date == referenceRollup.date
+                && rollup.deviceUuid == referenceRollup.deviceUuid
+                && rollup.deviceName == referenceRollup.deviceName
+                && rollup.words == referenceRollup.words
+                && rollup.characters == referenceRollup.characters
+                && rollup.sessions == referenceRollup.sessions) {
+                continue;
+            }
+
+            _runner.mismatch() << "daily rollup of "
+                               << qPrintable(referenceRollup.date.toString(Qt::ISODate)) << " for "
+                               << qPrintable(referenceRollup.deviceName) << " after batch "
+                               << _batchIndex << ": words " << rollup.words << " vs "
+                               << referenceRollup.words << ", characters " << rollup.characters
+                               << " vs " << referenceRollup.characters << ", sessions "
+                               << rollup.sessions << " vs " << referenceRollup.sessions
+                               << std::endl;
+            break;
+        }
+    };
+
+    //
+    // Каждая пачка содержит и новые сессии, и изменённые копии уже сохранённых, которые могут
+    // переехать на другой день или устройство
+    //
+    QVector<QUuid> sessionsUuids;
+    for (int batchIndex = 0; batchIndex < _batchesCount; ++batchIndex) {
+        QVector<Domain::SessionStatistics> batch;
+        const auto batchSize = 1 + random.bounded(20);
+        for (int sessionIndex = 0; sessionIndex < batchSize; ++sessionIndex) {
+            QUuid uuid;
+            if (!sessionsUuids.isEmpty() && random.bounded(3) == 0) {
+                uuid = sessionsUuids.at(random.bounded(sessionsUuids.size()));
+            } else {
+                uuid = QUuid::createUuid();
+                sessionsUuids.append(uuid);
+            }
+            const auto session = makeSession(uuid);
+            batch.append(session);
+            sessions.insert(uuid, session);
+        }
+        storage.saveSessionStatistics(batch);
+        check(batchIndex);
+    }
+
+    //
+    // Полный пересчёт самим хранилищем должен давать те же агрегаты
+    //
+    storage.rebuildRollups();
+    check(_batchesCount);
+}
+
+/**
+ * @brief Выполнить запрос через основное соединение и получить первое значение результата
+ */
+QVariant queryValue(const QString& _statement)
+{
+    auto query = DatabaseLayer::Database::query();
+    query.exec(_statement);
+    query.next();
+    return query.value(0);
+}
+
+/**
+ * @brief Сохранить журнал изменений и документы так же, как это делает автосохранение, и
+ *        проверить, что основное соединение при этом не используется, а изменения записываются
+ *        в фоне, в том числе и повторно при закрытии файла, если с первого раза записать их
+ *        не удалось
+ */
+void checkDeferredWrites(CheckRunner& _runner, int _changesCount)
+{
+    using DatabaseLayer::Database;
+
+    const auto projectPath = _runner.workingDir() + "/persistence.starc";
+    Database::setCurrentFile(projectPath);
+
+    auto storage = DataStorageLayer::StorageFacade::documentChangeStorage();
+    const auto documentUuid = QUuid::createUuid();
+    auto autosave = [storage, documentUuid](int _changesCount) {
+        Database::beginDeferredWrites();
+        for (int change = 0; change < _changesCount; ++change) {
+            storage->appendDocumentChange(documentUuid, QUuid::createUuid(), "undo", "redo",
+                                          "check@starc.app", "Check");
+        }
+        storage->store();
+        Database::endDeferredWrites();
+    };
+
+    //
+    // Первое сохранение загружает последний идентификатор таблицы, а последующие уже не должны
+    // обращаться к базе данных из потока интерфейса
+    //
+    autosave(_changesCount);
+    Database::waitForPendingWrites();
+    const auto queriesCount = Database::queriesCount();
+    autosave(_changesCount);
+    _runner.verify(QString("Autosave makes %1 queries from the GUI thread")
+                       .arg(Database::queriesCount() - queriesCount),
+                   Database::queriesCount() == queriesCount);
+    Database::waitForPendingWrites();
+    const auto writtenChanges = queryValue("SELECT COUNT(*) FROM documents_changes").toInt();
+    _runner.verify(
+        QString("%1 of %2 changes are written").arg(writtenChanges).arg(_changesCount * 2),
+        writtenChanges == _changesCount * 2);
+
+    //
+    // Отложенное обновление объекта
+    //
+    const auto change = storage->documentChangeAt(documentUuid, 0);
+    change->setSynced(true);
+    Database::beginDeferredWrites();
+    storage->updateDocumentChange(change);
+    Database::endDeferredWrites();
+    Database::waitForPendingWrites();
+    _runner.verify("Deferred update is not written",
+                   queryValue(QString("SELECT is_synced FROM documents_changes WHERE uuid = '%1'")
+                                  .arg(change->uuid().toString()))
+                           .toInt()
+                       == 1);
+
+    //
+    // Сохранение документа, как нового, так и изменённого, не обращается к основному соединению
+    //
+    auto documentStorage = DataStorageLayer::StorageFacade::documentStorage();
+    auto saveDocument = [documentStorage](const QByteArray& _content) {
+        auto document = documentStorage->createDocument(QUuid::createUuid(),
+                                                        Domain::DocumentObjectType::ScreenplayText);
+        document->setContent(_content);
+        documentStorage->saveDocument(document);
+        return document;
+    };
+    saveDocument("first");
+    Database::waitForPendingWrites();
+    const auto documentQueriesCount = Database::queriesCount();
+    auto document = saveDocument("second");
+    document->setContent("third");
+    documentStorage->saveDocument(document);
+    _runner.verify(QString("Document save makes %1 queries from the GUI thread")
+                       .arg(Database::queriesCount() - documentQueriesCount),
+                   Database::queriesCount() == documentQueriesCount);
+    Database::waitForPendingWrites();
+    const auto documentContent
+        = queryValue(QString("SELECT content FROM documents WHERE uuid = '%1'")
+                         .arg(document->uuid().toString()))
+              .toByteArray();
+    _runner.verify(QString("Saved document content is \"%1\"").arg(documentContent.constData()),
+                   documentContent == "third");
+
+    //
+    // Удалённое изменение не находится ни до, ни после фоновой записи удаления
+    //
+    auto mapper = DataMappingLayer::MapperFacade::documentChangeMapper();
+    auto isChangeFound = [mapper, documentUuid](const QUuid& _uuid,
+                                                const Domain::Identifier& _id) {
+        if (mapper->find(_uuid) != nullptr || mapper->find(_id) != nullptr) {
+            return true;
+        }
+        const auto changes = mapper->findAllUnsynced(documentUuid);
+        return std::any_of(changes.begin(), changes.end(),
+                           [_uuid](Domain::DocumentChangeObject* _change) {
+                               return _change != nullptr && _change->uuid() == _uuid;
+                           });
+    };
+    const auto removedChange = storage->documentChangeAt(documentUuid, 1);
+    const auto removedUuid = removedChange->uuid();
+    const auto removedId = removedChange->id();
+    storage->removeDocumentChange(removedChange);
+    _runner.verify("Removed change is found before the delete is written",
+                   !isChangeFound(removedUuid, removedId));
+    Database::waitForPendingWrites();
+    _runner.verify("Removed change is found after the delete is written",
+                   !isChangeFound(removedUuid, removedId));
+
+    //
+    // Транзакция и сжатие базы данных тоже выполняются в фоне
+    //
+    const auto maintenanceQueriesCount = Database::queriesCount();
+    storage->appendDocumentChange(documentUuid, QUuid::createUuid(), "undo", "redo",
+                                  "check@starc.app", "Check");
+    storage->store();
+    storage->removeAll();
+    _runner.verify(QString("Transaction and vacuum make %1 queries from the GUI thread")
+                       .arg(Database::queriesCount() - maintenanceQueriesCount),
+                   Database::queriesCount() == maintenanceQueriesCount);
+    Database::waitForPendingWrites();
+    _runner.verify("Changes are not removed",
+                   queryValue("SELECT COUNT(*) FROM documents_changes").toInt() == 0);
+
+    //
+    // Пакет, который не удалось записать, записывается повторно при закрытии файла
+    //
+    queryValue("CREATE TABLE persistence_check (id INTEGER PRIMARY KEY)");
+    queryValue("INSERT INTO persistence_check (id) VALUES (1)");
+    Database::beginDeferredWrites();
+    const auto conflictingBatch
+        = Database::deferWrite("INSERT INTO persistence_check (id) VALUES (?)", { 1 });
+    Database::endDeferredWrites();
+    Database::waitForPendingWrites();
+    _runner.verify("Conflicting batch is written",
+                   !Database::persistenceWorker()->lastError().isEmpty()
+                       && !Database::isBatchWritten(conflictingBatch));
+    queryValue("DELETE FROM persistence_check");
+    DataStorageLayer::StorageFacade::clearStorages();
+    Database::closeCurrentFile();
+    _runner.verify(QString("Failed batch is not written on close: %1").arg(Database::lastError()),
+                   !Database::hasError());
+    Database::setCurrentFile(projectPath);
+    _runner.verify("Failed batch is lost on close",
+                   queryValue("SELECT COUNT(*) FROM persistence_check").toInt() == 1
+                       && Database::isBatchWritten(conflictingBatch));
+
+    //
+    // ... а если не удалось и при закрытии, то сообщается об ошибке
+    //
+    int failedSignalsCount = 0;
+    QObject receiver;
+    QObject::connect(Database::persistenceWorker(),
+                     &DatabaseLayer::PersistenceWorker::writeFailed, &receiver,
+                     [&failedSignalsCount] { ++failedSignalsCount; });
+    Database::beginDeferredWrites();
+    const auto lostBatch
+        = Database::deferWrite("INSERT INTO persistence_missing (id) VALUES (?)", { 1 });
+    Database::endDeferredWrites();
+    Database::closeCurrentFile();
+    QCoreApplication::processEvents();
+    _runner.verify("Lost batch is not reported on close",
+                   Database::hasError() && Database::isBatchLost(lostBatch)
+                       && !Database::isBatchWritten(lostBatch));
+    _runner.verify(QString("Lost batch is reported %1 times").arg(failedSignalsCount),
+                   failedSignalsCount == 2);
+    Database::setLastError({});
+}
+
+/**
+ * @brief Проверить, что колонки, которых нет в файле текущей версии, добавляются при открытии
+ */
+void checkMissingColumns(CheckRunner& _runner)
+{
+    using DatabaseLayer::Database;
+
+    const auto projectPath = _runner.workingDir() + "/missing_columns.starc";
+    auto hasResultHash = [] {
+        auto query = Database::query();
+        query.exec("PRAGMA table_info(documents_changes)");
+        while (query.next()) {
+            if (query.value("name").toString() == "result_hash") {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    //
+    // Файл с версией программы, но без колонки, как у сохранённых до её появления
+    //
+    Database::setCurrentFile(projectPath);
+    queryValue("DROP TABLE documents_changes");
+    queryValue("CREATE TABLE documents_changes (id INTEGER PRIMARY KEY AUTOINCREMENT)");
+    queryValue(QString("INSERT OR REPLACE INTO system_variables VALUES ('application-version', "
+                       "'%1')")
+                   .arg(QCoreApplication::applicationVersion()));
+    _runner.verify("Test file still has result_hash", !hasResultHash());
+    Database::closeCurrentFile();
+
+    Database::setCurrentFile(projectPath);
+    _runner.verify("result_hash is not added on open", hasResultHash());
+    Database::closeCurrentFile();
+
+    Database::setCurrentFile(projectPath);
+    _runner.verify("result_hash is lost on reopen", hasResultHash());
+    Database::closeCurrentFile();
+}
+
+} // namespace
+
+
+void Checks::runStorageChecks(CheckRunner& _runner)
+{
+    _runner.run("backups/snapshots", [&_runner] { checkBackupSnapshots(_runner, 12, 5); });
+    _runner.run("writing_sessions/rollups",
+                [&_runner] { checkWritingSessionRollups(_runner, 200); });
+    _runner.run("persistence/deferred_writes", [&_runner] { checkDeferredWrites(_runner, 500); });
+    _runner.run("persistence/missing_columns", [&_runner] { checkMissingColumns(_runner); });
+}
@@ -0,0 +1,209 @@
+#include "synthetic_documents.h"
+
+#include <QRandomGenerator>
+#include <QStringList>
+
+
+namespace {
+
+/**
+ * @brief Зерно генератора, чтобы документы были одинаковыми между запусками
+ */
+constexpr quint32 kSeed = 20221018;
+
+const QStringList kCharacters = {
+    "ALICE", "BOB", "CAROL", "DAVE", "EVE", "FRANK", "GRACE", "HEIDI",
+};
+const QStringList kLocations = {
+    "KITCHEN", "OFFICE", "STREET", "ROOFTOP", "GARAGE", "HOSPITAL", "PARK", "TRAIN",
+};
+const QStringList kWords = {
+    "the",    "quiet",  "morning", "light",  "falls",   "across", "an",    "empty",
+    "table",  "where",  "someone", "left",   "a",       "letter", "that",  "nobody",
+    "dares",  "to",     "open",    "while",  "outside", "rain",   "keeps", "drumming",
+    "slowly", "behind", "closed",  "window", "glass",   "and",    "city",  "noise",
+};
+
+/**
+ * @brief Слова и знаки для текста, в котором смешаны разные алфавиты и особые символы
+ */
+const QStringList kMultilingualWords = {
+    "the", "don't", "42", "x2", "-", "\"", u8"Кто-то", u8"слово", u8"ёлка", u8"caf\u00e9",
+    u8"e\u0301t\u00e9", u8"\U0001D400\U0001D401", u8"\u4e2d\u6587",
+};
+const QStringList kMultilingualPunctuation = {
+    "", "", "", ",", ".", "!", "?", "...", u8"\u2026", ":", ";", "?!",
+};
+const QStringList kMultilingualSpaces = {
+    " ", " ", " ", "  ", "\t", "\n", u8"\u00a0",
+};
+
+QString sentence(QRandomGenerator& _random, int _wordsCount)
+{
+    QStringList words;
+    for (int index = 0; index < _wordsCount; ++index) {
+        words.append(kWords.at(_random.bounded(kWords.size())));
+    }
+    auto result = words.join(' ');
+    result[0] = result.at(0).toUpper();
+    return result + ".";
+}
+
+} // namespace
+
+
+QString SyntheticDocuments::marker()
+{
+    return QLatin1String("Benchmark marker line");
+}
+
+QString SyntheticDocuments::screenplayFountain(int _scenesCount)
+{
+    QRandomGenerator random(kSeed);
+    QString result;
+    for (int scene = 0; scene < _scenesCount; ++scene) {
+        result += QString("%1. %2 - %3\n\n")
+                      .arg(random.bounded(2) == 0 ? "INT" : "EXT",
+                           kLocations.at(random.bounded(kLocations.size())),
+                           random.bounded(2) == 0 ? "DAY" : "NIGHT");
+        result += sentence(random, 20 + random.bounded(30)) + "\n\n";
+        if (scene == _scenesCount / 2) {
+            result += marker() + "\n\n";
+        }
+
+        const int dialoguesCount = 2 + random.bounded(6);
+        for (int dialogue = 0; dialogue < dialoguesCount; ++dialogue) {
+            result += kCharacters.at(random.bounded(kCharacters.size())) + "\n";
+            if (random.bounded(4) == 0) {
+                result += "(quietly)\n";
+            }
+            result += sentence(random, 5 + random.bounded(20)) + "\n\n";
+        }
+    }
+    return result;
+}
+
+QString SyntheticDocuments::novelMarkdown(int _chaptersCount)
+{
+    QRandomGenerator random(kSeed);
+    QString result;
+    for (int chapter = 0; chapter < _chaptersCount; ++chapter) {
+        result += QString("# Chapter %1\n\n").arg(chapter + 1);
+        if (chapter == _chaptersCount / 2) {
+            result += marker() + "\n\n";
+        }
+
+        const int paragraphsCount = 10 + random.bounded(20);
+        for (int paragraph = 0; paragraph < paragraphsCount; ++paragraph) {
+            QStringList sentences;
+            const int sentencesCount = 3 + random.bounded(6);
+            for (int index = 0; index < sentencesCount; ++index) {
+                sentences.append(sentence(random, 6 + random.bounded(14)));
+            }
+            result += sentences.join(' ') + "\n\n";
+        }
+    }
+    return result;
+}
+
+QString SyntheticDocuments::multilingualText(int _seed, int _wordsCount)
+{
+    QRandomGenerator random(kSeed + static_cast<quint32>(_seed));
+    QString result;
+    for (int index = 0; index < _wordsCount; ++index) {
+        if (random.bounded(8) == 0) {
+            result += "(";
+        }
+        result += kMultilingualWords.at(random.bounded(kMultilingualWords.size()));
+        if (random.bounded(4) == 0) {
+            result += kMultilingualWords.at(random.bounded(kMultilingualWords.size()));
+        }
+        result += kMultilingualPunctuation.at(random.bounded(kMultilingualPunctuation.size()));
+        result += kMultilingualSpaces.at(random.bounded(kMultilingualSpaces.size()));
+    }
+    return result;
+}
+
+QVector<QString> SyntheticDocuments::editHistory(int _seed, int _editsCount)
+{
+    QRandomGenerator random(kSeed + static_cast<quint32>(_seed));
+
+    //
+    // Документ храним списком сцен, каждая из которых является списком абзацев
+    //
+    QVector<QStringList> scenes;
+    const int scenesCount = 1 + random.bounded(8);
+    for (int scene = 0; scene < scenesCount; ++scene) {
+        QStringList paragraphs;
+        const int paragraphsCount = 1 + random.bounded(6);
+        for (int paragraph = 0; paragraph < paragraphsCount; ++paragraph) {
+            paragraphs.append(sentence(random, 3 + random.bounded(30)));
+        }
+        scenes.append(paragraphs);
+    }
+    auto toXml = [&scenes] {
+        QString xml = "<document>";
+        for (const auto& paragraphs : std::as_const(scenes)) {
+            xml += "<scene>";
+            for (const auto& paragraph : paragraphs) {
+                xml += "<text>" + paragraph + "</text>";
+            }
+            xml += "</scene>";
+        }
+        return xml + "</document>";
+    };
+
+    QVector<QString> history = { toXml() };
+    for (int edit = 0; edit < _editsCount; ++edit) {
+        auto& paragraphs = scenes[random.bounded(scenes.size())];
+        const int paragraph = random.bounded(paragraphs.size());
+        auto& text = paragraphs[paragraph];
+        switch (random.bounded(5)) {
+        //
+        // Вставка текста, в том числе длиннее окна поиска совпадений
+        //
+        case 0: {
+            text.insert(random.bounded(text.size() + 1),
+                        " " + sentence(random, 1 + random.bounded(random.bounded(2) ? 3 : 20)));
+            break;
+        }
+        //
+        // Удаление куска текста
+        //
+        case 1: {
+            const int position = random.bounded(text.size());
+            text.remove(position, 1 + random.bounded(text.size() - position));
+            if (text.isEmpty()) {
+                text = sentence(random, 1);
+            }
+            break;
+        }
+        //
+        // Повтор абзаца, чтобы в документе были одинаковые куски
+        //
+        case 2: {
+            paragraphs.insert(paragraph, QString(text));
+            break;
+        }
+        //
+        // Удаление абзаца
+        //
+        case 3: {
+            if (paragraphs.size() > 1) {
+                paragraphs.removeAt(paragraph);
+            }
+            break;
+        }
+        //
+        // Добавление сцены
+        //
+        default: {
+            scenes.insert(random.bounded(scenes.size() + 1),
+                          { sentence(random, 2 + random.bounded(10)) });
+            break;
+        }
+        }
+        history.append(toXml());
+    }
+    return history;
+}
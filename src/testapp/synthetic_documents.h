@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+
+/**
+ * @brief Генератор синтетических документов заданного размера для замеров производительности
+ */
+class SyntheticDocuments
+{
+public:
+    /**
+     * @brief Текст, который вставляется в середину документа и используется для его изменения
+     */
+    static QString marker();
+
+    /**
+     * @brief Сценарий в формате fountain с заданным количеством сцен
+     */
+    static QString screenplayFountain(int _scenesCount);
+
+    /**
+     * @brief Роман в формате markdown с заданным количеством глав
+     */
+    static QString novelMarkdown(int _chaptersCount);
+
+    /**
+     * @brief Текст на нескольких языках с суррогатными парами, комбинируемыми символами и
+     *        знаками препинания в разных сочетаниях
+     */
+    static QString multilingualText(int _seed, int _wordsCount);
+
+    /**
+     * @brief История случайных правок xml-документа из тэгов document, scene и text
+     * @return Версии документа, начиная с исходной, после каждой из правок
+     */
+    static QVector<QString> editHistory(int _seed, int _editsCount);
+};
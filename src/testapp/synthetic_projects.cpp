@@ -0,0 +1,188 @@
+#include "synthetic_projects.h"
+
+#include "synthetic_documents.h"
+
+#include <business_layer/import/audioplay/audioplay_fountain_importer.h>
+#include <business_layer/import/screenplay/screenplay_fountain_importer.h>
+#include <business_layer/import/stageplay/stageplay_fountain_importer.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model_scene_item.h>
+#include <business_layer/model/text/text_model_group_item.h>
+#include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/templates/text_template.h>
+#include <domain/objects_builder.h>
+
+#include <QUuid>
+
+#include <functional>
+
+using namespace BusinessLayer;
+
+
+Domain::DocumentObject* SyntheticProjects::createDocument(Domain::DocumentObjectType _type)
+{
+    return Domain::ObjectsBuilder::createDocument({}, QUuid::createUuid(), _type, {});
+}
+
+QVector<ScreenplayTextModelSceneItem*> SyntheticProjects::screenplayScenes(TextModel* _model)
+{
+    QVector<ScreenplayTextModelSceneItem*> scenes;
+    std::function<void(TextModelItem*)> collectScenes;
+    collectScenes = [&scenes, &collectScenes](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            const auto child = _item->childAt(childIndex);
+            if (child->type() == TextModelItemType::Folder) {
+                collectScenes(child);
+            } else if (child->type() == TextModelItemType::Group
+                       && static_cast<TextModelGroupItem*>(child)->groupType()
+                           == TextGroupType::Scene) {
+                scenes.append(static_cast<ScreenplayTextModelSceneItem*>(child));
+            }
+        }
+    };
+    collectScenes(_model->itemForIndex({}));
+    return scenes;
+}
+
+
+// ****
+
+
+ScreenplayProject::ScreenplayProject()
+    : SyntheticProject(Domain::DocumentObjectType::Screenplay,
+                       Domain::DocumentObjectType::ScreenplayTitlePage,
+                       Domain::DocumentObjectType::ScreenplaySynopsis,
+                       Domain::DocumentObjectType::ScreenplayText,
+                       Domain::DocumentObjectType::ScreenplayDictionaries)
+{
+}
+
+ScreenplayProject::ScreenplayProject(int _scenesCount)
+    : ScreenplayProject()
+{
+    loadText(ScreenplayFountainImporter()
+                 .importScreenplay(SyntheticDocuments::screenplayFountain(_scenesCount))
+                 .text.toUtf8());
+}
+
+void ScreenplayProject::tagBreakdownResources()
+{
+    for (const auto& category : { "Props", "Wardrobe", "Vehicles" }) {
+        dictionariesModel->addResourceCategory(category, {}, Qt::gray, false);
+    }
+    const auto categories = dictionariesModel->resourceCategories();
+    for (int resourceIndex = 0; resourceIndex < 10; ++resourceIndex) {
+        dictionariesModel->addResource(categories.at(resourceIndex % categories.size()).uuid,
+                                       QString("Resource %1").arg(resourceIndex), {});
+    }
+
+    const auto resources = dictionariesModel->resources();
+    const auto scenes = SyntheticProjects::screenplayScenes(textModel.data());
+    for (int sceneIndex = 0; sceneIndex < scenes.size(); ++sceneIndex) {
+        const auto scene = scenes.at(sceneIndex);
+        for (int resourceIndex = 0; resourceIndex < resources.size(); ++resourceIndex) {
+            if ((sceneIndex * 7 + resourceIndex * 3) % 5 == 0) {
+                scene->storeResource(resources.at(resourceIndex).uuid,
+                                     1 + (sceneIndex + resourceIndex) % 4, {});
+            }
+        }
+        textModel->updateItem(scene);
+    }
+}
+
+
+// ****
+
+
+NovelProject::NovelProject()
+    : SyntheticProject(Domain::DocumentObjectType::Novel,
+                       Domain::DocumentObjectType::NovelTitlePage,
+                       Domain::DocumentObjectType::NovelSynopsis,
+                       Domain::DocumentObjectType::NovelText,
+                       Domain::DocumentObjectType::NovelDictionaries)
+{
+}
+
+
+// ****
+
+
+StageplayProject::StageplayProject()
+    : PlayProject(Domain::DocumentObjectType::Stageplay, Domain::DocumentObjectType::StageplayText)
+{
+}
+
+StageplayProject::StageplayProject(int _scenesCount)
+    : StageplayProject()
+{
+    loadText(StageplayFountainImporter()
+                 .importStageplay(SyntheticDocuments::screenplayFountain(_scenesCount))
+                 .text.toUtf8());
+}
+
+
+// ****
+
+
+AudioplayProject::AudioplayProject()
+    : PlayProject(Domain::DocumentObjectType::Audioplay, Domain::DocumentObjectType::AudioplayText)
+{
+}
+
+AudioplayProject::AudioplayProject(int _scenesCount)
+    : AudioplayProject()
+{
+    loadText(AudioplayFountainImporter()
+                 .importAudioplay(SyntheticDocuments::screenplayFountain(_scenesCount))
+                 .text.toUtf8());
+}
+
+
+// ****
+
+
+ComicBookProject::ComicBookProject()
+    : dictionariesDocument(
+        SyntheticProjects::createDocument(Domain::DocumentObjectType::ComicBookDictionaries))
+    , charactersDocument(SyntheticProjects::createDocument(Domain::DocumentObjectType::Characters))
+    , textDocument(SyntheticProjects::createDocument(Domain::DocumentObjectType::ComicBookText))
+    , dictionariesModel(new ComicBookDictionariesModel)
+    , charactersModel(new CharactersModel)
+    , textModel(new ComicBookTextModel)
+{
+    dictionariesModel->setDocument(dictionariesDocument.data());
+    charactersModel->setDocument(charactersDocument.data());
+    textModel->setDictionariesModel(dictionariesModel.data());
+    textModel->setCharactersModel(charactersModel.data());
+    textModel->setDocument(textDocument.data());
+}
+
+TextModelTextItem* ComicBookProject::createText(TextParagraphType _type,
+                                                const QString& _text) const
+{
+    auto textItem = textModel->createTextItem();
+    textItem->setParagraphType(_type);
+    textItem->setText(_text);
+    return textItem;
+}
+
+TextModelItem* ComicBookProject::createPanel(const QString& _heading) const
+{
+    auto panel = textModel->createGroupItem(TextGroupType::Panel);
+    panel->appendItem(createText(TextParagraphType::PanelHeading, _heading));
+    panel->appendItem(createText(TextParagraphType::Description, "Panel description"));
+    panel->appendItem(createText(TextParagraphType::Character, "HERO"));
+    panel->appendItem(createText(TextParagraphType::Dialogue, "Hello there"));
+    panel->appendItem(createText(TextParagraphType::Character, "SIDEKICK"));
+    panel->appendItem(createText(TextParagraphType::Lyrics, "La la la"));
+    return panel;
+}
+
+TextModelItem* ComicBookProject::createPage(const QString& _heading, int _panelsCount) const
+{
+    auto page = textModel->createGroupItem(TextGroupType::Page);
+    page->appendItem(createText(TextParagraphType::PageHeading, _heading));
+    for (int panelIndex = 0; panelIndex < _panelsCount; ++panelIndex) {
+        page->appendItem(createPanel(panelIndex % 4 == 3 ? "PANELS" : "PANEL"));
+    }
+    return page;
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <business_layer/model/audioplay/audioplay_information_model.h>
+#include <business_layer/model/audioplay/text/audioplay_text_model.h>
+#include <business_layer/model/characters/characters_model.h>
+#include <business_layer/model/comic_book/comic_book_dictionaries_model.h>
+#include <business_layer/model/comic_book/text/comic_book_text_model.h>
+#include <business_layer/model/locations/locations_model.h>
+#include <business_layer/model/novel/novel_dictionaries_model.h>
+#include <business_layer/model/novel/novel_information_model.h>
+#include <business_layer/model/novel/text/novel_text_model.h>
+#include <business_layer/model/screenplay/screenplay_dictionaries_model.h>
+#include <business_layer/model/screenplay/screenplay_information_model.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model.h>
+#include <business_layer/model/simple_text/simple_text_model.h>
+#include <business_layer/model/stageplay/stageplay_information_model.h>
+#include <business_layer/model/stageplay/text/stageplay_text_model.h>
+#include <domain/document_object.h>
+
+#include <QScopedPointer>
+#include <QVector>
+
+namespace BusinessLayer {
+class ScreenplayTextModelSceneItem;
+class TextModelItem;
+class TextModelTextItem;
+enum class TextParagraphType;
+} // namespace BusinessLayer
+
+
+/**
+ * @brief Построение синтетических проектов для проверок и замеров производительности
+ */
+class SyntheticProjects
+{
+public:
+    /**
+     * @brief Создать пустой документ заданного типа
+     */
+    static Domain::DocumentObject* createDocument(Domain::DocumentObjectType _type);
+
+    /**
+     * @brief Сцены сценария в порядке следования в документе
+     */
+    static QVector<BusinessLayer::ScreenplayTextModelSceneItem*> screenplayScenes(
+        BusinessLayer::TextModel* _model);
+};
+
+/**
+ * @brief Синтетический проект с текстовым документом и всеми моделями, от которых он зависит
+ */
+template<typename TextModelType, typename InformationModelType, typename DictionariesModelType>
+class SyntheticProject
+{
+public:
+    SyntheticProject(Domain::DocumentObjectType _informationType,
+                     Domain::DocumentObjectType _titlePageType,
+                     Domain::DocumentObjectType _synopsisType, Domain::DocumentObjectType _textType,
+                     Domain::DocumentObjectType _dictionariesType)
+        : informationDocument(SyntheticProjects::createDocument(_informationType))
+        , titlePageDocument(SyntheticProjects::createDocument(_titlePageType))
+        , synopsisDocument(SyntheticProjects::createDocument(_synopsisType))
+        , dictionariesDocument(SyntheticProjects::createDocument(_dictionariesType))
+        , charactersDocument(
+              SyntheticProjects::createDocument(Domain::DocumentObjectType::Characters))
+        , locationsDocument(
+              SyntheticProjects::createDocument(Domain::DocumentObjectType::Locations))
+        , textDocument(SyntheticProjects::createDocument(_textType))
+        , informationModel(new InformationModelType)
+        , titlePageModel(new BusinessLayer::SimpleTextModel)
+        , synopsisModel(new BusinessLayer::SimpleTextModel)
+        , dictionariesModel(new DictionariesModelType)
+        , charactersModel(new BusinessLayer::CharactersModel)
+        , locationsModel(new BusinessLayer::LocationsModel)
+    {
+        informationModel->setDocument(informationDocument.data());
+        titlePageModel->setDocument(titlePageDocument.data());
+        synopsisModel->setDocument(synopsisDocument.data());
+        dictionariesModel->setDocument(dictionariesDocument.data());
+        charactersModel->setDocument(charactersDocument.data());
+        locationsModel->setDocument(locationsDocument.data());
+    }
+
+    /**
+     * @brief Загрузить текст документа из xml
+     */
+    void loadText(const QByteArray& _xml)
+    {
+        textModel.reset(new TextModelType);
+        textModel->setInformationModel(informationModel.data());
+        textModel->setTitlePageModel(titlePageModel.data());
+        textModel->setSynopsisModel(synopsisModel.data());
+        textModel->setDictionariesModel(dictionariesModel.data());
+        textModel->setCharactersModel(charactersModel.data());
+        textModel->setLocationsModel(locationsModel.data());
+        textDocument->setContent(_xml);
+        textModel->setDocument(textDocument.data());
+    }
+
+    /**
+     * @brief Выгрузить текст документа
+     */
+    void unloadText()
+    {
+        textModel.reset();
+    }
+
+
+    QScopedPointer<Domain::DocumentObject> informationDocument;
+    QScopedPointer<Domain::DocumentObject> titlePageDocument;
+    QScopedPointer<Domain::DocumentObject> synopsisDocument;
+    QScopedPointer<Domain::DocumentObject> dictionariesDocument;
+    QScopedPointer<Domain::DocumentObject> charactersDocument;
+    QScopedPointer<Domain::DocumentObject> locationsDocument;
+    QScopedPointer<Domain::DocumentObject> textDocument;
+
+    QScopedPointer<InformationModelType> informationModel;
+    QScopedPointer<BusinessLayer::SimpleTextModel> titlePageModel;
+    QScopedPointer<BusinessLayer::SimpleTextModel> synopsisModel;
+    QScopedPointer<DictionariesModelType> dictionariesModel;
+    QScopedPointer<BusinessLayer::CharactersModel> charactersModel;
+    QScopedPointer<BusinessLayer::LocationsModel> locationsModel;
+    QScopedPointer<TextModelType> textModel;
+};
+
+/**
+ * @brief Синтетический сценарий с заданным количеством сцен
+ */
+class ScreenplayProject
+    : public SyntheticProject<BusinessLayer::ScreenplayTextModel,
+                              BusinessLayer::ScreenplayInformationModel,
+                              BusinessLayer::ScreenplayDictionariesModel>
+{
+public:
+    ScreenplayProject();
+    explicit ScreenplayProject(int _scenesCount);
+
+    /**
+     * @brief Добавить в справочники ресурсы разработки и отметить их в сценах сценария
+     */
+    void tagBreakdownResources();
+};
+
+/**
+ * @brief Синтетический роман
+ */
+class NovelProject : public SyntheticProject<BusinessLayer::NovelTextModel,
+                                             BusinessLayer::NovelInformationModel,
+                                             BusinessLayer::NovelDictionariesModel>
+{
+public:
+    NovelProject();
+};
+
+/**
+ * @brief Синтетическая пьеса или аудиопостановка с моделями, от которых зависит её текст
+ */
+template<typename TextModelType, typename InformationModelType>
+class PlayProject
+{
+public:
+    PlayProject(Domain::DocumentObjectType _informationType,
+                Domain::DocumentObjectType _textType)
+        : informationDocument(SyntheticProjects::createDocument(_informationType))
+        , charactersDocument(
+              SyntheticProjects::createDocument(Domain::DocumentObjectType::Characters))
+        , textDocument(SyntheticProjects::createDocument(_textType))
+        , informationModel(new InformationModelType)
+        , charactersModel(new BusinessLayer::CharactersModel)
+    {
+        informationModel->setDocument(informationDocument.data());
+        charactersModel->setDocument(charactersDocument.data());
+    }
+
+    /**
+     * @brief Загрузить текст документа из xml
+     */
+    void loadText(const QByteArray& _xml)
+    {
+        textModel.reset(new TextModelType);
+        textModel->setInformationModel(informationModel.data());
+        textModel->setCharactersModel(charactersModel.data());
+        textDocument->setContent(_xml);
+        textModel->setDocument(textDocument.data());
+    }
+
+
+    QScopedPointer<Domain::DocumentObject> informationDocument;
+    QScopedPointer<Domain::DocumentObject> charactersDocument;
+    QScopedPointer<Domain::DocumentObject> textDocument;
+
+    QScopedPointer<InformationModelType> informationModel;
+    QScopedPointer<BusinessLayer::CharactersModel> charactersModel;
+    QScopedPointer<TextModelType> textModel;
+};
+
+/**
+ * @brief Синтетическая пьеса с заданным количеством сцен
+ */
+class StageplayProject : public PlayProject<BusinessLayer::StageplayTextModel,
+                                            BusinessLayer::StageplayInformationModel>
+{
+public:
+    StageplayProject();
+    explicit StageplayProject(int _scenesCount);
+};
+
+/**
+ * @brief Синтетическая аудиопостановка с заданным количеством сцен
+ */
+class AudioplayProject : public PlayProject<BusinessLayer::AudioplayTextModel,
+                                            BusinessLayer::AudioplayInformationModel>
+{
+public:
+    AudioplayProject();
+    explicit AudioplayProject(int _scenesCount);
+};
+
+/**
+ * @brief Синтетический комикс со справочниками, от которых зависит нумерация его текста
+ */
+class ComicBookProject
+{
+public:
+    ComicBookProject();
+
+    /**
+     * @brief Создать блок текста заданного типа
+     */
+    BusinessLayer::TextModelTextItem* createText(BusinessLayer::TextParagraphType _type,
+                                                 const QString& _text) const;
+
+    /**
+     * @brief Создать панель с описанием и репликами двух персонажей
+     */
+    BusinessLayer::TextModelItem* createPanel(const QString& _heading) const;
+
+    /**
+     * @brief Создать страницу с заданным количеством панелей, каждая четвёртая из которых двойная
+     */
+    BusinessLayer::TextModelItem* createPage(const QString& _heading, int _panelsCount) const;
+
+
+    QScopedPointer<Domain::DocumentObject> dictionariesDocument;
+    QScopedPointer<Domain::DocumentObject> charactersDocument;
+    QScopedPointer<Domain::DocumentObject> textDocument;
+
+    QScopedPointer<BusinessLayer::ComicBookDictionariesModel> dictionariesModel;
+    QScopedPointer<BusinessLayer::CharactersModel> charactersModel;
+    QScopedPointer<BusinessLayer::ComicBookTextModel> textModel;
+};
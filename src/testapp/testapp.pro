@@ -1,8 +1,9 @@
 TEMPLATE = app
 TARGET = testapp
 
-CONFIG += c++11
-QT += widgets
+CONFIG += c++1z
+CONFIG += console
+QT += widgets sql
 
 DESTDIR = ../_build/
 
@@ -19,14 +20,39 @@ INCLUDEPATH += $$PWD/../corelib
 DEPENDPATH += $$PWD/../corelib
 #
 
+LIBSDIR = ../_build/libs
+
+#
+# Подключаем библиотеку fileformats
+#
+LIBS += -L$$LIBSDIR/ -lfileformats
+INCLUDEPATH += $$PWD/../3rd_party/fileformats
+DEPENDPATH += $$PWD/../3rd_party/fileformats
+
+mac:LIBS += -lz
+#
+
 #
 # Подключаем библиотеку Webloader
 #
-LIBSDIR = ../_build/libs
 LIBS += -L$$LIBSDIR/ -lwebloader
 INCLUDEPATH += $$PWD/../3rd_party/webloader/src
 DEPENDPATH += $$PWD/../3rd_party/webloader
 #
 
 SOURCES += \
-    main.cpp
+    benchmark_runner.cpp \
+    check_runner.cpp \
+    main.cpp \
+    model_checks.cpp \
+    storage_checks.cpp \
+    synthetic_documents.cpp \
+    synthetic_projects.cpp \
+    text_checks.cpp
+
+HEADERS += \
+    benchmark_runner.h \
+    check_runner.h \
+    checks.h \
+    synthetic_documents.h \
+    synthetic_projects.h
@@ -0,0 +1,274 @@
+#include "check_runner.h"
+#include "checks.h"
+#include "synthetic_documents.h"
+
+#include <utils/diff_match_patch/diff_match_patch_controller.h>
+
+#include <QHash>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <iostream>
+
+
+namespace {
+
+/**
+ * @brief Есть ли в тексте буквы или цифры
+ */
+bool hasLettersOrNumbers(const QString& _text)
+{
+    const auto characters = _text.toUcs4();
+    return std::any_of(characters.begin(), characters.end(),
+                       [](uint _character) { return QChar::isLetterOrNumber(_character); });
+}
+
+} // namespace
+
+
+TextHelper::Counters Checks::referenceCounters(const QString& _text)
+{
+    //
+    // Слова считаем в точности так же, как считал TextHelper::wordsCount до перехода на подсчёт
+    // за один проход, чтобы сверяться с прежним поведением, а не с его пересказом
+    //
+    static const QRegularExpression wordCountExpression("[\\s.,!():;]+");
+    static const QRegularExpression sentencesEnds(u8"[.!?\u2026]+");
+
+    TextHelper::Counters counters;
+    counters.words = _text.split(wordCountExpression, Qt::SkipEmptyParts).count();
+    const auto characters = _text.toUcs4();
+    counters.characters = static_cast<int>(characters.size());
+    counters.charactersWithoutSpaces = static_cast<int>(
+        std::count_if(characters.begin(), characters.end(),
+                      [](uint _character) { return !QChar::isSpace(_character); }));
+    for (const auto& sentence : _text.split(sentencesEnds, Qt::SkipEmptyParts)) {
+        if (hasLettersOrNumbers(sentence)) {
+            ++counters.sentences;
+        }
+    }
+    return counters;
+}
+
+
+namespace {
+
+/**
+ * @brief Сверить счётчики текста с эталонными на случайных текстах разной длины
+ */
+void checkTextCounters(CheckRunner& _runner, int _textsCount)
+{
+    for (int seed = 0; seed < _textsCount; ++seed) {
+        const auto text = SyntheticDocuments::multilingualText(seed, seed % 64);
+        const auto counters = TextHelper::counters(text);
+        const auto reference = Checks::referenceCounters(text);
+        if (counters.words == reference.words && counters.characters == reference.characters
+            && counters.charactersWithoutSpaces == reference.charactersWithoutSpaces
+            && counters.sentences == reference.sentences) {
+            continue;
+        }
+
+        _runner.mismatch() << "\"" << qPrintable(text) << "\": words " << counters.words
+                           << " vs " << reference.words << ", characters " << counters.characters
+                           << " vs " << reference.characters << ", characters without spaces "
+                           << counters.charactersWithoutSpaces << " vs "
+                           << reference.charactersWithoutSpaces << ", sentences "
+                           << counters.sentences << " vs " << reference.sentences << std::endl;
+    }
+}
+
+/**
+ * @brief Воспроизвести случайные истории правок через патчи с проверкой результата наложения
+ */
+void checkPatchReplay(CheckRunner& _runner, int _historiesCount)
+{
+    const DiffMatchPatchController dmpController({ "document", "scene", "text" });
+    for (int seed = 0; seed < _historiesCount; ++seed) {
+        const auto history = SyntheticDocuments::editHistory(seed, 1 + seed % 32);
+
+        //
+        // Изменения, наложенные на ту же версию, что и при формировании, должны наложиться точно,
+        // а результат совпасть с ожидаемым
+        //
+        auto content = history.constFirst().toUtf8();
+        for (int index = 1; index < history.size(); ++index) {
+            const auto expectedContent = history.at(index).toUtf8();
+            const auto patch = dmpController.makePatch(history.at(index - 1), history.at(index));
+            auto result = dmpController.applyPatchVerified(
+                content, patch, DiffMatchPatchController::contentHash(expectedContent));
+            if (result.isValid() && result.isExact() && result.content == expectedContent) {
+                content.swap(result.content);
+                continue;
+            }
+
+            _runner.mismatch() << "history " << seed << " at change " << index << std::endl;
+            break;
+        }
+
+        //
+        // Изменения, наложенные на разошедшуюся версию, должны признаваться корректными только,
+        // если результат совпал с ожидаемым
+        //
+        auto divergedContent = history.constFirst().toUtf8();
+        divergedContent.insert(divergedContent.indexOf("<text>") + 6, "Diverged ");
+        for (int index = 1; index < history.size(); ++index) {
+            const auto expectedContent = history.at(index).toUtf8();
+            const auto patch = dmpController.makePatch(history.at(index - 1), history.at(index));
+            auto result = dmpController.applyPatchVerified(
+                divergedContent, patch, DiffMatchPatchController::contentHash(expectedContent));
+            if (result.isValid() != (result.content == expectedContent)) {
+                _runner.mismatch() << "diverged history " << seed << " is verified wrong at change "
+                                   << index << std::endl;
+                break;
+            }
+            divergedContent.swap(result.content);
+        }
+    }
+}
+
+/**
+ * @brief Эталонное определение изменённых кусков xml через замену тэгов во всём документе,
+ *        обратный поиск тэгов по служебным символам и преобразование начала документа в xml
+ */
+QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> referenceChangedXml(
+    const DiffMatchPatchController& _dmpController, const QVector<QString>& _tags,
+    const QString& _xml, const QString& _patch)
+{
+    QHash<QString, QChar> tagsMap;
+    uint characterIndex = 0xE000;
+    for (const auto& tag : _tags) {
+        tagsMap.insert("<" + tag + ">", QChar(characterIndex++));
+        tagsMap.insert("</" + tag + ">", QChar(characterIndex++));
+    }
+    auto xmlToPlain = [&tagsMap](QString _text) {
+        for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
+            _text.replace(iter.key(), iter.value());
+        }
+        return _text;
+    };
+    auto plainToXml = [&tagsMap](QString _text) {
+        for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
+            _text.replace(iter.value(), iter.key());
+        }
+        return _text;
+    };
+
+    const QString oldXmlPlain = xmlToPlain(_xml);
+    const QString newXmlPlain
+        = xmlToPlain(_dmpController.applyPatch(_xml.toUtf8(), _patch.toUtf8()));
+    const QString newPatch = _dmpController.makePatch(oldXmlPlain, newXmlPlain);
+    if (newPatch.isEmpty()) {
+        return {};
+    }
+
+    //
+    // Разбираем заголовки кусков патча так же, как это делает diff_match_patch::patch_fromText
+    //
+    static const QRegularExpression patchHeader(
+        QRegularExpression::anchoredPattern("@@ -(\\d+),?(\\d*) \\+(\\d+),?(\\d*) @@"));
+    auto range = [](const QString& _start, const QString& _length) {
+        if (_length.isEmpty()) {
+            return qMakePair(_start.toInt() - 1, 1);
+        }
+        if (_length == "0") {
+            return qMakePair(_start.toInt(), 0);
+        }
+        return qMakePair(_start.toInt() - 1, _length.toInt());
+    };
+    int oldStartPos = -1;
+    int oldEndPos = -1;
+    int oldDistance = 0;
+    int newStartPos = -1;
+    int newEndPos = -1;
+    for (const auto& line : newPatch.split('\n', Qt::SkipEmptyParts)) {
+        const auto match = patchHeader.match(line);
+        if (!match.hasMatch()) {
+            continue;
+        }
+
+        const auto [start1, length1] = range(match.captured(1), match.captured(2));
+        const auto [start2, length2] = range(match.captured(3), match.captured(4));
+        if (oldStartPos == -1 || start1 < oldStartPos) {
+            oldStartPos = start1;
+        }
+        if (oldEndPos == -1 || oldEndPos < (start1 + length1 - oldDistance)) {
+            oldEndPos = start1 + length1 - oldDistance;
+        }
+        oldDistance += length2 - length1;
+        if (newStartPos == -1 || start2 < newStartPos) {
+            newStartPos = start2;
+        }
+        if (newEndPos == -1 || newEndPos < (start2 + length2)) {
+            newEndPos = start2 + length2;
+        }
+    }
+    if (oldDistance == 0) {
+        oldEndPos = newEndPos;
+    }
+    oldEndPos -= 1;
+    newEndPos -= 1;
+
+    auto changeForUpdate = [&tagsMap, &plainToXml](const QString& _xmlPlain, int _startPos,
+                                                   int _endPos) {
+        int startPos = _startPos;
+        for (; startPos > 0; --startPos) {
+            const auto tag = tagsMap.key(_xmlPlain.at(startPos));
+            if (!tag.isEmpty() && !tag.contains('/')) {
+                break;
+            }
+        }
+        int endPos = _endPos;
+        for (; endPos < _xmlPlain.length(); ++endPos) {
+            if (tagsMap.key(_xmlPlain.at(endPos)).contains('/')) {
+                ++endPos;
+                break;
+            }
+        }
+        return DiffMatchPatchController::Change{
+            plainToXml(_xmlPlain.mid(startPos, endPos - startPos)).toUtf8(),
+            static_cast<int>(plainToXml(_xmlPlain.left(startPos)).length())
+        };
+    };
+    return { changeForUpdate(oldXmlPlain, oldStartPos, oldEndPos),
+             changeForUpdate(newXmlPlain, newStartPos, newEndPos) };
+}
+
+/**
+ * @brief Сверить изменённые куски xml с эталонными на случайных историях правок
+ */
+void checkChangedXml(CheckRunner& _runner, int _historiesCount)
+{
+    const QVector<QString> tags = { "document", "scene", "text" };
+    const DiffMatchPatchController dmpController(tags);
+    for (int seed = 0; seed < _historiesCount; ++seed) {
+        const auto history = SyntheticDocuments::editHistory(seed, 1 + seed % 32);
+        for (int index = 1; index < history.size(); ++index) {
+            const QString patch
+                = dmpController.makePatch(history.at(index - 1), history.at(index));
+            const auto changes = dmpController.changedXml(history.at(index - 1), patch);
+            const auto reference
+                = referenceChangedXml(dmpController, tags, history.at(index - 1), patch);
+            if (changes.first.xml == reference.first.xml
+                && changes.first.from == reference.first.from
+                && changes.second.xml == reference.second.xml
+                && changes.second.from == reference.second.from) {
+                continue;
+            }
+
+            _runner.mismatch() << "history " << seed << " at change " << index << ": from "
+                               << changes.first.from << " vs " << reference.first.from << ", to "
+                               << changes.second.from << " vs " << reference.second.from
+                               << std::endl;
+        }
+    }
+}
+
+} // namespace
+
+
+void Checks::runTextChecks(CheckRunner& _runner)
+{
+    _runner.run("text/counters", [&_runner] { checkTextCounters(_runner, 1000); });
+    _runner.run("patch/replay", [&_runner] { checkPatchReplay(_runner, 500); });
+    _runner.run("patch/changed_xml", [&_runner] { checkChangedXml(_runner, 200); });
+}
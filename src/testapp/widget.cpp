@@ -1,10 +0,0 @@
-#include "widget.h"
-
-Widget::Widget(QWidget* parent)
-    : QWidget(parent)
-{
-}
-
-Widget::~Widget()
-{
-}